@@ -1,7 +1,14 @@
 #include "AssetFileParsing.h"
 #include "Mem.h"
+#include "DataStructures/HashMap.h"
+#include "Utility/Logging.h"
 
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <float.h>
+#include <chrono>
 
 namespace Tk
 {
@@ -25,73 +32,104 @@ static bool HitSpecialChar(char TheChar, const char* SpecialCharList, uint32 Num
     return false;
 }
 
-static void scanLine(const uint8* buffer, uint64* currentIndex)
+// Files can end without a null terminator, e.g. when parsing a mapped view, so the buffer size also marks EOF
+static bool HitEOF(const uint8* buffer, uint64 bufferSize, uint64 index)
+{
+    return index >= bufferSize || HitSpecialChar(buffer[index], &EOFChar, 1);
+}
+
+static void scanLine(const uint8* buffer, uint64 bufferSize, uint64* currentIndex)
 {
     // Scan up to the line ending
-    while (!HitSpecialChar(buffer[*currentIndex], LineEndingChars, ARRAYCOUNT(LineEndingChars)))
+    while (!HitEOF(buffer, bufferSize, *currentIndex) &&
+           !HitSpecialChar(buffer[*currentIndex], LineEndingChars, ARRAYCOUNT(LineEndingChars)))
     {
-        if (HitSpecialChar(buffer[*currentIndex], &EOFChar, 1))
-            return; // marks EOF
-
         ++*currentIndex;
     }
 
     // Scan to the first character after the line ending
-    while (HitSpecialChar(buffer[*currentIndex], LineEndingChars, ARRAYCOUNT(LineEndingChars)))
+    while (!HitEOF(buffer, bufferSize, *currentIndex) &&
+           HitSpecialChar(buffer[*currentIndex], LineEndingChars, ARRAYCOUNT(LineEndingChars)))
     {
-        if (HitSpecialChar(buffer[*currentIndex], &EOFChar, 1))
-            return; // marks EOF
-
-        ++* currentIndex;
+        ++*currentIndex;
     }
 }
 
-static void scanWord(const uint8* buffer, uint64* currentIndex)
+static void scanWord(const uint8* buffer, uint64 bufferSize, uint64* currentIndex)
 {
-    while (!HitSpecialChar(buffer[*currentIndex], LineEndingChars, ARRAYCOUNT(LineEndingChars)) &&
+    while (!HitEOF(buffer, bufferSize, *currentIndex) &&
+           !HitSpecialChar(buffer[*currentIndex], LineEndingChars, ARRAYCOUNT(LineEndingChars)) &&
            !HitSpecialChar(buffer[*currentIndex], WhiteSpaceChars, ARRAYCOUNT(WhiteSpaceChars)))
     {
         ++*currentIndex;
     }
 }
 
-static void scanWhiteSpace(const uint8* buffer, uint64* currentIndex)
+static void scanWhiteSpace(const uint8* buffer, uint64 bufferSize, uint64* currentIndex)
 {
-    while (HitSpecialChar(buffer[*currentIndex], WhiteSpaceChars, ARRAYCOUNT(WhiteSpaceChars)))
+    while (!HitEOF(buffer, bufferSize, *currentIndex) &&
+           HitSpecialChar(buffer[*currentIndex], WhiteSpaceChars, ARRAYCOUNT(WhiteSpaceChars)))
     {
         ++*currentIndex;
     }
 }
 
-static void scanWordIntoBuffer(const uint8* buffer, uint64* currentIndex, char* NextWord, uint32 NextWordMaxLen)
+// NextWord is always null terminated, words that don't fit are truncated
+static void scanWordIntoBuffer(const uint8* buffer, uint64 bufferSize, uint64* currentIndex, char* NextWord, uint32 NextWordMaxLen)
 {
     // Scan to the next word separated by white space
-    scanWhiteSpace(buffer, currentIndex);
+    scanWhiteSpace(buffer, bufferSize, currentIndex);
 
     // We are now on the first character of the word
     uint64 wordStartIndex = *currentIndex;
 
     // Scan to the end of the word
-    scanWord(buffer, currentIndex);
+    scanWord(buffer, bufferSize, currentIndex);
 
     uint32 numBytesToCopy = (uint32)(*currentIndex - wordStartIndex);
-    numBytesToCopy = Min(NextWordMaxLen, numBytesToCopy);
+    numBytesToCopy = Min(NextWordMaxLen - 1, numBytesToCopy);
     memcpy(NextWord, buffer + wordStartIndex, numBytesToCopy);
+    NextWord[numBytesToCopy] = '\0';
 }
 
-static void ReadWordsIntoVertBuffer(uint32 NumWords, float* OutVertexData, const uint8* EntireFileBuffer, uint64* currentIndex)
+static void ReadWordsIntoVertBuffer(uint32 NumWords, float* OutVertexData, const uint8* EntireFileBuffer, uint64 FileSize, uint64* currentIndex)
 {
     for (uint32 uiWord = 0; uiWord < NumWords; ++uiWord)
     {
         char NextWord[MAX_SCRATCH_WORD_LEN];
-        memset(NextWord, 0, ARRAYCOUNT(NextWord) * sizeof(char));
-        scanWordIntoBuffer(EntireFileBuffer, currentIndex, NextWord, ARRAYCOUNT(NextWord));
+        scanWordIntoBuffer(EntireFileBuffer, FileSize, currentIndex, NextWord, ARRAYCOUNT(NextWord));
         float WordAsFloat = (float)atof(NextWord);
         OutVertexData[uiWord] = WordAsFloat;
     }
 }
 
-void ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator& UVAllocator,
+// Line starts with this two character tag, e.g. "vt"
+static bool HitLineTag(const uint8* buffer, uint64 bufferSize, uint64 index, char tag0, char tag1)
+{
+    return index + 1 < bufferSize && buffer[index] == tag0 && buffer[index + 1] == tag1;
+}
+
+// Reads one index of a face vertex and converts it to start from 0. Fails on indices that don't refer to an element
+// parsed so far, which includes relative (negative) indices since those aren't supported.
+static bool ScanOBJIndex(const uint8* buffer, uint64 bufferSize, uint64* currentIndex, uint32 numElements, uint32* outIndex)
+{
+    char NextWord[MAX_SCRATCH_WORD_LEN];
+    scanWordIntoBuffer(buffer, bufferSize, currentIndex, NextWord, ARRAYCOUNT(NextWord));
+    const int objIndex = atoi(NextWord);
+    if (objIndex < 1 || (uint32)objIndex > numElements)
+        return false;
+
+    *outIndex = (uint32)objIndex - 1;
+    return true;
+}
+
+// Face vertices must be "v/vt/vn", e.g. "1//1" has no uv
+static bool HitOBJIndexSeparator(const uint8* buffer, uint64 bufferSize, uint64 index)
+{
+    return index < bufferSize && buffer[index] == '/' && (index + 1 >= bufferSize || buffer[index + 1] != '/');
+}
+
+bool ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator& UVAllocator,
     Tk::Core::LinearAllocator& NormalAllocator, Tk::Core::LinearAllocator& IndexAllocator,
     OBJParseScratchBuffers& ScratchBuffers, const uint8* EntireFileBuffer, uint64 FileSize, uint32* OutVertCount)
 {
@@ -104,42 +142,42 @@ void ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator
     // Need global counter for indices
     uint32 indicesCounter = 0;
 
-    // Scan until we hit the null terminator which is used here to mark EOF, and for safety, stay within file size
-    while (currentIndex < FileSize && !HitSpecialChar(EntireFileBuffer[currentIndex], &EOFChar, 1))
+    // Scan until we hit the null terminator or the end of the buffer, either marks EOF
+    while (!HitEOF(EntireFileBuffer, FileSize, currentIndex))
     {
-        if (EntireFileBuffer[currentIndex] == 'v' && EntireFileBuffer[currentIndex + 1] == ' ') // Vertex positions
+        if (HitLineTag(EntireFileBuffer, FileSize, currentIndex, 'v', ' ')) // Vertex positions
         {
             // skip the 'v'
-            scanWord(EntireFileBuffer, &currentIndex);
+            scanWord(EntireFileBuffer, FileSize, &currentIndex);
 
             v4f* VertBufferPtr = (v4f*)ScratchBuffers.VertPosAllocator.Alloc(sizeof(v4f), 1);
             const uint32 numWordsPerVert = 3;
-            ReadWordsIntoVertBuffer(numWordsPerVert, (float*)VertBufferPtr, EntireFileBuffer, &currentIndex);
+            ReadWordsIntoVertBuffer(numWordsPerVert, (float*)VertBufferPtr, EntireFileBuffer, FileSize, &currentIndex);
             (*VertBufferPtr)[numWordsPerVert] = 1.0f; // set homogeneous coord to 1
         }
-        else if (EntireFileBuffer[currentIndex] == 'v' && EntireFileBuffer[currentIndex + 1] == 't') // Vertex texture coordinates
+        else if (HitLineTag(EntireFileBuffer, FileSize, currentIndex, 'v', 't')) // Vertex texture coordinates
         {
             // skip the 'vt'
-            scanWord(EntireFileBuffer, &currentIndex);
+            scanWord(EntireFileBuffer, FileSize, &currentIndex);
 
             v2f* VertBufferPtr = (v2f*)ScratchBuffers.VertUVAllocator.Alloc(sizeof(v2f), 1);
             const uint32 numWordsPerVert = 2;
-            ReadWordsIntoVertBuffer(numWordsPerVert, (float*)VertBufferPtr, EntireFileBuffer, &currentIndex);
+            ReadWordsIntoVertBuffer(numWordsPerVert, (float*)VertBufferPtr, EntireFileBuffer, FileSize, &currentIndex);
         }
-        else if (EntireFileBuffer[currentIndex] == 'v' && EntireFileBuffer[currentIndex + 1] == 'n') // Vertex normals
+        else if (HitLineTag(EntireFileBuffer, FileSize, currentIndex, 'v', 'n')) // Vertex normals
         {
             // skip the 'vn'
-            scanWord(EntireFileBuffer, &currentIndex);
+            scanWord(EntireFileBuffer, FileSize, &currentIndex);
 
             v4f* VertBufferPtr = (v4f*)ScratchBuffers.VertNormalAllocator.Alloc(sizeof(v4f), 1);
             const uint32 numWordsPerVert = 3;
-            ReadWordsIntoVertBuffer(numWordsPerVert, (float*)VertBufferPtr, EntireFileBuffer, &currentIndex);
+            ReadWordsIntoVertBuffer(numWordsPerVert, (float*)VertBufferPtr, EntireFileBuffer, FileSize, &currentIndex);
             VertBufferPtr->w = 0.0f;
         }
-        else if (EntireFileBuffer[currentIndex] == 'f' && EntireFileBuffer[currentIndex + 1] == ' ') // Indices
+        else if (HitLineTag(EntireFileBuffer, FileSize, currentIndex, 'f', ' ')) // Indices
         {
             // skip the 'f'
-            scanWord(EntireFileBuffer, &currentIndex);
+            scanWord(EntireFileBuffer, FileSize, &currentIndex);
 
             const uint8 numWordsPerFace = 3;
             for (uint8 uiWord = 0; uiWord < numWordsPerFace; ++uiWord)
@@ -147,21 +185,21 @@ void ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator
                 const uint8 numIndicesPerFace = 3;
                 uint32 newIndices[numIndicesPerFace] = {};
 
-                // NOTE: '/' characters are treated as white space when scanning chars
-                char NextWord[MAX_SCRATCH_WORD_LEN];
-
-                // Normalize indices to start from 0, OBJ convention is to start from 1
-                memset(NextWord, 0, ARRAYCOUNT(NextWord) * sizeof(char));
-                scanWordIntoBuffer(EntireFileBuffer, &currentIndex, NextWord, ARRAYCOUNT(NextWord));
-                newIndices[0] = (uint32)atoi(NextWord) - 1;
-
-                memset(NextWord, 0, ARRAYCOUNT(NextWord) * sizeof(char));
-                scanWordIntoBuffer(EntireFileBuffer, &currentIndex, NextWord, ARRAYCOUNT(NextWord));
-                newIndices[1] = (uint32)atoi(NextWord) - 1;
-
-                memset(NextWord, 0, ARRAYCOUNT(NextWord) * sizeof(char));
-                scanWordIntoBuffer(EntireFileBuffer, &currentIndex, NextWord, ARRAYCOUNT(NextWord));
-                newIndices[2] = (uint32)atoi(NextWord) - 1;
+                // NOTE: '/' characters are treated as white space when scanning words, so the separators are checked
+                // before each word. Indices are normalized to start from 0, OBJ convention is to start from 1.
+                const uint32 numPositions = (uint32)(ScratchBuffers.VertPosAllocator.m_nextAllocOffset / sizeof(v4f));
+                const uint32 numUVs = (uint32)(ScratchBuffers.VertUVAllocator.m_nextAllocOffset / sizeof(v2f));
+                const uint32 numNormals = (uint32)(ScratchBuffers.VertNormalAllocator.m_nextAllocOffset / sizeof(v4f));
+                if (!ScanOBJIndex(EntireFileBuffer, FileSize, &currentIndex, numPositions, &newIndices[0]) ||
+                    !HitOBJIndexSeparator(EntireFileBuffer, FileSize, currentIndex) ||
+                    !ScanOBJIndex(EntireFileBuffer, FileSize, &currentIndex, numUVs, &newIndices[1]) ||
+                    !HitOBJIndexSeparator(EntireFileBuffer, FileSize, currentIndex) ||
+                    !ScanOBJIndex(EntireFileBuffer, FileSize, &currentIndex, numNormals, &newIndices[2]))
+                {
+                    Tk::Core::Utility::LogMsg("Asset", "OBJ face has an invalid, relative or missing v/vt/vn index!", Tk::Core::Utility::LogSeverity::eCritical);
+                    *OutVertCount = indicesCounter;
+                    return false;
+                }
 
                 v4f*    FinalVertPosBufferPtr    = (v4f*)PosAllocator.Alloc(sizeof(v4f), 1);
                 v2f*    FinalVertUVBufferPtr     = (v2f*)UVAllocator.Alloc(sizeof(v2f), 1);
@@ -181,18 +219,463 @@ void ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator
         else
         {
             // Proceed to next line
-            scanLine(EntireFileBuffer, &currentIndex);
+            scanLine(EntireFileBuffer, FileSize, &currentIndex);
         }
     }
 
     *OutVertCount = indicesCounter;
+    return true;
+}
+
+// Upper bounds for ParseOBJ's allocators, one element per tagged line
+static void CountOBJElements(const uint8* buffer, uint64 bufferSize, uint32* outNumPositions, uint32* outNumUVs, uint32* outNumNormals, uint32* outNumFaces)
+{
+    *outNumPositions = *outNumUVs = *outNumNormals = *outNumFaces = 0;
+
+    uint64 currentIndex = 0;
+    while (!HitEOF(buffer, bufferSize, currentIndex))
+    {
+        if (HitLineTag(buffer, bufferSize, currentIndex, 'v', ' '))
+            ++*outNumPositions;
+        else if (HitLineTag(buffer, bufferSize, currentIndex, 'v', 't'))
+            ++*outNumUVs;
+        else if (HitLineTag(buffer, bufferSize, currentIndex, 'v', 'n'))
+            ++*outNumNormals;
+        else if (HitLineTag(buffer, bufferSize, currentIndex, 'f', ' '))
+            ++*outNumFaces;
+        scanLine(buffer, bufferSize, &currentIndex);
+    }
+}
+
+static uint32 HashVertex(const v4f& pos, const v2f& uv, const v4f& normal)
+{
+    uint32 words[8];
+    memcpy(&words[0], &pos, sizeof(float) * 3);
+    memcpy(&words[3], &uv, sizeof(float) * 2);
+    memcpy(&words[5], &normal, sizeof(float) * 3);
+
+    uint32 hash = 0;
+    for (uint32 i = 0; i < ARRAYCOUNT(words); ++i)
+    {
+        hash = Hash32(hash ^ words[i]);
+    }
+    return hash;
+}
+
+static int16 QuantizeSnorm16(float value)
+{
+    return (int16)roundf(CLAMP(value, -1.0f, 1.0f) * 32767.0f);
+}
+
+static int8 QuantizeSnorm8(float value)
+{
+    return (int8)roundf(CLAMP(value, -1.0f, 1.0f) * 127.0f);
+}
+
+static uint16 QuantizeUnorm16(float value)
+{
+    return (uint16)roundf(CLAMP(value, 0.0f, 1.0f) * 65535.0f);
+}
+
+static uint64 AlignStreamOffset(uint64 offset)
+{
+    return (offset + COOKED_MESH_STREAM_ALIGNMENT - 1) & ~((uint64)COOKED_MESH_STREAM_ALIGNMENT - 1);
+}
+
+static void GetCookedMeshStrides(uint32 flags, uint32* outStrides)
+{
+    const bool isQuantized = (flags & CookedMeshFlags::eQuantized) != 0;
+    outStrides[CookedMeshStream::ePosition] = isQuantized ? (uint32)sizeof(int16) * 4 : (uint32)sizeof(v4f);
+    outStrides[CookedMeshStream::eUV] = isQuantized ? (uint32)sizeof(uint16) * 2 : (uint32)sizeof(v2f);
+    outStrides[CookedMeshStream::eNormal] = isQuantized ? (uint32)sizeof(int8) * 4 : (uint32)sizeof(v4f);
+    outStrides[CookedMeshStream::eIndex] = (flags & CookedMeshFlags::eIndices16) ? (uint32)sizeof(uint16) : (uint32)sizeof(uint32);
+}
+
+bool CookOBJ(const uint8* objFileBuffer, uint64 objFileSize, uint32 flags, Buffer* outCookedMesh)
+{
+    *outCookedMesh = {};
+
+    uint32 numPositions, numUVs, numNormals, numFaces;
+    CountOBJElements(objFileBuffer, objFileSize, &numPositions, &numUVs, &numNormals, &numFaces);
+    if (!numPositions || !numUVs || !numNormals || !numFaces)
+    {
+        Tk::Core::Utility::LogMsg("Asset", "OBJ needs positions, uvs, normals and faces to be cooked!", Tk::Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    // ParseOBJ emits three unindexed vertices per face
+    const uint32 maxVerts = numFaces * 3;
+    OBJParseScratchBuffers scratchBuffers;
+    scratchBuffers.VertPosAllocator.Init(sizeof(v4f) * numPositions, 16);
+    scratchBuffers.VertUVAllocator.Init(sizeof(v2f) * numUVs, 16);
+    scratchBuffers.VertNormalAllocator.Init(sizeof(v4f) * numNormals, 16);
+    Tk::Core::LinearAllocator posAllocator, uvAllocator, normalAllocator, indexAllocator;
+    posAllocator.Init(sizeof(v4f) * maxVerts, 16);
+    uvAllocator.Init(sizeof(v2f) * maxVerts, 16);
+    normalAllocator.Init(sizeof(v4f) * maxVerts, 16);
+    indexAllocator.Init(sizeof(uint32) * maxVerts, 16);
+
+    uint32 numVerts = 0;
+    if (!ParseOBJ(posAllocator, uvAllocator, normalAllocator, indexAllocator, scratchBuffers, objFileBuffer, objFileSize, &numVerts))
+        return false;
+    const v4f* positions = (const v4f*)posAllocator.m_ownedMemPtr;
+    const v2f* uvs = (const v2f*)uvAllocator.m_ownedMemPtr;
+    const v4f* normals = (const v4f*)normalAllocator.m_ownedMemPtr;
+
+    // Deduplicate with an open addressing table of unique vertex indices. Unique vertices keep the order they are
+    // first referenced in, so fetching them follows the index buffer.
+    uint32 tableSize = 1;
+    while (tableSize < numVerts * 2)
+        tableSize <<= 1;
+    uint32* table = (uint32*)Tk::Core::CoreMalloc(sizeof(uint32) * tableSize);
+    memset(table, 0xFF, sizeof(uint32) * tableSize);
+    uint32* indices = (uint32*)Tk::Core::CoreMalloc(sizeof(uint32) * numVerts);
+    uint32* uniqueVerts = (uint32*)Tk::Core::CoreMalloc(sizeof(uint32) * numVerts); // index of the first copy in the parsed streams
+    uint32 numUniqueVerts = 0;
+    for (uint32 uiVert = 0; uiVert < numVerts; ++uiVert)
+    {
+        uint32 slot = HashVertex(positions[uiVert], uvs[uiVert], normals[uiVert]) & (tableSize - 1);
+        while (table[slot] != MAX_UINT32)
+        {
+            const uint32 other = uniqueVerts[table[slot]];
+            if (!memcmp(&positions[uiVert], &positions[other], sizeof(v4f)) &&
+                !memcmp(&uvs[uiVert], &uvs[other], sizeof(v2f)) &&
+                !memcmp(&normals[uiVert], &normals[other], sizeof(v4f)))
+                break;
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (table[slot] == MAX_UINT32)
+        {
+            table[slot] = numUniqueVerts;
+            uniqueVerts[numUniqueVerts++] = uiVert;
+        }
+        indices[uiVert] = table[slot];
+    }
+    Tk::Core::CoreFree(table);
+
+    const bool isQuantized = (flags & CookedMeshFlags::eQuantized) != 0;
+    const bool isIndices16 = numUniqueVerts <= (uint32)MAX_UINT16 + 1;
+
+    CookedMeshHeader header = {};
+    header.magic = COOKED_MESH_MAGIC;
+    header.version = COOKED_MESH_VERSION;
+    header.flags = (isQuantized ? (uint32)CookedMeshFlags::eQuantized : 0u) | (isIndices16 ? (uint32)CookedMeshFlags::eIndices16 : 0u);
+    header.numVertices = numUniqueVerts;
+    header.numIndices = numVerts;
+
+    uint32 strides[CookedMeshStream::eMax];
+    GetCookedMeshStrides(header.flags, strides);
+    uint64 fileSize = AlignStreamOffset(sizeof(CookedMeshHeader));
+    for (uint32 uiStream = 0; uiStream < CookedMeshStream::eMax; ++uiStream)
+    {
+        CookedMeshStreamDesc& stream = header.streams[uiStream];
+        stream.offset = fileSize;
+        stream.stride = strides[uiStream];
+        stream.sizeInBytes = (uint64)stream.stride * (uiStream == CookedMeshStream::eIndex ? header.numIndices : header.numVertices);
+        fileSize = AlignStreamOffset(stream.offset + stream.sizeInBytes);
+    }
+
+    if (isQuantized)
+    {
+        float posMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+        float posMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        float uvMin[2] = { FLT_MAX, FLT_MAX };
+        float uvMax[2] = { -FLT_MAX, -FLT_MAX };
+        for (uint32 uiVert = 0; uiVert < numUniqueVerts; ++uiVert)
+        {
+            const uint32 src = uniqueVerts[uiVert];
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                posMin[i] = Min(posMin[i], positions[src][i]);
+                posMax[i] = Max(posMax[i], positions[src][i]);
+            }
+            for (uint32 i = 0; i < 2; ++i)
+            {
+                uvMin[i] = Min(uvMin[i], uvs[src][i]);
+                uvMax[i] = Max(uvMax[i], uvs[src][i]);
+            }
+        }
+
+        // Flat extents get a scale of 1 so that decoding doesn't divide by zero
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            const float halfExtent = (posMax[i] - posMin[i]) * 0.5f;
+            header.positionScale[i] = halfExtent > 0.0f ? halfExtent / 32767.0f : 1.0f;
+            header.positionBias[i] = (posMax[i] + posMin[i]) * 0.5f;
+        }
+        for (uint32 i = 0; i < 2; ++i)
+        {
+            const float extent = uvMax[i] - uvMin[i];
+            header.uvScale[i] = extent > 0.0f ? extent / 65535.0f : 1.0f;
+            header.uvBias[i] = uvMin[i];
+        }
+    }
+
+    outCookedMesh->Alloc(fileSize);
+    uint8* data = outCookedMesh->m_data;
+    memset(data, 0, fileSize);
+    memcpy(data, &header, sizeof(header));
+
+    uint8* posStream = data + header.streams[CookedMeshStream::ePosition].offset;
+    uint8* uvStream = data + header.streams[CookedMeshStream::eUV].offset;
+    uint8* normalStream = data + header.streams[CookedMeshStream::eNormal].offset;
+    for (uint32 uiVert = 0; uiVert < numUniqueVerts; ++uiVert)
+    {
+        const uint32 src = uniqueVerts[uiVert];
+        if (isQuantized)
+        {
+            int16 pos[4];
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                pos[i] = QuantizeSnorm16((positions[src][i] - header.positionBias[i]) / (header.positionScale[i] * 32767.0f));
+            }
+            pos[3] = 32767;
+
+            uint16 uv[2];
+            for (uint32 i = 0; i < 2; ++i)
+            {
+                uv[i] = QuantizeUnorm16((uvs[src][i] - header.uvBias[i]) / (header.uvScale[i] * 65535.0f));
+            }
+
+            int8 normal[4];
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                normal[i] = QuantizeSnorm8(normals[src][i]);
+            }
+            normal[3] = 0;
+
+            memcpy(posStream + sizeof(pos) * uiVert, pos, sizeof(pos));
+            memcpy(uvStream + sizeof(uv) * uiVert, uv, sizeof(uv));
+            memcpy(normalStream + sizeof(normal) * uiVert, normal, sizeof(normal));
+        }
+        else
+        {
+            memcpy(posStream + sizeof(v4f) * uiVert, &positions[src], sizeof(v4f));
+            memcpy(uvStream + sizeof(v2f) * uiVert, &uvs[src], sizeof(v2f));
+            memcpy(normalStream + sizeof(v4f) * uiVert, &normals[src], sizeof(v4f));
+        }
+    }
+
+    uint8* indexStream = data + header.streams[CookedMeshStream::eIndex].offset;
+    if (isIndices16)
+    {
+        for (uint32 uiIndex = 0; uiIndex < numVerts; ++uiIndex)
+        {
+            ((uint16*)indexStream)[uiIndex] = (uint16)indices[uiIndex];
+        }
+    }
+    else
+    {
+        memcpy(indexStream, indices, sizeof(uint32) * numVerts);
+    }
+
+    Tk::Core::CoreFree(uniqueVerts);
+    Tk::Core::CoreFree(indices);
+    return true;
+}
+
+bool GetCookedMesh(const uint8* entireFileBuffer, uint64 fileSizeInBytes, CookedMesh* outMesh)
+{
+    *outMesh = {};
+
+    if (fileSizeInBytes < sizeof(CookedMeshHeader))
+        return false;
+
+    const CookedMeshHeader* header = (const CookedMeshHeader*)entireFileBuffer;
+    if (header->magic != COOKED_MESH_MAGIC || header->version != COOKED_MESH_VERSION)
+    {
+        Tk::Core::Utility::LogMsg("Asset", "Cooked mesh has the wrong magic or version, recook it!", Tk::Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    uint32 strides[CookedMeshStream::eMax];
+    GetCookedMeshStrides(header->flags, strides);
+    for (uint32 uiStream = 0; uiStream < CookedMeshStream::eMax; ++uiStream)
+    {
+        const CookedMeshStreamDesc& stream = header->streams[uiStream];
+        const uint64 numElements = uiStream == CookedMeshStream::eIndex ? header->numIndices : header->numVertices;
+        if (stream.stride != strides[uiStream])
+        {
+            Tk::Core::Utility::LogMsg("Asset", "Cooked mesh stream stride doesn't match its flags!", Tk::Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+        if ((stream.offset & (COOKED_MESH_STREAM_ALIGNMENT - 1)) || stream.sizeInBytes != numElements * stream.stride ||
+            stream.offset > fileSizeInBytes || stream.sizeInBytes > fileSizeInBytes - stream.offset)
+        {
+            Tk::Core::Utility::LogMsg("Asset", "Cooked mesh stream is out of bounds!", Tk::Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+        outMesh->streams[uiStream] = entireFileBuffer + stream.offset;
+    }
+
+    // Indices are used to fetch vertices on the gpu, so one out of range index reads past the vertex buffers
+    const uint8* indexStream = outMesh->streams[CookedMeshStream::eIndex];
+    const bool isIndices16 = (header->flags & CookedMeshFlags::eIndices16) != 0;
+    for (uint32 uiIndex = 0; uiIndex < header->numIndices; ++uiIndex)
+    {
+        const uint32 index = isIndices16 ? ((const uint16*)indexStream)[uiIndex] : ((const uint32*)indexStream)[uiIndex];
+        if (index >= header->numVertices)
+        {
+            Tk::Core::Utility::LogMsg("Asset", "Cooked mesh index is out of range!", Tk::Core::Utility::LogSeverity::eCritical);
+            *outMesh = {};
+            return false;
+        }
+    }
+
+    outMesh->header = header;
+    return true;
 }
 
-BMPInfo GetBMPInfo(uint8* entireFileBuffer)
+static uint64 GetTimeNS()
+{
+    return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Appends a line to the OBJ text, asserting that it fits in what's left of the buffer
+static void AppendOBJLine(Buffer* obj, uint64 capacity, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int len = vsnprintf((char*)obj->m_data + obj->m_sizeInBytes, capacity - obj->m_sizeInBytes, format, args);
+    va_end(args);
+    TINKER_ASSERT(len >= 0 && (uint64)len < capacity - obj->m_sizeInBytes);
+    obj->m_sizeInBytes += (uint64)len;
+}
+
+// Same layout as a Maya export, v/vt/vn per vertex and triangulated faces
+static void GenerateGridOBJ(uint32 gridSize, Buffer* outOBJ)
+{
+    TINKER_ASSERT(gridSize <= MESH_LOAD_BENCHMARK_GRID_SIZE_MAX);
+    const uint32 numGridVerts = (gridSize + 1) * (gridSize + 1);
+    const uint32 numFaces = gridSize * gridSize * 2;
+
+    // Longest lines: "vn -1.000000 -1.000000 -1.000000\n" and a face with three 10 digit indices per vertex
+    const uint64 maxVertLineLen = 34;
+    const uint64 maxFaceLineLen = 2 + 3 * (3 * 10 + 2) + 2 + 1;
+    const uint64 capacity = numGridVerts * 3 * maxVertLineLen + numFaces * maxFaceLineLen + 1;
+    outOBJ->Alloc(capacity);
+    outOBJ->m_sizeInBytes = 0;
+
+    for (uint32 y = 0; y <= gridSize; ++y)
+    {
+        for (uint32 x = 0; x <= gridSize; ++x)
+        {
+            const float u = (float)x / (float)gridSize;
+            const float v = (float)y / (float)gridSize;
+            AppendOBJLine(outOBJ, capacity, "v %f %f %f\n", u * 2.0f - 1.0f, 0.0f, v * 2.0f - 1.0f);
+            AppendOBJLine(outOBJ, capacity, "vt %f %f\n", u, v);
+            AppendOBJLine(outOBJ, capacity, "vn %f %f %f\n", 0.0f, 1.0f, 0.0f);
+        }
+    }
+    for (uint32 y = 0; y < gridSize; ++y)
+    {
+        for (uint32 x = 0; x < gridSize; ++x)
+        {
+            // OBJ indices start at 1
+            const uint32 i0 = y * (gridSize + 1) + x + 1;
+            const uint32 i1 = i0 + 1;
+            const uint32 i2 = i0 + gridSize + 1;
+            const uint32 i3 = i2 + 1;
+            AppendOBJLine(outOBJ, capacity, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i2, i2, i2, i1, i1, i1);
+            AppendOBJLine(outOBJ, capacity, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i1, i1, i1, i2, i2, i2, i3, i3, i3);
+        }
+    }
+}
+
+// GetCookedMesh and a copy of each stream into staging, returns the time taken
+static float TimeCookedMeshLoad(const Buffer& cookedMesh, uint8* staging)
+{
+    const uint64 startTimeNS = GetTimeNS();
+    CookedMesh mesh;
+    if (GetCookedMesh(cookedMesh.m_data, cookedMesh.m_sizeInBytes, &mesh))
+    {
+        uint64 stagingOffset = 0;
+        for (uint32 uiStream = 0; uiStream < CookedMeshStream::eMax; ++uiStream)
+        {
+            const uint64 streamSize = mesh.header->streams[uiStream].sizeInBytes;
+            memcpy(staging + stagingOffset, mesh.streams[uiStream], streamSize);
+            stagingOffset += streamSize;
+        }
+    }
+    return (float)(GetTimeNS() - startTimeNS) * 1e-6f;
+}
+
+void BenchmarkMeshLoad(uint32 gridSize, MeshLoadBenchmark* outResults)
+{
+    *outResults = {};
+    gridSize = CLAMP(gridSize, 1u, (uint32)MESH_LOAD_BENCHMARK_GRID_SIZE_MAX);
+
+    Buffer objFile;
+    GenerateGridOBJ(gridSize, &objFile);
+
+    // Parse the way a loader would today, allocators sized up front so their setup isn't timed
+    uint32 numPositions, numUVs, numNormals, numFaces;
+    CountOBJElements(objFile.m_data, objFile.m_sizeInBytes, &numPositions, &numUVs, &numNormals, &numFaces);
+    {
+        OBJParseScratchBuffers scratchBuffers;
+        scratchBuffers.VertPosAllocator.Init(sizeof(v4f) * numPositions, 16);
+        scratchBuffers.VertUVAllocator.Init(sizeof(v2f) * numUVs, 16);
+        scratchBuffers.VertNormalAllocator.Init(sizeof(v4f) * numNormals, 16);
+        Tk::Core::LinearAllocator posAllocator, uvAllocator, normalAllocator, indexAllocator;
+        posAllocator.Init(sizeof(v4f) * numFaces * 3, 16);
+        uvAllocator.Init(sizeof(v2f) * numFaces * 3, 16);
+        normalAllocator.Init(sizeof(v4f) * numFaces * 3, 16);
+        indexAllocator.Init(sizeof(uint32) * numFaces * 3, 16);
+
+        const uint64 parseStartTimeNS = GetTimeNS();
+        uint32 numVerts = 0;
+        ParseOBJ(posAllocator, uvAllocator, normalAllocator, indexAllocator, scratchBuffers, objFile.m_data, objFile.m_sizeInBytes, &numVerts);
+        outResults->parseTimeMS = (float)(GetTimeNS() - parseStartTimeNS) * 1e-6f;
+    }
+
+    Buffer cookedMesh, cookedMeshQuantized;
+    const uint64 cookStartTimeNS = GetTimeNS();
+    bool bOk = CookOBJ(objFile.m_data, objFile.m_sizeInBytes, CookedMeshFlags::eNone, &cookedMesh);
+    outResults->cookTimeMS = (float)(GetTimeNS() - cookStartTimeNS) * 1e-6f;
+    bOk = bOk && CookOBJ(objFile.m_data, objFile.m_sizeInBytes, CookedMeshFlags::eQuantized, &cookedMeshQuantized);
+
+    if (bOk)
+    {
+        uint8* staging = (uint8*)Tk::Core::CoreMalloc(cookedMesh.m_sizeInBytes);
+        outResults->cookedLoadTimeMS = TimeCookedMeshLoad(cookedMesh, staging);
+        outResults->cookedQuantizedLoadTimeMS = TimeCookedMeshLoad(cookedMeshQuantized, staging);
+        Tk::Core::CoreFree(staging);
+
+        const CookedMeshHeader* header = (const CookedMeshHeader*)cookedMesh.m_data;
+        outResults->numTriangles = header->numIndices / 3;
+        outResults->numVertices = header->numVertices;
+        outResults->objSizeInBytes = objFile.m_sizeInBytes;
+        outResults->cookedSizeInBytes = cookedMesh.m_sizeInBytes;
+        outResults->cookedQuantizedSizeInBytes = cookedMeshQuantized.m_sizeInBytes;
+    }
+
+    cookedMeshQuantized.Dealloc();
+    cookedMesh.Dealloc();
+    objFile.Dealloc();
+}
+
+BMPInfo GetBMPInfo(const uint8* entireFileBuffer)
 {
     // NOTE: assumes the buffer is a well-formed bmp file
     // Skips the file header, which is immediately followed by the bmp info
-    return *(BMPInfo*)(entireFileBuffer + sizeof(BMPHeader));
+    BMPInfo info;
+    memcpy(&info, entireFileBuffer + sizeof(BMPHeader), sizeof(BMPInfo));
+    return info;
+}
+
+const uint8* GetBMPPixels(const uint8* entireFileBuffer, uint64 fileSizeInBytes)
+{
+    if (fileSizeInBytes < sizeof(BMPHeader) + sizeof(BMPInfo))
+        return nullptr;
+
+    BMPHeader header;
+    memcpy(&header, entireFileBuffer, sizeof(BMPHeader));
+    const BMPInfo info = GetBMPInfo(entireFileBuffer);
+    if (header.type != 0x4D42 || (uint64)header.offsetToBMPBytes + info.sizeInBytes > fileSizeInBytes)
+        return nullptr;
+
+    return entireFileBuffer + header.offsetToBMPBytes;
 }
 
 void SaveBMP(Buffer* outputBuffer, uint8* inputData, uint32 width, uint32 height, uint16 bitsPerPx)
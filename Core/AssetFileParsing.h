@@ -50,11 +50,102 @@ struct OBJParseScratchBuffers
     }
 };
 
-// Parse the OBJ file and populate existing vertex attribute buffers
-TINKER_API void ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator& UVAllocator,
+// Parse the OBJ file and populate existing vertex attribute buffers. The buffer doesn't need to be null terminated, so
+// it can be a mapped view of the file. Returns false and logs if a face index is out of range or not in v/vt/vn form.
+TINKER_API bool ParseOBJ(Tk::Core::LinearAllocator& PosAllocator, Tk::Core::LinearAllocator& UVAllocator,
     Tk::Core::LinearAllocator& NormalAllocator, Tk::Core::LinearAllocator& IndexAllocator,
     OBJParseScratchBuffers& ScratchBuffers, const uint8* EntireFileBuffer, uint64 FileSize, uint32* OutVertCount);
 
+// Cooked meshes are OBJs converted offline by TinkerMC into a binary file that loads without parsing. Vertices are
+// deduplicated and indexed, and each attribute is its own stream so a stream can be copied straight into staging memory.
+#define COOKED_MESH_MAGIC 0x48534D54 // "TMSH"
+#define COOKED_MESH_VERSION 1
+#define COOKED_MESH_STREAM_ALIGNMENT 64
+#define COOKED_MESH_FILE_EXT ".tmsh"
+
+namespace CookedMeshFlags
+{
+enum : uint32
+{
+    eNone = 0,
+    eQuantized = 0x1, // positions snorm16x4, uvs unorm16x2, normals snorm8x4. Otherwise v4f, v2f, v4f like ParseOBJ.
+    eIndices16 = 0x2, // set by the cooker when every index fits, otherwise indices are uint32
+};
+}
+
+namespace CookedMeshStream
+{
+enum : uint32
+{
+    ePosition = 0,
+    eUV,
+    eNormal,
+    eIndex,
+    eMax
+};
+}
+
+typedef struct cooked_mesh_stream_desc
+{
+    uint64 offset; // from the start of the file, multiple of COOKED_MESH_STREAM_ALIGNMENT
+    uint64 sizeInBytes;
+    uint32 stride;
+    uint32 pad;
+} CookedMeshStreamDesc;
+
+typedef struct cooked_mesh_header
+{
+    uint32 magic;
+    uint32 version;
+    uint32 flags; // CookedMeshFlags
+    uint32 numVertices;
+    uint32 numIndices;
+    uint32 pad;
+
+    // Quantized attributes decode as value * scale + bias, with the snorm/unorm value as an integer
+    float positionScale[3];
+    float positionBias[3];
+    float uvScale[2];
+    float uvBias[2];
+
+    CookedMeshStreamDesc streams[CookedMeshStream::eMax];
+} CookedMeshHeader;
+
+// Points into the file data, nothing is copied
+typedef struct cooked_mesh
+{
+    const CookedMeshHeader* header;
+    const uint8* streams[CookedMeshStream::eMax];
+} CookedMesh;
+
+// Returns false and logs if the OBJ has no uvs or normals, or ParseOBJ fails. outCookedMesh is allocated here, Dealloc it when done.
+// flags is CookedMeshFlags, only eQuantized is read.
+TINKER_API bool CookOBJ(const uint8* objFileBuffer, uint64 objFileSize, uint32 flags, Buffer* outCookedMesh);
+
+// Checks the header, that the streams are inside the file with the strides their flags imply, and that every index
+// refers to a vertex. Nothing is copied, so it works on a mapped view.
+TINKER_API bool GetCookedMesh(const uint8* entireFileBuffer, uint64 fileSizeInBytes, CookedMesh* outMesh);
+
+typedef struct mesh_load_benchmark
+{
+    uint32 numTriangles;
+    uint32 numVertices; // after deduplication
+    uint64 objSizeInBytes;
+    uint64 cookedSizeInBytes;
+    uint64 cookedQuantizedSizeInBytes;
+    float parseTimeMS; // ParseOBJ
+    float cookTimeMS;
+    float cookedLoadTimeMS; // GetCookedMesh and a copy of every stream, like filling staging memory
+    float cookedQuantizedLoadTimeMS;
+} MeshLoadBenchmark;
+
+#define MESH_LOAD_BENCHMARK_GRID_SIZE_MAX 1024
+
+// Generates an OBJ of a gridSize x gridSize quad grid in memory and times parsing it against loading it cooked.
+// Files aren't involved, so this only measures what cooking saves over parsing. gridSize is clamped to
+// MESH_LOAD_BENCHMARK_GRID_SIZE_MAX.
+TINKER_API void BenchmarkMeshLoad(uint32 gridSize, MeshLoadBenchmark* outResults);
+
 // Loading of various texture types
 #pragma pack(push, 1)
 // https://docs.microsoft.com/en-us/windows/win32/api/wingdi/ns-wingdi-bitmapfileheader
@@ -90,7 +181,10 @@ typedef struct bmp_info
 } BMPInfo;
 #pragma pack(pop)
 
-TINKER_API BMPInfo GetBMPInfo(uint8* entireFileBuffer);
+// Both work on a mapped view of the file, the pixels are not copied
+TINKER_API BMPInfo GetBMPInfo(const uint8* entireFileBuffer);
+// Null if the file is too small for the pixel data its header describes
+TINKER_API const uint8* GetBMPPixels(const uint8* entireFileBuffer, uint64 fileSizeInBytes);
 
 TINKER_API void SaveBMP(Buffer* outputBuffer, uint8* inputData, uint32 width, uint32 height, uint16 bitsPerPx);
 
@@ -32,6 +32,82 @@ struct FileHandle
     };
 };
 
+// Read-only view of an entire file, mapped into the address space instead of copied. The file can't be replaced on
+// disk while it is mapped. Views are not null terminated.
+struct MappedFile
+{
+    const uint8* data;
+    uint64 sizeInBytes;
+    uint64 fileHandle;
+    uint64 mappingHandle;
+};
+
+// How a mapped file will be read, so the OS can pick its read ahead
+namespace FileAccessPattern
+{
+enum : uint32
+{
+    eDefault = 0,
+    eSequential,
+    eRandom,
+    eMax
+};
+}
+
+namespace MappedFileAdvice
+{
+enum : uint32
+{
+    eWillNeed = 0, // same as PrefetchMappedFile
+    eDontNeed, // drop the pages from the working set, they are read from disk again if touched
+    eMax
+};
+}
+
+struct FileReadRequest;
+typedef void (*FileReadCallback)(FileReadRequest* request);
+
+// Read of part of a file into caller memory on a worker thread, see ReadFileAsync
+struct FileReadRequest
+{
+    const char* filename; // must stay valid until the read completes
+    uint64 offset;
+    uint64 sizeInBytes;
+    uint8* buffer;
+    FileReadCallback onComplete; // called on the thread that did the read once it's done, can be null
+    void* userData;
+
+    // Written before onComplete is called
+    uint64 numBytesRead; // less than sizeInBytes if the read failed or went past the end of the file
+};
+
+namespace FileReadFlags
+{
+enum : uint32
+{
+    eNone = 0,
+    eUnbuffered = 0x1, // bypasses the OS file cache, see FILE_UNBUFFERED_ALIGNMENT
+};
+}
+
+// Offsets, sizes and buffers of unbuffered reads must be multiples of the sector size, this covers all current disks
+#define FILE_UNBUFFERED_ALIGNMENT 4096
+#define FILE_READ_QUEUE_DEPTH_MAX 64
+#define FILE_READ_BENCHMARK_FILES_MAX 256
+#define FILE_READ_BENCHMARK_QUEUE_DEPTHS 7 // 1 to FILE_READ_QUEUE_DEPTH_MAX in powers of 2
+#define FILE_READ_BENCHMARK_MODES 2 // indexed by the FileReadFlags::eUnbuffered bit
+
+// Serial and batched times are measured with the same caching, so each mode compares like with like. Buffered reads hit
+// the file cache since the files were just written, unbuffered reads all go to disk.
+typedef struct file_read_benchmark
+{
+    uint32 numFiles;
+    uint64 fileSizeInBytes;
+    float serialTimeMS[FILE_READ_BENCHMARK_MODES]; // one blocking read per file, like the loaders
+    uint32 queueDepths[FILE_READ_BENCHMARK_QUEUE_DEPTHS];
+    float batchedTimeMS[FILE_READ_BENCHMARK_MODES][FILE_READ_BENCHMARK_QUEUE_DEPTHS]; // ReadFilesBatched
+} FileReadBenchmark;
+
 #define GET_PLATFORM_WINDOW_HANDLES(name) TINKER_API WindowHandles* name()
 GET_PLATFORM_WINDOW_HANDLES(GetPlatformWindowHandles);
 
@@ -44,15 +120,47 @@ ALLOC_ALIGNED_RAW(AllocAlignedRaw);
 #define FREE_ALIGNED_RAW(name) TINKER_API void name(void* ptr)
 FREE_ALIGNED_RAW(FreeAlignedRaw);
 
-#define READ_ENTIRE_FILE(name) TINKER_API uint32 name(const char* filename, uint32 fileSizeInBytes, uint8* buffer)
+#define READ_ENTIRE_FILE(name) TINKER_API uint32 name(const char* filename, uint64 fileSizeInBytes, uint8* buffer)
 READ_ENTIRE_FILE(ReadEntireFile);
 
-#define WRITE_ENTIRE_FILE(name) TINKER_API uint32 name(const char* filename, uint32 fileSizeInBytes, uint8* buffer)
+#define WRITE_ENTIRE_FILE(name) TINKER_API uint32 name(const char* filename, uint64 fileSizeInBytes, uint8* buffer)
 WRITE_ENTIRE_FILE(WriteEntireFile);
 
-#define GET_ENTIRE_FILE_SIZE(name) TINKER_API uint32 name(const char* filename)
+#define GET_ENTIRE_FILE_SIZE(name) TINKER_API uint64 name(const char* filename)
 GET_ENTIRE_FILE_SIZE(GetEntireFileSize);
 
+// Reads sizeInBytes starting at offset into buffer, returns the number of bytes read. Safe to call from any thread.
+#define READ_FILE_RANGE(name) TINKER_API uint64 name(const char* filename, uint64 offset, uint64 sizeInBytes, uint8* buffer)
+READ_FILE_RANGE(ReadFileRange);
+
+// Reads all requests with up to queueDepth reads in flight, requests complete in whatever order the disk finishes
+// them. Blocks until every request is done and calls onComplete on this thread as each one finishes. Large
+// requests are split so several reads of one file can be in flight. flags is FileReadFlags, returns the total
+// number of bytes read.
+#define READ_FILES_BATCHED(name) TINKER_API uint64 name(FileReadRequest* requests, uint32 numRequests, uint32 queueDepth, uint32 flags)
+READ_FILES_BATCHED(ReadFilesBatched);
+
+// Writes numFiles temporary files, times loading them serially and batched at each queue depth, both buffered and
+// unbuffered, then deletes them.
+// fileSizeInBytes is rounded up to FILE_UNBUFFERED_ALIGNMENT.
+#define BENCHMARK_FILE_READS(name) TINKER_API void name(uint32 numFiles, uint64 fileSizeInBytes, FileReadBenchmark* outResults)
+BENCHMARK_FILE_READS(BenchmarkFileReads);
+
+// Returns false and leaves outMappedFile zeroed if the file doesn't exist or is empty. accessPattern is a FileAccessPattern.
+#define MAP_FILE_READ_ONLY(name) TINKER_API bool name(const char* filename, uint32 accessPattern, MappedFile* outMappedFile)
+MAP_FILE_READ_ONLY(MapFileReadOnly);
+
+#define UNMAP_FILE(name) TINKER_API void name(MappedFile* mappedFile)
+UNMAP_FILE(UnmapFile);
+
+// Starts reading the range into memory without waiting for it, so that touching it later doesn't fault on each page
+#define PREFETCH_MAPPED_FILE(name) TINKER_API void name(const MappedFile* mappedFile, uint64 offset, uint64 sizeInBytes)
+PREFETCH_MAPPED_FILE(PrefetchMappedFile);
+
+// advice is a MappedFileAdvice. Ranges are clamped to the file.
+#define ADVISE_MAPPED_FILE(name) TINKER_API void name(const MappedFile* mappedFile, uint64 offset, uint64 sizeInBytes, uint32 advice)
+ADVISE_MAPPED_FILE(AdviseMappedFile);
+
 #define FIND_FILE_OPEN(name) TINKER_API FileHandle name(const char* dirWithFileExts, wchar_t* outFilename, uint32 outFilenameMax)
 FIND_FILE_OPEN(FindFileOpen);
 
@@ -62,6 +170,42 @@ FIND_FILE_NEXT(FindFileNext);
 #define FIND_FILE_CLOSE(name) TINKER_API void name(FileHandle handle)
 FIND_FILE_CLOSE(FindFileClose);
 
+// Queues the read on the worker threads. Wait on the returned job before touching the buffer, then free it with
+// FreeThreadJob.
+inline WorkerJob* ReadFileAsync(FileReadRequest* request)
+{
+    WorkerJob* job = CreateNewThreadJob([=]()
+        {
+            request->numBytesRead = ReadFileRange(request->filename, request->offset, request->sizeInBytes, request->buffer);
+            if (request->onComplete)
+                request->onComplete(request);
+        });
+    EnqueueWorkerThreadJob(job);
+    return job;
+}
+
+// Queues a read per request and adds their jobs to the list, so they can be waited on and freed together
+inline void ReadFilesAsync(FileReadRequest* requests, uint32 numRequests, WorkerJobList* jobList)
+{
+    for (uint32 uiRequest = 0; uiRequest < numRequests; ++uiRequest)
+    {
+        TINKER_ASSERT(jobList->m_numJobs < ARRAYCOUNT(jobList->m_jobs));
+        jobList->m_jobs[jobList->m_numJobs++] = ReadFileAsync(&requests[uiRequest]);
+    }
+}
+
+// Runs ReadFilesBatched on a worker thread so the caller can keep going. requests must stay valid until the
+// returned job is done, then free it with FreeThreadJob.
+inline WorkerJob* ReadFilesBatchedAsync(FileReadRequest* requests, uint32 numRequests, uint32 queueDepth, uint32 flags)
+{
+    WorkerJob* job = CreateNewThreadJob([=]()
+        {
+            ReadFilesBatched(requests, numRequests, queueDepth, flags);
+        });
+    EnqueueWorkerThreadJob(job);
+    return job;
+}
+
 #define INIT_NETWORK_CONNECTION(name) TINKER_API int name()
 INIT_NETWORK_CONNECTION(InitNetworkConnection);
 
@@ -34,6 +34,13 @@ inline void WaitOnJob(WorkerJob* job)
     while (!job->m_done);
 }
 
+// Jobs from CreateNewThreadJob that aren't in a WorkerJobList
+inline void FreeThreadJob(WorkerJob* job)
+{
+    job->~WorkerJob();
+    Tk::Core::CoreFreeAligned(job);
+}
+
 struct WorkerJobList
 {
 public:
@@ -60,8 +67,7 @@ public:
             {
                 if (m_jobs[i])
                 {
-                    m_jobs[i]->~WorkerJob();
-                    Tk::Core::CoreFreeAligned(m_jobs[i]);
+                    FreeThreadJob(m_jobs[i]);
                 }
             }
         }
@@ -3,23 +3,51 @@
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <stdio.h>
+#include <string.h>
+
+// ReadFile and WriteFile take 32 bit sizes, larger transfers are split
+#define FILE_IO_CHUNK_SIZE (1u << 30)
+
+// Batched reads are split into pieces of this size, a multiple of FILE_UNBUFFERED_ALIGNMENT
+#define FILE_BATCH_OP_SIZE (1u << 20)
 
 namespace Tk
 {
 namespace Platform
 {
 
+// Positioned read on a synchronous handle, returns the number of bytes read
+static uint64 ReadFileChunked(HANDLE fileHandle, uint64 offset, uint64 sizeInBytes, uint8* buffer)
+{
+    uint64 totalBytesRead = 0;
+    while (totalBytesRead < sizeInBytes)
+    {
+        const uint64 readOffset = offset + totalBytesRead;
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)(readOffset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = (DWORD)(readOffset >> 32);
+
+        const DWORD chunkSize = (DWORD)Min(sizeInBytes - totalBytesRead, (uint64)FILE_IO_CHUNK_SIZE);
+        DWORD numBytesRead = 0;
+        if (!ReadFile(fileHandle, buffer + totalBytesRead, chunkSize, &numBytesRead, &overlapped) || !numBytesRead)
+            break;
+        totalBytesRead += numBytesRead;
+    }
+    return totalBytesRead;
+}
+
 GET_ENTIRE_FILE_SIZE(GetEntireFileSize)
 {
     HANDLE fileHandle = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
 
-    uint32 fileSize = 0;
+    uint64 fileSize = 0;
     if (fileHandle != INVALID_HANDLE_VALUE)
     {
         LARGE_INTEGER fileSizeInBytes = {};
         if (GetFileSizeEx(fileHandle, &fileSizeInBytes))
         {
-            fileSize = SafeTruncateUint64(fileSizeInBytes.QuadPart);
+            fileSize = (uint64)fileSizeInBytes.QuadPart;
         }
         else
         {
@@ -44,7 +72,7 @@ READ_ENTIRE_FILE(ReadEntireFile)
 
     if (fileHandle != INVALID_HANDLE_VALUE)
     {
-        uint32 fileSize = 0;
+        uint64 fileSize = 0;
         if (fileSizeInBytes)
         {
             fileSize = fileSizeInBytes;
@@ -54,8 +82,7 @@ READ_ENTIRE_FILE(ReadEntireFile)
             fileSize = Tk::Platform::GetEntireFileSize(filename);
         }
 
-        DWORD numBytesRead = 0;
-        ReadFile(fileHandle, buffer, fileSize, &numBytesRead, 0);
+        const uint64 numBytesRead = ReadFileChunked(fileHandle, 0, fileSize, buffer);
         TINKER_ASSERT(numBytesRead == fileSize);
         CloseHandle(fileHandle);
         return 0;
@@ -76,9 +103,16 @@ WRITE_ENTIRE_FILE(WriteEntireFile)
 
     if (fileHandle != INVALID_HANDLE_VALUE)
     {
-        DWORD numBytesWritten = 0;
-        WriteFile(fileHandle, buffer, fileSizeInBytes, &numBytesWritten, 0);
-        TINKER_ASSERT(numBytesWritten == fileSizeInBytes);
+        uint64 totalBytesWritten = 0;
+        while (totalBytesWritten < fileSizeInBytes)
+        {
+            const DWORD chunkSize = (DWORD)Min(fileSizeInBytes - totalBytesWritten, (uint64)FILE_IO_CHUNK_SIZE);
+            DWORD numBytesWritten = 0;
+            if (!WriteFile(fileHandle, buffer + totalBytesWritten, chunkSize, &numBytesWritten, 0) || !numBytesWritten)
+                break;
+            totalBytesWritten += numBytesWritten;
+        }
+        TINKER_ASSERT(totalBytesWritten == fileSizeInBytes);
         CloseHandle(fileHandle);
         return 0;
     }
@@ -90,6 +124,426 @@ WRITE_ENTIRE_FILE(WriteEntireFile)
     }
 }
 
+READ_FILE_RANGE(ReadFileRange)
+{
+    TINKER_ASSERT(buffer || !sizeInBytes);
+
+    HANDLE fileHandle = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to create file handle!", Core::Utility::LogSeverity::eCritical);
+        return 0;
+    }
+
+    const uint64 numBytesRead = ReadFileChunked(fileHandle, offset, sizeInBytes, buffer);
+    CloseHandle(fileHandle);
+    return numBytesRead;
+}
+
+typedef struct batched_read_op
+{
+    OVERLAPPED overlapped; // first member, completions hand back a pointer to it
+    uint32 stateIndex;
+    uint32 sizeInBytes;
+} BatchedReadOp;
+
+// Only requests that are being issued or still have reads in flight need state, so there are at most one per op plus
+// the request being issued. Fixed size so that batches can run on worker threads without touching the allocator.
+#define FILE_BATCH_MAX_STATES (FILE_READ_QUEUE_DEPTH_MAX + 1)
+
+typedef struct batched_read_state
+{
+    HANDLE fileHandle;
+    uint32 requestIndex;
+    uint64 numBytesIssued;
+    uint32 numOpsInFlight;
+    bool isFailed; // stop issuing, a read errored or came back short
+} BatchedReadState;
+
+static void FinishBatchedRead(FileReadRequest* request, BatchedReadState* state, uint32* inOutNumRequestsDone)
+{
+    if (state->fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(state->fileHandle);
+        state->fileHandle = INVALID_HANDLE_VALUE;
+    }
+    ++(*inOutNumRequestsDone);
+
+    if (request->onComplete)
+        request->onComplete(request);
+}
+
+READ_FILES_BATCHED(ReadFilesBatched)
+{
+    if (!numRequests)
+        return 0;
+
+    queueDepth = CLAMP(queueDepth, 1u, (uint32)FILE_READ_QUEUE_DEPTH_MAX);
+    const bool isUnbuffered = (flags & FileReadFlags::eUnbuffered) != 0;
+
+    HANDLE completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, 0, 0, 1);
+    if (!completionPort)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to create io completion port!", Core::Utility::LogSeverity::eCritical);
+        return 0;
+    }
+
+    for (uint32 uiRequest = 0; uiRequest < numRequests; ++uiRequest)
+    {
+        FileReadRequest* request = &requests[uiRequest];
+        TINKER_ASSERT(request->buffer || !request->sizeInBytes);
+        if (isUnbuffered)
+        {
+            TINKER_ASSERT(!(request->offset & (FILE_UNBUFFERED_ALIGNMENT - 1)));
+            TINKER_ASSERT(!(request->sizeInBytes & (FILE_UNBUFFERED_ALIGNMENT - 1)));
+            TINKER_ASSERT(!((uint64)request->buffer & (FILE_UNBUFFERED_ALIGNMENT - 1)));
+        }
+        request->numBytesRead = 0;
+    }
+
+    BatchedReadState states[FILE_BATCH_MAX_STATES];
+    uint32 freeStates[FILE_BATCH_MAX_STATES];
+    uint32 numFreeStates = FILE_BATCH_MAX_STATES;
+    for (uint32 uiState = 0; uiState < FILE_BATCH_MAX_STATES; ++uiState)
+    {
+        states[uiState] = {};
+        states[uiState].fileHandle = INVALID_HANDLE_VALUE;
+        freeStates[uiState] = uiState;
+    }
+
+    BatchedReadOp ops[FILE_READ_QUEUE_DEPTH_MAX] = {};
+    uint32 freeOps[FILE_READ_QUEUE_DEPTH_MAX];
+    uint32 numFreeOps = queueDepth;
+    for (uint32 uiOp = 0; uiOp < queueDepth; ++uiOp)
+    {
+        freeOps[uiOp] = uiOp;
+    }
+
+    uint32 nextRequest = 0; // requests before this have had all of their reads issued
+    uint32 nextRequestState = TINKER_INVALID_HANDLE;
+    uint32 numRequestsDone = 0;
+    uint64 totalBytesRead = 0;
+    while (numRequestsDone < numRequests)
+    {
+        // Top the queue back up, in request order so that files finish roughly in order
+        while (numFreeOps && nextRequest < numRequests)
+        {
+            FileReadRequest* request = &requests[nextRequest];
+            if (nextRequestState == TINKER_INVALID_HANDLE)
+            {
+                TINKER_ASSERT(numFreeStates);
+                nextRequestState = freeStates[--numFreeStates];
+                states[nextRequestState] = {};
+                states[nextRequestState].fileHandle = INVALID_HANDLE_VALUE;
+                states[nextRequestState].requestIndex = nextRequest;
+            }
+            BatchedReadState* state = &states[nextRequestState];
+
+            if (state->fileHandle == INVALID_HANDLE_VALUE && request->sizeInBytes && !state->isFailed)
+            {
+                const DWORD fileFlags = FILE_FLAG_OVERLAPPED | (isUnbuffered ? FILE_FLAG_NO_BUFFERING : FILE_FLAG_SEQUENTIAL_SCAN);
+                state->fileHandle = CreateFile(request->filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, fileFlags, 0);
+                if (state->fileHandle == INVALID_HANDLE_VALUE || !CreateIoCompletionPort(state->fileHandle, completionPort, 0, 0))
+                {
+                    Tk::Core::Utility::LogMsg("Platform", "Unable to create file handle!", Core::Utility::LogSeverity::eCritical);
+                    state->isFailed = true;
+                }
+            }
+
+            if (state->isFailed || state->numBytesIssued == request->sizeInBytes)
+            {
+                // Otherwise the state stays with the reads in flight and is released by the last one
+                if (!state->numOpsInFlight)
+                {
+                    FinishBatchedRead(request, state, &numRequestsDone);
+                    freeStates[numFreeStates++] = nextRequestState;
+                }
+                nextRequestState = TINKER_INVALID_HANDLE;
+                ++nextRequest;
+                continue;
+            }
+
+            const uint32 opIndex = freeOps[--numFreeOps];
+            BatchedReadOp* op = &ops[opIndex];
+            const uint64 readOffset = request->offset + state->numBytesIssued;
+            *op = {};
+            op->overlapped.Offset = (DWORD)(readOffset & 0xFFFFFFFF);
+            op->overlapped.OffsetHigh = (DWORD)(readOffset >> 32);
+            op->stateIndex = nextRequestState;
+            op->sizeInBytes = (uint32)Min(request->sizeInBytes - state->numBytesIssued, (uint64)FILE_BATCH_OP_SIZE);
+
+            // Reads that finish immediately still post a completion packet
+            if (!ReadFile(state->fileHandle, request->buffer + state->numBytesIssued, op->sizeInBytes, 0, &op->overlapped) &&
+                GetLastError() != ERROR_IO_PENDING)
+            {
+                // Past the end of the file or a disk error
+                freeOps[numFreeOps++] = opIndex;
+                state->isFailed = true;
+                continue;
+            }
+            state->numBytesIssued += op->sizeInBytes;
+            ++state->numOpsInFlight;
+        }
+
+        if (numRequestsDone == numRequests)
+            break;
+
+        OVERLAPPED_ENTRY entries[FILE_READ_QUEUE_DEPTH_MAX];
+        ULONG numEntries = 0;
+        if (!GetQueuedCompletionStatusEx(completionPort, entries, queueDepth, &numEntries, INFINITE, FALSE))
+        {
+            Tk::Core::Utility::LogMsg("Platform", "Failed to wait on io completion port!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+            break;
+        }
+
+        for (uint32 uiEntry = 0; uiEntry < numEntries; ++uiEntry)
+        {
+            BatchedReadOp* op = (BatchedReadOp*)entries[uiEntry].lpOverlapped;
+            const uint32 stateIndex = op->stateIndex;
+            BatchedReadState* state = &states[stateIndex];
+            FileReadRequest* request = &requests[state->requestIndex];
+
+            DWORD numBytesRead = 0;
+            if (!GetOverlappedResult(state->fileHandle, &op->overlapped, &numBytesRead, FALSE) || numBytesRead < op->sizeInBytes)
+                state->isFailed = true;
+            request->numBytesRead += numBytesRead;
+            totalBytesRead += numBytesRead;
+
+            --state->numOpsInFlight;
+            freeOps[numFreeOps++] = (uint32)(op - ops);
+
+            // The request being issued is finished by the issue loop instead
+            if (!state->numOpsInFlight && stateIndex != nextRequestState)
+            {
+                FinishBatchedRead(request, state, &numRequestsDone);
+                freeStates[numFreeStates++] = stateIndex;
+            }
+        }
+    }
+
+    for (uint32 uiState = 0; uiState < FILE_BATCH_MAX_STATES; ++uiState)
+    {
+        if (states[uiState].fileHandle != INVALID_HANDLE_VALUE)
+        {
+            CancelIoEx(states[uiState].fileHandle, 0);
+            CloseHandle(states[uiState].fileHandle);
+        }
+    }
+    CloseHandle(completionPort);
+    return totalBytesRead;
+}
+
+static uint64 GetTimeNS()
+{
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+}
+
+// Blocking read of a whole file, opened the same way ReadFilesBatched opens it for the given flags
+static uint64 ReadFileSerial(const char* filename, uint64 sizeInBytes, uint8* buffer, uint32 flags)
+{
+    const DWORD fileFlags = (flags & FileReadFlags::eUnbuffered) ? FILE_FLAG_NO_BUFFERING : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE fileHandle = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, fileFlags, 0);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return 0;
+
+    const uint64 numBytesRead = ReadFileChunked(fileHandle, 0, sizeInBytes, buffer);
+    CloseHandle(fileHandle);
+    return numBytesRead;
+}
+
+BENCHMARK_FILE_READS(BenchmarkFileReads)
+{
+    *outResults = {};
+
+    numFiles = CLAMP(numFiles, 1u, (uint32)FILE_READ_BENCHMARK_FILES_MAX);
+    fileSizeInBytes = Max((fileSizeInBytes + FILE_UNBUFFERED_ALIGNMENT - 1) & ~((uint64)FILE_UNBUFFERED_ALIGNMENT - 1),
+        (uint64)FILE_UNBUFFERED_ALIGNMENT);
+
+    char benchmarkDir[MAX_PATH];
+    const DWORD tempPathLen = GetTempPath(MAX_PATH, benchmarkDir);
+    if (!tempPathLen || tempPathLen + 32 > MAX_PATH)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to get temp path for file read benchmark!", Core::Utility::LogSeverity::eCritical);
+        return;
+    }
+    strcat_s(benchmarkDir, "TinkerFileReadBenchmark\\");
+    CreateDirectory(benchmarkDir, 0);
+
+    // Page aligned, which covers unbuffered reads
+    const uint64 totalSizeInBytes = fileSizeInBytes * numFiles;
+    uint8* buffer = (uint8*)VirtualAlloc(0, totalSizeInBytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!buffer)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to allocate file read benchmark buffer!", Core::Utility::LogSeverity::eCritical);
+        return;
+    }
+
+    static char filenames[FILE_READ_BENCHMARK_FILES_MAX][MAX_PATH];
+    static FileReadRequest requests[FILE_READ_BENCHMARK_FILES_MAX];
+    for (uint32 uiFile = 0; uiFile < numFiles; ++uiFile)
+    {
+        sprintf_s(filenames[uiFile], "%sbenchmark_%03u.bin", benchmarkDir, uiFile);
+
+        uint8* fileData = buffer + fileSizeInBytes * uiFile;
+        for (uint64 uiByte = 0; uiByte < fileSizeInBytes; ++uiByte)
+        {
+            fileData[uiByte] = (uint8)(uiByte * 31 + uiFile);
+        }
+        WriteEntireFile(filenames[uiFile], fileSizeInBytes, fileData);
+
+        requests[uiFile] = {};
+        requests[uiFile].filename = filenames[uiFile];
+        requests[uiFile].sizeInBytes = fileSizeInBytes;
+        requests[uiFile].buffer = fileData;
+    }
+
+    for (uint32 uiMode = 0; uiMode < FILE_READ_BENCHMARK_MODES; ++uiMode)
+    {
+        const uint32 flags = uiMode ? FileReadFlags::eUnbuffered : FileReadFlags::eNone;
+
+        const uint64 serialStartTimeNS = GetTimeNS();
+        uint64 numSerialBytesRead = 0;
+        for (uint32 uiFile = 0; uiFile < numFiles; ++uiFile)
+        {
+            numSerialBytesRead += ReadFileSerial(filenames[uiFile], fileSizeInBytes, buffer + fileSizeInBytes * uiFile, flags);
+        }
+        outResults->serialTimeMS[uiMode] = (float)(GetTimeNS() - serialStartTimeNS) * 1e-6f;
+        TINKER_ASSERT(numSerialBytesRead == totalSizeInBytes);
+
+        for (uint32 uiDepth = 0; uiDepth < FILE_READ_BENCHMARK_QUEUE_DEPTHS; ++uiDepth)
+        {
+            const uint32 queueDepth = 1u << uiDepth;
+            const uint64 batchedStartTimeNS = GetTimeNS();
+            const uint64 numBytesRead = ReadFilesBatched(requests, numFiles, queueDepth, flags);
+            outResults->batchedTimeMS[uiMode][uiDepth] = (float)(GetTimeNS() - batchedStartTimeNS) * 1e-6f;
+            outResults->queueDepths[uiDepth] = queueDepth;
+            TINKER_ASSERT(numBytesRead == totalSizeInBytes);
+        }
+    }
+
+    for (uint32 uiFile = 0; uiFile < numFiles; ++uiFile)
+    {
+        DeleteFile(filenames[uiFile]);
+    }
+    RemoveDirectory(benchmarkDir);
+    VirtualFree(buffer, 0, MEM_RELEASE);
+
+    outResults->numFiles = numFiles;
+    outResults->fileSizeInBytes = fileSizeInBytes;
+}
+
+MAP_FILE_READ_ONLY(MapFileReadOnly)
+{
+    *outMappedFile = {};
+
+    // The cache manager reads further ahead for sequential access, and not at all for random access
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (accessPattern == FileAccessPattern::eSequential)
+        flags = FILE_FLAG_SEQUENTIAL_SCAN;
+    else if (accessPattern == FileAccessPattern::eRandom)
+        flags = FILE_FLAG_RANDOM_ACCESS;
+
+    HANDLE fileHandle = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, flags, 0);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to create file handle!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    // Empty files can't be mapped
+    LARGE_INTEGER fileSizeInBytes = {};
+    if (!GetFileSizeEx(fileHandle, &fileSizeInBytes) || fileSizeInBytes.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMapping(fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+    if (!mappingHandle)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to create file mapping!", Core::Utility::LogSeverity::eCritical);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        Tk::Core::Utility::LogMsg("Platform", "Unable to map view of file!", Core::Utility::LogSeverity::eCritical);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    outMappedFile->data = (const uint8*)view;
+    outMappedFile->sizeInBytes = (uint64)fileSizeInBytes.QuadPart;
+    outMappedFile->fileHandle = (uint64)fileHandle;
+    outMappedFile->mappingHandle = (uint64)mappingHandle;
+    return true;
+}
+
+UNMAP_FILE(UnmapFile)
+{
+    if (mappedFile->data)
+    {
+        UnmapViewOfFile(mappedFile->data);
+        CloseHandle((HANDLE)mappedFile->mappingHandle);
+        CloseHandle((HANDLE)mappedFile->fileHandle);
+    }
+    *mappedFile = {};
+}
+
+// Clamps a range to the mapped file, returns false if nothing is left
+static bool ClampMappedRange(const MappedFile* mappedFile, uint64 offset, uint64* inOutSizeInBytes)
+{
+    if (!mappedFile->data || offset >= mappedFile->sizeInBytes)
+        return false;
+
+    *inOutSizeInBytes = Min(*inOutSizeInBytes, mappedFile->sizeInBytes - offset);
+    return *inOutSizeInBytes > 0;
+}
+
+PREFETCH_MAPPED_FILE(PrefetchMappedFile)
+{
+    if (!ClampMappedRange(mappedFile, offset, &sizeInBytes))
+        return;
+
+    WIN32_MEMORY_RANGE_ENTRY range = {};
+    range.VirtualAddress = (PVOID)(mappedFile->data + offset);
+    range.NumberOfBytes = (SIZE_T)sizeInBytes;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+ADVISE_MAPPED_FILE(AdviseMappedFile)
+{
+    switch (advice)
+    {
+        case MappedFileAdvice::eWillNeed:
+        {
+            PrefetchMappedFile(mappedFile, offset, sizeInBytes);
+            break;
+        }
+
+        case MappedFileAdvice::eDontNeed:
+        {
+            // Unlocking pages that aren't locked fails, but removes them from the working set
+            if (ClampMappedRange(mappedFile, offset, &sizeInBytes))
+                VirtualUnlock((LPVOID)(mappedFile->data + offset), (SIZE_T)sizeInBytes);
+            break;
+        }
+
+        default:
+        {
+            TINKER_ASSERT(0);
+            break;
+        }
+    }
+}
+
 FIND_FILE_OPEN(FindFileOpen)
 {
     WIN32_FIND_DATA fd;
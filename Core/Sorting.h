@@ -79,5 +79,55 @@ void MergeSort(T* data, uint32 numEles, CmpFunc Compare)
     Tk::Core::CoreFree(tmpList);
 }
 
+// Stable LSD radix sort, 8 bits per pass. Passes where every key has the same digit are skipped, so keys that only
+// differ in a few bytes sort in a few passes. scratch must hold numEles keys.
+inline void RadixSort64(uint64* keys, uint64* scratch, uint32 numEles)
+{
+    if (numEles < 2)
+        return;
+
+    uint32 histograms[8][256] = {};
+    for (uint32 i = 0; i < numEles; ++i)
+    {
+        for (uint32 uiPass = 0; uiPass < 8; ++uiPass)
+        {
+            ++histograms[uiPass][(keys[i] >> (uiPass * 8)) & 0xFF];
+        }
+    }
+
+    uint64* src = keys;
+    uint64* dst = scratch;
+    for (uint32 uiPass = 0; uiPass < 8; ++uiPass)
+    {
+        const uint32 shift = uiPass * 8;
+        uint32* histogram = histograms[uiPass];
+        if (histogram[(src[0] >> shift) & 0xFF] == numEles)
+            continue;
+
+        // Exclusive prefix sum gives each digit's first output slot
+        uint32 sum = 0;
+        for (uint32 uiDigit = 0; uiDigit < 256; ++uiDigit)
+        {
+            const uint32 count = histogram[uiDigit];
+            histogram[uiDigit] = sum;
+            sum += count;
+        }
+
+        for (uint32 i = 0; i < numEles; ++i)
+        {
+            dst[histogram[(src[i] >> shift) & 0xFF]++] = src[i];
+        }
+
+        uint64* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != keys)
+    {
+        memcpy(keys, src, numEles * sizeof(uint64));
+    }
+}
+
 }
 }
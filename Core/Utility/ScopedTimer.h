@@ -6,6 +6,8 @@
 #include "Logging.h"
 
 #include <chrono>
+#include <cstring>
+#include <cstdlib>
 
 #define MAX_MSG_LEN 128
 #define MAX_TIME_DIGITS 16 + 1 // + 1 for the dot in a decimal
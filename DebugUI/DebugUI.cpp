@@ -8,11 +8,14 @@
 #include "imgui.h"
 
 #include "Graphics/Common/GPUTimestamps.h"
+#include "Graphics/Common/RenderGraph.h"
+#include "Graphics/Common/ShaderManager.h"
 #include "DataStructures/Vector.h"
 #include "DataStructures/HashMap.h"
 #include "Sorting.h"
 #include "StringTypes.h"
 #include "MurmurHash3.h"
+#include "AssetFileParsing.h"
 #define SEED 0x1234
 
 static const uint32 MAX_VERTS = 1024 * 1024;
@@ -26,7 +29,6 @@ static Tk::Graphics::ResourceHandle positionBuffer = Tk::Graphics::DefaultResHan
 static Tk::Graphics::ResourceHandle uvBuffer = Tk::Graphics::DefaultResHandle_Invalid;
 static Tk::Graphics::ResourceHandle colorBuffer = Tk::Graphics::DefaultResHandle_Invalid;
 static Tk::Graphics::ResourceHandle fontTexture = Tk::Graphics::DefaultResHandle_Invalid;
-static Tk::Graphics::DescriptorHandle vbDesc = Tk::Graphics::DefaultDescHandle_Invalid;
 static Tk::Graphics::DescriptorHandle texDesc = Tk::Graphics::DefaultDescHandle_Invalid;
 
 void* ImGuiMemWrapper_Malloc(size_t sz, void* user_data)
@@ -41,7 +43,7 @@ void ImGuiMemWrapper_Free(void* ptr, void* user_data)
     free(ptr);
 }
 
-void Init(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream)
+void Init()
 {
     // ImGui startup
     ImGui::CreateContext();
@@ -76,15 +78,6 @@ void Init(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream)
         desc.dims = v3ui((MAX_VERTS - 2) * 3 * sizeof(uint32), 0, 0);
         desc.debugLabel = "Imgui idx buf";
         indexBuffer = Tk::Graphics::CreateResource(desc);
-
-        vbDesc = Tk::Graphics::CreateDescriptor(Tk::Graphics::DESCLAYOUT_ID_IMGUI_VBS);
-
-        Tk::Graphics::DescriptorSetDataHandles descDataHandles = {};
-        descDataHandles.handles[0] = positionBuffer;
-        descDataHandles.handles[1] = uvBuffer;
-        descDataHandles.handles[2] = colorBuffer;
-
-        Tk::Graphics::WriteDescriptor(Tk::Graphics::DESCLAYOUT_ID_IMGUI_VBS, vbDesc, &descDataHandles);
     }
 
     // Font texture
@@ -103,55 +96,9 @@ void Init(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream)
         desc.debugLabel = "Imgui font image";
         fontTexture = Tk::Graphics::CreateResource(desc);
 
-        // Staging buffer
-        Tk::Graphics::ResourceHandle imageStagingBufferHandle;
-        uint32 textureSizeInBytes = desc.dims.x * desc.dims.y * 4; // 4 bytes per pixel since RGBA8
-        desc.dims = v3ui(textureSizeInBytes, 0, 0);
-        desc.resourceType = Tk::Graphics::ResourceType::eBuffer1D; // staging buffer is just a 1D buffer
-        desc.bufferUsage = Tk::Graphics::BufferUsage::eStaging;
-        desc.debugLabel = "Imgui font staging buffer";
-        imageStagingBufferHandle = Tk::Graphics::CreateResource(desc);
-        
-        // Copy to GPU
-        void* stagingBufferMemPtr = Tk::Graphics::MapResource(imageStagingBufferHandle);
-        memcpy(stagingBufferMemPtr, pixels, textureSizeInBytes);
-
-        // Command recording and submission
-        Tk::Graphics::GraphicsCommand* command = &graphicsCommandStream->m_graphicsCommands[graphicsCommandStream->m_numCommands];
-
-        // Transition to transfer dst optimal layout
-        command->m_commandType = Tk::Graphics::GraphicsCommand::eLayoutTransition;
-        command->debugLabel = "Transition imgui font image layout to transfer dst optimal";
-        command->m_imageHandle = fontTexture;
-        command->m_startLayout = Tk::Graphics::ImageLayout::eUndefined;
-        command->m_endLayout = Tk::Graphics::ImageLayout::eTransferDst;
-        ++command;
-        ++graphicsCommandStream->m_numCommands;
-
-        // Texture buffer copy
-        command->m_commandType = Tk::Graphics::GraphicsCommand::eMemTransfer;
-        command->debugLabel = "Update imgui font texture data";
-        command->m_sizeInBytes = textureSizeInBytes;
-        command->m_srcBufferHandle = imageStagingBufferHandle;
-        command->m_dstBufferHandle = fontTexture;
-        ++command;
-        ++graphicsCommandStream->m_numCommands;
-
-        // Transition to shader read optimal layout
-        command->m_commandType = Tk::Graphics::GraphicsCommand::eLayoutTransition;
-        command->debugLabel = "Transition imgui font image layout to shader read optimal";
-        command->m_imageHandle = fontTexture;
-        command->m_startLayout = Tk::Graphics::ImageLayout::eTransferDst;
-        command->m_endLayout = Tk::Graphics::ImageLayout::eShaderRead;
-        ++command;
-        ++graphicsCommandStream->m_numCommands;
-
-        // Perform the copy from staging buffer to device local buffer
-        Tk::Graphics::SubmitCmdsImmediate(graphicsCommandStream);
-        graphicsCommandStream->m_numCommands = 0; // reset the cmd counter for the stream
-
-        Tk::Graphics::UnmapResource(imageStagingBufferHandle);
-        Tk::Graphics::DestroyResource(imageStagingBufferHandle);
+        // Staged upload, batched with any other uploads until the caller submits them
+        const uint32 textureSizeInBytes = desc.dims.x * desc.dims.y * 4; // 4 bytes per pixel since RGBA8
+        Tk::Graphics::UploadImageData(fontTexture, pixels, textureSizeInBytes);
 
         // Descriptor
         texDesc = Tk::Graphics::CreateDescriptor(Tk::Graphics::DESCLAYOUT_ID_IMGUI_TEX);
@@ -178,8 +125,6 @@ void Shutdown()
     Tk::Graphics::DestroyResource(fontTexture);
     fontTexture = Tk::Graphics::DefaultResHandle_Invalid;
 
-    Tk::Graphics::DestroyDescriptor(vbDesc);
-    vbDesc = Tk::Graphics::DefaultDescHandle_Invalid;
     Tk::Graphics::DestroyDescriptor(texDesc);
     texDesc = Tk::Graphics::DefaultDescHandle_Invalid;
 
@@ -206,8 +151,6 @@ void Render(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, Tk::Grap
         ImGui::RenderPlatformWindowsDefault();
     }*/
 
-    Tk::Graphics::GraphicsCommand* command = &graphicsCommandStream->m_graphicsCommands[graphicsCommandStream->m_numCommands];
-
     ImDrawData* drawData = ImGui::GetDrawData();
     if (!drawData->Valid)
     {
@@ -224,21 +167,23 @@ void Render(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, Tk::Grap
         const uint32 fbWidth = (uint32)(drawData->DisplaySize.x * drawData->FramebufferScale.x);
         const uint32 fbHeight = (uint32)(drawData->DisplaySize.y * drawData->FramebufferScale.y);
 
-        command->m_commandType = Tk::Graphics::GraphicsCommand::eRenderPassBegin;
-        command->debugLabel = "Imgui render pass";
-        command->m_numColorRTs = 1;
-        command->m_colorRTs[0] = renderTarget;
-        command->m_depthRT = Tk::Graphics::DefaultResHandle_Invalid;
-        command->m_renderWidth  = fbWidth;
-        command->m_renderHeight = fbHeight;
-        ++graphicsCommandStream->m_numCommands;
-        ++command;
+        graphicsCommandStream->CmdRenderPassBegin(1, &renderTarget, Tk::Graphics::DefaultResHandle_Invalid, fbWidth, fbHeight, "Imgui render pass");
 
         const v2f scissorWindowMin = v2f(drawData->DisplayPos.x, drawData->DisplayPos.y);
         const v2f scissorScale = v2f(drawData->FramebufferScale.x, drawData->FramebufferScale.y);
 
         const v2f scale = v2f(2.0f / drawData->DisplaySize.x, 2.0f / drawData->DisplaySize.y);
         const v2f translate = v2f(-1.0f - drawData->DisplayPos.x * scale.x, -1.0f - drawData->DisplayPos.y * scale.y);
+        const float pushConstantData[] = { scale.x, scale.y, translate.x, translate.y };
+
+        // The vertex buffers are multi buffered, so the descriptor pointing at this frame's copies only lives for this frame
+        Tk::Graphics::DescriptorHandle vbDesc = Tk::Graphics::CreateTransientDescriptor(Tk::Graphics::DESCLAYOUT_ID_IMGUI_VBS);
+        Tk::Graphics::DescriptorSetDataHandles descDataHandles = {};
+        descDataHandles.handles[0] = positionBuffer;
+        descDataHandles.handles[1] = uvBuffer;
+        descDataHandles.handles[2] = colorBuffer;
+        Tk::Graphics::WriteDescriptor(Tk::Graphics::DESCLAYOUT_ID_IMGUI_VBS, vbDesc, &descDataHandles);
+        const Tk::Graphics::DescriptorHandle descriptors[] = { texDesc, vbDesc };
 
         uint32* idxBufPtr = (uint32*)Tk::Graphics::MapResource(indexBuffer);
         v2f* posBufPtr = (v2f*)Tk::Graphics::MapResource(positionBuffer);
@@ -270,18 +215,7 @@ void Render(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, Tk::Grap
             {
                 const ImDrawCmd& cmd = currDrawList->CmdBuffer[uiCmd];
 
-                command->m_commandType = Tk::Graphics::GraphicsCommand::ePushConstant;
-                command->debugLabel = "Imgui push constant";
-                command->m_shaderForLayout = Tk::Graphics::SHADER_ID_IMGUI_DEBUGUI;
-                {
-                    float* data = (float*)command->m_pushConstantData;
-                    data[0] = scale.x;
-                    data[1] = scale.y;
-                    data[2] = translate.x;
-                    data[3] = translate.y;
-                }
-                ++graphicsCommandStream->m_numCommands;
-                ++command;
+                graphicsCommandStream->CmdPushConstant(Tk::Graphics::SHADER_ID_IMGUI_DEBUGUI, pushConstantData, sizeof(pushConstantData), "Imgui push constant");
 
                 // Calc tight scissor
                 v2f scissorMin = {};
@@ -298,33 +232,12 @@ void Render(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, Tk::Grap
                     continue;
                 }
                 
-                command->m_commandType = Tk::Graphics::GraphicsCommand::eSetScissor;
-                command->debugLabel = "Set render pass scissor state";
-                command->m_scissorOffsetX = (int32)scissorMin.x;
-                command->m_scissorOffsetY = (int32)scissorMin.y;
-                command->m_scissorWidth = uint32(scissorMax.x - scissorMin.x);
-                command->m_scissorHeight = uint32(scissorMax.y - scissorMin.y);
-                ++graphicsCommandStream->m_numCommands;
-                ++command;
-
-                command->m_commandType = Tk::Graphics::GraphicsCommand::eDrawCall;
-                command->debugLabel = "Draw imgui element";
-                command->m_numIndices = cmd.ElemCount;
-                command->m_numInstances = 1;
-                command->m_vertOffset = cmd.VtxOffset + vtxCtr;
-                command->m_indexOffset = cmd.IdxOffset + idxCtr;
-                command->m_indexBufferHandle = indexBuffer;
-                command->m_shader = Tk::Graphics::SHADER_ID_IMGUI_DEBUGUI;
-                command->m_blendState = Tk::Graphics::BlendState::eAlphaBlend;
-                command->m_depthState = Tk::Graphics::DepthState::eOff_NoCull;
-                for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-                {
-                    command->m_descriptors[i] = Tk::Graphics::DefaultDescHandle_Invalid;
-                }
-                command->m_descriptors[0] = texDesc;
-                command->m_descriptors[1] = vbDesc;
-                ++graphicsCommandStream->m_numCommands;
-                ++command;
+                graphicsCommandStream->CmdSetScissor((int32)scissorMin.x, (int32)scissorMin.y,
+                    uint32(scissorMax.x - scissorMin.x), uint32(scissorMax.y - scissorMin.y), "Set render pass scissor state");
+
+                graphicsCommandStream->CmdDraw(indexBuffer, cmd.ElemCount, 1, cmd.VtxOffset + vtxCtr, cmd.IdxOffset + idxCtr,
+                    Tk::Graphics::SHADER_ID_IMGUI_DEBUGUI, Tk::Graphics::BlendState::eAlphaBlend, Tk::Graphics::DepthState::eOff_NoCull,
+                    descriptors, ARRAYCOUNT(descriptors), "Draw imgui element");
             }
 
             idxCtr += numIdxs;
@@ -336,10 +249,7 @@ void Render(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, Tk::Grap
         Tk::Graphics::UnmapResource(uvBuffer);
         Tk::Graphics::UnmapResource(colorBuffer);
 
-        command->m_commandType = Tk::Graphics::GraphicsCommand::eRenderPassEnd;
-        command->debugLabel = "End Imgui render pass";
-        ++graphicsCommandStream->m_numCommands;
-        ++command;
+        graphicsCommandStream->CmdRenderPassEnd("End Imgui render pass");
     }
 }
 
@@ -556,4 +466,288 @@ void UI_RenderPassStats()
     }
 }
 
+static bool mainMenu_SelectedGraphicsStats = true;
+
+void UI_GraphicsStats()
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            Tk::Graphics::GraphicsStats stats = {};
+            Tk::Graphics::GetGraphicsStats(&stats);
+
+            ImGui::Text("Deferred destroys pending: %u", stats.numDeferredDestroysPending);
+            ImGui::Text("Deferred destroys total: %llu", stats.numDeferredDestroysTotal);
+            ImGui::Text("Device stalls avoided: %llu", stats.numDeviceStallsAvoided);
+
+            ImGui::Separator();
+            int numFramesInFlight = (int)stats.numFramesInFlight;
+            int framePacingMode = (int)stats.framePacingMode;
+            bool framePacingChanged = ImGui::SliderInt("Frames in flight", &numFramesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
+            framePacingChanged |= ImGui::RadioButton("Throughput", &framePacingMode, (int)Tk::Graphics::FramePacingMode::eThroughput);
+            ImGui::SameLine();
+            framePacingChanged |= ImGui::RadioButton("Low latency", &framePacingMode, (int)Tk::Graphics::FramePacingMode::eLowLatency);
+            if (framePacingChanged)
+            {
+                Tk::Graphics::SetFramePacing((uint32)numFramesInFlight, (uint32)framePacingMode);
+            }
+
+            ImGui::Text("Frame time: %.3f ms (%.1f fps)", stats.avgFrameTimeMS, stats.avgFrameTimeMS > 0.0f ? 1000.0f / stats.avgFrameTimeMS : 0.0f);
+            ImGui::Text("Input to gpu complete: %.3f ms", stats.avgInputToGPUCompleteMS);
+
+            ImGui::Separator();
+            ImGui::Text("Transient upload: %u / %u bytes", stats.transientUploadBytesUsed, stats.transientUploadRingSize);
+            ImGui::Text("Mapped range flushes per frame: %u", stats.numMappedRangeFlushes);
+
+            ImGui::Separator();
+            ImGui::Text("Upload queue: %s", stats.hasDedicatedTransferQueue ? "dedicated transfer" : "graphics");
+            ImGui::Text("Upload batches in flight: %u", stats.numUploadBatchesInFlight);
+            ImGui::Text("Upload batches total: %llu (%llu bytes)", stats.numUploadBatchesTotal, stats.numUploadBytesTotal);
+
+            ImGui::Separator();
+            ImGui::Text("Async compute queue: %s", stats.hasDedicatedComputeQueue ? "dedicated compute" : "graphics");
+            bool isAsyncComputeEnabled = stats.isAsyncComputeEnabled;
+            if (stats.hasDedicatedComputeQueue && ImGui::Checkbox("Async compute", &isAsyncComputeEnabled))
+            {
+                Tk::Graphics::SetAsyncComputeEnabled(isAsyncComputeEnabled);
+            }
+            ImGui::Text("Graphics queue: %.3f ms", stats.avgGraphicsQueueGPUTimeMS);
+            ImGui::Text("Async compute work: %.3f ms (%s queue)", stats.avgAsyncComputeGPUTimeMS,
+                stats.wasAsyncComputeOnComputeQueue ? "compute" : "graphics");
+
+            // On the graphics queue the async work is part of the graphics queue time. On the compute queue both queues
+            // start once the previous frame is done, so the frame takes about as long as the slower one.
+            static float graphicsQueueBaselineMS = 0.0f;
+            const float frameGPUTimeMS = stats.wasAsyncComputeOnComputeQueue ?
+                Max(stats.avgGraphicsQueueGPUTimeMS, stats.avgAsyncComputeGPUTimeMS) : stats.avgGraphicsQueueGPUTimeMS;
+            if (!stats.wasAsyncComputeOnComputeQueue)
+            {
+                graphicsQueueBaselineMS = frameGPUTimeMS;
+            }
+            ImGui::Text("Frame gpu time: %.3f ms", frameGPUTimeMS);
+            if (stats.wasAsyncComputeOnComputeQueue && graphicsQueueBaselineMS > 0.0f)
+            {
+                ImGui::Text("Overlap gain: %.3f ms (graphics queue baseline %.3f ms)", graphicsQueueBaselineMS - frameGPUTimeMS, graphicsQueueBaselineMS);
+            }
+
+            ImGui::Separator();
+            ImGui::Text("Descriptor pools: %u", stats.numDescriptorPools);
+            ImGui::Text("Descriptor sets allocated: %llu, recycled: %llu", stats.numDescriptorSetsAllocated, stats.numDescriptorSetsRecycled);
+            ImGui::Text("Transient descriptors per frame: %u", stats.numTransientDescriptors);
+            ImGui::Text("Bindless buffers: %u / %u", stats.numBindlessBuffers, stats.maxBindlessBuffers);
+            ImGui::Text("Bindless images: %u / %u", stats.numBindlessImages, stats.maxBindlessImages);
+            ImGui::Text("Descriptor set layouts: %u", stats.numDescriptorSetLayouts);
+
+            ImGui::Separator();
+            ImGui::Text("Graphics PSOs: %u (blend state %s)", stats.numGraphicsPSOs, stats.isBlendStateDynamic ? "dynamic" : "per pipeline");
+            ImGui::Text("Shader modules: %u", stats.numShaderModules);
+
+            ImGui::Separator();
+            bool sortDrawCalls = Tk::Graphics::IsDrawCallSortingEnabled();
+            if (ImGui::Checkbox("Sort draw calls", &sortDrawCalls))
+            {
+                Tk::Graphics::SetDrawCallSorting(sortDrawCalls);
+            }
+
+            Tk::Graphics::CommandStreamStats cmdStats = {};
+            Tk::Graphics::GetCommandStreamStats(&cmdStats);
+            ImGui::Text("Draws: %u (%u sorted)", cmdStats.numDraws, cmdStats.numSortedDraws);
+            ImGui::Text("PSO binds: %u (recorded order: %u)", cmdStats.numPSOBinds, cmdStats.numPSOBindsUnsorted);
+            ImGui::Text("Descriptor binds: %u (recorded order: %u)", cmdStats.numDescriptorBinds, cmdStats.numDescriptorBindsUnsorted);
+            ImGui::Text("Commands: %u (%u bytes, %.1f bytes/cmd)", cmdStats.numCommands, cmdStats.numCommandBytes,
+                cmdStats.numCommands ? (float)cmdStats.numCommandBytes / cmdStats.numCommands : 0.0f);
+            ImGui::Text("Command replay: %.3f ms", cmdStats.replayTimeMS);
+
+            static Tk::Graphics::CommandStreamBenchmark benchmark = {};
+            static int benchmarkNumCommands = 100000;
+            ImGui::SliderInt("Benchmark commands", &benchmarkNumCommands, 100000, 1000000);
+            if (ImGui::Button("Run command stream benchmark"))
+            {
+                Tk::Graphics::BenchmarkCommandStream((uint32)benchmarkNumCommands, &benchmark);
+            }
+            if (benchmark.numCommands)
+            {
+                ImGui::Text("%u commands, %.1f bytes/cmd, %u binds", benchmark.numCommands,
+                    (float)benchmark.numBytes / benchmark.numCommands, benchmark.numBinds);
+                ImGui::Text("Record: %.3f ms (%.1f M cmds/s)", benchmark.recordTimeMS,
+                    benchmark.recordTimeMS > 0.0f ? (float)benchmark.numCommands / (benchmark.recordTimeMS * 1000.0f) : 0.0f);
+                ImGui::Text("Decode: %.3f ms (%.1f M cmds/s)", benchmark.decodeTimeMS,
+                    benchmark.decodeTimeMS > 0.0f ? (float)benchmark.numCommands / (benchmark.decodeTimeMS * 1000.0f) : 0.0f);
+            }
+        }
+        ImGui::End();
+    }
+}
+
+void UI_RenderGraphStats(const Tk::Graphics::RenderGraph* renderGraph)
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        // Appends to the graphics stats window
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            Tk::Graphics::RenderGraphStats stats = {};
+            renderGraph->GetStats(&stats);
+
+            ImGui::Separator();
+            ImGui::Text("Render graph passes: %u (%u culled)", stats.numLivePasses, stats.numPasses - stats.numLivePasses);
+            ImGui::Text("Render graph barriers: %u", stats.numBarriers);
+            ImGui::Text("Transient images: %u", stats.numTransientImages);
+            ImGui::Text("Transient memory: %.2f MB (%.2f MB without aliasing)",
+                (double)stats.transientHeapBytes / (1024.0 * 1024.0), (double)stats.transientBytesUnaliased / (1024.0 * 1024.0));
+        }
+        ImGui::End();
+    }
+}
+
+void UI_GPUInstances(bool* isEnabled, uint32* numInstances, uint32 maxInstances)
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        // Appends to the graphics stats window
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            ImGui::Separator();
+            ImGui::Checkbox("GPU culled instances", isEnabled);
+            int numInstancesInt = (int)*numInstances;
+            if (ImGui::SliderInt("Instances", &numInstancesInt, 1, (int)maxInstances))
+            {
+                *numInstances = (uint32)numInstancesInt;
+            }
+
+            Tk::Graphics::CommandStreamStats cmdStats = {};
+            Tk::Graphics::GetCommandStreamStats(&cmdStats);
+            ImGui::Text("Dispatches: %u, indirect draws: %u", cmdStats.numDispatches, cmdStats.numIndirectDraws);
+        }
+        ImGui::End();
+    }
+}
+
+void UI_ShaderVariants(uint32 shaderID)
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        // Appends to the graphics stats window. Nothing else changes with the variant, so the gpu timestamps compare them directly.
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            const uint32 maxVariants = 32;
+            Tk::Graphics::ShaderManager::ShaderVariantInfo variants[maxVariants];
+            const uint32 numVariants = Tk::Graphics::ShaderManager::GetShaderVariants(shaderID, variants, maxVariants);
+            const uint32 activeVariantKey = Tk::Graphics::ShaderManager::GetActiveShaderVariant(shaderID);
+
+            const char* variantNames[maxVariants] = {};
+            int activeVariant = 0;
+            for (uint32 uiVariant = 0; uiVariant < numVariants; ++uiVariant)
+            {
+                variantNames[uiVariant] = variants[uiVariant].defines[0] ? variants[uiVariant].defines : "default";
+                if (variants[uiVariant].variantKey == activeVariantKey)
+                    activeVariant = (int)uiVariant;
+            }
+
+            ImGui::PushID((int)shaderID);
+            if (ImGui::Combo("Shader variant", &activeVariant, variantNames, (int)numVariants))
+            {
+                Tk::Graphics::ShaderManager::SetShaderVariant(shaderID, variants[activeVariant].variantKey);
+            }
+            ImGui::PopID();
+        }
+        ImGui::End();
+    }
+}
+
+void UI_ComputeBenchmark(bool* isEnabled, uint32* kernel, const char* const* kernelNames, uint32 numKernels, uint32* numElements, uint32 maxElements)
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        // Appends to the graphics stats window, the kernel's time shows up with the gpu timestamps
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            ImGui::Separator();
+            ImGui::Checkbox("Compute benchmark", isEnabled);
+            int kernelInt = (int)*kernel;
+            if (ImGui::Combo("Kernel", &kernelInt, kernelNames, (int)numKernels))
+            {
+                *kernel = (uint32)kernelInt;
+            }
+            int numElementsInt = (int)*numElements;
+            if (ImGui::SliderInt("Elements", &numElementsInt, 1, (int)maxElements))
+            {
+                *numElements = (uint32)numElementsInt;
+            }
+        }
+        ImGui::End();
+    }
+}
+
+void UI_FileReadBenchmark()
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        // Appends to the graphics stats window. Blocks the frame while it runs.
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            ImGui::Separator();
+            static Tk::Platform::FileReadBenchmark benchmark = {};
+            static int benchmarkNumFiles = 64;
+            static int benchmarkFileSizeKB = 1024;
+            ImGui::SliderInt("Benchmark files", &benchmarkNumFiles, 1, FILE_READ_BENCHMARK_FILES_MAX);
+            ImGui::SliderInt("Benchmark file size (KB)", &benchmarkFileSizeKB, 4, 16384);
+            if (ImGui::Button("Run file read benchmark"))
+            {
+                Tk::Platform::BenchmarkFileReads((uint32)benchmarkNumFiles, (uint64)benchmarkFileSizeKB * 1024, &benchmark);
+            }
+            if (benchmark.numFiles)
+            {
+                const float totalMB = (float)(benchmark.numFiles * benchmark.fileSizeInBytes) / (1024.0f * 1024.0f);
+                ImGui::Text("%u files, %.2f MB total", benchmark.numFiles, totalMB);
+                for (uint32 uiMode = 0; uiMode < FILE_READ_BENCHMARK_MODES; ++uiMode)
+                {
+                    const char* modeName = uiMode ? "unbuffered" : "buffered";
+                    const float serialTimeMS = benchmark.serialTimeMS[uiMode];
+                    ImGui::Text("Serial, %s: %.3f ms (%.1f MB/s)", modeName, serialTimeMS,
+                        serialTimeMS > 0.0f ? totalMB / (serialTimeMS * 1e-3f) : 0.0f);
+                    for (uint32 uiDepth = 0; uiDepth < FILE_READ_BENCHMARK_QUEUE_DEPTHS; ++uiDepth)
+                    {
+                        const float timeMS = benchmark.batchedTimeMS[uiMode][uiDepth];
+                        ImGui::Text("Batched, %s, queue depth %u: %.3f ms (%.1f MB/s)", modeName, benchmark.queueDepths[uiDepth], timeMS,
+                            timeMS > 0.0f ? totalMB / (timeMS * 1e-3f) : 0.0f);
+                    }
+                }
+            }
+        }
+        ImGui::End();
+    }
+}
+
+void UI_MeshLoadBenchmark()
+{
+    if (mainMenu_SelectedGraphicsStats)
+    {
+        // Appends to the graphics stats window. Blocks the frame while it runs.
+        if (ImGui::Begin("Graphics Stats", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            ImGui::Separator();
+            static Tk::Core::Asset::MeshLoadBenchmark benchmark = {};
+            static int benchmarkGridSize = 512;
+            ImGui::SliderInt("Benchmark mesh grid size", &benchmarkGridSize, 16, MESH_LOAD_BENCHMARK_GRID_SIZE_MAX, "%d", ImGuiSliderFlags_AlwaysClamp);
+            if (ImGui::Button("Run mesh load benchmark"))
+            {
+                Tk::Core::Asset::BenchmarkMeshLoad((uint32)benchmarkGridSize, &benchmark);
+            }
+            if (benchmark.numTriangles)
+            {
+                const float toMB = 1.0f / (1024.0f * 1024.0f);
+                ImGui::Text("%u triangles, %u vertices", benchmark.numTriangles, benchmark.numVertices);
+                ImGui::Text("OBJ parse: %.3f ms (%.2f MB)", benchmark.parseTimeMS, (float)benchmark.objSizeInBytes * toMB);
+                ImGui::Text("Cook: %.3f ms", benchmark.cookTimeMS);
+                ImGui::Text("Cooked load: %.3f ms (%.2f MB)", benchmark.cookedLoadTimeMS, (float)benchmark.cookedSizeInBytes * toMB);
+                ImGui::Text("Cooked quantized load: %.3f ms (%.2f MB)", benchmark.cookedQuantizedLoadTimeMS,
+                    (float)benchmark.cookedQuantizedSizeInBytes * toMB);
+            }
+        }
+        ImGui::End();
+    }
+}
+
 }
@@ -6,16 +6,24 @@ namespace Graphics
 {
     struct GraphicsCommandStream;
     struct ResourceHandle;
+    struct RenderGraph;
 }
 }
 
 namespace DebugUI
 {
-    void Init(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream);
+    void Init();
     void Shutdown();
     void NewFrame();
     void Render(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, Tk::Graphics::ResourceHandle renderTarget);
     void ToggleEnable();
 
     void UI_RenderPassStats();
+    void UI_GraphicsStats();
+    void UI_RenderGraphStats(const Tk::Graphics::RenderGraph* renderGraph);
+    void UI_GPUInstances(bool* isEnabled, uint32* numInstances, uint32 maxInstances);
+    void UI_ComputeBenchmark(bool* isEnabled, uint32* kernel, const char* const* kernelNames, uint32 numKernels, uint32* numElements, uint32 maxElements);
+    void UI_ShaderVariants(uint32 shaderID);
+    void UI_FileReadBenchmark();
+    void UI_MeshLoadBenchmark();
 }
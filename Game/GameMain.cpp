@@ -2,6 +2,7 @@
 #include "Graphics/Common/GraphicsCommon.h"
 #include "Graphics/Common/GPUTimestamps.h"
 #include "Graphics/Common/ShaderManager.h"
+#include "Graphics/Common/RenderGraph.h"
 #include "ShaderCompiler/ShaderCompiler.h"
 #include "Allocators.h"
 #include "Math/VectorTypes.h"
@@ -39,8 +40,10 @@ static uint32 currentWindowHeight = 0;
 static bool isWindowMinimized;
 static Tk::Platform::WindowHandles* windowHandles = nullptr;
 
-#define TINKER_PLATFORM_GRAPHICS_COMMAND_STREAM_MAX MAX_UINT16
-Tk::Graphics::GraphicsCommandStream graphicsCommandStream;
+#define TINKER_PLATFORM_GRAPHICS_COMMAND_STREAM_INITIAL_SIZE (64u * 1024) // bytes, grows as needed
+Tk::Graphics::GraphicsCommandStream g_graphicsCommandStream;
+Tk::Graphics::GraphicsCommandStream g_asyncComputeCommandStream;
+static Tk::Graphics::RenderGraph g_renderGraph = {};
 
 static GameGraphicsData gameGraphicsData = {};
 static GameRenderPass gameRenderPasses[eRenderPass_Max] = {};
@@ -52,14 +55,19 @@ INPUT_CALLBACK(HotloadAllShaders)
     Tk::Core::Utility::LogMsg("Game", "Attempting to hotload shaders...\n", Tk::Core::Utility::LogSeverity::eInfo);
 
     uint32 result = Tk::ShaderCompiler::ErrCode::NonShaderError;
+    static Tk::ShaderCompiler::CompiledShaderList compiledShaders = {};
+    compiledShaders.numShaders = 0;
     #ifdef VULKAN
-    result = Tk::ShaderCompiler::CompileAllShadersVK();
+    result = Tk::ShaderCompiler::CompileChangedShadersVK(&compiledShaders);
     #else
     #endif
     
     if (result == Tk::ShaderCompiler::ErrCode::Success)
     {
-        Tk::Graphics::ShaderManager::ReloadShaders(currentWindowWidth, currentWindowHeight);
+        const char* spvFilenames[MAX_COMPILED_SHADERS] = {};
+        for (uint32 i = 0; i < compiledShaders.numShaders; ++i)
+            spvFilenames[i] = compiledShaders.spvFilenames[i];
+        Tk::Graphics::ShaderManager::ReloadChangedShaders(spvFilenames, compiledShaders.numShaders);
         Tk::Core::Utility::LogMsg("Game", "...Done.\n", Tk::Core::Utility::LogSeverity::eInfo);
     }
     else
@@ -78,38 +86,16 @@ static void InitDemo()
 
 static void DestroyDescriptors()
 {
-    Graphics::DestroyDescriptor(gameGraphicsData.m_swapChainBlitDescHandle);
-    gameGraphicsData.m_swapChainBlitDescHandle = Graphics::DefaultDescHandle_Invalid;
-
     Graphics::DestroyDescriptor(gameGraphicsData.m_DescData_Global);
     gameGraphicsData.m_DescData_Global = Graphics::DefaultDescHandle_Invalid;
     Graphics::DestroyResource(gameGraphicsData.m_DescDataBufferHandle_Global);
     gameGraphicsData.m_DescDataBufferHandle_Global = Graphics::DefaultResHandle_Invalid;
 
-    Graphics::DestroyAllDescriptors(); // destroys descriptor pool
-}
-
-static void WriteSwapChainBlitResources()
-{
-    Graphics::DescriptorSetDataHandles blitHandles = {};
-    blitHandles.InitInvalid();
-    blitHandles.handles[0] = gameGraphicsData.m_rtColorHandle;
-    Graphics::WriteDescriptor(Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_TEX, gameGraphicsData.m_swapChainBlitDescHandle, &blitHandles);
-
-    Graphics::DescriptorSetDataHandles vbHandles = {};
-    vbHandles.InitInvalid();
-    vbHandles.handles[0] = defaultQuad.m_positionBuffer.gpuBufferHandle;
-    vbHandles.handles[1] = defaultQuad.m_uvBuffer.gpuBufferHandle;
-    vbHandles.handles[2] = defaultQuad.m_normalBuffer.gpuBufferHandle;
-    Graphics::WriteDescriptor(Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_VBS, defaultQuad.m_descriptor, &vbHandles);
+    Graphics::DestroyAllDescriptors(); // destroys descriptor pools
 }
 
 static void CreateAllDescriptors()
 {
-    // Swap chain blit
-    gameGraphicsData.m_swapChainBlitDescHandle = Graphics::CreateDescriptor(Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_TEX);
-    WriteSwapChainBlitResources();
-
     // Descriptor data
     Graphics::ResourceDesc desc;
     desc.resourceType = Graphics::ResourceType::eBuffer1D;
@@ -127,15 +113,47 @@ static void CreateAllDescriptors()
     Graphics::WriteDescriptor(Graphics::DESCLAYOUT_ID_VIEW_GLOBAL, gameGraphicsData.m_DescData_Global, &descDataHandles[0]);
 }
 
-static void CreateGameRenderingResources(uint32 windowWidth, uint32 windowHeight)
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_ClearMainView);
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_MainView);
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_DebugUI);
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_SwapChainBlit);
+
+// Barriers, layout transitions and transient render target memory are all derived from the declared accesses
+static void BuildRenderGraph(uint32 windowWidth, uint32 windowHeight)
 {
+    g_renderGraph.Reset();
+
     Graphics::ResourceDesc desc;
     desc.resourceType = Graphics::ResourceType::eImage2D;
     desc.arrayEles = 1;
     desc.dims = v3ui(windowWidth, windowHeight, 1);
     desc.imageFormat = Graphics::ImageFormat::RGBA8_SRGB;
     desc.debugLabel = "MainViewColor";
-    gameGraphicsData.m_rtColorHandle = Graphics::CreateResource(desc);
+    const uint32 rtColor = g_renderGraph.CreateTransientImage(desc);
+    const uint32 swapChain = g_renderGraph.ImportImage(Graphics::IMAGE_HANDLE_SWAP_CHAIN,
+        Graphics::ImageAccess::ePresent, Graphics::ImageAccess::ePresent, true, "Swap chain");
+
+    uint32 pass = g_renderGraph.AddPass("Clear main view", RenderGraphPass_ClearMainView, nullptr);
+    g_renderGraph.AddAccess(pass, rtColor, Graphics::ImageAccess::eTransferDst);
+
+    pass = g_renderGraph.AddPass("Main view", RenderGraphPass_MainView, nullptr);
+    g_renderGraph.AddAccess(pass, rtColor, Graphics::ImageAccess::eColorAttachment);
+
+    pass = g_renderGraph.AddPass("Debug UI", RenderGraphPass_DebugUI, nullptr);
+    g_renderGraph.AddAccess(pass, rtColor, Graphics::ImageAccess::eColorAttachment);
+
+    pass = g_renderGraph.AddPass("Blit to swap chain", RenderGraphPass_SwapChainBlit, nullptr);
+    g_renderGraph.AddAccess(pass, rtColor, Graphics::ImageAccess::eFragmentShaderRead);
+    g_renderGraph.AddAccess(pass, swapChain, Graphics::ImageAccess::eColorAttachment);
+
+    g_renderGraph.Compile();
+
+    gameGraphicsData.m_rtColorHandle = g_renderGraph.GetImage(rtColor);
+}
+
+static void CreateGameRenderingResources(uint32 windowWidth, uint32 windowHeight)
+{
+    BuildRenderGraph(windowWidth, windowHeight);
 
     gameRenderPasses[eRenderPass_MainView].Init();
     gameRenderPasses[eRenderPass_MainView].numColorRTs = 1;
@@ -154,10 +172,8 @@ static uint32 GameInit(uint32 windowWidth, uint32 windowHeight)
 
     // Graphics init
     Tk::Graphics::CreateContext(windowHandles, windowWidth, windowHeight);
-    graphicsCommandStream = {};
-    graphicsCommandStream.m_numCommands = 0;
-    graphicsCommandStream.m_maxCommands = TINKER_PLATFORM_GRAPHICS_COMMAND_STREAM_MAX;
-    graphicsCommandStream.m_graphicsCommands = (Tk::Graphics::GraphicsCommand*)Tk::Core::CoreMallocAligned(graphicsCommandStream.m_maxCommands * sizeof(Tk::Graphics::GraphicsCommand), CACHE_LINE);
+    g_graphicsCommandStream.Init(TINKER_PLATFORM_GRAPHICS_COMMAND_STREAM_INITIAL_SIZE);
+    g_asyncComputeCommandStream.Init(TINKER_PLATFORM_GRAPHICS_COMMAND_STREAM_INITIAL_SIZE);
 
     /*if (Tk::ShaderCompiler::Init() != Tk::ShaderCompiler::ErrCode::Success)
     {
@@ -165,10 +181,10 @@ static uint32 GameInit(uint32 windowWidth, uint32 windowHeight)
         Tk::Core::Utility::LogMsg("Game", "Failed to init shader compiler!", Tk::Core::Utility::LogSeverity::eCritical);
     }*/
     Tk::Graphics::ShaderManager::Startup();
-    Tk::Graphics::ShaderManager::LoadAllShaderResources(windowWidth, windowHeight);
+    Tk::Graphics::ShaderManager::LoadAllShaderResources();
     //g_InputManager.BindKeycodeCallback_KeyDown(Platform::Keycode::eF11, HotloadAllShaders); // Bind shader hotloading hotkey
 
-    DebugUI::Init(&graphicsCommandStream);
+    DebugUI::Init();
 
     g_gameCamera.m_ref = v3f(0.0f, 0.0f, 0.0f);
     g_gameCamera.m_eye = v3f(27.0f, 27.0f, 27.0f);
@@ -176,7 +192,12 @@ static uint32 GameInit(uint32 windowWidth, uint32 windowHeight)
     currentWindowHeight = windowHeight;
     g_projMat = PerspectiveProjectionMatrix((float)currentWindowWidth / currentWindowHeight);
 
-    CreateDefaultGeometry(&graphicsCommandStream);
+    CreateDefaultGeometry();
+    CreateGPUInstanceField(&gameGraphicsData.m_gpuInstances, GPU_INSTANCES_MAX);
+    CreateComputeBenchmark(&gameGraphicsData.m_computeBenchmark);
+
+    // Everything above is needed by the first frame
+    Tk::Graphics::WaitForUpload(Tk::Graphics::SubmitUploads());
 
     CreateGameRenderingResources(windowWidth, windowHeight);
 
@@ -187,10 +208,83 @@ static uint32 GameInit(uint32 windowWidth, uint32 windowHeight)
     return 0;
 }
 
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_ClearMainView)
+{
+    graphicsCommandStream->CmdClearImage(gameGraphicsData.m_rtColorHandle, v4f(0.0f, 0.0f, 0.0f, 0.0f), "Clear color buffer");
+}
+
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_MainView)
+{
+    // Timestamp start of frame - we do this after the clear to keep it out of the timings
+    graphicsCommandStream->CmdTimestamp("Begin Frame", "Timestamp", true);
+
+    // Compute can't run inside the render pass, cull before it starts
+    if (gameGraphicsData.m_gpuInstances.isEnabled)
+        CullGPUInstanceField(&gameGraphicsData.m_gpuInstances, graphicsCommandStream);
+    graphicsCommandStream->CmdTimestamp("Cull instances", "Timestamp");
+
+    // Bindless shaders, nothing to bind per draw
+    BindlessQuadPushConstants quadConstants = {};
+    quadConstants.positionBufferIndex = Graphics::GetBindlessIndex(defaultQuad.m_positionBuffer.gpuBufferHandle);
+
+    StartRenderPass(&gameRenderPasses[eRenderPass_MainView], graphicsCommandStream);
+
+    graphicsCommandStream->CmdSetScissor(0, 0, currentWindowWidth, currentWindowHeight, "Set render pass scissor state");
+
+    graphicsCommandStream->CmdPushConstant(Graphics::SHADER_ID_Pass1, &quadConstants, sizeof(quadConstants), "Quad push constants");
+    graphicsCommandStream->CmdDraw(defaultQuad.m_indexBuffer.gpuBufferHandle, DEFAULT_QUAD_NUM_INDICES, 1, 0, 0,
+        Graphics::SHADER_ID_Pass1, Graphics::BlendState::eReplace, Graphics::DepthState::eOff_NoCull,
+        nullptr, 0, "Draw default quad");
+
+    graphicsCommandStream->CmdTimestamp("Pass 1", "Timestamp");
+
+    graphicsCommandStream->CmdPushConstant(Graphics::SHADER_ID_Pass2, &quadConstants, sizeof(quadConstants), "Quad push constants");
+    graphicsCommandStream->CmdDraw(defaultQuad.m_indexBuffer.gpuBufferHandle, DEFAULT_QUAD_NUM_INDICES, 1, 0, 0,
+        Graphics::SHADER_ID_Pass2, Graphics::BlendState::eReplace, Graphics::DepthState::eOff_NoCull,
+        nullptr, 0, "Draw default quad");
+
+    graphicsCommandStream->CmdTimestamp("Pass 2", "Timestamp");
+
+    if (gameGraphicsData.m_gpuInstances.isEnabled)
+        DrawGPUInstanceField(&gameGraphicsData.m_gpuInstances, graphicsCommandStream);
+
+    EndRenderPass(&gameRenderPasses[eRenderPass_MainView], graphicsCommandStream);
+
+    graphicsCommandStream->CmdTimestamp("Instances", "Timestamp");
+}
+
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_DebugUI)
+{
+    DebugUI::Render(graphicsCommandStream, gameGraphicsData.m_rtColorHandle);
+    //graphicsCommandStream->CmdTimestamp("Debug UI", "Timestamp");
+}
+
+static RENDER_GRAPH_PASS_FUNC(RenderGraphPass_SwapChainBlit)
+{
+    const Graphics::ResourceHandle swapChainRT = Graphics::IMAGE_HANDLE_SWAP_CHAIN;
+    graphicsCommandStream->CmdRenderPassBegin(1, &swapChainRT, Graphics::DefaultResHandle_Invalid, currentWindowWidth, currentWindowHeight, "Blit to swap chain");
+
+    graphicsCommandStream->CmdSetScissor(0, 0, currentWindowWidth, currentWindowHeight, "Set render pass scissor state");
+
+    // The main view color target is aliased transient memory with a new bindless slot after every resize, so look it up each frame
+    BindlessQuadPushConstants blitConstants = {};
+    blitConstants.positionBufferIndex = Graphics::GetBindlessIndex(defaultQuad.m_positionBuffer.gpuBufferHandle);
+    blitConstants.srcImageIndex = Graphics::GetBindlessIndex(gameGraphicsData.m_rtColorHandle);
+    graphicsCommandStream->CmdPushConstant(Graphics::SHADER_ID_SWAP_CHAIN_BLIT, &blitConstants, sizeof(blitConstants), "Blit push constants");
+    graphicsCommandStream->CmdDraw(defaultQuad.m_indexBuffer.gpuBufferHandle, DEFAULT_QUAD_NUM_INDICES, 1, 0, 0,
+        Graphics::SHADER_ID_SWAP_CHAIN_BLIT, Graphics::BlendState::eReplace, Graphics::DepthState::eOff_NoCull,
+        nullptr, 0, "Draw default quad");
+
+    graphicsCommandStream->CmdRenderPassEnd("End blit to screen render pass");
+
+    //graphicsCommandStream->CmdTimestamp("Blit to swap chain", "Timestamp");
+}
+
 extern "C"
 GAME_UPDATE(GameUpdate)
 {
-    graphicsCommandStream.m_numCommands = 0;
+    g_graphicsCommandStream.Reset();
+    g_asyncComputeCommandStream.Reset();
 
     if (!isGameInitted)
     {
@@ -237,200 +331,44 @@ GAME_UPDATE(GameUpdate)
         void* descDataBufferMemPtr_Global = Tk::Graphics::MapResource(gameGraphicsData.m_DescDataBufferHandle_Global);
         memcpy(descDataBufferMemPtr_Global, &globalData, sizeof(DescriptorData_Global));
         Tk::Graphics::UnmapResource(gameGraphicsData.m_DescDataBufferHandle_Global);
-    }
 
-    // Transition color buffer
-    {
-        Graphics::GraphicsCommand* command = &graphicsCommandStream.m_graphicsCommands[graphicsCommandStream.m_numCommands];
-
-        // Transition from layout undefined to transfer_dst (required for clear command)
-        command->m_commandType = Graphics::GraphicsCommand::eLayoutTransition;
-        command->debugLabel = "Transition color to transfer_dst";
-        command->m_imageHandle = gameGraphicsData.m_rtColorHandle;
-        command->m_startLayout = Graphics::ImageLayout::eUndefined;
-        command->m_endLayout = Graphics::ImageLayout::eTransferDst;
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
-
-        command->m_commandType = Graphics::GraphicsCommand::eClearImage;
-        command->debugLabel = "Clear color buffer";
-        command->m_imageHandle = gameGraphicsData.m_rtColorHandle;
-        command->m_clearValue = v4f(0.0f, 0.0f, 0.0f, 0.0f);
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
-
-        // Transition from transfer dst to depth_attachment_optimal
-        command->m_commandType = Graphics::GraphicsCommand::eLayoutTransition;
-        command->debugLabel = "Transition color to render_optimal";
-        command->m_imageHandle = gameGraphicsData.m_rtColorHandle;
-        command->m_startLayout = Graphics::ImageLayout::eTransferDst;
-        command->m_endLayout = Graphics::ImageLayout::eRenderOptimal;
-        ++graphicsCommandStream.m_numCommands;
+        if (gameGraphicsData.m_gpuInstances.isEnabled)
+            UpdateGPUInstanceField(&gameGraphicsData.m_gpuInstances);
     }
 
-    // Timestamp start of frame - we do this after the clear to keep it out of the timings
-    {
-        Graphics::GraphicsCommand* command = &graphicsCommandStream.m_graphicsCommands[graphicsCommandStream.m_numCommands];
-        command->CmdTimestamp("Begin Frame", "Timestamp", true);
-        ++graphicsCommandStream.m_numCommands;
-    }
-
-    // Record render commands for main view render
+    // Imgui menus
+    DebugUI::UI_RenderPassStats();
+    DebugUI::UI_GraphicsStats();
+    DebugUI::UI_RenderGraphStats(&g_renderGraph);
+    DebugUI::UI_GPUInstances(&gameGraphicsData.m_gpuInstances.isEnabled, &gameGraphicsData.m_gpuInstances.numInstances,
+        gameGraphicsData.m_gpuInstances.numInstancesCreated);
     {
-        Graphics::DescriptorHandle descriptors[MAX_DESCRIPTOR_SETS_PER_SHADER];
-        descriptors[0] = gameGraphicsData.m_DescData_Global;
-
-        StartRenderPass(&gameRenderPasses[eRenderPass_MainView], &graphicsCommandStream);
-
-        Graphics::GraphicsCommand* command = &graphicsCommandStream.m_graphicsCommands[graphicsCommandStream.m_numCommands];
-        command->m_commandType = Graphics::GraphicsCommand::eSetScissor;
-        command->debugLabel = "Set render pass scissor state";
-        command->m_scissorOffsetX = 0;
-        command->m_scissorOffsetY = 0;
-        command->m_scissorWidth = windowWidth;
-        command->m_scissorHeight = windowHeight;
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
-
-        command->m_commandType = Graphics::GraphicsCommand::eDrawCall;
-        command->debugLabel = "Draw default quad";
-        command->m_numIndices = DEFAULT_QUAD_NUM_INDICES;
-        command->m_numInstances = 1;
-        command->m_vertOffset = 0;
-        command->m_indexOffset = 0;
-        command->m_indexBufferHandle = defaultQuad.m_indexBuffer.gpuBufferHandle;
-        command->m_shader = Graphics::SHADER_ID_Pass1;
-        command->m_blendState = Graphics::BlendState::eReplace;
-        command->m_depthState = Graphics::DepthState::eOff_NoCull;
-        for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-        {
-            command->m_descriptors[i] = Graphics::DefaultDescHandle_Invalid;
-        }
-        command->m_descriptors[0] = defaultQuad.m_descriptor;
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
-
-        command->CmdTimestamp("Pass 1", "Timestamp");
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
-
-        command->m_commandType = Graphics::GraphicsCommand::eDrawCall;
-        command->debugLabel = "Draw default quad";
-        command->m_numIndices = DEFAULT_QUAD_NUM_INDICES;
-        command->m_numInstances = 1;
-        command->m_vertOffset = 0;
-        command->m_indexOffset = 0;
-        command->m_indexBufferHandle = defaultQuad.m_indexBuffer.gpuBufferHandle;
-        command->m_shader = Graphics::SHADER_ID_Pass2;
-        command->m_blendState = Graphics::BlendState::eReplace;
-        command->m_depthState = Graphics::DepthState::eOff_NoCull;
-        for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
+        const char* kernelNames[COMPUTE_BENCH_KERNELS_MAX] = {};
+        const uint32 numKernels = GetNumComputeKernels();
+        for (uint32 uiKernel = 0; uiKernel < numKernels; ++uiKernel)
         {
-            command->m_descriptors[i] = Graphics::DefaultDescHandle_Invalid;
+            kernelNames[uiKernel] = GetComputeKernelName(uiKernel);
         }
-        command->m_descriptors[0] = defaultQuad.m_descriptor;
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
-
-        EndRenderPass(&gameRenderPasses[eRenderPass_MainView], &graphicsCommandStream);
-
-        command = &graphicsCommandStream.m_graphicsCommands[graphicsCommandStream.m_numCommands];
-        command->CmdTimestamp("Pass 2", "Timestamp");
-        ++graphicsCommandStream.m_numCommands;
-        ++command;
+        DebugUI::UI_ComputeBenchmark(&gameGraphicsData.m_computeBenchmark.isEnabled, &gameGraphicsData.m_computeBenchmark.kernel,
+            kernelNames, numKernels, &gameGraphicsData.m_computeBenchmark.numElements, COMPUTE_BENCH_ELEMENTS_MAX);
+        DebugUI::UI_ShaderVariants(GetComputeKernelShaderID(gameGraphicsData.m_computeBenchmark.kernel));
     }
+    DebugUI::UI_FileReadBenchmark();
+    DebugUI::UI_MeshLoadBenchmark();
 
-    // Imgui menus
-    DebugUI::UI_RenderPassStats();
-    DebugUI::Render(&graphicsCommandStream, gameGraphicsData.m_rtColorHandle);
-    /*{
-        Graphics::GraphicsCommand* command = &graphicsCommandStream.m_graphicsCommands[graphicsCommandStream.m_numCommands];
-        command->CmdTimestamp("Debug UI", "Timestamp");
-        ++graphicsCommandStream.m_numCommands;
-    }*/
+    // Record the frame's passes along with the barriers the graph compiled for them
+    g_renderGraph.Execute(&g_graphicsCommandStream);
 
-    // FINAL BLIT TO SWAP CHAIN
-    Graphics::GraphicsCommand* command = &graphicsCommandStream.m_graphicsCommands[graphicsCommandStream.m_numCommands];
-
-    // Transition main view render target from render optimal to shader read
-    command->m_commandType = Graphics::GraphicsCommand::eLayoutTransition;
-    command->debugLabel = "Transition main view render target to shader read for blit";
-    command->m_imageHandle = gameGraphicsData.m_rtColorHandle;
-    command->m_startLayout = Graphics::ImageLayout::eRenderOptimal;
-    command->m_endLayout = Graphics::ImageLayout::eShaderRead;
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    // Transition of swap chain to render optimal
-    command->m_commandType = Graphics::GraphicsCommand::eLayoutTransition;
-    command->debugLabel = "Transition swap chain to render_optimal";
-    command->m_imageHandle = Graphics::IMAGE_HANDLE_SWAP_CHAIN;
-    command->m_startLayout = Graphics::ImageLayout::eUndefined;
-    command->m_endLayout = Graphics::ImageLayout::eRenderOptimal;
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    command->m_commandType = Graphics::GraphicsCommand::eRenderPassBegin;
-    command->debugLabel = "Blit to swap chain";
-    command->m_numColorRTs = 1;
-    command->m_colorRTs[0] = Graphics::IMAGE_HANDLE_SWAP_CHAIN;
-    command->m_depthRT = Graphics::DefaultResHandle_Invalid;
-    command->m_renderWidth = windowWidth;
-    command->m_renderHeight = windowHeight;
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    command->m_commandType = Graphics::GraphicsCommand::eSetScissor;
-    command->debugLabel = "Set render pass scissor state";
-    command->m_scissorOffsetX = 0;
-    command->m_scissorOffsetY = 0;
-    command->m_scissorWidth = windowWidth;
-    command->m_scissorHeight = windowHeight;
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    command->m_commandType = Graphics::GraphicsCommand::eDrawCall;
-    command->debugLabel = "Draw default quad";
-    command->m_numIndices = DEFAULT_QUAD_NUM_INDICES;
-    command->m_numInstances = 1;
-    command->m_vertOffset = 0;
-    command->m_indexOffset = 0;
-    command->m_indexBufferHandle = defaultQuad.m_indexBuffer.gpuBufferHandle;
-    command->m_shader = Graphics::SHADER_ID_SWAP_CHAIN_BLIT;
-    command->m_blendState = Graphics::BlendState::eReplace;
-    command->m_depthState = Graphics::DepthState::eOff_NoCull;
-    for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-    {
-        command->m_descriptors[i] = Graphics::DefaultDescHandle_Invalid;
-    }
-    command->m_descriptors[0] = gameGraphicsData.m_swapChainBlitDescHandle;
-    command->m_descriptors[1] = defaultQuad.m_descriptor;
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    command->m_commandType = Graphics::GraphicsCommand::eRenderPassEnd;
-    command->debugLabel = "End blit to screen render pass";
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    // Transition of swap chain from render optimal to present
-    command->m_commandType = Graphics::GraphicsCommand::eLayoutTransition;
-    command->debugLabel = "Transition swap chain to present";
-    command->m_imageHandle = Graphics::IMAGE_HANDLE_SWAP_CHAIN;
-    command->m_startLayout = Graphics::ImageLayout::eRenderOptimal;
-    command->m_endLayout = Graphics::ImageLayout::ePresent;
-    ++graphicsCommandStream.m_numCommands;
-    ++command;
-
-    /*command->CmdTimestamp("Blit to swap chain", "Timestamp");
-    ++graphicsCommandStream.m_numCommands;
-    ++command;*/
+    // Nothing in the frame reads the benchmark's results, so it can overlap the frame's passes
+    if (gameGraphicsData.m_computeBenchmark.isEnabled)
+        RecordComputeBenchmark(&gameGraphicsData.m_computeBenchmark, &g_asyncComputeCommandStream);
 
     // Process recorded graphics command stream
     {
         //TIMED_SCOPED_BLOCK("Graphics command stream processing");
         Tk::Graphics::BeginFrameRecording();
-        Tk::Graphics::ProcessGraphicsCommandStream(&graphicsCommandStream, false);
+        Tk::Graphics::ProcessAsyncComputeCommandStream(&g_asyncComputeCommandStream);
+        Tk::Graphics::ProcessGraphicsCommandStream(&g_graphicsCommandStream, false);
         Tk::Graphics::EndFrameRecording();
         Tk::Graphics::SubmitFrameToGPU();
     }
@@ -453,7 +391,8 @@ GAME_UPDATE(GameUpdate)
 
 static void DestroyWindowResizeDependentResources()
 {
-    Graphics::DestroyResource(gameGraphicsData.m_rtColorHandle);
+    g_renderGraph.DestroyTransientImages();
+    gameGraphicsData.m_rtColorHandle = Graphics::DefaultResHandle_Invalid;
 }
 
 extern "C"
@@ -466,9 +405,11 @@ GAME_WINDOW_RESIZE(GameWindowResize)
     }
     else
     {
+        TIMED_SCOPED_BLOCK("Window resize");
+
+        // Only the swap chain and size-dependent render targets are recreated, PSOs are unaffected
         isWindowMinimized = false;
         Tk::Graphics::WindowResize();
-        Tk::Graphics::ShaderManager::CreateWindowDependentResources(newWindowWidth, newWindowHeight);
 
         currentWindowWidth = newWindowWidth;
         currentWindowHeight = newWindowHeight;
@@ -478,7 +419,6 @@ GAME_WINDOW_RESIZE(GameWindowResize)
         g_projMat = PerspectiveProjectionMatrix((float)currentWindowWidth / currentWindowHeight);
 
         CreateGameRenderingResources(newWindowWidth, newWindowHeight);
-        WriteSwapChainBlitResources();
     }
 }
 
@@ -496,10 +436,13 @@ GAME_DESTROY(GameDestroy)
         DestroyDefaultGeometryVertexBufferDescriptor(defaultQuad);
         
         DestroyAnimatedPoly(&gameGraphicsData.m_animatedPolygon);
+        DestroyGPUInstanceField(&gameGraphicsData.m_gpuInstances);
+        DestroyComputeBenchmark(&gameGraphicsData.m_computeBenchmark);
 
         // Shutdown graphics
         Tk::Graphics::ShaderManager::Shutdown();
         Tk::Graphics::DestroyContext();
-        Tk::Core::CoreFreeAligned(graphicsCommandStream.m_graphicsCommands);
+        g_graphicsCommandStream.Destroy();
+        g_asyncComputeCommandStream.Destroy();
     }
 }
@@ -1,10 +1,11 @@
 #include "GraphicsTypes.h"
+#include "Graphics/Common/ShaderManager.h"
 
 #include <string.h>
 
 using namespace Tk;
 
-void CreateDefaultGeometry(Graphics::GraphicsCommandStream* graphicsCommandStream)
+void CreateDefaultGeometry()
 {
     // Default Quad
     {
@@ -17,93 +18,29 @@ void CreateDefaultGeometry(Graphics::GraphicsCommandStream* graphicsCommandStrea
         desc.bufferUsage = Graphics::BufferUsage::eVertex;
         defaultQuad.m_positionBuffer.gpuBufferHandle = Graphics::CreateResource(desc);
 
-        desc.bufferUsage = Graphics::BufferUsage::eStaging;
-        Graphics::ResourceHandle stagingBufferHandle_Pos = Graphics::CreateResource(desc);
-        void* stagingBufferMemPtr_Pos = Graphics::MapResource(stagingBufferHandle_Pos);
-
         // UVs
         desc.dims = v3ui(sizeof(defaultQuad.m_uvs), 0, 0);
         desc.bufferUsage = Graphics::BufferUsage::eVertex;
         defaultQuad.m_uvBuffer.gpuBufferHandle = Graphics::CreateResource(desc);
 
-        desc.bufferUsage = Graphics::BufferUsage::eStaging;
-        Graphics::ResourceHandle stagingBufferHandle_UV = Graphics::CreateResource(desc);
-        void* stagingBufferMemPtr_UV = Graphics::MapResource(stagingBufferHandle_UV);
-
         // Normals
         desc.dims = v3ui(sizeof(defaultQuad.m_normals), 0, 0);
         desc.bufferUsage = Graphics::BufferUsage::eVertex;
         defaultQuad.m_normalBuffer.gpuBufferHandle = Graphics::CreateResource(desc);
 
-        desc.bufferUsage = Graphics::BufferUsage::eStaging;
-        Graphics::ResourceHandle stagingBufferHandle_Norm = Graphics::CreateResource(desc);
-        void* stagingBufferMemPtr_Norm = Graphics::MapResource(stagingBufferHandle_Norm);
-
         // Indices
         desc.dims = v3ui(sizeof(defaultQuad.m_indices), 0, 0);
         desc.bufferUsage = Graphics::BufferUsage::eIndex;
         defaultQuad.m_indexBuffer.gpuBufferHandle = Graphics::CreateResource(desc);
 
-        desc.bufferUsage = Graphics::BufferUsage::eStaging;
-        Graphics::ResourceHandle stagingBufferHandle_Idx = Graphics::CreateResource(desc);
-        void* stagingBufferMemPtr_Idx = Graphics::MapResource(stagingBufferHandle_Idx);
-
         // Descriptor
         CreateDefaultGeometryVertexBufferDescriptor(defaultQuad);
 
-        // Memcpy into staging buffers
-        memcpy(stagingBufferMemPtr_Pos, defaultQuad.m_points, sizeof(defaultQuad.m_points));
-        memcpy(stagingBufferMemPtr_UV, defaultQuad.m_uvs, sizeof(defaultQuad.m_uvs));
-        memcpy(stagingBufferMemPtr_Norm, defaultQuad.m_normals, sizeof(defaultQuad.m_normals));
-        memcpy(stagingBufferMemPtr_Idx, defaultQuad.m_indices, sizeof(defaultQuad.m_indices));
-
-        // Do GPU buffer copies
-        Graphics::GraphicsCommand* command = &graphicsCommandStream->m_graphicsCommands[graphicsCommandStream->m_numCommands];
-        command->m_commandType = Graphics::GraphicsCommand::eMemTransfer;
-        command->debugLabel = "Update Default Quad Vtx Pos Buf";
-        command->m_sizeInBytes = sizeof(defaultQuad.m_points);
-        command->m_dstBufferHandle = defaultQuad.m_positionBuffer.gpuBufferHandle;
-        command->m_srcBufferHandle = stagingBufferHandle_Pos;
-        ++graphicsCommandStream->m_numCommands;
-        ++command;
-
-        command->m_commandType = Graphics::GraphicsCommand::eMemTransfer;
-        command->debugLabel = "Update Default Quad Vtx UV Buf";
-        command->m_sizeInBytes = sizeof(defaultQuad.m_uvs);
-        command->m_dstBufferHandle = defaultQuad.m_uvBuffer.gpuBufferHandle;
-        command->m_srcBufferHandle = stagingBufferHandle_UV;
-        ++graphicsCommandStream->m_numCommands;
-        ++command;
-
-        command->m_commandType = Graphics::GraphicsCommand::eMemTransfer;
-        command->debugLabel = "Update Default Quad Vtx Norm Buf";
-        command->m_sizeInBytes = sizeof(defaultQuad.m_normals);
-        command->m_dstBufferHandle = defaultQuad.m_normalBuffer.gpuBufferHandle;
-        command->m_srcBufferHandle = stagingBufferHandle_Norm;
-        ++graphicsCommandStream->m_numCommands;
-        ++command;
-
-        command->m_commandType = Graphics::GraphicsCommand::eMemTransfer;
-        command->debugLabel = "Update Default Quad Vtx Idx Buf";
-        command->m_sizeInBytes = sizeof(defaultQuad.m_indices);
-        command->m_dstBufferHandle = defaultQuad.m_indexBuffer.gpuBufferHandle;
-        command->m_srcBufferHandle = stagingBufferHandle_Idx;
-        ++graphicsCommandStream->m_numCommands;
-        ++command;
-
-        Graphics::SubmitCmdsImmediate(graphicsCommandStream);
-        graphicsCommandStream->m_numCommands = 0; // reset the cmd counter for the stream
-
-        // Unmap + destroy resources
-        Graphics::UnmapResource(stagingBufferHandle_Pos);
-        Graphics::UnmapResource(stagingBufferHandle_UV);
-        Graphics::UnmapResource(stagingBufferHandle_Norm);
-        Graphics::UnmapResource(stagingBufferHandle_Idx);
-
-        Graphics::DestroyResource(stagingBufferHandle_Pos);
-        Graphics::DestroyResource(stagingBufferHandle_UV);
-        Graphics::DestroyResource(stagingBufferHandle_Norm);
-        Graphics::DestroyResource(stagingBufferHandle_Idx);
+        // Staged uploads, batched with any other uploads until the caller submits them
+        Graphics::UploadBufferData(defaultQuad.m_positionBuffer.gpuBufferHandle, 0, defaultQuad.m_points, sizeof(defaultQuad.m_points));
+        Graphics::UploadBufferData(defaultQuad.m_uvBuffer.gpuBufferHandle, 0, defaultQuad.m_uvs, sizeof(defaultQuad.m_uvs));
+        Graphics::UploadBufferData(defaultQuad.m_normalBuffer.gpuBufferHandle, 0, defaultQuad.m_normals, sizeof(defaultQuad.m_normals));
+        Graphics::UploadBufferData(defaultQuad.m_indexBuffer.gpuBufferHandle, 0, defaultQuad.m_indices, sizeof(defaultQuad.m_indices));
     }
 }
 
@@ -151,24 +88,18 @@ DefaultGeometry<DEFAULT_QUAD_NUM_VERTICES, DEFAULT_QUAD_NUM_INDICES> defaultQuad
 
 void CreateAnimatedPoly(TransientPrim* prim)
 {
-    Graphics::ResourceDesc desc;
-    desc.resourceType = Graphics::ResourceType::eBuffer1D;
-
     prim->numVertices = 150;
+    prim->numIndices = 0;
+    prim->vertOffset = 0;
+    prim->indexOffset = 0;
+    prim->frameCtr = 0;
 
-    desc.dims = v3ui(prim->numVertices * sizeof(v4f), 0, 0);
-    desc.bufferUsage = Graphics::BufferUsage::eTransientVertex;
-    prim->vertexBufferHandle = Graphics::CreateResource(desc);
-    desc.bufferUsage = Graphics::BufferUsage::eTransientIndex;
-    desc.dims = v3ui((prim->numVertices - 1) * 3 * sizeof(uint32), 0, 0);
-    prim->indexBufferHandle = Graphics::CreateResource(desc);
-
-    // Descriptor - vertex buffer
+    // Descriptor - vertex buffer, the draw's vertex offset selects this frame's vertices within the ring
     prim->descriptor = Graphics::CreateDescriptor(Graphics::DESCLAYOUT_ID_POSONLY_VBS);
 
     Graphics::DescriptorSetDataHandles descDataHandles[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
     descDataHandles[0].InitInvalid();
-    descDataHandles[0].handles[0] = prim->vertexBufferHandle;
+    descDataHandles[0].handles[0] = Graphics::GetTransientUploadRing();
     descDataHandles[1].InitInvalid();
     descDataHandles[2].InitInvalid();
 
@@ -177,23 +108,28 @@ void CreateAnimatedPoly(TransientPrim* prim)
 
 void DestroyAnimatedPoly(TransientPrim* prim)
 {
-    Graphics::DestroyResource(prim->indexBufferHandle);
-    prim->indexBufferHandle = Graphics::DefaultResHandle_Invalid;
-    Graphics::DestroyResource(prim->vertexBufferHandle);
-    prim->vertexBufferHandle = Graphics::DefaultResHandle_Invalid;
-
     Graphics::DestroyDescriptor(prim->descriptor);
     prim->descriptor = Graphics::DefaultDescHandle_Invalid;
 }
 
 void UpdateAnimatedPoly(TransientPrim* prim)
 {
-    // Map
-    void* indexBuf = Graphics::MapResource(prim->indexBufferHandle);
-    void* vertexBuf = Graphics::MapResource(prim->vertexBufferHandle);
+    // Sub-allocate this frame's data, offsets have to be whole elements for the draw call
+    const uint32 numIndices = ((prim->numVertices - 1) * 3);
+    Graphics::TransientAllocation indexAlloc = Graphics::AllocTransient(numIndices * sizeof(uint32), sizeof(uint32));
+    Graphics::TransientAllocation vertexAlloc = Graphics::AllocTransient(prim->numVertices * sizeof(v4f), sizeof(v4f));
+    if (!indexAlloc.cpuPtr || !vertexAlloc.cpuPtr)
+    {
+        prim->numIndices = 0;
+        return;
+    }
+    prim->numIndices = numIndices;
+    prim->indexOffset = indexAlloc.offset / sizeof(uint32);
+    prim->vertOffset = vertexAlloc.offset / sizeof(v4f);
+    void* indexBuf = indexAlloc.cpuPtr;
+    void* vertexBuf = vertexAlloc.cpuPtr;
 
     // Update
-    const uint32 numIndices = ((prim->numVertices - 1) * 3);
     for (uint32 idx = 0; idx < numIndices; idx += 3)
     {
         ((uint32*)indexBuf)[idx + 0] = 0;
@@ -201,8 +137,7 @@ void UpdateAnimatedPoly(TransientPrim* prim)
         ((uint32*)indexBuf)[idx + 2] = idx < numIndices - 3 ? idx / 3 + 2 : 1;
     }
 
-    static uint32 frameCtr = 0;
-    ++frameCtr;
+    const uint32 frameCtr = ++prim->frameCtr;
     for (uint32 vtx = 0; vtx < prim->numVertices; ++vtx)
     {
         if (vtx == 0)
@@ -217,32 +152,379 @@ void UpdateAnimatedPoly(TransientPrim* prim)
             ((v4f*)vertexBuf)[vtx] = v4f(cosf(amt) * scale, sinf(amt) * scale, 0.0f, 1.0f);
         }
     }
-
-    // Unmap
-    Graphics::UnmapResource(prim->indexBufferHandle);
-    Graphics::UnmapResource(prim->vertexBufferHandle);
 }
 
 void DrawAnimatedPoly(TransientPrim* prim, Graphics::DescriptorHandle globalData, uint32 shaderID, uint32 blendState, uint32 depthState, Graphics::GraphicsCommandStream* graphicsCommandStream)
 {
-    Graphics::GraphicsCommand* command = &graphicsCommandStream->m_graphicsCommands[graphicsCommandStream->m_numCommands];
+    if (prim->numIndices == 0)
+        return;
 
-    command->m_commandType = Graphics::GraphicsCommand::eDrawCall;
-    command->debugLabel = "Draw animated poly";
-    command->m_numIndices = (prim->numVertices - 1) * 3;
-    command->m_numInstances = 1;
-    command->m_vertOffset = 0;
-    command->m_indexOffset = 0;
-    command->m_indexBufferHandle = prim->indexBufferHandle;
-    command->m_shader = shaderID;
-    command->m_blendState = blendState;
-    command->m_depthState = depthState;
+    const Graphics::DescriptorHandle descriptors[] = { globalData, prim->descriptor };
+    graphicsCommandStream->CmdDraw(Graphics::GetTransientUploadRing(), prim->numIndices, 1, prim->vertOffset, prim->indexOffset,
+        shaderID, blendState, depthState, descriptors, ARRAYCOUNT(descriptors), "Draw animated poly");
+}
+
+void CreateGPUInstanceField(GPUInstanceField* field, uint32 numInstances)
+{
+    TINKER_ASSERT(numInstances && numInstances <= GPU_INSTANCES_MAX);
+    *field = {};
+    field->numInstancesCreated = numInstances;
+    field->numInstances = numInstances;
+    field->viewScale = 1.0f;
 
-    for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
+    Graphics::ResourceDesc desc;
+    desc.resourceType = Graphics::ResourceType::eBuffer1D;
+    desc.dims = v3ui(numInstances * (uint32)sizeof(GPUInstance), 0, 0);
+    desc.bufferUsage = Graphics::BufferUsage::eVertex;
+    desc.debugLabel = "GPU instances";
+    field->instanceBuffer = Graphics::CreateResource(desc);
+
+    desc.dims = v3ui(numInstances * (uint32)sizeof(uint32), 0, 0);
+    desc.debugLabel = "GPU visible instances";
+    field->visibleInstanceBuffer = Graphics::CreateResource(desc);
+
+    desc.dims = v3ui(GPU_DRAW_ARGS_COUNT_OFFSET + sizeof(uint32), 0, 0);
+    desc.bufferUsage = Graphics::BufferUsage::eIndirectArgs;
+    desc.debugLabel = "GPU instance draw args";
+    field->drawArgsBuffer = Graphics::CreateResource(desc);
+
+    // Square grid over [-16, 16], uploaded in chunks so that the cpu copy stays small whatever the instance count
+    const uint32 gridDim = (uint32)ceilf(sqrtf((float)numInstances));
+    const float worldExtent = 16.0f;
+    const float spacing = (2.0f * worldExtent) / gridDim;
+
+    const uint32 chunkNumInstances = 64 * 1024;
+    static GPUInstance chunk[chunkNumInstances];
+    for (uint32 chunkStart = 0; chunkStart < numInstances; chunkStart += chunkNumInstances)
     {
-        command->m_descriptors[i] = Graphics::DefaultDescHandle_Invalid;
+        const uint32 numInChunk = Min(chunkNumInstances, numInstances - chunkStart);
+        for (uint32 uiInst = 0; uiInst < numInChunk; ++uiInst)
+        {
+            const uint32 instanceIndex = chunkStart + uiInst;
+            GPUInstance& instance = chunk[uiInst];
+            instance.center = v2f(((instanceIndex % gridDim) + 0.5f) * spacing - worldExtent, ((instanceIndex / gridDim) + 0.5f) * spacing - worldExtent);
+            instance.radius = spacing * 0.4f;
+            instance.colorSeed = (float)(instanceIndex % 997) / 997.0f;
+        }
+        Graphics::UploadBufferData(field->instanceBuffer, chunkStart * (uint32)sizeof(GPUInstance), chunk, numInChunk * (uint32)sizeof(GPUInstance));
+    }
+}
+
+void DestroyGPUInstanceField(GPUInstanceField* field)
+{
+    Graphics::DestroyResource(field->instanceBuffer);
+    Graphics::DestroyResource(field->visibleInstanceBuffer);
+    Graphics::DestroyResource(field->drawArgsBuffer);
+    *field = {};
+}
+
+void UpdateGPUInstanceField(GPUInstanceField* field)
+{
+    // Pan and zoom across the field so that the visible set changes every frame
+    ++field->frameCtr;
+    const float t = (float)field->frameCtr * 0.01f;
+    field->viewOffset = v2f(cosf(t * 0.7f) * 12.0f, sinf(t) * 12.0f);
+    field->viewScale = 0.25f + 0.875f * (sinf(t * 0.3f) + 1.0f);
+}
+
+static GPUCullingPushConstants GetGPUCullingPushConstants(const GPUInstanceField* field)
+{
+    GPUCullingPushConstants pushConstants = {};
+    pushConstants.positionBufferIndex = Graphics::GetBindlessIndex(defaultQuad.m_positionBuffer.gpuBufferHandle);
+    pushConstants.instanceBufferIndex = Graphics::GetBindlessIndex(field->instanceBuffer);
+    pushConstants.visibleInstanceBufferIndex = Graphics::GetBindlessIndex(field->visibleInstanceBuffer);
+    pushConstants.drawArgsBufferIndex = Graphics::GetBindlessIndex(field->drawArgsBuffer);
+    pushConstants.numInstances = Min(field->numInstances, field->numInstancesCreated);
+    pushConstants.viewScale = field->viewScale;
+    pushConstants.viewOffset = field->viewOffset;
+    return pushConstants;
+}
+
+void CullGPUInstanceField(GPUInstanceField* field, Graphics::GraphicsCommandStream* graphicsCommandStream)
+{
+    // Reset the draw args from the upload ring, the culling shader counts the visible instances into them
+    Graphics::TransientAllocation argsAlloc = Graphics::AllocTransient(GPU_DRAW_ARGS_COUNT_OFFSET + sizeof(uint32), sizeof(uint32));
+    if (!argsAlloc.cpuPtr)
+        return;
+
+    Graphics::GPUDrawIndexedIndirectArgs drawArgs = {};
+    drawArgs.indexCount = DEFAULT_QUAD_NUM_INDICES;
+    const uint32 drawCount = 0; // set by the first visible instance
+    memcpy(argsAlloc.cpuPtr, &drawArgs, sizeof(drawArgs));
+    memcpy((uint8*)argsAlloc.cpuPtr + GPU_DRAW_ARGS_COUNT_OFFSET, &drawCount, sizeof(drawCount));
+
+    // Previous frames may still be reading the buffers
+    Graphics::BufferBarrier barriers[2] = {};
+    barriers[0].bufferHandle = field->drawArgsBuffer;
+    barriers[0].srcAccess = Graphics::BufferAccess::eIndirectArgs;
+    barriers[0].dstAccess = Graphics::BufferAccess::eTransferDst;
+    barriers[1].bufferHandle = field->visibleInstanceBuffer;
+    barriers[1].srcAccess = Graphics::BufferAccess::eVertexShaderRead;
+    barriers[1].dstAccess = Graphics::BufferAccess::eComputeReadWrite;
+    graphicsCommandStream->CmdBufferBarriers(barriers, ARRAYCOUNT(barriers), "GPU instance culling - WAR barriers");
+
+    graphicsCommandStream->CmdMemTransfer(argsAlloc.sizeInBytes, Graphics::GetTransientUploadRing(), argsAlloc.offset,
+        field->drawArgsBuffer, 0, "Reset GPU instance draw args");
+
+    barriers[0].srcAccess = Graphics::BufferAccess::eTransferDst;
+    barriers[0].dstAccess = Graphics::BufferAccess::eComputeReadWrite;
+    graphicsCommandStream->CmdBufferBarriers(barriers, 1, "GPU instance draw args reset barrier");
+
+    const GPUCullingPushConstants pushConstants = GetGPUCullingPushConstants(field);
+    graphicsCommandStream->CmdPushConstant(Graphics::SHADER_ID_CULL_INSTANCES_CS, &pushConstants, sizeof(pushConstants), "GPU culling push constants");
+    graphicsCommandStream->CmdDispatch(Graphics::SHADER_ID_CULL_INSTANCES_CS,
+        (pushConstants.numInstances + GPU_CULLING_GROUP_SIZE - 1) / GPU_CULLING_GROUP_SIZE, 1, 1, "Cull GPU instances");
+
+    barriers[0].srcAccess = Graphics::BufferAccess::eComputeReadWrite;
+    barriers[0].dstAccess = Graphics::BufferAccess::eIndirectArgs;
+    barriers[1].srcAccess = Graphics::BufferAccess::eComputeReadWrite;
+    barriers[1].dstAccess = Graphics::BufferAccess::eVertexShaderRead;
+    graphicsCommandStream->CmdBufferBarriers(barriers, ARRAYCOUNT(barriers), "GPU instance culling results barriers");
+}
+
+void DrawGPUInstanceField(GPUInstanceField* field, Graphics::GraphicsCommandStream* graphicsCommandStream)
+{
+    const GPUCullingPushConstants pushConstants = GetGPUCullingPushConstants(field);
+    graphicsCommandStream->CmdPushConstant(Graphics::SHADER_ID_INSTANCES, &pushConstants, sizeof(pushConstants), "GPU instance push constants");
+    graphicsCommandStream->CmdDrawIndirect(defaultQuad.m_indexBuffer.gpuBufferHandle,
+        field->drawArgsBuffer, 0, field->drawArgsBuffer, GPU_DRAW_ARGS_COUNT_OFFSET, 1,
+        Graphics::SHADER_ID_INSTANCES, Graphics::BlendState::eReplace, Graphics::DepthState::eOff_NoCull,
+        nullptr, 0, "Draw GPU instances");
+}
+
+static const char* g_ComputeKernelNames[ComputeKernel::eMax] =
+{
+    "Reduction",
+    "Prefix sum",
+    "Blur",
+};
+
+static const uint32 g_ComputeKernelShaderIDs[ComputeKernel::eMax] =
+{
+    Graphics::SHADER_ID_BENCH_REDUCE_CS,
+    Graphics::SHADER_ID_BENCH_PREFIX_SUM_CS,
+    Graphics::SHADER_ID_BENCH_BLUR_CS,
+};
+
+static uint32 GetDiscoveredComputeKernels(uint32* outShaderIDs)
+{
+    return Graphics::ShaderManager::GetDiscoveredComputeShaders("bench_", outShaderIDs, SHADER_DISCOVERED_MAX);
+}
+
+uint32 GetNumComputeKernels()
+{
+    uint32 shaderIDs[SHADER_DISCOVERED_MAX] = {};
+    return ComputeKernel::eMax + GetDiscoveredComputeKernels(shaderIDs);
+}
+
+const char* GetComputeKernelName(uint32 kernel)
+{
+    if (kernel < ComputeKernel::eMax)
+        return g_ComputeKernelNames[kernel];
+
+    const char* spvFilename = Graphics::ShaderManager::GetShaderName(GetComputeKernelShaderID(kernel));
+    return spvFilename ? spvFilename : "Unknown";
+}
+
+uint32 GetComputeKernelShaderID(uint32 kernel)
+{
+    if (kernel < ComputeKernel::eMax)
+        return g_ComputeKernelShaderIDs[kernel];
+
+    uint32 shaderIDs[SHADER_DISCOVERED_MAX] = {};
+    const uint32 numDiscovered = GetDiscoveredComputeKernels(shaderIDs);
+    TINKER_ASSERT(kernel - ComputeKernel::eMax < numDiscovered);
+    return shaderIDs[kernel - ComputeKernel::eMax];
+}
+
+void CreateComputeBenchmark(ComputeBenchmark* bench)
+{
+    *bench = {};
+    bench->numElements = COMPUTE_BENCH_ELEMENTS_MAX;
+    bench->kernel = ComputeKernel::eReduction;
+
+    Graphics::ResourceDesc desc;
+    desc.resourceType = Graphics::ResourceType::eBuffer1D;
+    desc.dims = v3ui(COMPUTE_BENCH_ELEMENTS_MAX * (uint32)sizeof(uint32), 0, 0);
+    desc.bufferUsage = Graphics::BufferUsage::eVertex;
+    desc.debugLabel = "Compute bench src";
+    bench->srcBuffer = Graphics::CreateResource(desc);
+
+    desc.debugLabel = "Compute bench dst";
+    bench->dstBuffer = Graphics::CreateResource(desc);
+
+    desc.dims = v3ui(COMPUTE_BENCH_RESULT_OFFSET + sizeof(uint32), 0, 0);
+    desc.bufferUsage = Graphics::BufferUsage::eIndirectArgs;
+    desc.debugLabel = "Compute bench args";
+    bench->argsBuffer = Graphics::CreateResource(desc);
+
+    Graphics::ResourceDesc imageDesc;
+    imageDesc.resourceType = Graphics::ResourceType::eImage2D;
+    imageDesc.dims = v3ui(COMPUTE_BENCH_IMAGE_DIM, COMPUTE_BENCH_IMAGE_DIM, 1);
+    imageDesc.imageFormat = Graphics::ImageFormat::RGBA16_Float;
+    imageDesc.arrayEles = 1;
+    imageDesc.isStorage = true;
+    imageDesc.debugLabel = "Compute bench image 0";
+    bench->images[0] = Graphics::CreateResource(imageDesc);
+    imageDesc.debugLabel = "Compute bench image 1";
+    bench->images[1] = Graphics::CreateResource(imageDesc);
+
+    // Small pseudo random values so that the sum of every element still fits in 32 bits
+    const uint32 chunkNumElements = 64 * 1024;
+    static uint32 chunk[chunkNumElements];
+    for (uint32 chunkStart = 0; chunkStart < COMPUTE_BENCH_ELEMENTS_MAX; chunkStart += chunkNumElements)
+    {
+        for (uint32 uiEle = 0; uiEle < chunkNumElements; ++uiEle)
+        {
+            chunk[uiEle] = ((chunkStart + uiEle) * 2654435761u) >> 28;
+        }
+        Graphics::UploadBufferData(bench->srcBuffer, chunkStart * (uint32)sizeof(uint32), chunk, chunkNumElements * (uint32)sizeof(uint32));
+    }
+}
+
+void DestroyComputeBenchmark(ComputeBenchmark* bench)
+{
+    Graphics::DestroyResource(bench->srcBuffer);
+    Graphics::DestroyResource(bench->dstBuffer);
+    Graphics::DestroyResource(bench->argsBuffer);
+    Graphics::DestroyResource(bench->images[0]);
+    Graphics::DestroyResource(bench->images[1]);
+    *bench = {};
+}
+
+static void RecordComputeBenchmarkBufferKernel(ComputeBenchmark* bench, ComputeBenchPushConstants* pushConstants, uint32 shaderID,
+    Graphics::GraphicsCommandStream* graphicsCommandStream)
+{
+    uint32 threadGroupSize[3] = {};
+    if (!Graphics::ShaderManager::GetThreadGroupSize(shaderID, threadGroupSize) || !threadGroupSize[0])
+        return;
+
+    // Group count and zeroed reduction result, from the upload ring
+    Graphics::TransientAllocation argsAlloc = Graphics::AllocTransient(COMPUTE_BENCH_RESULT_OFFSET + sizeof(uint32), sizeof(uint32));
+    if (!argsAlloc.cpuPtr)
+        return;
+
+    Graphics::GPUDispatchIndirectArgs dispatchArgs = {};
+    dispatchArgs.groupCountX = (pushConstants->numElements + threadGroupSize[0] - 1) / threadGroupSize[0];
+    dispatchArgs.groupCountY = 1;
+    dispatchArgs.groupCountZ = 1;
+    const uint32 result = 0;
+    memcpy(argsAlloc.cpuPtr, &dispatchArgs, sizeof(dispatchArgs));
+    memcpy((uint8*)argsAlloc.cpuPtr + COMPUTE_BENCH_RESULT_OFFSET, &result, sizeof(result));
+
+    // Previous frames may still be using the buffers
+    Graphics::BufferBarrier barriers[2] = {};
+    barriers[0].bufferHandle = bench->argsBuffer;
+    barriers[0].srcAccess = Graphics::BufferAccess::eComputeReadWrite;
+    barriers[0].dstAccess = Graphics::BufferAccess::eTransferDst;
+    barriers[1].bufferHandle = bench->dstBuffer;
+    barriers[1].srcAccess = Graphics::BufferAccess::eComputeReadWrite;
+    barriers[1].dstAccess = Graphics::BufferAccess::eComputeReadWrite;
+    graphicsCommandStream->CmdBufferBarriers(barriers, ARRAYCOUNT(barriers), "Compute bench - WAR barriers");
+
+    graphicsCommandStream->CmdMemTransfer(argsAlloc.sizeInBytes, Graphics::GetTransientUploadRing(), argsAlloc.offset,
+        bench->argsBuffer, 0, "Reset compute bench args");
+
+    barriers[0].srcAccess = Graphics::BufferAccess::eTransferDst;
+    barriers[0].dstAccess = Graphics::BufferAccess::eIndirectArgs;
+    barriers[1] = barriers[0];
+    barriers[1].dstAccess = Graphics::BufferAccess::eComputeReadWrite;
+    graphicsCommandStream->CmdBufferBarriers(barriers, ARRAYCOUNT(barriers), "Compute bench args barriers");
+
+    pushConstants->srcIndex = Graphics::GetBindlessIndex(bench->srcBuffer);
+    pushConstants->dstIndex = Graphics::GetBindlessIndex(bench->dstBuffer);
+    pushConstants->resultBufferIndex = Graphics::GetBindlessIndex(bench->argsBuffer);
+    graphicsCommandStream->CmdPushConstant(shaderID, pushConstants, sizeof(*pushConstants), "Compute bench push constants");
+    graphicsCommandStream->CmdDispatchIndirect(shaderID, bench->argsBuffer, 0, "Compute bench kernel");
+}
+
+static void RecordComputeBenchmarkBlur(ComputeBenchmark* bench, ComputeBenchPushConstants* pushConstants,
+    Graphics::GraphicsCommandStream* graphicsCommandStream)
+{
+    uint32 threadGroupSize[3] = {};
+    if (!Graphics::ShaderManager::GetThreadGroupSize(Graphics::SHADER_ID_BENCH_BLUR_CS, threadGroupSize) || !threadGroupSize[0] || !threadGroupSize[1])
+        return;
+
+    Graphics::ImageBarrier barriers[2] = {};
+    for (uint32 uiImage = 0; uiImage < ARRAYCOUNT(barriers); ++uiImage)
+    {
+        barriers[uiImage].imageHandle = bench->images[uiImage];
+        barriers[uiImage].srcAccess = Graphics::ImageAccess::eComputeReadWrite;
+        barriers[uiImage].dstAccess = Graphics::ImageAccess::eComputeReadWrite;
+    }
+
+    if (!bench->areImagesInitialized)
+    {
+        // The images stay in the storage image layout after this
+        for (uint32 uiImage = 0; uiImage < ARRAYCOUNT(barriers); ++uiImage)
+        {
+            barriers[uiImage].srcAccess = Graphics::ImageAccess::eNone;
+            barriers[uiImage].dstAccess = Graphics::ImageAccess::eTransferDst;
+            barriers[uiImage].discardContents = 1;
+        }
+        graphicsCommandStream->CmdImageBarriers(barriers, ARRAYCOUNT(barriers), "Compute bench - init images");
+        graphicsCommandStream->CmdClearImage(bench->images[0], v4f(0.5f, 0.25f, 0.125f, 1.0f), "Clear compute bench image 0");
+        graphicsCommandStream->CmdClearImage(bench->images[1], v4f(0.0f, 0.0f, 0.0f, 0.0f), "Clear compute bench image 1");
+
+        for (uint32 uiImage = 0; uiImage < ARRAYCOUNT(barriers); ++uiImage)
+        {
+            barriers[uiImage].srcAccess = Graphics::ImageAccess::eTransferDst;
+            barriers[uiImage].dstAccess = Graphics::ImageAccess::eComputeReadWrite;
+            barriers[uiImage].discardContents = 0;
+        }
+        bench->areImagesInitialized = true;
+    }
+
+    // Separable, horizontal from the first image into the second then vertical back
+    const uint32 numGroupsX = (COMPUTE_BENCH_IMAGE_DIM + threadGroupSize[0] - 1) / threadGroupSize[0];
+    const uint32 numGroupsY = (COMPUTE_BENCH_IMAGE_DIM + threadGroupSize[1] - 1) / threadGroupSize[1];
+    for (uint32 uiPass = 0; uiPass < 2; ++uiPass)
+    {
+        graphicsCommandStream->CmdImageBarriers(barriers, ARRAYCOUNT(barriers), "Compute bench image barriers");
+        for (uint32 uiImage = 0; uiImage < ARRAYCOUNT(barriers); ++uiImage)
+        {
+            barriers[uiImage].srcAccess = Graphics::ImageAccess::eComputeReadWrite;
+        }
+
+        pushConstants->srcIndex = Graphics::GetBindlessIndex(bench->images[uiPass]);
+        pushConstants->dstIndex = Graphics::GetBindlessIndex(bench->images[1 - uiPass]);
+        pushConstants->isVertical = uiPass;
+        graphicsCommandStream->CmdPushConstant(Graphics::SHADER_ID_BENCH_BLUR_CS, pushConstants, sizeof(*pushConstants), "Compute bench push constants");
+        graphicsCommandStream->CmdDispatch(Graphics::SHADER_ID_BENCH_BLUR_CS, numGroupsX, numGroupsY, 1, "Compute bench blur pass");
+    }
+}
+
+void RecordComputeBenchmark(ComputeBenchmark* bench, Graphics::GraphicsCommandStream* graphicsCommandStream)
+{
+    ComputeBenchPushConstants pushConstants = {};
+    pushConstants.numElements = Min(bench->numElements, (uint32)COMPUTE_BENCH_ELEMENTS_MAX);
+    pushConstants.imageDim = COMPUTE_BENCH_IMAGE_DIM;
+
+    switch (bench->kernel)
+    {
+        case ComputeKernel::eReduction:
+        {
+            RecordComputeBenchmarkBufferKernel(bench, &pushConstants, GetComputeKernelShaderID(bench->kernel), graphicsCommandStream);
+            break;
+        }
+
+        case ComputeKernel::ePrefixSum:
+        {
+            RecordComputeBenchmarkBufferKernel(bench, &pushConstants, GetComputeKernelShaderID(bench->kernel), graphicsCommandStream);
+            break;
+        }
+
+        case ComputeKernel::eBlur:
+        {
+            RecordComputeBenchmarkBlur(bench, &pushConstants, graphicsCommandStream);
+            break;
+        }
+
+        default:
+        {
+            // Kernels found in the shader directory
+            RecordComputeBenchmarkBufferKernel(bench, &pushConstants, GetComputeKernelShaderID(bench->kernel), graphicsCommandStream);
+            break;
+        }
     }
-    command->m_descriptors[0] = globalData;
-    command->m_descriptors[1] = prim->descriptor;
-    ++graphicsCommandStream->m_numCommands;
 }
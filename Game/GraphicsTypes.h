@@ -45,12 +45,15 @@ enum
     eRenderPass_Max
 };
 
+// Vertex and index data live in the transient upload ring and get rewritten every frame
 struct TransientPrim
 {
-    Tk::Graphics::ResourceHandle indexBufferHandle;
-    Tk::Graphics::ResourceHandle vertexBufferHandle;
     Tk::Graphics::DescriptorHandle descriptor;
     uint32 numVertices;
+    uint32 numIndices; // 0 if this frame's data didn't fit in the ring
+    uint32 vertOffset; // in vertices from the start of this frame's ring copy
+    uint32 indexOffset; // in indices from the start of this frame's ring copy
+    uint32 frameCtr; // drives the animation
 };
 
 void CreateAnimatedPoly(TransientPrim* prim);
@@ -58,6 +61,103 @@ void DestroyAnimatedPoly(TransientPrim* prim);
 void UpdateAnimatedPoly(TransientPrim* prim);
 void DrawAnimatedPoly(TransientPrim* prim, Tk::Graphics::DescriptorHandle globalData, uint32 shaderID, uint32 blendState, uint32 depthState, Tk::Graphics::GraphicsCommandStream* graphicsCommandStream);
 
+#define GPU_INSTANCES_MAX (1024u * 1024u)
+#define GPU_CULLING_GROUP_SIZE 64u // numthreads of cull_instances_CS.hlsl
+
+typedef struct gpu_instance
+{
+    v2f center;
+    float radius;
+    float colorSeed;
+} GPUInstance;
+
+// Push constants of cull_instances_CS.hlsl and instance_VS.hlsl, buffers are indices into the bindless descriptor arrays
+typedef struct gpu_culling_push_constants
+{
+    uint32 positionBufferIndex;
+    uint32 instanceBufferIndex;
+    uint32 visibleInstanceBufferIndex;
+    uint32 drawArgsBufferIndex;
+    uint32 numInstances;
+    float viewScale;
+    v2f viewOffset;
+} GPUCullingPushConstants;
+
+// Instances that never go through the cpu after creation. A compute pass culls them against the view and compacts the
+// visible ones into the arguments of a single indirect draw, so the cpu cost per frame doesn't depend on the instance count.
+struct GPUInstanceField
+{
+    Tk::Graphics::ResourceHandle instanceBuffer; // GPUInstance per instance
+    Tk::Graphics::ResourceHandle visibleInstanceBuffer; // uint32 instance index per visible instance
+    Tk::Graphics::ResourceHandle drawArgsBuffer; // GPUDrawIndexedIndirectArgs, then the uint32 draw count
+    uint32 numInstancesCreated;
+    uint32 numInstances; // drawn this frame, at most numInstancesCreated
+    bool isEnabled;
+
+    v2f viewOffset;
+    float viewScale;
+    uint32 frameCtr; // drives the pan and zoom
+};
+#define GPU_DRAW_ARGS_COUNT_OFFSET sizeof(Tk::Graphics::GPUDrawIndexedIndirectArgs)
+
+void CreateGPUInstanceField(GPUInstanceField* field, uint32 numInstances);
+void DestroyGPUInstanceField(GPUInstanceField* field);
+void UpdateGPUInstanceField(GPUInstanceField* field);
+// Outside of a render pass, before the pass that draws the field
+void CullGPUInstanceField(GPUInstanceField* field, Tk::Graphics::GraphicsCommandStream* graphicsCommandStream);
+void DrawGPUInstanceField(GPUInstanceField* field, Tk::Graphics::GraphicsCommandStream* graphicsCommandStream);
+
+namespace ComputeKernel
+{
+    enum : uint32
+    {
+        eReduction = 0,
+        ePrefixSum,
+        eBlur,
+        eMax
+    };
+}
+// Any other bench_*_CS.hlsl is picked up from the shader directory and dispatched like the reduction, one thread per
+// element with ComputeBenchPushConstants. Its kernel index follows the ones above.
+#define COMPUTE_BENCH_KERNELS_MAX (ComputeKernel::eMax + SHADER_DISCOVERED_MAX)
+
+#define COMPUTE_BENCH_ELEMENTS_MAX (16u * 1024u * 1024u)
+#define COMPUTE_BENCH_IMAGE_DIM 2048u
+
+// Push constants of the bench_*_CS.hlsl kernels, buffers and images are indices into the bindless descriptor arrays
+typedef struct compute_bench_push_constants
+{
+    uint32 srcIndex;
+    uint32 dstIndex;
+    uint32 resultBufferIndex;
+    uint32 numElements;
+    uint32 imageDim;
+    uint32 isVertical; // blur direction
+} ComputeBenchPushConstants;
+
+// Runs one compute kernel per frame so that its cost shows up in the gpu timings. Reductions and prefix sums are
+// dispatched indirectly, with the group count written into the args buffer each frame.
+struct ComputeBenchmark
+{
+    Tk::Graphics::ResourceHandle srcBuffer; // uint32 per element
+    Tk::Graphics::ResourceHandle dstBuffer; // uint32 per element, prefix sums of each group
+    Tk::Graphics::ResourceHandle argsBuffer; // GPUDispatchIndirectArgs, then the uint32 reduction result
+    Tk::Graphics::ResourceHandle images[2]; // storage images, blurred back and forth
+    uint32 numElements; // summed or scanned this frame, at most COMPUTE_BENCH_ELEMENTS_MAX
+    uint32 kernel;
+    bool isEnabled;
+    bool areImagesInitialized;
+};
+#define COMPUTE_BENCH_RESULT_OFFSET sizeof(Tk::Graphics::GPUDispatchIndirectArgs)
+
+void CreateComputeBenchmark(ComputeBenchmark* bench);
+void DestroyComputeBenchmark(ComputeBenchmark* bench);
+uint32 GetNumComputeKernels();
+const char* GetComputeKernelName(uint32 kernel);
+uint32 GetComputeKernelShaderID(uint32 kernel);
+// Only dispatches, copies, clears and barriers, meant for the async compute stream
+void RecordComputeBenchmark(ComputeBenchmark* bench, Tk::Graphics::GraphicsCommandStream* graphicsCommandStream);
+
 typedef struct game_graphics_data
 {
     Tk::Graphics::ResourceHandle m_rtColorHandle;
@@ -67,11 +167,18 @@ typedef struct game_graphics_data
     Tk::Graphics::ResourceHandle m_DescDataBufferHandle_Global;
     void* m_DescDataBufferMemPtr_Global;
 
-    Tk::Graphics::DescriptorHandle m_swapChainBlitDescHandle;
-
     TransientPrim m_animatedPolygon;
+    GPUInstanceField m_gpuInstances;
+    ComputeBenchmark m_computeBenchmark;
 } GameGraphicsData;
 
+// Push constants of the quad and swap chain blit shaders, indices into the bindless descriptor arrays
+typedef struct bindless_quad_push_constants
+{
+    uint32 positionBufferIndex;
+    uint32 srcImageIndex;
+} BindlessQuadPushConstants;
+
 typedef struct descriptor_instance_data
 {
     alignas(16) m4f modelMatrix;
@@ -104,7 +211,7 @@ using DefaultGeometry = struct default_geometry<numPoints, numIndices>;
 #define DEFAULT_QUAD_NUM_INDICES 6
 extern DefaultGeometry<DEFAULT_QUAD_NUM_VERTICES, DEFAULT_QUAD_NUM_INDICES> defaultQuad;
 
-void CreateDefaultGeometry(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream);
+void CreateDefaultGeometry();
 void DestroyDefaultGeometry();
 
 template <typename DefGeom>
@@ -47,17 +47,7 @@ void RecordRenderPassCommands(View* view, Scene* scene, GameRenderPass* renderPa
 
                 StaticMeshData* meshData = g_AssetManager.GetMeshGraphicsDataByID(currentAssetID);
 
-                {
-                    Tk::Graphics::GraphicsCommand* command = &graphicsCommandStream->m_graphicsCommands[graphicsCommandStream->m_numCommands];
-                    command->m_commandType = Tk::Graphics::GraphicsCommand::ePushConstant;
-                    command->debugLabel = "Push constant";
-                    command->m_shaderForLayout = shaderID;
-                    {
-                        uint8* data = command->m_pushConstantData;
-                        memcpy(data, &instanceCount, sizeof(uint32));
-                    }
-                    ++graphicsCommandStream->m_numCommands;
-                }
+                graphicsCommandStream->CmdPushConstant(shaderID, &instanceCount, sizeof(uint32), "Push constant");
 
                 DrawMeshDataCommand(graphicsCommandStream,
                         meshData->m_numIndices,
@@ -1,6 +1,11 @@
 #include "GraphicsCommon.h"
 #include "GPUTimestamps.h"
+#include "Sorting.h"
 #include "Utility/Logging.h"
+#include "Mem.h"
+
+#include <chrono>
+#include <string.h>
 
 #ifdef VULKAN
 #include "Graphics/Vulkan/Vulkan.h"
@@ -20,9 +25,24 @@ uint32 MultiBufferedStatusFromBufferUsage[] =
     1u,
     0u,
     1u,
+    1u,
+    0u,
 };
 static_assert(ARRAYCOUNT(MultiBufferedStatusFromBufferUsage) == BufferUsage::eMax); // Don't forget to add one here if enum is added to
 
+uint32 ImageLayoutFromImageAccess[] =
+{
+    ImageLayout::eUndefined,
+    ImageLayout::eTransferDst,
+    ImageLayout::eRenderOptimal,
+    ImageLayout::eDepthOptimal,
+    ImageLayout::eShaderRead,
+    ImageLayout::ePresent,
+    ImageLayout::eShaderRead,
+    ImageLayout::eGeneral,
+};
+static_assert(ARRAYCOUNT(ImageLayoutFromImageAccess) == ImageAccess::eMax);
+
 void CreateContext(const Tk::Platform::WindowHandles* windowHandles, uint32 windowWidth, uint32 windowHeight)
 {
     int result = 0;
@@ -46,7 +66,7 @@ void RecreateContext(const Tk::Platform::WindowHandles* windowHandles, uint32 wi
 void WindowResize()
 {
     #ifdef VULKAN
-    VulkanDestroyAllPSOPerms();
+    // Note: viewport/scissor are dynamic state, so PSOs don't need to be rebuilt here
     VulkanDestroySwapChain();
     VulkanCreateSwapChain();
     #endif
@@ -85,9 +105,530 @@ bool AcquireFrame()
     #endif
 }
 
+// Draw call sort key, most significant state first so that sorted draws rebind as little as possible:
+// 63..56 shader | 55..52 blend state | 51..48 depth state | 47..36 desc set 0 | 35..24 desc set 1 | 23..12 index buffer | 11..0 recorded order
+#define DRAW_SORT_KEY_ORDER_BITS 12
+#define MAX_SORTED_DRAWS_PER_RUN (1u << DRAW_SORT_KEY_ORDER_BITS)
+static_assert(SHADER_ID_MAX <= 256);
+static_assert(BlendState::eMax <= 16);
+static_assert(DepthState::eMax <= 16);
+
+#define GRAPHICS_COMMAND_STREAM_MIN_BYTES (4u * 1024)
+#define GRAPHICS_COMMAND_STREAM_MAX_BYTES (256u * 1024 * 1024)
+static_assert(GraphicsCommandType::eMax <= 256);
+static_assert(sizeof(GraphicsCmdDrawCall) % alignof(DescriptorHandle) == 0);
+static_assert(sizeof(GraphicsCmdRenderPassBegin) % alignof(ResourceHandle) == 0);
+static_assert(sizeof(GraphicsCmdImageBarriers) % alignof(ImageBarrier) == 0);
+static_assert(sizeof(GraphicsCmdDrawIndirect) % alignof(DescriptorHandle) == 0);
+static_assert(sizeof(GraphicsCmdBufferBarriers) % alignof(BufferBarrier) == 0);
+
+typedef struct draw_call_view
+{
+    const GraphicsCmdDrawCall* draw;
+    const DescriptorHandle* descriptors; // draw->numDescriptors of them
+    const char* debugLabel;
+} DrawCallView;
+
+static bool g_sortDrawCalls = false;
+static uint64 g_drawSortKeys[MAX_SORTED_DRAWS_PER_RUN];
+static uint64 g_drawSortScratch[MAX_SORTED_DRAWS_PER_RUN];
+static DrawCallView g_drawRun[MAX_SORTED_DRAWS_PER_RUN];
+static CommandStreamStats g_cmdStreamStats = {};
+static CommandStreamStats g_cmdStreamStatsLastFrame = {};
+
+static uint64 GetTimeNS()
+{
+    return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint32 AlignOffset(uint32 offset, uint32 alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+void GraphicsCommandStream::Init(uint32 initialCapacityInBytes)
+{
+    m_data = nullptr;
+    m_numBytes = 0;
+    m_capacityInBytes = 0;
+    m_numCommands = 0;
+
+    if (initialCapacityInBytes)
+    {
+        m_capacityInBytes = Min(AlignOffset(initialCapacityInBytes, GRAPHICS_COMMAND_ALIGNMENT), GRAPHICS_COMMAND_STREAM_MAX_BYTES);
+        m_data = (uint8*)Core::CoreMallocAligned(m_capacityInBytes, CACHE_LINE);
+    }
+}
+
+void GraphicsCommandStream::Destroy()
+{
+    if (m_data)
+        Core::CoreFreeAligned(m_data);
+    Init(0);
+}
+
+void* GraphicsCommandStream::AllocCommand(uint32 commandType, uint32 payloadAlignment, uint32 payloadSizeInBytes, const char* debugLabel)
+{
+    TINKER_ASSERT(commandType < GraphicsCommandType::eMax);
+    TINKER_ASSERT(payloadAlignment && !(payloadAlignment & (payloadAlignment - 1)));
+
+    // The buffer is cache line aligned, so offsets aligned here are aligned in memory too
+    const uint32 headerOffset = m_numBytes;
+    uint32 payloadOffset = headerOffset + sizeof(GraphicsCommandHeader);
+    #ifdef ENABLE_GRAPHICS_COMMAND_LABELS
+    const uint32 labelOffset = AlignOffset(payloadOffset, alignof(const char*));
+    payloadOffset = labelOffset + sizeof(const char*);
+    #endif
+    payloadOffset = AlignOffset(payloadOffset, payloadAlignment);
+    const uint32 endOffset = AlignOffset(payloadOffset + payloadSizeInBytes, GRAPHICS_COMMAND_ALIGNMENT);
+    TINKER_ASSERT(endOffset - headerOffset <= MAX_UINT16);
+
+    if (endOffset > m_capacityInBytes)
+    {
+        if (endOffset > GRAPHICS_COMMAND_STREAM_MAX_BYTES)
+        {
+            Core::Utility::LogMsg("Graphics", "Graphics command stream is full, dropping command!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+            return nullptr;
+        }
+
+        uint32 newCapacity = Max(m_capacityInBytes, GRAPHICS_COMMAND_STREAM_MIN_BYTES);
+        while (newCapacity < endOffset)
+        {
+            newCapacity = Min(newCapacity * 2, GRAPHICS_COMMAND_STREAM_MAX_BYTES);
+        }
+
+        uint8* newData = (uint8*)Core::CoreMallocAligned(newCapacity, CACHE_LINE);
+        if (m_data)
+        {
+            memcpy(newData, m_data, m_numBytes);
+            Core::CoreFreeAligned(m_data);
+        }
+        m_data = newData;
+        m_capacityInBytes = newCapacity;
+    }
+
+    GraphicsCommandHeader* header = (GraphicsCommandHeader*)(m_data + headerOffset);
+    header->commandType = (uint8)commandType;
+    header->payloadOffset = (uint8)(payloadOffset - headerOffset);
+    header->sizeInBytes = (uint16)(endOffset - headerOffset);
+    #ifdef ENABLE_GRAPHICS_COMMAND_LABELS
+    *(const char**)(m_data + labelOffset) = debugLabel;
+    #endif
+
+    m_numBytes = endOffset;
+    ++m_numCommands;
+    return m_data + payloadOffset;
+}
+
+void GraphicsCommandStream::CmdDraw(ResourceHandle indexBufferHandle, uint32 numIndices, uint32 numInstances, uint32 vertOffset, uint32 indexOffset,
+    uint32 shaderID, uint32 blendState, uint32 depthState, const DescriptorHandle* descriptors, uint32 numDescriptors,
+    const char* debugLabel)
+{
+    TINKER_ASSERT(shaderID < SHADER_ID_MAX);
+    TINKER_ASSERT(blendState < BlendState::eMax);
+    TINKER_ASSERT(depthState < DepthState::eMax);
+    TINKER_ASSERT(numDescriptors <= MAX_DESCRIPTOR_SETS_PER_SHADER);
+    TINKER_ASSERT(descriptors || !numDescriptors);
+
+    // Trailing invalid descriptors would never be bound, don't store them
+    while (numDescriptors && descriptors[numDescriptors - 1] == DefaultDescHandle_Invalid)
+    {
+        --numDescriptors;
+    }
+
+    GraphicsCmdDrawCall* cmd = (GraphicsCmdDrawCall*)AllocCommand(GraphicsCommandType::eDrawCall, alignof(GraphicsCmdDrawCall),
+        sizeof(GraphicsCmdDrawCall) + sizeof(DescriptorHandle) * numDescriptors, debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->numIndices = numIndices;
+    cmd->numInstances = numInstances;
+    cmd->vertOffset = vertOffset;
+    cmd->indexOffset = indexOffset;
+    cmd->indexBufferHandle = indexBufferHandle;
+    cmd->shader = (uint8)shaderID;
+    cmd->blendState = (uint8)blendState;
+    cmd->depthState = (uint8)depthState;
+    cmd->numDescriptors = (uint8)numDescriptors;
+    if (numDescriptors)
+        memcpy((DescriptorHandle*)(cmd + 1), descriptors, sizeof(DescriptorHandle) * numDescriptors);
+}
+
+void GraphicsCommandStream::CmdMemTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHandle, uint32 srcOffset, ResourceHandle dstBufferHandle, uint32 dstOffset,
+    const char* debugLabel)
+{
+    GraphicsCmdMemTransfer* cmd = (GraphicsCmdMemTransfer*)AllocCommand(GraphicsCommandType::eMemTransfer, alignof(GraphicsCmdMemTransfer),
+        sizeof(GraphicsCmdMemTransfer), debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->sizeInBytes = sizeInBytes;
+    cmd->srcBufferHandle = srcBufferHandle;
+    cmd->dstBufferHandle = dstBufferHandle;
+    cmd->srcOffset = srcOffset;
+    cmd->dstOffset = dstOffset;
+}
+
+void GraphicsCommandStream::CmdPushConstant(uint32 shaderForLayout, const void* data, uint32 sizeInBytes, const char* debugLabel)
+{
+    TINKER_ASSERT(data && sizeInBytes);
+    TINKER_ASSERT(sizeInBytes <= MAX_PUSH_CONSTANT_BYTES_PER_COMMAND && (sizeInBytes % 4) == 0);
+
+    GraphicsCmdPushConstant* cmd = (GraphicsCmdPushConstant*)AllocCommand(GraphicsCommandType::ePushConstant, alignof(GraphicsCmdPushConstant),
+        sizeof(GraphicsCmdPushConstant) + sizeInBytes, debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->shaderForLayout = shaderForLayout;
+    cmd->sizeInBytes = sizeInBytes;
+    memcpy(cmd + 1, data, sizeInBytes);
+}
+
+void GraphicsCommandStream::CmdSetScissor(int32 offsetX, int32 offsetY, uint32 width, uint32 height, const char* debugLabel)
+{
+    GraphicsCmdSetScissor* cmd = (GraphicsCmdSetScissor*)AllocCommand(GraphicsCommandType::eSetScissor, alignof(GraphicsCmdSetScissor),
+        sizeof(GraphicsCmdSetScissor), debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->offsetX = offsetX;
+    cmd->offsetY = offsetY;
+    cmd->width = width;
+    cmd->height = height;
+}
+
+void GraphicsCommandStream::CmdRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colorRTs, ResourceHandle depthRT,
+    uint32 renderWidth, uint32 renderHeight, const char* debugLabel)
+{
+    TINKER_ASSERT(numColorRTs <= MAX_MULTIPLE_RENDERTARGETS);
+    TINKER_ASSERT(colorRTs || !numColorRTs);
+
+    GraphicsCmdRenderPassBegin* cmd = (GraphicsCmdRenderPassBegin*)AllocCommand(GraphicsCommandType::eRenderPassBegin, alignof(GraphicsCmdRenderPassBegin),
+        sizeof(GraphicsCmdRenderPassBegin) + sizeof(ResourceHandle) * numColorRTs, debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->renderWidth = renderWidth;
+    cmd->renderHeight = renderHeight;
+    cmd->numColorRTs = numColorRTs;
+    cmd->depthRT = depthRT;
+    if (numColorRTs)
+        memcpy((ResourceHandle*)(cmd + 1), colorRTs, sizeof(ResourceHandle) * numColorRTs);
+}
+
+void GraphicsCommandStream::CmdRenderPassEnd(const char* debugLabel)
+{
+    AllocCommand(GraphicsCommandType::eRenderPassEnd, 1, 0, debugLabel);
+}
+
+void GraphicsCommandStream::CmdLayoutTransition(ResourceHandle imageHandle, uint32 startLayout, uint32 endLayout, const char* debugLabel)
+{
+    GraphicsCmdLayoutTransition* cmd = (GraphicsCmdLayoutTransition*)AllocCommand(GraphicsCommandType::eLayoutTransition, alignof(GraphicsCmdLayoutTransition),
+        sizeof(GraphicsCmdLayoutTransition), debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->imageHandle = imageHandle;
+    cmd->startLayout = startLayout;
+    cmd->endLayout = endLayout;
+}
+
+void GraphicsCommandStream::CmdClearImage(ResourceHandle imageHandle, const v4f& clearValue, const char* debugLabel)
+{
+    GraphicsCmdClearImage* cmd = (GraphicsCmdClearImage*)AllocCommand(GraphicsCommandType::eClearImage, alignof(GraphicsCmdClearImage),
+        sizeof(GraphicsCmdClearImage), debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->imageHandle = imageHandle;
+    cmd->clearValue = clearValue;
+}
+
+void GraphicsCommandStream::CmdTimestamp(const char* nameStr, const char* dbgLabel, bool startFrame)
+{
+    GraphicsCmdGPUTimestamp* cmd = (GraphicsCmdGPUTimestamp*)AllocCommand(GraphicsCommandType::eGPUTimestamp, alignof(GraphicsCmdGPUTimestamp),
+        sizeof(GraphicsCmdGPUTimestamp), dbgLabel);
+    if (!cmd)
+        return;
+
+    cmd->nameStr = nameStr;
+    cmd->startFrame = startFrame ? 1 : 0;
+}
+
+void GraphicsCommandStream::CmdImageBarriers(const ImageBarrier* barriers, uint32 numBarriers, const char* debugLabel)
+{
+    TINKER_ASSERT(barriers && numBarriers);
+    TINKER_ASSERT(numBarriers <= MAX_IMAGE_BARRIERS_PER_COMMAND);
+
+    GraphicsCmdImageBarriers* cmd = (GraphicsCmdImageBarriers*)AllocCommand(GraphicsCommandType::eImageBarriers, alignof(GraphicsCmdImageBarriers),
+        sizeof(GraphicsCmdImageBarriers) + sizeof(ImageBarrier) * numBarriers, debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->numBarriers = numBarriers;
+    memcpy((ImageBarrier*)(cmd + 1), barriers, sizeof(ImageBarrier) * numBarriers);
+}
+
+void GraphicsCommandStream::CmdDispatch(uint32 shaderID, uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ, const char* debugLabel)
+{
+    TINKER_ASSERT(shaderID < SHADER_ID_MAX);
+
+    GraphicsCmdDispatch* cmd = (GraphicsCmdDispatch*)AllocCommand(GraphicsCommandType::eDispatch, alignof(GraphicsCmdDispatch),
+        sizeof(GraphicsCmdDispatch), debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->groupCountX = groupCountX;
+    cmd->groupCountY = groupCountY;
+    cmd->groupCountZ = groupCountZ;
+    cmd->shader = shaderID;
+}
+
+void GraphicsCommandStream::CmdDrawIndirect(ResourceHandle indexBufferHandle, ResourceHandle argsBufferHandle, uint32 argsOffset,
+    ResourceHandle countBufferHandle, uint32 countOffset, uint32 maxDrawCount,
+    uint32 shaderID, uint32 blendState, uint32 depthState, const DescriptorHandle* descriptors, uint32 numDescriptors,
+    const char* debugLabel)
+{
+    TINKER_ASSERT(shaderID < SHADER_ID_MAX);
+    TINKER_ASSERT(blendState < BlendState::eMax);
+    TINKER_ASSERT(depthState < DepthState::eMax);
+    TINKER_ASSERT(numDescriptors <= MAX_DESCRIPTOR_SETS_PER_SHADER);
+    TINKER_ASSERT(descriptors || !numDescriptors);
+    TINKER_ASSERT((argsOffset % 4) == 0 && (countOffset % 4) == 0);
+
+    while (numDescriptors && descriptors[numDescriptors - 1] == DefaultDescHandle_Invalid)
+    {
+        --numDescriptors;
+    }
+
+    GraphicsCmdDrawIndirect* cmd = (GraphicsCmdDrawIndirect*)AllocCommand(GraphicsCommandType::eDrawIndirect, alignof(GraphicsCmdDrawIndirect),
+        sizeof(GraphicsCmdDrawIndirect) + sizeof(DescriptorHandle) * numDescriptors, debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->indexBufferHandle = indexBufferHandle;
+    cmd->argsBufferHandle = argsBufferHandle;
+    cmd->argsOffset = argsOffset;
+    cmd->countBufferHandle = countBufferHandle;
+    cmd->countOffset = countOffset;
+    cmd->maxDrawCount = maxDrawCount;
+    cmd->shader = (uint8)shaderID;
+    cmd->blendState = (uint8)blendState;
+    cmd->depthState = (uint8)depthState;
+    cmd->numDescriptors = (uint8)numDescriptors;
+    if (numDescriptors)
+        memcpy((DescriptorHandle*)(cmd + 1), descriptors, sizeof(DescriptorHandle) * numDescriptors);
+}
+
+void GraphicsCommandStream::CmdBufferBarriers(const BufferBarrier* barriers, uint32 numBarriers, const char* debugLabel)
+{
+    TINKER_ASSERT(barriers && numBarriers);
+    TINKER_ASSERT(numBarriers <= MAX_BUFFER_BARRIERS_PER_COMMAND);
+
+    GraphicsCmdBufferBarriers* cmd = (GraphicsCmdBufferBarriers*)AllocCommand(GraphicsCommandType::eBufferBarriers, alignof(GraphicsCmdBufferBarriers),
+        sizeof(GraphicsCmdBufferBarriers) + sizeof(BufferBarrier) * numBarriers, debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->numBarriers = numBarriers;
+    memcpy((BufferBarrier*)(cmd + 1), barriers, sizeof(BufferBarrier) * numBarriers);
+}
+
+void GraphicsCommandStream::CmdDispatchIndirect(uint32 shaderID, ResourceHandle argsBufferHandle, uint32 argsOffset, const char* debugLabel)
+{
+    TINKER_ASSERT(shaderID < SHADER_ID_MAX);
+    TINKER_ASSERT((argsOffset % 4) == 0);
+
+    GraphicsCmdDispatchIndirect* cmd = (GraphicsCmdDispatchIndirect*)AllocCommand(GraphicsCommandType::eDispatchIndirect, alignof(GraphicsCmdDispatchIndirect),
+        sizeof(GraphicsCmdDispatchIndirect), debugLabel);
+    if (!cmd)
+        return;
+
+    cmd->argsBufferHandle = argsBufferHandle;
+    cmd->argsOffset = argsOffset;
+    cmd->shader = shaderID;
+}
+
+static const GraphicsCommandHeader* GetCommandHeader(const GraphicsCommandStream* graphicsCommandStream, uint32 offset)
+{
+    TINKER_ASSERT(offset + sizeof(GraphicsCommandHeader) <= graphicsCommandStream->m_numBytes);
+    const GraphicsCommandHeader* header = (const GraphicsCommandHeader*)(graphicsCommandStream->m_data + offset);
+    TINKER_ASSERT(header->commandType < GraphicsCommandType::eMax);
+    TINKER_ASSERT(header->sizeInBytes >= header->payloadOffset && offset + header->sizeInBytes <= graphicsCommandStream->m_numBytes);
+    return header;
+}
+
+template <typename T>
+static const T* GetCommandPayload(const GraphicsCommandHeader* header)
+{
+    return (const T*)((const uint8*)header + header->payloadOffset);
+}
+
+static const char* GetCommandLabel(const GraphicsCommandHeader* header)
+{
+    #ifdef ENABLE_GRAPHICS_COMMAND_LABELS
+    const uintptr_t labelAddr = ((uintptr_t)(header + 1) + alignof(const char*) - 1) & ~(uintptr_t)(alignof(const char*) - 1);
+    return *(const char* const*)labelAddr;
+    #else
+    return "";
+    #endif
+}
+
+static DrawCallView GetDrawCallView(const GraphicsCommandHeader* header)
+{
+    DrawCallView drawView;
+    drawView.draw = GetCommandPayload<GraphicsCmdDrawCall>(header);
+    drawView.descriptors = (const DescriptorHandle*)(drawView.draw + 1);
+    drawView.debugLabel = GetCommandLabel(header);
+    return drawView;
+}
+
+static uint32 DrawDescriptorForSortKey(const DrawCallView& drawView, uint32 descSetIndex)
+{
+    return descSetIndex < drawView.draw->numDescriptors ? drawView.descriptors[descSetIndex].m_hDesc : TINKER_INVALID_HANDLE;
+}
+
+typedef struct draw_bind_state
+{
+    uint32 shaderID;
+    uint32 blendState;
+    uint32 depthState;
+    DescriptorHandle descriptors[MAX_DESCRIPTOR_SETS_PER_SHADER];
+
+    void Reset()
+    {
+        shaderID = SHADER_ID_MAX;
+        blendState = BlendState::eMax;
+        depthState = DepthState::eMax;
+        for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
+        {
+            descriptors[i] = Graphics::DefaultDescHandle_Invalid;
+        }
+    }
+} DrawBindState;
+
+static uint64 DrawSortKey(const DrawCallView& drawView, uint32 recordedOrder)
+{
+    const uint64 key =
+        ((uint64)(drawView.draw->shader & 0xFF) << 56) |
+        ((uint64)(drawView.draw->blendState & 0xF) << 52) |
+        ((uint64)(drawView.draw->depthState & 0xF) << 48) |
+        ((uint64)(DrawDescriptorForSortKey(drawView, 0) & 0xFFF) << 36) |
+        ((uint64)(DrawDescriptorForSortKey(drawView, 1) & 0xFFF) << 24) |
+        ((uint64)(drawView.draw->indexBufferHandle.m_hRes & 0xFFF) << 12) |
+        (uint64)(recordedOrder & (MAX_SORTED_DRAWS_PER_RUN - 1));
+    return key;
+}
+
+// Only draws that test and write depth without blending give the same image in any order
+static bool IsSortableDraw(const GraphicsCommandHeader* header)
+{
+    if (header->commandType != GraphicsCommandType::eDrawCall)
+        return false;
+
+    const GraphicsCmdDrawCall* draw = GetCommandPayload<GraphicsCmdDrawCall>(header);
+    return draw->blendState != BlendState::eAlphaBlend &&
+        draw->depthState == DepthState::eTestOnWriteOn_CCW;
+}
+
+// Binds whatever state a draw needs that isn't bound yet. Only counts the binds if record is false.
+static void ApplyBindState(uint32 shaderID, uint32 blendState, uint32 depthState, const DescriptorHandle* descriptors, uint32 numDescriptors,
+    DrawBindState* bindState, bool record, bool immediateSubmit, uint32* numPSOBinds, uint32* numDescriptorBinds)
+{
+    const bool shaderChange = bindState->shaderID != shaderID;
+    const bool psoChange = shaderChange ||
+        (bindState->blendState != blendState) ||
+        (bindState->depthState != depthState);
+
+    bindState->shaderID = shaderID;
+    bindState->blendState = blendState;
+    bindState->depthState = depthState;
+
+    if (psoChange)
+    {
+        if (record)
+            RecordCommandBindShader(bindState->shaderID, bindState->blendState, bindState->depthState, immediateSubmit);
+        ++*numPSOBinds;
+    }
+
+    // A different shader can have a different pipeline layout, so don't rely on its sets still being bound
+    if (shaderChange)
+    {
+        for (uint32 uiDesc = 0; uiDesc < MAX_DESCRIPTOR_SETS_PER_SHADER; ++uiDesc)
+        {
+            bindState->descriptors[uiDesc] = Graphics::DefaultDescHandle_Invalid;
+        }
+    }
+
+    for (uint32 uiDesc = 0; uiDesc < numDescriptors; ++uiDesc)
+    {
+        const DescriptorHandle descHandle = descriptors[uiDesc];
+        if (descHandle != Graphics::DefaultDescHandle_Invalid && bindState->descriptors[uiDesc] != descHandle)
+        {
+            if (record)
+                RecordCommandBindDescriptor(bindState->shaderID, descHandle, uiDesc, immediateSubmit);
+            bindState->descriptors[uiDesc] = descHandle;
+            ++*numDescriptorBinds;
+        }
+    }
+}
+
+static void ApplyDrawBindState(const DrawCallView& drawView, DrawBindState* bindState, bool record, bool immediateSubmit,
+    uint32* numPSOBinds, uint32* numDescriptorBinds)
+{
+    const GraphicsCmdDrawCall* draw = drawView.draw;
+    ApplyBindState(draw->shader, draw->blendState, draw->depthState, drawView.descriptors, draw->numDescriptors,
+        bindState, record, immediateSubmit, numPSOBinds, numDescriptorBinds);
+}
+
+static void RecordDraw(const DrawCallView& drawView, DrawBindState* bindState, bool immediateSubmit, CommandStreamStats* stats)
+{
+    ApplyDrawBindState(drawView, bindState, true, immediateSubmit, &stats->numPSOBinds, &stats->numDescriptorBinds);
+
+    const GraphicsCmdDrawCall* draw = drawView.draw;
+    RecordCommandDrawCall(draw->indexBufferHandle, draw->numIndices,
+        draw->numInstances, draw->vertOffset, draw->indexOffset,
+        drawView.debugLabel, immediateSubmit);
+    ++stats->numDraws;
+}
+
+static void RecordSortedDrawRun(const DrawCallView* drawViews, uint32 numDraws, DrawBindState* bindState, bool immediateSubmit, CommandStreamStats* stats)
+{
+    TINKER_ASSERT(numDraws <= MAX_SORTED_DRAWS_PER_RUN);
+
+    for (uint32 uiDraw = 0; uiDraw < numDraws; ++uiDraw)
+    {
+        g_drawSortKeys[uiDraw] = DrawSortKey(drawViews[uiDraw], uiDraw);
+    }
+    Core::RadixSort64(g_drawSortKeys, g_drawSortScratch, numDraws);
+
+    for (uint32 uiDraw = 0; uiDraw < numDraws; ++uiDraw)
+    {
+        const uint32 recordedOrder = (uint32)(g_drawSortKeys[uiDraw] & (MAX_SORTED_DRAWS_PER_RUN - 1));
+        RecordDraw(drawViews[recordedOrder], bindState, immediateSubmit, stats);
+    }
+    stats->numSortedDraws += numDraws;
+}
+
+void SetDrawCallSorting(bool enabled)
+{
+    g_sortDrawCalls = enabled;
+}
+
+bool IsDrawCallSortingEnabled()
+{
+    return g_sortDrawCalls;
+}
+
+void GetCommandStreamStats(CommandStreamStats* outStats)
+{
+    *outStats = g_cmdStreamStatsLastFrame;
+}
+
 void ProcessGraphicsCommandStream(const GraphicsCommandStream* graphicsCommandStream, bool immediateSubmit)
 {
-    TINKER_ASSERT(graphicsCommandStream->m_numCommands <= graphicsCommandStream->m_maxCommands);
+    TINKER_ASSERT(graphicsCommandStream->m_numBytes <= graphicsCommandStream->m_capacityInBytes);
 
     const bool multithreadedCmdRecording = false;
 
@@ -97,111 +638,136 @@ void ProcessGraphicsCommandStream(const GraphicsCommandStream* graphicsCommandSt
     }
     else
     {
-        uint32 currentShaderID = SHADER_ID_MAX;
-        uint32 currentBlendState = BlendState::eMax;
-        uint32 currentDepthState = DepthState::eMax;
-        DescriptorHandle currDescriptors[MAX_DESCRIPTOR_SETS_PER_SHADER];
-        for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-        {
-            currDescriptors[i] = Graphics::DefaultDescHandle_Invalid;
-        }
+        const uint64 replayStartTimeNS = GetTimeNS();
 
-        for (uint32 i = 0; i < graphicsCommandStream->m_numCommands; ++i)
-        {
-            TINKER_ASSERT(graphicsCommandStream->m_graphicsCommands[i].m_commandType < GraphicsCommand::eMax);
+        DrawBindState bindState;
+        bindState.Reset();
+        // Tracks the binds the recorded order would have needed, for comparison with sorting
+        DrawBindState unsortedBindState;
+        unsortedBindState.Reset();
+
+        CommandStreamStats immediateStats = {};
+        CommandStreamStats* stats = immediateSubmit ? &immediateStats : &g_cmdStreamStats;
 
-            const GraphicsCommand& currentCmd = graphicsCommandStream->m_graphicsCommands[i];
+        // Compute has its own bind point, so dispatches don't disturb the graphics bind state
+        uint32 boundComputeShaderID = SHADER_ID_MAX;
 
-            switch (currentCmd.m_commandType)
+        uint32 numCommandsProcessed = 0;
+        uint32 offset = 0;
+        while (offset < graphicsCommandStream->m_numBytes)
+        {
+            const GraphicsCommandHeader* header = GetCommandHeader(graphicsCommandStream, offset);
+            const char* debugLabel = GetCommandLabel(header);
+            uint32 nextOffset = offset + header->sizeInBytes;
+            ++numCommandsProcessed;
+
+            switch (header->commandType)
             {
-                case GraphicsCommand::eDrawCall:
+                case GraphicsCommandType::eDrawCall:
                 {
-                    const bool psoChange =
-                        currentShaderID != currentCmd.m_shader ||
-                        (currentBlendState != currentCmd.m_blendState) ||
-                        (currentDepthState != currentCmd.m_depthState);
-                    
-                    currentShaderID = currentCmd.m_shader;
-                    currentBlendState = currentCmd.m_blendState;
-                    currentDepthState = currentCmd.m_depthState;
-
-                    if (psoChange)
+                    // Sort the run of sortable draws starting here, anything else in the stream ends the run
+                    uint32 numDrawsInRun = 0;
+                    uint32 runEndOffset = offset;
+                    if (g_sortDrawCalls)
                     {
-                        RecordCommandBindShader(currentShaderID, currentBlendState, currentDepthState, immediateSubmit);
+                        while (runEndOffset < graphicsCommandStream->m_numBytes && numDrawsInRun < MAX_SORTED_DRAWS_PER_RUN)
+                        {
+                            const GraphicsCommandHeader* runHeader = GetCommandHeader(graphicsCommandStream, runEndOffset);
+                            if (!IsSortableDraw(runHeader))
+                                break;
+
+                            g_drawRun[numDrawsInRun] = GetDrawCallView(runHeader);
+                            ++numDrawsInRun;
+                            runEndOffset += runHeader->sizeInBytes;
+                        }
                     }
 
-                    for (uint32 uiDesc = 0; uiDesc < MAX_DESCRIPTOR_SETS_PER_SHADER; ++uiDesc)
+                    if (numDrawsInRun > 1)
                     {
-                        if (currDescriptors[uiDesc] != currentCmd.m_descriptors[uiDesc])
+                        for (uint32 uiDraw = 0; uiDraw < numDrawsInRun; ++uiDraw)
                         {
-                            RecordCommandBindDescriptor(currentShaderID, currentCmd.m_descriptors[uiDesc], uiDesc, immediateSubmit);
+                            ApplyDrawBindState(g_drawRun[uiDraw], &unsortedBindState, false, immediateSubmit,
+                                &stats->numPSOBindsUnsorted, &stats->numDescriptorBindsUnsorted);
                         }
+                        RecordSortedDrawRun(g_drawRun, numDrawsInRun, &bindState, immediateSubmit, stats);
+                        numCommandsProcessed += numDrawsInRun - 1;
+                        nextOffset = runEndOffset;
+                    }
+                    else
+                    {
+                        const DrawCallView drawView = GetDrawCallView(header);
+                        ApplyDrawBindState(drawView, &unsortedBindState, false, immediateSubmit,
+                            &stats->numPSOBindsUnsorted, &stats->numDescriptorBindsUnsorted);
+                        RecordDraw(drawView, &bindState, immediateSubmit, stats);
                     }
-
-                    RecordCommandDrawCall(currentCmd.m_indexBufferHandle, currentCmd.m_numIndices,
-                        currentCmd.m_numInstances, currentCmd.m_vertOffset, currentCmd.m_indexOffset,
-                        currentCmd.debugLabel, immediateSubmit);
                     break;
                 }
 
-                case GraphicsCommand::eMemTransfer:
+                case GraphicsCommandType::eMemTransfer:
                 {
-                    RecordCommandMemoryTransfer(currentCmd.m_sizeInBytes, currentCmd.m_srcBufferHandle, currentCmd.m_dstBufferHandle,
-                        currentCmd.debugLabel, immediateSubmit);
+                    const GraphicsCmdMemTransfer* cmd = GetCommandPayload<GraphicsCmdMemTransfer>(header);
+                    RecordCommandMemoryTransfer(cmd->sizeInBytes, cmd->srcBufferHandle, cmd->srcOffset,
+                        cmd->dstBufferHandle, cmd->dstOffset, debugLabel, immediateSubmit);
 
                     break;
                 }
 
-                case GraphicsCommand::ePushConstant:
+                case GraphicsCommandType::ePushConstant:
                 {
-                    RecordCommandPushConstant(&currentCmd.m_pushConstantData[0], ARRAYCOUNT(currentCmd.m_pushConstantData) * sizeof(uint8), currentCmd.m_shaderForLayout);
+                    const GraphicsCmdPushConstant* cmd = GetCommandPayload<GraphicsCmdPushConstant>(header);
+                    RecordCommandPushConstant((const uint8*)(cmd + 1), cmd->sizeInBytes, cmd->shaderForLayout);
 
                     break;
                 }
 
-                case GraphicsCommand::eSetScissor:
+                case GraphicsCommandType::eSetScissor:
                 {
-                    RecordCommandSetScissor(currentCmd.m_scissorOffsetX, currentCmd.m_scissorOffsetY, currentCmd.m_scissorWidth, currentCmd.m_scissorHeight);
+                    const GraphicsCmdSetScissor* cmd = GetCommandPayload<GraphicsCmdSetScissor>(header);
+                    RecordCommandSetScissor(cmd->offsetX, cmd->offsetY, cmd->width, cmd->height);
 
                     break;
                 }
 
-                case GraphicsCommand::eRenderPassBegin:
+                case GraphicsCommandType::eRenderPassBegin:
                 {
-                    RecordCommandRenderPassBegin(currentCmd.m_numColorRTs, &currentCmd.m_colorRTs[0], currentCmd.m_depthRT,
-                        currentCmd.m_renderWidth, currentCmd.m_renderHeight, currentCmd.debugLabel, immediateSubmit);
+                    const GraphicsCmdRenderPassBegin* cmd = GetCommandPayload<GraphicsCmdRenderPassBegin>(header);
+                    RecordCommandRenderPassBegin(cmd->numColorRTs, (const ResourceHandle*)(cmd + 1), cmd->depthRT,
+                        cmd->renderWidth, cmd->renderHeight, debugLabel, immediateSubmit);
 
                     break;
                 }
 
-                case GraphicsCommand::eRenderPassEnd:
+                case GraphicsCommandType::eRenderPassEnd:
                 {
                     RecordCommandRenderPassEnd(immediateSubmit);
 
                     break;
                 }
 
-                case GraphicsCommand::eLayoutTransition:
+                case GraphicsCommandType::eLayoutTransition:
                 {
-                    RecordCommandTransitionLayout(currentCmd.m_imageHandle,
-                        currentCmd.m_startLayout, currentCmd.m_endLayout,
-                        currentCmd.debugLabel, immediateSubmit);
+                    const GraphicsCmdLayoutTransition* cmd = GetCommandPayload<GraphicsCmdLayoutTransition>(header);
+                    RecordCommandTransitionLayout(cmd->imageHandle,
+                        cmd->startLayout, cmd->endLayout,
+                        debugLabel, immediateSubmit);
 
                     break;
                 }
 
-                case GraphicsCommand::eClearImage:
+                case GraphicsCommandType::eClearImage:
                 {
-                    RecordCommandClearImage(currentCmd.m_imageHandle,
-                        currentCmd.m_clearValue, currentCmd.debugLabel, immediateSubmit);
+                    const GraphicsCmdClearImage* cmd = GetCommandPayload<GraphicsCmdClearImage>(header);
+                    RecordCommandClearImage(cmd->imageHandle,
+                        cmd->clearValue, debugLabel, immediateSubmit);
 
                     break;
                 }
 
-                case GraphicsCommand::eGPUTimestamp:
+                case GraphicsCommandType::eGPUTimestamp:
                 {
+                    const GraphicsCmdGPUTimestamp* cmd = GetCommandPayload<GraphicsCmdGPUTimestamp>(header);
                     TINKER_ASSERT(GPUTimestamps::GetMostRecentRecordedTimestampCount() <= GPU_TIMESTAMP_NUM_MAX);
-                    if (currentCmd.m_timestampStartFrame)
+                    if (cmd->startFrame)
                     {
                         void* cpuCopyBuffer = GPUTimestamps::GetRawCPUSideTimestampBuffer();
                         const uint32 numTimestampsRecorded = GPUTimestamps::GetMostRecentRecordedTimestampCount();
@@ -210,7 +776,68 @@ void ProcessGraphicsCommandStream(const GraphicsCommandStream* graphicsCommandSt
                     }
 
                     RecordCommandGPUTimestamp(GPUTimestamps::GetMostRecentRecordedTimestampCount(), immediateSubmit);
-                    GPUTimestamps::RecordName(currentCmd.m_timestampNameStr);
+                    GPUTimestamps::RecordName(cmd->nameStr);
+
+                    break;
+                }
+
+                case GraphicsCommandType::eImageBarriers:
+                {
+                    const GraphicsCmdImageBarriers* cmd = GetCommandPayload<GraphicsCmdImageBarriers>(header);
+                    RecordCommandImageBarriers((const ImageBarrier*)(cmd + 1), cmd->numBarriers, debugLabel, immediateSubmit);
+
+                    break;
+                }
+
+                case GraphicsCommandType::eDispatch:
+                {
+                    const GraphicsCmdDispatch* cmd = GetCommandPayload<GraphicsCmdDispatch>(header);
+                    if (boundComputeShaderID != cmd->shader)
+                    {
+                        RecordCommandBindComputeShader(cmd->shader, immediateSubmit);
+                        boundComputeShaderID = cmd->shader;
+                        ++stats->numPSOBinds;
+                    }
+                    RecordCommandDispatch(cmd->groupCountX, cmd->groupCountY, cmd->groupCountZ, debugLabel, immediateSubmit);
+                    ++stats->numDispatches;
+
+                    break;
+                }
+
+                case GraphicsCommandType::eDrawIndirect:
+                {
+                    const GraphicsCmdDrawIndirect* cmd = GetCommandPayload<GraphicsCmdDrawIndirect>(header);
+                    const DescriptorHandle* descriptors = (const DescriptorHandle*)(cmd + 1);
+                    ApplyBindState(cmd->shader, cmd->blendState, cmd->depthState, descriptors, cmd->numDescriptors,
+                        &unsortedBindState, false, immediateSubmit, &stats->numPSOBindsUnsorted, &stats->numDescriptorBindsUnsorted);
+                    ApplyBindState(cmd->shader, cmd->blendState, cmd->depthState, descriptors, cmd->numDescriptors,
+                        &bindState, true, immediateSubmit, &stats->numPSOBinds, &stats->numDescriptorBinds);
+                    RecordCommandDrawIndirect(cmd->indexBufferHandle, cmd->argsBufferHandle, cmd->argsOffset,
+                        cmd->countBufferHandle, cmd->countOffset, cmd->maxDrawCount, debugLabel, immediateSubmit);
+                    ++stats->numIndirectDraws;
+
+                    break;
+                }
+
+                case GraphicsCommandType::eBufferBarriers:
+                {
+                    const GraphicsCmdBufferBarriers* cmd = GetCommandPayload<GraphicsCmdBufferBarriers>(header);
+                    RecordCommandBufferBarriers((const BufferBarrier*)(cmd + 1), cmd->numBarriers, debugLabel, immediateSubmit);
+
+                    break;
+                }
+
+                case GraphicsCommandType::eDispatchIndirect:
+                {
+                    const GraphicsCmdDispatchIndirect* cmd = GetCommandPayload<GraphicsCmdDispatchIndirect>(header);
+                    if (boundComputeShaderID != cmd->shader)
+                    {
+                        RecordCommandBindComputeShader(cmd->shader, immediateSubmit);
+                        boundComputeShaderID = cmd->shader;
+                        ++stats->numPSOBinds;
+                    }
+                    RecordCommandDispatchIndirect(cmd->argsBufferHandle, cmd->argsOffset, debugLabel, immediateSubmit);
+                    ++stats->numDispatches;
 
                     break;
                 }
@@ -222,8 +849,79 @@ void ProcessGraphicsCommandStream(const GraphicsCommandStream* graphicsCommandSt
                     break;
                 }
             }
+
+            offset = nextOffset;
+        }
+        TINKER_ASSERT(numCommandsProcessed == graphicsCommandStream->m_numCommands);
+
+        stats->numCommands += graphicsCommandStream->m_numCommands;
+        stats->numCommandBytes += graphicsCommandStream->m_numBytes;
+        stats->replayTimeMS += (float)(GetTimeNS() - replayStartTimeNS) * 1e-6f;
+    }
+}
+
+static void RecordBenchmarkCommands(GraphicsCommandStream* graphicsCommandStream, uint32 numCommands)
+{
+    DescriptorHandle descriptors[3] = { DescriptorHandle(0), DescriptorHandle(1), DescriptorHandle(2) };
+
+    for (uint32 uiCmd = 0; uiCmd < numCommands; ++uiCmd)
+    {
+        if ((uiCmd & 63) == 0)
+        {
+            graphicsCommandStream->CmdSetScissor(0, 0, 1920, 1080, "Benchmark scissor");
+        }
+        else if (uiCmd & 1)
+        {
+            const uint32 instanceOffset = uiCmd;
+            graphicsCommandStream->CmdPushConstant(SHADER_ID_Pass1, &instanceOffset, sizeof(uint32), "Benchmark push constant");
         }
+        else
+        {
+            descriptors[2] = DescriptorHandle(2 + ((uiCmd >> 1) & 63));
+            graphicsCommandStream->CmdDraw(ResourceHandle((uiCmd >> 1) & 63), 36, 1, 0, 0,
+                SHADER_ID_Pass1, BlendState::eReplace, DepthState::eTestOnWriteOn_CCW, descriptors, ARRAYCOUNT(descriptors),
+                "Benchmark draw");
+        }
+    }
+}
+
+void BenchmarkCommandStream(uint32 numCommands, CommandStreamBenchmark* outResults)
+{
+    *outResults = {};
+
+    // Untimed pass first so that growing the buffer isn't measured
+    GraphicsCommandStream benchmarkStream;
+    benchmarkStream.Init(0);
+    RecordBenchmarkCommands(&benchmarkStream, numCommands);
+    benchmarkStream.Reset();
+
+    const uint64 recordStartTimeNS = GetTimeNS();
+    RecordBenchmarkCommands(&benchmarkStream, numCommands);
+    const uint64 decodeStartTimeNS = GetTimeNS();
+
+    DrawBindState bindState;
+    bindState.Reset();
+    CommandStreamStats decodeStats = {};
+    uint32 offset = 0;
+    while (offset < benchmarkStream.m_numBytes)
+    {
+        const GraphicsCommandHeader* header = GetCommandHeader(&benchmarkStream, offset);
+        if (header->commandType == GraphicsCommandType::eDrawCall)
+        {
+            ApplyDrawBindState(GetDrawCallView(header), &bindState, false, false, &decodeStats.numPSOBinds, &decodeStats.numDescriptorBinds);
+            ++decodeStats.numDraws;
+        }
+        offset += header->sizeInBytes;
     }
+    const uint64 decodeEndTimeNS = GetTimeNS();
+
+    outResults->numCommands = benchmarkStream.m_numCommands;
+    outResults->numBytes = benchmarkStream.m_numBytes;
+    outResults->numBinds = decodeStats.numPSOBinds + decodeStats.numDescriptorBinds;
+    outResults->recordTimeMS = (float)(decodeStartTimeNS - recordStartTimeNS) * 1e-6f;
+    outResults->decodeTimeMS = (float)(decodeEndTimeNS - decodeStartTimeNS) * 1e-6f;
+
+    benchmarkStream.Destroy();
 }
 
 void BeginFrameRecording()
@@ -242,11 +940,106 @@ void EndFrameRecording()
 
 void SubmitFrameToGPU()
 {
+    g_cmdStreamStatsLastFrame = g_cmdStreamStats;
+    g_cmdStreamStats = {};
+
     #ifdef VULKAN
     Graphics::VulkanSubmitFrame();
     #endif
 }
 
+void ProcessAsyncComputeCommandStream(const GraphicsCommandStream* asyncComputeCommandStream)
+{
+    if (asyncComputeCommandStream->m_numCommands == 0)
+        return;
+
+    #ifdef VULKAN
+    BeginVulkanAsyncComputeRecording();
+    #endif
+
+    ProcessGraphicsCommandStream(asyncComputeCommandStream, false);
+
+    #ifdef VULKAN
+    EndVulkanAsyncComputeRecording();
+    #endif
+}
+
+void SetAsyncComputeEnabled(bool enabled)
+{
+    #ifdef VULKAN
+    Graphics::VulkanSetAsyncComputeEnabled(enabled);
+    #endif
+}
+
+void SetFramePacing(uint32 numFramesInFlight, uint32 framePacingMode)
+{
+    #ifdef VULKAN
+    Graphics::VulkanSetFramePacing(numFramesInFlight, framePacingMode);
+    #endif
+}
+
+TransientAllocation AllocTransient(uint32 sizeInBytes, uint32 alignment)
+{
+    #ifdef VULKAN
+    return Graphics::VulkanAllocTransient(sizeInBytes, alignment);
+    #else
+    TransientAllocation transientAlloc = {};
+    return transientAlloc;
+    #endif
+}
+
+ResourceHandle GetTransientUploadRing()
+{
+    #ifdef VULKAN
+    return Graphics::VulkanGetTransientUploadRing();
+    #else
+    return Graphics::DefaultResHandle_Invalid;
+    #endif
+}
+
+uint64 UploadBufferData(ResourceHandle dstBuffer, uint32 dstOffset, const void* data, uint32 sizeInBytes)
+{
+    #ifdef VULKAN
+    return Graphics::VulkanUploadBufferData(dstBuffer, dstOffset, data, sizeInBytes);
+    #else
+    return 0;
+    #endif
+}
+
+uint64 UploadImageData(ResourceHandle dstImage, const void* data, uint32 sizeInBytes)
+{
+    #ifdef VULKAN
+    return Graphics::VulkanUploadImageData(dstImage, data, sizeInBytes);
+    #else
+    return 0;
+    #endif
+}
+
+uint64 SubmitUploads()
+{
+    #ifdef VULKAN
+    return Graphics::VulkanSubmitUploads();
+    #else
+    return 0;
+    #endif
+}
+
+bool IsUploadComplete(uint64 uploadValue)
+{
+    #ifdef VULKAN
+    return Graphics::VulkanIsUploadComplete(uploadValue);
+    #else
+    return true;
+    #endif
+}
+
+void WaitForUpload(uint64 uploadValue)
+{
+    #ifdef VULKAN
+    Graphics::VulkanWaitForUpload(uploadValue);
+    #endif
+}
+
 SUBMIT_CMDS_IMMEDIATE(SubmitCmdsImmediate)
 {
     #ifdef VULKAN
@@ -272,6 +1065,34 @@ DESTROY_RESOURCE(DestroyResource)
     #endif
 }
 
+void GetImageMemoryRequirements(ResourceHandle imageHandle, uint64* outSizeInBytes, uint64* outAlignment)
+{
+    #ifdef VULKAN
+    VulkanGetImageMemoryRequirements(imageHandle, outSizeInBytes, outAlignment);
+    #else
+    *outSizeInBytes = 0;
+    *outAlignment = 1;
+    #endif
+}
+
+ResourceHandle CreateTransientHeap(uint64 sizeInBytes, const ResourceHandle* imageHandles, const uint64* imageOffsets, uint32 numImages, const char* debugLabel)
+{
+    #ifdef VULKAN
+    return VulkanCreateTransientHeap(sizeInBytes, imageHandles, imageOffsets, numImages, debugLabel);
+    #else
+    return Graphics::DefaultResHandle_Invalid;
+    #endif
+}
+
+uint32 GetBindlessIndex(ResourceHandle handle)
+{
+    #ifdef VULKAN
+    return VulkanGetBindlessIndex(handle);
+    #else
+    return BINDLESS_INDEX_INVALID;
+    #endif
+}
+
 MAP_RESOURCE(MapResource)
 {
     #ifdef VULKAN
@@ -292,7 +1113,7 @@ CREATE_GRAPHICS_PIPELINE(CreateGraphicsPipeline)
 {
     #ifdef VULKAN
     return VulkanCreateGraphicsPipeline(vertexShaderCode, numVertexShaderBytes, fragmentShaderCode, numFragmentShaderBytes,
-        shaderID, viewportWidth, viewportHeight, numColorRTs, colorRTFormats, depthFormat, descriptorHandles, numDescriptorHandles);
+        shaderID, numColorRTs, colorRTFormats, depthFormat, descriptorHandles, numDescriptorHandles);
     #else
     return false;
     #endif
@@ -307,6 +1128,15 @@ CREATE_DESCRIPTOR(CreateDescriptor)
     #endif
 }
 
+CREATE_TRANSIENT_DESCRIPTOR(CreateTransientDescriptor)
+{
+    #ifdef VULKAN
+    return VulkanCreateTransientDescriptor(descLayoutID);
+    #else
+    return DefaultDescHandle_Invalid;
+    #endif
+}
+
 DESTROY_DESCRIPTOR(DestroyDescriptor)
 {
     #ifdef VULKAN
@@ -338,6 +1168,15 @@ CREATE_DESCRIPTOR_LAYOUT(CreateDescriptorLayout)
 
 }
 
+CREATE_COMPUTE_PIPELINE(CreateComputePipeline)
+{
+    #ifdef VULKAN
+    return VulkanCreateComputePipeline(computeShaderCode, numComputeShaderBytes, shaderID, descriptorHandles, numDescriptorHandles);
+    #else
+    return false;
+    #endif
+}
+
 DESTROY_GRAPHICS_PIPELINE(DestroyGraphicsPipeline)
 {
     #ifdef VULKAN
@@ -23,6 +23,8 @@ namespace DescriptorType
         eBuffer = 0,
         eSampledImage,
         eSSBO,
+        eStorageImage,
+        eSampler, // standalone sampler, always the linear sampler
         eMax
     };
 }
@@ -37,6 +39,8 @@ namespace BufferUsage
         eTransientIndex,
         eStaging,
         eUniform,
+        eTransientUpload, // the per-frame upload ring, usable as storage, index, uniform or vertex data
+        eIndirectArgs, // indirect draw and dispatch arguments and draw counts, written by compute shaders
         eMax
     };
 }
@@ -47,6 +51,7 @@ namespace ResourceType
     {
         eBuffer1D = 0,
         eImage2D,
+        eTransientHeap, // device memory shared by transient images, see CreateTransientHeap
         eMax
     };
 }
@@ -82,6 +87,7 @@ namespace ImageFormat
         BGRA8_SRGB,
         RGBA8_SRGB,
         Depth_32F,
+        RGBA16_Float, // usable as a storage image
         TheSwapChainFormat,
         eMax
     };
@@ -97,6 +103,39 @@ namespace ImageLayout
         eRenderOptimal,
         eDepthOptimal,
         ePresent,
+        eGeneral,
+        eMax
+    };
+}
+
+// How a pass uses an image. Barriers are derived from an image's access before and after, see RenderGraph.
+namespace ImageAccess
+{
+    enum : uint32
+    {
+        eNone = 0, // not accessed yet
+        eTransferDst,
+        eColorAttachment,
+        eDepthAttachment,
+        eFragmentShaderRead,
+        ePresent,
+        eComputeRead, // sampled
+        eComputeReadWrite, // storage image, see ResourceDesc::isStorage
+        eMax
+    };
+}
+
+// How a command uses a buffer, see CmdBufferBarriers
+namespace BufferAccess
+{
+    enum : uint32
+    {
+        eNone = 0, // not accessed yet
+        eTransferDst,
+        eComputeRead,
+        eComputeReadWrite,
+        eIndirectArgs,
+        eVertexShaderRead,
         eMax
     };
 }
@@ -119,6 +158,27 @@ inline uint32 IsBufferUsageMultiBuffered(uint32 bufferUsage)
     return MultiBufferedStatusFromBufferUsage[bufferUsage];
 }
 
+extern uint32 ImageLayoutFromImageAccess[ImageAccess::eMax];
+inline uint32 GetImageAccessLayout(uint32 imageAccess)
+{
+    TINKER_ASSERT(imageAccess < ImageAccess::eMax);
+    return ImageLayoutFromImageAccess[imageAccess];
+}
+
+inline bool IsImageAccessWrite(uint32 imageAccess)
+{
+    return imageAccess == ImageAccess::eTransferDst ||
+        imageAccess == ImageAccess::eColorAttachment ||
+        imageAccess == ImageAccess::eDepthAttachment ||
+        imageAccess == ImageAccess::eComputeReadWrite;
+}
+
+inline bool IsBufferAccessWrite(uint32 bufferAccess)
+{
+    return bufferAccess == BufferAccess::eTransferDst ||
+        bufferAccess == BufferAccess::eComputeReadWrite;
+}
+
 // Concrete type for resource handle to catch errors at compile time, e.g.
 // Try to free a descriptor set with a resource handle, which can happen if all handles
 // are just plain uint32.
@@ -167,9 +227,36 @@ typedef struct graphics_resource_description
         };
     };
 
+    // Images only - created without device memory, which is bound later by CreateTransientHeap
+    bool isTransient = false;
+
+    // Images only - can also be bound as a storage image, at the same bindless index as the sampled image
+    bool isStorage = false;
+
     const char* debugLabel = "";
 } ResourceDesc;
 
+#define MAX_IMAGE_BARRIERS_PER_COMMAND 64
+
+typedef struct image_barrier
+{
+    ResourceHandle imageHandle;
+    uint32 srcAccess;
+    uint32 dstAccess;
+    uint32 discardContents; // transition from the undefined layout, the old contents aren't kept
+    uint32 aliasSrcAccesses; // bit per ImageAccess of other images that used this memory before, waited on as well
+} ImageBarrier;
+
+#define MAX_BUFFER_BARRIERS_PER_COMMAND 16
+
+// Covers the whole buffer, the current frame's copy if it is multi-buffered
+typedef struct buffer_barrier
+{
+    ResourceHandle bufferHandle;
+    uint32 srcAccess;
+    uint32 dstAccess;
+} BufferBarrier;
+
 struct FramebufferHandle
 {
     uint32 m_hFramebuffer;
@@ -262,7 +349,20 @@ typedef struct descriptor_set_data_handles
 } DescriptorSetDataHandles;
 
 // Important graphics defines
-#define MAX_FRAMES_IN_FLIGHT 2
+// Upper bound on frames in flight, the count actually used is set at runtime. Per-frame resource copies are only allocated
+// for as many frames in flight as have been requested so far.
+#define MAX_FRAMES_IN_FLIGHT 4
+#define DEFAULT_FRAMES_IN_FLIGHT 2
+
+namespace FramePacingMode
+{
+    enum : uint32
+    {
+        eThroughput = 0, // cpu can run up to numFramesInFlight frames ahead of the gpu
+        eLowLatency, // cpu waits for the previous frame to finish on the gpu before sampling input for the next one
+        eMax
+    };
+}
 #define MAX_MULTIPLE_RENDERTARGETS 8u
 
 #define IMAGE_HANDLE_SWAP_CHAIN ResourceHandle(0xFFFFFFFE) // INVALID_HANDLE - 1 reserved to refer to the swap chain image 
@@ -279,11 +379,12 @@ typedef struct descriptor_set_data_handles
 #define DEPTH_OP DepthCompareOp::eGeOrEqual
 #endif
 
-#define GPU_TIMESTAMP_NUM_MAX 5
+#define GPU_TIMESTAMP_NUM_MAX 8
 
 #define MIN_PUSH_CONSTANTS_SIZE 128 // bytes
 
-typedef struct graphics_command
+// Command debug labels are only stored in the stream if ENABLE_GRAPHICS_COMMAND_LABELS is defined (debug builds)
+namespace GraphicsCommandType
 {
     enum : uint32
     {
@@ -297,133 +398,206 @@ typedef struct graphics_command
         eClearImage,
         //eImageCopy,
         eGPUTimestamp,
+        eImageBarriers,
+        eDispatch,
+        eDrawIndirect,
+        eBufferBarriers,
+        eDispatchIndirect,
         eMax
     };
+}
 
-    const char* debugLabel = "Default Label";
-    uint32 m_commandType;
+// Commands are packed back to back in the stream: a header, the debug label if enabled, then the payload of the
+// command type. Payloads ending in an array only store the elements in use.
+#define GRAPHICS_COMMAND_ALIGNMENT 4u
+#define MAX_PUSH_CONSTANT_BYTES_PER_COMMAND MIN_PUSH_CONSTANTS_SIZE
 
-    union
-    {
-        // Draw call
-        struct
-        {
-            uint32 m_numIndices;
-            uint32 m_numInstances;
-            uint32 m_vertOffset;
-            uint32 m_indexOffset;
-            uint32 m_shader;
-            uint32 m_blendState;
-            uint32 m_depthState;
-            ResourceHandle m_indexBufferHandle;
-            DescriptorHandle m_descriptors[MAX_DESCRIPTOR_SETS_PER_SHADER];
-        };
+typedef struct graphics_command_header
+{
+    uint8 commandType;
+    uint8 payloadOffset; // bytes from the start of the header
+    uint16 sizeInBytes; // whole command including padding, the next header starts here
+} GraphicsCommandHeader;
 
-        // Memory transfer
-        struct
-        {
-            uint32 m_sizeInBytes;
-            ResourceHandle m_srcBufferHandle;
-            ResourceHandle m_dstBufferHandle;
-        };
+// Draw call, followed by numDescriptors descriptor handles
+typedef struct graphics_cmd_draw_call
+{
+    uint32 numIndices;
+    uint32 numInstances;
+    uint32 vertOffset;
+    uint32 indexOffset;
+    ResourceHandle indexBufferHandle;
+    uint8 shader;
+    uint8 blendState;
+    uint8 depthState;
+    uint8 numDescriptors;
+} GraphicsCmdDrawCall;
+
+typedef struct graphics_cmd_mem_transfer
+{
+    uint32 sizeInBytes;
+    ResourceHandle srcBufferHandle;
+    ResourceHandle dstBufferHandle;
+    uint32 srcOffset; // bytes
+    uint32 dstOffset; // bytes, buffer destinations only
+} GraphicsCmdMemTransfer;
+
+// Push constant, followed by sizeInBytes bytes of data
+typedef struct graphics_cmd_push_constant
+{
+    uint32 shaderForLayout;
+    uint32 sizeInBytes;
+} GraphicsCmdPushConstant;
 
-        // Push constant
-        struct
-        {
-            uint32 m_shaderForLayout;
-            // TODO: more data here makes this struct bigger, maybe store a pointer?
-            uint8 m_pushConstantData[32];
-        };
+typedef struct graphics_cmd_set_scissor
+{
+    int32 offsetX;
+    int32 offsetY;
+    uint32 width;
+    uint32 height;
+} GraphicsCmdSetScissor;
+
+// Begin render pass, followed by numColorRTs resource handles
+typedef struct graphics_cmd_render_pass_begin
+{
+    uint32 renderWidth;
+    uint32 renderHeight;
+    uint32 numColorRTs;
+    ResourceHandle depthRT;
+} GraphicsCmdRenderPassBegin;
 
-        // Scissor
-        struct
-        {
-            int32 m_scissorOffsetX;
-            int32 m_scissorOffsetY;
-            uint32 m_scissorWidth;
-            uint32 m_scissorHeight;
-        };
+// End render pass has no payload
 
-        // Begin render pass
-        struct
-        {
-            uint32 m_renderWidth;
-            uint32 m_renderHeight;
-            uint32 m_numColorRTs;
-            ResourceHandle m_colorRTs[MAX_MULTIPLE_RENDERTARGETS];
-            ResourceHandle m_depthRT;
-        };
+typedef struct graphics_cmd_layout_transition
+{
+    ResourceHandle imageHandle;
+    uint32 startLayout;
+    uint32 endLayout;
+} GraphicsCmdLayoutTransition;
 
-        // End render pass
-        // NOTE: no actual data required
-        /* struct
-        {
-        }; */
+typedef struct graphics_cmd_clear_image
+{
+    ResourceHandle imageHandle;
+    v4f clearValue;
+} GraphicsCmdClearImage;
 
-        // Image Layout Transition
-        struct
-        {
-            ResourceHandle m_imageHandle;
-            uint32 m_startLayout;
-            uint32 m_endLayout;
-        };
+// Image barriers recorded as one batch, followed by numBarriers ImageBarriers
+typedef struct graphics_cmd_image_barriers
+{
+    uint32 numBarriers;
+} GraphicsCmdImageBarriers;
 
-        // Clear image
-        struct
-        {
-            ResourceHandle m_imageHandle;
-            v4f m_clearValue;
-        };
+// Compute dispatch, the shader's bindless set is bound along with the pipeline
+typedef struct graphics_cmd_dispatch
+{
+    uint32 groupCountX;
+    uint32 groupCountY;
+    uint32 groupCountZ;
+    uint32 shader;
+} GraphicsCmdDispatch;
+
+// Compute dispatch whose group counts are read from a gpu buffer
+typedef struct graphics_cmd_dispatch_indirect
+{
+    ResourceHandle argsBufferHandle;
+    uint32 argsOffset; // bytes
+    uint32 shader;
+} GraphicsCmdDispatchIndirect;
+
+// Indexed indirect draw whose arguments, and optionally draw count, are read from gpu buffers.
+// Followed by numDescriptors descriptor handles.
+typedef struct graphics_cmd_draw_indirect
+{
+    ResourceHandle indexBufferHandle;
+    ResourceHandle argsBufferHandle;
+    uint32 argsOffset; // bytes
+    ResourceHandle countBufferHandle; // invalid to always draw maxDrawCount
+    uint32 countOffset; // bytes
+    uint32 maxDrawCount;
+    uint8 shader;
+    uint8 blendState;
+    uint8 depthState;
+    uint8 numDescriptors;
+} GraphicsCmdDrawIndirect;
+
+// Buffer barriers recorded as one batch, followed by numBarriers BufferBarriers
+typedef struct graphics_cmd_buffer_barriers
+{
+    uint32 numBarriers;
+} GraphicsCmdBufferBarriers;
 
-        // Image copy
-        /*struct
-        {
-            uint32 m_width;
-            uint32 m_height;
-            ResourceHandle m_srcImgHandle;
-            ResourceHandle m_dstImgHandle;
-        };*/
+typedef struct graphics_cmd_gpu_timestamp
+{
+    const char* nameStr;
+    uint32 startFrame;
+} GraphicsCmdGPUTimestamp;
 
-        // GPU Timestamp
-        struct
-        {
-            const char* m_timestampNameStr;
-            bool m_timestampStartFrame;
-        };
-    };
+// Growable linear buffer of packed graphics commands. Record with the Cmd functions, replay with ProcessGraphicsCommandStream.
+struct GraphicsCommandStream
+{
+    uint8* m_data;
+    uint32 m_numBytes;
+    uint32 m_capacityInBytes;
+    uint32 m_numCommands;
 
-    void CmdTimestamp(const char* nameStr, const char* dbgLabel = "Timestamp", bool startFrame = false)
+    void Init(uint32 initialCapacityInBytes);
+    void Destroy();
+    void Reset()
     {
-        m_commandType = eGPUTimestamp;
-        debugLabel = dbgLabel;
-        m_timestampNameStr = nameStr;
-        m_timestampStartFrame = startFrame;
+        m_numBytes = 0;
+        m_numCommands = 0;
     }
 
-} GraphicsCommand;
-
-struct GraphicsCommandStream
-{
-    GraphicsCommand* m_graphicsCommands;
-    uint32 m_numCommands;
-    uint32 m_maxCommands;
+    // descriptors can be null if numDescriptors is 0, invalid handles aren't bound
+    void CmdDraw(ResourceHandle indexBufferHandle, uint32 numIndices, uint32 numInstances, uint32 vertOffset, uint32 indexOffset,
+        uint32 shaderID, uint32 blendState, uint32 depthState, const DescriptorHandle* descriptors, uint32 numDescriptors,
+        const char* debugLabel);
+    void CmdMemTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHandle, uint32 srcOffset, ResourceHandle dstBufferHandle, uint32 dstOffset,
+        const char* debugLabel);
+    // sizeInBytes must be a multiple of 4
+    void CmdPushConstant(uint32 shaderForLayout, const void* data, uint32 sizeInBytes, const char* debugLabel);
+    void CmdSetScissor(int32 offsetX, int32 offsetY, uint32 width, uint32 height, const char* debugLabel);
+    void CmdRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colorRTs, ResourceHandle depthRT,
+        uint32 renderWidth, uint32 renderHeight, const char* debugLabel);
+    void CmdRenderPassEnd(const char* debugLabel);
+    void CmdLayoutTransition(ResourceHandle imageHandle, uint32 startLayout, uint32 endLayout, const char* debugLabel);
+    void CmdClearImage(ResourceHandle imageHandle, const v4f& clearValue, const char* debugLabel);
+    void CmdTimestamp(const char* nameStr, const char* dbgLabel = "Timestamp", bool startFrame = false);
+    void CmdImageBarriers(const ImageBarrier* barriers, uint32 numBarriers, const char* debugLabel);
+    // Compute shaders only, must be recorded outside of render passes
+    void CmdDispatch(uint32 shaderID, uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ, const char* debugLabel);
+    // argsBufferHandle holds maxDrawCount tightly packed GPUDrawIndexedIndirectArgs
+    void CmdDrawIndirect(ResourceHandle indexBufferHandle, ResourceHandle argsBufferHandle, uint32 argsOffset,
+        ResourceHandle countBufferHandle, uint32 countOffset, uint32 maxDrawCount,
+        uint32 shaderID, uint32 blendState, uint32 depthState, const DescriptorHandle* descriptors, uint32 numDescriptors,
+        const char* debugLabel);
+    void CmdBufferBarriers(const BufferBarrier* barriers, uint32 numBarriers, const char* debugLabel);
+    // argsBufferHandle holds a GPUDispatchIndirectArgs at argsOffset
+    void CmdDispatchIndirect(uint32 shaderID, ResourceHandle argsBufferHandle, uint32 argsOffset, const char* debugLabel);
+
+private:
+    // Returns the payload of a new command, or null if the stream can't grow
+    void* AllocCommand(uint32 commandType, uint32 payloadAlignment, uint32 payloadSizeInBytes, const char* debugLabel);
 };
 
 
-// TODO: move all this, and also autogenerate this eventually?
 // TODO: don't use them as uint32's 
-// IDs must be uniquely named and have their id ascend monotonically from 0
+// IDs must be uniquely named and have their id ascend monotonically from 0. Layouts of shader resources that match none
+// of the named layouts, and compute shaders found in the spv directory that aren't named here, get IDs from the ranges
+// at the end, see ShaderManager.
+#define DESCLAYOUT_REFLECTED_MAX 16
+#define SHADER_DISCOVERED_MAX 16
 enum
 {
-    DESCLAYOUT_ID_SWAP_CHAIN_BLIT_TEX = 0,
-    DESCLAYOUT_ID_SWAP_CHAIN_BLIT_VBS,
-    DESCLAYOUT_ID_VIEW_GLOBAL,
+    DESCLAYOUT_ID_VIEW_GLOBAL = 0,
     DESCLAYOUT_ID_ASSET_INSTANCE,
     DESCLAYOUT_ID_ASSET_VBS,
     DESCLAYOUT_ID_POSONLY_VBS,
     DESCLAYOUT_ID_IMGUI_VBS,
     DESCLAYOUT_ID_IMGUI_TEX,
-    DESCLAYOUT_ID_MAX,
+    DESCLAYOUT_ID_BINDLESS, // created by the graphics backend, see GetBindlessIndex
+    DESCLAYOUT_ID_REFLECTED_FIRST,
+    DESCLAYOUT_ID_MAX = DESCLAYOUT_ID_REFLECTED_FIRST + DESCLAYOUT_REFLECTED_MAX,
 };
 
 enum
@@ -432,10 +606,34 @@ enum
     SHADER_ID_IMGUI_DEBUGUI,
     SHADER_ID_Pass1,
     SHADER_ID_Pass2,
-    SHADER_ID_MAX,
+    SHADER_ID_INSTANCES,
+    SHADER_ID_CULL_INSTANCES_CS,
+    SHADER_ID_BENCH_REDUCE_CS,
+    SHADER_ID_BENCH_PREFIX_SUM_CS,
+    SHADER_ID_BENCH_BLUR_CS,
+    SHADER_ID_DISCOVERED_FIRST,
+    SHADER_ID_MAX = SHADER_ID_DISCOVERED_FIRST + SHADER_DISCOVERED_MAX,
 };
 //-----
 
+// Layout of one indexed indirect draw in an args buffer, matches VkDrawIndexedIndirectCommand
+typedef struct gpu_draw_indexed_indirect_args
+{
+    uint32 indexCount;
+    uint32 instanceCount;
+    uint32 firstIndex;
+    int32 vertexOffset;
+    uint32 firstInstance;
+} GPUDrawIndexedIndirectArgs;
+
+// Layout of one indirect dispatch in an args buffer, matches VkDispatchIndirectCommand
+typedef struct gpu_dispatch_indirect_args
+{
+    uint32 groupCountX;
+    uint32 groupCountY;
+    uint32 groupCountZ;
+} GPUDispatchIndirectArgs;
+
 // Graphics API layer
 #define CREATE_RESOURCE(name) ResourceHandle name(const ResourceDesc& resDesc)
 CREATE_RESOURCE(CreateResource);
@@ -452,6 +650,11 @@ UNMAP_RESOURCE(UnmapResource);
 #define CREATE_DESCRIPTOR(name) DescriptorHandle name(uint32 descLayoutID)
 CREATE_DESCRIPTOR(CreateDescriptor);
 
+// Transient descriptors come from a per frame pool that is reset wholesale once the frame has retired. They are only
+// valid for the frame they are created in and are never destroyed.
+#define CREATE_TRANSIENT_DESCRIPTOR(name) DescriptorHandle name(uint32 descLayoutID)
+CREATE_TRANSIENT_DESCRIPTOR(CreateTransientDescriptor);
+
 #define DESTROY_DESCRIPTOR(name) void name(DescriptorHandle handle)
 DESTROY_DESCRIPTOR(DestroyDescriptor);
 
@@ -471,7 +674,7 @@ void RecordCommandDrawCall(ResourceHandle indexBufferHandle, uint32 numIndices,
     uint32 vertOffset, uint32 indexOffset, const char* debugLabel, bool immediateSubmit);
 void RecordCommandBindShader(uint32 shaderID, uint32 blendState, uint32 depthState, bool immediateSubmit);
 void RecordCommandBindDescriptor(uint32 shaderID, const DescriptorHandle descSetHandle, uint32 descSetIndex, bool immediateSubmit);
-void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHandle, ResourceHandle dstBufferHandle,
+void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHandle, uint32 srcOffset, ResourceHandle dstBufferHandle, uint32 dstOffset,
     const char* debugLabel, bool immediateSubmit);
 void RecordCommandRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colorRTs, ResourceHandle depthRT,
     uint32 renderWidth, uint32 renderHeight, const char* debugLabel, bool immediateSubmit);
@@ -481,15 +684,26 @@ void RecordCommandTransitionLayout(ResourceHandle imageHandle, uint32 startLayou
 void RecordCommandClearImage(ResourceHandle imageHandle, 
     const v4f& clearValue, const char* debugLabel, bool immediateSubmit);
 void RecordCommandGPUTimestamp(uint32 gpuTimestampID, bool immediateSubmit);
+void RecordCommandImageBarriers(const ImageBarrier* barriers, uint32 numBarriers, const char* debugLabel, bool immediateSubmit);
+void RecordCommandBindComputeShader(uint32 shaderID, bool immediateSubmit);
+void RecordCommandDispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ, const char* debugLabel, bool immediateSubmit);
+void RecordCommandDispatchIndirect(ResourceHandle argsBufferHandle, uint32 argsOffset, const char* debugLabel, bool immediateSubmit);
+void RecordCommandDrawIndirect(ResourceHandle indexBufferHandle, ResourceHandle argsBufferHandle, uint32 argsOffset,
+    ResourceHandle countBufferHandle, uint32 countOffset, uint32 maxDrawCount, const char* debugLabel, bool immediateSubmit);
+void RecordCommandBufferBarriers(const BufferBarrier* barriers, uint32 numBarriers, const char* debugLabel, bool immediateSubmit);
 //
 
 // Called only by ShaderManager
 #define CREATE_DESCRIPTOR_LAYOUT(name) bool name(uint32 descLayoutID, const DescriptorLayout* descLayout)
 CREATE_DESCRIPTOR_LAYOUT(CreateDescriptorLayout);
 
-#define CREATE_GRAPHICS_PIPELINE(name) bool name(void* vertexShaderCode, uint32 numVertexShaderBytes, void* fragmentShaderCode, uint32 numFragmentShaderBytes, uint32 shaderID, uint32 viewportWidth, uint32 viewportHeight, uint32 numColorRTs, const uint32* colorRTFormats, uint32 depthFormat, uint32* descriptorHandles, uint32 numDescriptorHandles)
+#define CREATE_GRAPHICS_PIPELINE(name) bool name(const void* vertexShaderCode, uint32 numVertexShaderBytes, const void* fragmentShaderCode, uint32 numFragmentShaderBytes, uint32 shaderID, uint32 numColorRTs, const uint32* colorRTFormats, uint32 depthFormat, uint32* descriptorHandles, uint32 numDescriptorHandles)
 CREATE_GRAPHICS_PIPELINE(CreateGraphicsPipeline);
 
+#define CREATE_COMPUTE_PIPELINE(name) bool name(const void* computeShaderCode, uint32 numComputeShaderBytes, uint32 shaderID, uint32* descriptorHandles, uint32 numDescriptorHandles)
+CREATE_COMPUTE_PIPELINE(CreateComputePipeline);
+
+// Destroys compute pipelines too
 #define DESTROY_GRAPHICS_PIPELINE(name) void name(uint32 shaderID)
 DESTROY_GRAPHICS_PIPELINE(DestroyGraphicsPipeline);
 //
@@ -507,8 +721,140 @@ void BeginFrameRecording();
 void EndFrameRecording();
 void SubmitFrameToGPU();
 
+// Async compute streams hold compute work that doesn't depend on the frame's graphics work, only dispatches, copies,
+// clears and barriers. With a dedicated compute queue family they are submitted to that queue and overlap the frame's
+// graphics work, otherwise they are recorded at the start of the graphics frame. Results are visible to the next frame.
+// Process between BeginFrameRecording and EndFrameRecording, before the frame's graphics command stream.
+void ProcessAsyncComputeCommandStream(const Tk::Graphics::GraphicsCommandStream* asyncComputeCommandStream);
+// Disabling keeps async compute streams on the graphics queue even with a dedicated compute queue, as a baseline
+void SetAsyncComputeEnabled(bool enabled);
+// numFramesInFlight in [1, MAX_FRAMES_IN_FLIGHT]. Takes effect at the next AcquireFrame.
+void SetFramePacing(uint32 numFramesInFlight, uint32 framePacingMode);
+
+// Sub-allocation of this frame's copy of the transient upload ring. Only valid until the frame is submitted.
+typedef struct transient_allocation
+{
+    void* cpuPtr; // nullptr if the ring is full for this frame
+    uint32 offset; // byte offset into the ring's current frame copy, for draw offsets or dynamic descriptor offsets
+    uint32 sizeInBytes;
+} TransientAllocation;
+
+// One bump of a persistently mapped linear allocator, the whole frame's range gets flushed once at submit.
+// alignment must be a power of two.
+TransientAllocation AllocTransient(uint32 sizeInBytes, uint32 alignment);
+// Buffer backing every TransientAllocation, bind it with the allocation's offset
+ResourceHandle GetTransientUploadRing();
+
+// Staged uploads, batched into one submission on the transfer queue. Each returns the upload value of the batch it
+// was recorded into (0 on failure). Frames recorded after that value completes see the data, the first use has to wait
+// until IsUploadComplete or WaitForUpload. Destinations must not be in use by in-flight frames.
+uint64 UploadBufferData(ResourceHandle dstBuffer, uint32 dstOffset, const void* data, uint32 sizeInBytes);
+// Replaces the whole image, which is left in the shader read layout
+uint64 UploadImageData(ResourceHandle dstImage, const void* data, uint32 sizeInBytes);
+// Submits the current batch, returns the upload value of the most recently submitted batch
+uint64 SubmitUploads();
+bool IsUploadComplete(uint64 uploadValue);
+// Submits the batch first if needed
+void WaitForUpload(uint64 uploadValue);
+
+// Transient images get no device memory of their own. CreateTransientHeap allocates one range of device memory and
+// binds each image at its offset, so images that are never alive at the same time can share bytes. The heap is
+// destroyed with DestroyResource like any other resource. Returns DefaultResHandle_Invalid if the memory can't be
+// allocated, the images are then unusable.
+void GetImageMemoryRequirements(ResourceHandle imageHandle, uint64* outSizeInBytes, uint64* outAlignment);
+ResourceHandle CreateTransientHeap(uint64 sizeInBytes, const ResourceHandle* imageHandles, const uint64* imageOffsets, uint32 numImages, const char* debugLabel);
+
+// Every storage buffer and sampled image gets a slot in one global descriptor set when it is created. Shaders that use
+// DESCLAYOUT_ID_BINDLESS as their first descriptor layout index those arrays with indices passed in push constants
+// instead of binding descriptor sets per draw. Multi-buffered buffers return the slot of the current frame's copy.
+// Storage images (ResourceDesc::isStorage) are also in the compute only storage image array at the same slot.
+#define BINDLESS_BINDING_STORAGE_BUFFERS 0
+#define BINDLESS_BINDING_SAMPLED_IMAGES 1
+#define BINDLESS_BINDING_STORAGE_IMAGES 2
+#define BINDLESS_INDEX_INVALID TINKER_INVALID_HANDLE
+uint32 GetBindlessIndex(ResourceHandle handle);
+
+// Sorts each run of consecutive opaque, depth writing draw calls by pipeline, descriptors and index buffer before recording
+void SetDrawCallSorting(bool enabled);
+bool IsDrawCallSortingEnabled();
+
+typedef struct command_stream_stats
+{
+    uint32 numDraws;
+    uint32 numSortedDraws;
+    uint32 numPSOBinds;
+    uint32 numDescriptorBinds;
+    uint32 numPSOBindsUnsorted; // what the recorded order would have bound
+    uint32 numDescriptorBindsUnsorted;
+    uint32 numDispatches;
+    uint32 numIndirectDraws; // commands, the draws themselves are decided on the gpu
+
+    uint32 numCommands;
+    uint32 numCommandBytes;
+    float replayTimeMS; // cpu time spent in ProcessGraphicsCommandStream
+} CommandStreamStats;
+
+// Last submitted frame, immediate submits aren't counted
+void GetCommandStreamStats(CommandStreamStats* outStats);
+
+typedef struct command_stream_benchmark
+{
+    uint32 numCommands;
+    uint32 numBytes;
+    uint32 numBinds; // pso and descriptor binds the replay would have recorded
+    float recordTimeMS;
+    float decodeTimeMS; // walking the stream and tracking bind state, nothing is recorded to the graphics api
+} CommandStreamBenchmark;
+
+// Records a synthetic stream of numCommands push constants, draws and scissors like a scene pass would, then decodes it
+// with the same bind state tracking as the replay. Doesn't time the Record* calls of a real replay.
+void BenchmarkCommandStream(uint32 numCommands, CommandStreamBenchmark* outResults);
+
+typedef struct graphics_stats
+{
+    uint32 numDeferredDestroysPending;
+    uint64 numDeferredDestroysTotal;
+    uint64 numDeviceStallsAvoided;
+
+    uint32 numFramesInFlight;
+    uint32 framePacingMode;
+    float avgFrameTimeMS; // cpu frame start to frame start
+    float avgInputToGPUCompleteMS; // input sampling to the frame's gpu work completing, as observed at the next frame starts
+
+    uint32 transientUploadBytesUsed; // last submitted frame
+    uint32 transientUploadRingSize; // per frame in flight
+    uint32 numMappedRangeFlushes; // vkFlushMappedMemoryRanges calls last submitted frame
+
+    bool hasDedicatedTransferQueue;
+    uint32 numUploadBatchesInFlight;
+    uint64 numUploadBatchesTotal;
+    uint64 numUploadBytesTotal;
+
+    bool hasDedicatedComputeQueue;
+    bool isAsyncComputeEnabled;
+    bool wasAsyncComputeOnComputeQueue; // last frame with an async compute stream
+    float avgGraphicsQueueGPUTimeMS; // whole graphics command buffer, including async compute streams recorded into it
+    float avgAsyncComputeGPUTimeMS; // async compute streams, on whichever queue ran them
+
+    uint32 numDescriptorPools;
+    uint64 numDescriptorSetsAllocated;
+    uint64 numDescriptorSetsRecycled;
+    uint32 numTransientDescriptors; // last submitted frame
+
+    uint32 numBindlessBuffers;
+    uint32 maxBindlessBuffers;
+    uint32 numBindlessImages;
+    uint32 maxBindlessImages;
+
+    uint32 numGraphicsPSOs; // live graphics pipelines, across all shaders
+    uint32 numShaderModules; // distinct bytecode, pipelines built from the same bytecode share one module
+    bool isBlendStateDynamic; // otherwise each blend state in use is its own pipeline
+    uint32 numDescriptorSetLayouts; // distinct layouts, descriptor layout IDs with identical bindings share one
+} GraphicsStats;
+
 float GetGPUTimestampPeriod();
 uint32 GetCurrentFrameInFlightIndex();
+void GetGraphicsStats(GraphicsStats* outStats);
 void ResolveMostRecentAvailableTimestamps(void* gpuTimestampCPUSideBuffer, uint32 numTimestampsInQuery, bool immediateSubmit);
 
 }
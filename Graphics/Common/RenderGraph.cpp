@@ -0,0 +1,432 @@
+#include "RenderGraph.h"
+#include "Utility/Logging.h"
+
+#include <stdio.h>
+
+namespace Tk
+{
+namespace Graphics
+{
+
+static_assert(RENDER_GRAPH_MAX_ACCESSES_PER_PASS <= MAX_IMAGE_BARRIERS_PER_COMMAND);
+static_assert(RENDER_GRAPH_MAX_RESOURCES <= MAX_IMAGE_BARRIERS_PER_COMMAND);
+static_assert(ImageAccess::eMax <= 32); // ImageBarrier::aliasSrcAccesses
+
+void RenderGraph::Reset()
+{
+    // Transient images have to be destroyed before the graph describing them is thrown away
+    TINKER_ASSERT(m_transientHeap == DefaultResHandle_Invalid);
+
+    m_numPasses = 0;
+    m_numResources = 0;
+    m_numBarriers = 0;
+    m_numLivePasses = 0;
+    m_firstFinalBarrier = 0;
+    m_numFinalBarriers = 0;
+    m_transientHeapBytes = 0;
+    m_transientBytesUnaliased = 0;
+}
+
+uint32 RenderGraph::ImportImage(ResourceHandle imageHandle, uint32 lastAccess, uint32 finalAccess, bool discardContents, const char* debugLabel)
+{
+    if (m_numResources >= RENDER_GRAPH_MAX_RESOURCES)
+    {
+        Core::Utility::LogMsg("Graphics", "Too many resources imported into render graph!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return TINKER_INVALID_HANDLE;
+    }
+    TINKER_ASSERT(lastAccess < ImageAccess::eMax && finalAccess < ImageAccess::eMax);
+
+    RenderGraphResource& resource = m_resources[m_numResources];
+    resource = {};
+    resource.imageHandle = imageHandle;
+    resource.lastAccess = lastAccess;
+    resource.finalAccess = finalAccess;
+    resource.discardContents = discardContents ? 1 : 0;
+    resource.debugLabel = debugLabel;
+    return m_numResources++;
+}
+
+uint32 RenderGraph::CreateTransientImage(const ResourceDesc& desc)
+{
+    TINKER_ASSERT(desc.resourceType == ResourceType::eImage2D);
+
+    uint32 resource = ImportImage(DefaultResHandle_Invalid, ImageAccess::eNone, ImageAccess::eNone, true, desc.debugLabel);
+    if (resource != TINKER_INVALID_HANDLE)
+    {
+        m_resources[resource].isTransient = 1;
+        m_resources[resource].transientDesc = desc;
+        m_resources[resource].transientDesc.isTransient = true;
+    }
+    return resource;
+}
+
+uint32 RenderGraph::AddPass(const char* name, render_graph_pass_func* func, void* userData)
+{
+    if (m_numPasses >= RENDER_GRAPH_MAX_PASSES)
+    {
+        Core::Utility::LogMsg("Graphics", "Too many passes added to render graph!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return TINKER_INVALID_HANDLE;
+    }
+
+    RenderGraphPass& pass = m_passes[m_numPasses];
+    pass = {};
+    pass.name = name;
+    pass.func = func;
+    pass.userData = userData;
+    return m_numPasses++;
+}
+
+void RenderGraph::AddAccess(uint32 pass, uint32 resource, uint32 access)
+{
+    TINKER_ASSERT(pass < m_numPasses && resource < m_numResources);
+    TINKER_ASSERT(access != ImageAccess::eNone && access < ImageAccess::eMax);
+
+    RenderGraphPass& renderPass = m_passes[pass];
+    if (renderPass.numAccesses >= RENDER_GRAPH_MAX_ACCESSES_PER_PASS)
+    {
+        Core::Utility::LogMsg("Graphics", "Too many resource accesses in render graph pass!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return;
+    }
+
+    for (uint32 uiAccess = 0; uiAccess < renderPass.numAccesses; ++uiAccess)
+    {
+        // An image can only be in one layout during a pass
+        TINKER_ASSERT(renderPass.accesses[uiAccess].resource != resource);
+    }
+
+    renderPass.accesses[renderPass.numAccesses].resource = resource;
+    renderPass.accesses[renderPass.numAccesses].access = access;
+    ++renderPass.numAccesses;
+}
+
+void RenderGraph::Compile()
+{
+    // Cull passes back to front - a pass is live if it writes something that is needed later.
+    // Passes that write nothing are assumed to have side effects outside the graph and are kept.
+    uint32 isResourceNeeded[RENDER_GRAPH_MAX_RESOURCES];
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        isResourceNeeded[uiRes] = m_resources[uiRes].finalAccess != ImageAccess::eNone;
+    }
+
+    m_numLivePasses = 0;
+    for (uint32 uiPass = m_numPasses; uiPass-- > 0;)
+    {
+        RenderGraphPass& pass = m_passes[uiPass];
+
+        bool writesAnything = false;
+        bool writesNeeded = false;
+        for (uint32 uiAccess = 0; uiAccess < pass.numAccesses; ++uiAccess)
+        {
+            const RenderGraphAccess& access = pass.accesses[uiAccess];
+            if (IsImageAccessWrite(access.access))
+            {
+                writesAnything = true;
+                writesNeeded |= isResourceNeeded[access.resource] != 0;
+            }
+        }
+
+        pass.isLive = (writesNeeded || !writesAnything) ? 1 : 0;
+        if (pass.isLive)
+        {
+            ++m_numLivePasses;
+
+            // Attachment writes load the existing contents, so everything a live pass touches is needed by it
+            for (uint32 uiAccess = 0; uiAccess < pass.numAccesses; ++uiAccess)
+            {
+                isResourceNeeded[pass.accesses[uiAccess].resource] = 1;
+            }
+        }
+    }
+
+    // Lifetimes of each image over the live passes
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        m_resources[uiRes].firstPass = TINKER_INVALID_HANDLE;
+        m_resources[uiRes].lastPass = TINKER_INVALID_HANDLE;
+        m_resources[uiRes].lastPassAccess = ImageAccess::eNone;
+    }
+    for (uint32 uiPass = 0; uiPass < m_numPasses; ++uiPass)
+    {
+        const RenderGraphPass& pass = m_passes[uiPass];
+        if (!pass.isLive)
+            continue;
+
+        for (uint32 uiAccess = 0; uiAccess < pass.numAccesses; ++uiAccess)
+        {
+            RenderGraphResource& resource = m_resources[pass.accesses[uiAccess].resource];
+            if (resource.firstPass == TINKER_INVALID_HANDLE)
+                resource.firstPass = uiPass;
+            resource.lastPass = uiPass;
+            resource.lastPassAccess = pass.accesses[uiAccess].access;
+        }
+    }
+
+    if (m_transientHeap == DefaultResHandle_Invalid)
+    {
+        AllocateTransientImages();
+    }
+    AliasTransientImages();
+
+    // Walk the live passes front to back and only emit a barrier when an image changes layout
+    // or when there is a write on either side of the dependency
+    uint32 currentAccess[RENDER_GRAPH_MAX_RESOURCES];
+    uint32 pendingDiscard[RENDER_GRAPH_MAX_RESOURCES];
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        currentAccess[uiRes] = m_resources[uiRes].lastAccess;
+        pendingDiscard[uiRes] = m_resources[uiRes].discardContents;
+    }
+
+    m_numBarriers = 0;
+    for (uint32 uiPass = 0; uiPass < m_numPasses; ++uiPass)
+    {
+        RenderGraphPass& pass = m_passes[uiPass];
+        pass.firstBarrier = m_numBarriers;
+        pass.numBarriers = 0;
+        if (!pass.isLive)
+            continue;
+
+        for (uint32 uiAccess = 0; uiAccess < pass.numAccesses; ++uiAccess)
+        {
+            const RenderGraphAccess& access = pass.accesses[uiAccess];
+            const uint32 srcAccess = currentAccess[access.resource];
+
+            if (srcAccess != access.access || IsImageAccessWrite(srcAccess) || IsImageAccessWrite(access.access) || pendingDiscard[access.resource])
+            {
+                ImageBarrier& barrier = m_barriers[m_numBarriers++];
+                barrier.imageHandle = m_resources[access.resource].imageHandle;
+                barrier.srcAccess = srcAccess;
+                barrier.dstAccess = access.access;
+                barrier.discardContents = pendingDiscard[access.resource];
+                barrier.aliasSrcAccesses = pendingDiscard[access.resource] ? m_resources[access.resource].aliasSrcAccesses : 0;
+                ++pass.numBarriers;
+            }
+
+            currentAccess[access.resource] = access.access;
+            pendingDiscard[access.resource] = 0;
+        }
+    }
+
+    // Leave each image in the access the next frame / presentation expects
+    m_firstFinalBarrier = m_numBarriers;
+    m_numFinalBarriers = 0;
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        const RenderGraphResource& resource = m_resources[uiRes];
+        if (resource.finalAccess == ImageAccess::eNone)
+            continue;
+
+        if (currentAccess[uiRes] != resource.finalAccess || pendingDiscard[uiRes])
+        {
+            ImageBarrier& barrier = m_barriers[m_numBarriers++];
+            barrier.imageHandle = resource.imageHandle;
+            barrier.srcAccess = currentAccess[uiRes];
+            barrier.dstAccess = resource.finalAccess;
+            barrier.discardContents = pendingDiscard[uiRes];
+            barrier.aliasSrcAccesses = 0;
+            ++m_numFinalBarriers;
+        }
+    }
+}
+
+static bool DoLifetimesOverlap(const RenderGraphResource& a, const RenderGraphResource& b)
+{
+    return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+}
+
+static bool DoHeapRangesOverlap(const RenderGraphResource& a, const RenderGraphResource& b)
+{
+    return a.heapOffset < b.heapOffset + b.sizeInBytes && b.heapOffset < a.heapOffset + a.sizeInBytes;
+}
+
+void RenderGraph::AllocateTransientImages()
+{
+    uint32 transients[RENDER_GRAPH_MAX_RESOURCES];
+    uint32 numTransients = 0;
+    uint64 alignments[RENDER_GRAPH_MAX_RESOURCES] = {};
+
+    m_transientHeapBytes = 0;
+    m_transientBytesUnaliased = 0;
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        RenderGraphResource& resource = m_resources[uiRes];
+        if (!resource.isTransient)
+            continue;
+
+        // An image no live pass touches still needs valid memory, just don't let it share any
+        if (resource.firstPass == TINKER_INVALID_HANDLE)
+        {
+            resource.firstPass = 0;
+            resource.lastPass = m_numPasses;
+        }
+
+        resource.imageHandle = CreateResource(resource.transientDesc);
+        GetImageMemoryRequirements(resource.imageHandle, &resource.sizeInBytes, &alignments[uiRes]);
+        m_transientBytesUnaliased += resource.sizeInBytes;
+
+        // Largest first, so that small images fill in the gaps
+        uint32 insertIdx = numTransients++;
+        while (insertIdx > 0 && m_resources[transients[insertIdx - 1]].sizeInBytes < resource.sizeInBytes)
+        {
+            transients[insertIdx] = transients[insertIdx - 1];
+            --insertIdx;
+        }
+        transients[insertIdx] = uiRes;
+    }
+
+    if (numTransients == 0)
+        return;
+
+    // Place each image at the lowest offset that doesn't collide with an already placed image that is alive at the same time
+    for (uint32 uiTransient = 0; uiTransient < numTransients; ++uiTransient)
+    {
+        RenderGraphResource& resource = m_resources[transients[uiTransient]];
+        const uint64 alignment = alignments[transients[uiTransient]];
+
+        uint64 bestOffset = MAX_UINT64;
+        for (uint32 uiCandidate = 0; uiCandidate <= uiTransient; ++uiCandidate)
+        {
+            // Candidate offsets are the start of the heap and the end of every placed image
+            uint64 candidateOffset = 0;
+            if (uiCandidate < uiTransient)
+            {
+                const RenderGraphResource& placed = m_resources[transients[uiCandidate]];
+                candidateOffset = placed.heapOffset + placed.sizeInBytes;
+            }
+            candidateOffset = (candidateOffset + alignment - 1) / alignment * alignment;
+            if (candidateOffset >= bestOffset)
+                continue;
+
+            resource.heapOffset = candidateOffset;
+            bool fits = true;
+            for (uint32 uiPlaced = 0; uiPlaced < uiTransient; ++uiPlaced)
+            {
+                const RenderGraphResource& placed = m_resources[transients[uiPlaced]];
+                if (DoLifetimesOverlap(resource, placed) && DoHeapRangesOverlap(resource, placed))
+                {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits)
+                bestOffset = candidateOffset;
+        }
+
+        resource.heapOffset = bestOffset;
+        m_transientHeapBytes = Max(m_transientHeapBytes, resource.heapOffset + resource.sizeInBytes);
+    }
+
+    ResourceHandle imageHandles[RENDER_GRAPH_MAX_RESOURCES];
+    uint64 imageOffsets[RENDER_GRAPH_MAX_RESOURCES];
+    for (uint32 uiTransient = 0; uiTransient < numTransients; ++uiTransient)
+    {
+        imageHandles[uiTransient] = m_resources[transients[uiTransient]].imageHandle;
+        imageOffsets[uiTransient] = m_resources[transients[uiTransient]].heapOffset;
+    }
+    m_transientHeap = CreateTransientHeap(m_transientHeapBytes, imageHandles, imageOffsets, numTransients, "Render graph transient heap");
+    if (m_transientHeap == DefaultResHandle_Invalid)
+    {
+        Core::Utility::LogMsg("Graphics", "Render graph transient images have no memory!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return;
+    }
+
+    char msg[256];
+    snprintf(msg, sizeof(msg), "Render graph transient images: %u, %.2f MB aliased (%.2f MB without aliasing).",
+        numTransients, (double)m_transientHeapBytes / (1024.0 * 1024.0), (double)m_transientBytesUnaliased / (1024.0 * 1024.0));
+    Core::Utility::LogMsg("Graphics", msg, Core::Utility::LogSeverity::eInfo);
+}
+
+void RenderGraph::AliasTransientImages()
+{
+    // The first use of a transient image is an aliasing barrier: it starts from the undefined layout and waits on the
+    // last access of every other image sharing its bytes, earlier in this frame or later in the previous one. A single
+    // predecessor isn't enough, a large image can cover several smaller ones that don't overlap each other.
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        RenderGraphResource& resource = m_resources[uiRes];
+        if (!resource.isTransient || resource.lastPassAccess == ImageAccess::eNone)
+            continue;
+
+        resource.aliasSrcAccesses = 0;
+        for (uint32 uiOther = 0; uiOther < m_numResources; ++uiOther)
+        {
+            const RenderGraphResource& other = m_resources[uiOther];
+            if (uiOther == uiRes || !other.isTransient || other.lastPassAccess == ImageAccess::eNone || !DoHeapRangesOverlap(resource, other))
+                continue;
+
+            resource.aliasSrcAccesses |= 1u << other.lastPassAccess;
+        }
+
+        // Its own last access, from the previous frame
+        resource.lastAccess = resource.lastPassAccess;
+        resource.discardContents = 1;
+    }
+}
+
+void RenderGraph::Execute(GraphicsCommandStream* graphicsCommandStream) const
+{
+    for (uint32 uiPass = 0; uiPass < m_numPasses; ++uiPass)
+    {
+        const RenderGraphPass& pass = m_passes[uiPass];
+        if (!pass.isLive)
+            continue;
+
+        if (pass.numBarriers)
+        {
+            graphicsCommandStream->CmdImageBarriers(&m_barriers[pass.firstBarrier], pass.numBarriers, pass.name);
+        }
+        pass.func(graphicsCommandStream, pass.userData);
+    }
+
+    if (m_numFinalBarriers)
+    {
+        graphicsCommandStream->CmdImageBarriers(&m_barriers[m_firstFinalBarrier], m_numFinalBarriers, "Render graph final transitions");
+    }
+}
+
+ResourceHandle RenderGraph::GetImage(uint32 resource) const
+{
+    TINKER_ASSERT(resource < m_numResources);
+    return m_resources[resource].imageHandle;
+}
+
+void RenderGraph::DestroyTransientImages()
+{
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        RenderGraphResource& resource = m_resources[uiRes];
+        if (resource.isTransient && resource.imageHandle != DefaultResHandle_Invalid)
+        {
+            DestroyResource(resource.imageHandle);
+            resource.imageHandle = DefaultResHandle_Invalid;
+        }
+    }
+
+    if (m_transientHeap != DefaultResHandle_Invalid)
+    {
+        DestroyResource(m_transientHeap);
+        m_transientHeap = DefaultResHandle_Invalid;
+    }
+}
+
+void RenderGraph::GetStats(RenderGraphStats* outStats) const
+{
+    *outStats = {};
+    outStats->numPasses = m_numPasses;
+    outStats->numLivePasses = m_numLivePasses;
+    outStats->numBarriers = m_numBarriers;
+    for (uint32 uiRes = 0; uiRes < m_numResources; ++uiRes)
+    {
+        outStats->numTransientImages += m_resources[uiRes].isTransient;
+    }
+    outStats->transientBytesUnaliased = m_transientBytesUnaliased;
+    outStats->transientHeapBytes = m_transientHeapBytes;
+}
+
+}
+}
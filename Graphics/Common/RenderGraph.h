@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreDefines.h"
+#include "GraphicsCommon.h"
+
+namespace Tk
+{
+namespace Graphics
+{
+
+#define RENDER_GRAPH_MAX_PASSES 32
+#define RENDER_GRAPH_MAX_RESOURCES 32
+#define RENDER_GRAPH_MAX_ACCESSES_PER_PASS 8
+#define RENDER_GRAPH_MAX_BARRIERS (RENDER_GRAPH_MAX_PASSES * RENDER_GRAPH_MAX_ACCESSES_PER_PASS + RENDER_GRAPH_MAX_RESOURCES)
+
+#define RENDER_GRAPH_PASS_FUNC(name) void name(Tk::Graphics::GraphicsCommandStream* graphicsCommandStream, void* userData)
+typedef RENDER_GRAPH_PASS_FUNC(render_graph_pass_func);
+
+typedef struct render_graph_access
+{
+    uint32 resource;
+    uint32 access; // ImageAccess
+} RenderGraphAccess;
+
+typedef struct render_graph_pass
+{
+    const char* name;
+    render_graph_pass_func* func;
+    void* userData;
+    RenderGraphAccess accesses[RENDER_GRAPH_MAX_ACCESSES_PER_PASS];
+    uint32 numAccesses;
+
+    // Filled out by Compile()
+    uint32 isLive;
+    uint32 firstBarrier;
+    uint32 numBarriers;
+} RenderGraphPass;
+
+typedef struct render_graph_resource
+{
+    ResourceHandle imageHandle;
+    uint32 lastAccess; // access the image was left in before this graph runs
+    uint32 finalAccess; // access the image must be in after this graph runs, eNone if the contents aren't needed afterwards
+    uint32 discardContents; // contents at the start of the graph can be thrown away
+    const char* debugLabel;
+
+    // Transient images are created by the graph and alias device memory with other transients whose lifetimes don't overlap
+    uint32 isTransient;
+    ResourceDesc transientDesc;
+    uint64 heapOffset;
+    uint64 sizeInBytes;
+    uint32 aliasSrcAccesses; // bit per ImageAccess of the other transients sharing its bytes, see ImageBarrier
+
+    // Filled out by Compile(), first/last live pass that accesses the image
+    uint32 firstPass;
+    uint32 lastPass;
+    uint32 lastPassAccess;
+} RenderGraphResource;
+
+typedef struct render_graph_stats
+{
+    uint32 numPasses;
+    uint32 numLivePasses;
+    uint32 numBarriers;
+    uint32 numTransientImages;
+    uint64 transientBytesUnaliased; // every transient image in its own allocation
+    uint64 transientHeapBytes; // peak with aliasing, the size of the transient heap
+} RenderGraphStats;
+
+// Passes declare the images they touch and how. Compile() culls passes whose results are never
+// consumed and derives the minimal set of barriers/layout transitions between the remaining passes,
+// batching them into one barrier command per pass.
+// The graph is meant to be built and compiled once and executed every frame - transient images are
+// placed into their heap on the first Compile() and live until DestroyTransientImages().
+struct RenderGraph
+{
+    RenderGraphPass m_passes[RENDER_GRAPH_MAX_PASSES];
+    RenderGraphResource m_resources[RENDER_GRAPH_MAX_RESOURCES];
+    ImageBarrier m_barriers[RENDER_GRAPH_MAX_BARRIERS];
+    uint32 m_numPasses;
+    uint32 m_numResources;
+    uint32 m_numBarriers;
+    uint32 m_numLivePasses;
+    uint32 m_firstFinalBarrier;
+    uint32 m_numFinalBarriers;
+
+    ResourceHandle m_transientHeap;
+    uint64 m_transientHeapBytes;
+    uint64 m_transientBytesUnaliased;
+
+    void Reset();
+
+    uint32 ImportImage(ResourceHandle imageHandle, uint32 lastAccess, uint32 finalAccess, bool discardContents, const char* debugLabel);
+    // Contents never survive the frame, the image handle is valid after Compile()
+    uint32 CreateTransientImage(const ResourceDesc& desc);
+    uint32 AddPass(const char* name, render_graph_pass_func* func, void* userData);
+    void AddAccess(uint32 pass, uint32 resource, uint32 access);
+
+    void Compile();
+    void Execute(GraphicsCommandStream* graphicsCommandStream) const;
+
+    ResourceHandle GetImage(uint32 resource) const;
+    void DestroyTransientImages();
+    void GetStats(RenderGraphStats* outStats) const;
+
+private:
+    void AllocateTransientImages();
+    void AliasTransientImages();
+};
+
+}
+}
@@ -1,15 +1,14 @@
 #include "Graphics/Common/ShaderManager.h"
 #include "Graphics/Common/GraphicsCommon.h"
+#include "Graphics/Common/ShaderReflection.h"
 #include "Platform/PlatformGameAPI.h"
-#include "Allocators.h"
+#include "StringTypes.h"
+#include "Utility/ScopedTimer.h"
 
 #ifdef _SHADERS_SPV_DIR
 #define SHADERS_SPV_PATH STRINGIFY(_SHADERS_SPV_DIR)
 #endif
 
-static const uint32 totalShaderBytecodeMaxSizeInBytes = 1024 * 1024 * 100;
-static Tk::Core::LinearAllocator g_ShaderBytecodeAllocator;
-
 namespace Tk
 {
 namespace Graphics
@@ -34,144 +33,906 @@ typedef struct gfx_pipeline_attach_fmts
     }
 } GraphicsPipelineAttachmentFormats;
 
-static bool LoadShader(const char* vertexShaderFileName, const char* fragmentShaderFileName,
-    uint32 shaderID, uint32 viewportWidth, uint32 viewportHeight,
-    const GraphicsPipelineAttachmentFormats& pipelineFormats,
-    uint32* descLayouts, uint32 numDescLayouts)
+// Compiled shader files, found in the shader archive by their stage suffix. Files are only ever added, so a file's index
+// is stable for the rest of the session.
+#define SHADER_FILES_MAX 64
+#define SHADER_FILE_INVALID SHADER_FILES_MAX
+
+static const char* g_ShaderFileSuffixes[] =
+{
+    "_VS.spv",
+    "_PS.spv",
+    "_CS.spv",
+};
+
+static char g_ShaderFilenames[SHADER_FILES_MAX][COMPILED_SHADER_FILENAME_MAX] = {}; // default variant, e.g. "blit_VS.spv"
+static uint32 g_NumShaderFiles = 0;
+
+// Packed bytecode written by the shader compiler. It is only mapped while shaders are loaded, so that the compiler can
+// rewrite it between hotloads, and bytecode pointers into it are only valid until the load finishes.
+static Tk::Platform::MappedFile g_ShaderArchive = {};
+static const ShaderCompiler::ShaderArchiveEntry* g_ShaderArchiveEntries = nullptr;
+static uint32 g_NumShaderArchiveEntries = 0;
+static const uint8* g_ShaderArchiveBlobs = nullptr; // entry blob offsets are relative to this
+
+// Without an archive, e.g. in a checkout where only the loose spv files were compiled, those are read into one
+// allocation and indexed with the same entries for the duration of the load
+#define SHADER_LOOSE_FILES_MAX 256
+static ShaderCompiler::ShaderArchiveEntry g_LooseShaderEntries[SHADER_LOOSE_FILES_MAX] = {};
+static uint8* g_LooseShaderBlobs = nullptr;
+
+typedef struct shader_bytecode
+{
+    const uint8* data; // into g_ShaderArchiveBlobs, null while it isn't mapped
+    uint32 sizeInBytes;
+    uint64 contentHash; // of the bytecode the file was last reflected from
+} ShaderBytecode;
+static ShaderBytecode g_ShaderBytecode[SHADER_FILES_MAX] = {};
+
+// Resource interface of the bytecode in g_ShaderBytecode, pipelines derive their descriptor layouts from it
+static ShaderReflection::ShaderReflectionData g_ShaderReflections[SHADER_FILES_MAX] = {};
+static bool g_IsShaderReflected[SHADER_FILES_MAX] = {};
+
+// Compiled variant each shader file uses, g_ShaderBytecode holds the bytecode of this variant
+typedef struct shader_file_variant
+{
+    uint32 variantKey;
+    char spvFilename[COMPILED_SHADER_FILENAME_MAX]; // empty for the default variant
+} ShaderFileVariant;
+static ShaderFileVariant g_ShaderFileVariants[SHADER_FILES_MAX] = {};
+
+// Lists the compiled variants, read again on first use after shaders were recompiled
+static ShaderCompiler::ShaderManifest g_ShaderManifest = {};
+static bool g_IsShaderManifestLoaded = false;
+
+// Descriptor layouts created so far, so that shaders with identical set signatures share one layout ID
+static DescriptorLayout g_DescLayouts[Graphics::DESCLAYOUT_ID_MAX] = {};
+static bool g_IsDescLayoutCreated[Graphics::DESCLAYOUT_ID_MAX] = {};
+static uint32 g_NumReflectedDescLayouts = 0;
+
+// blit_VS.spv for the default variant of the blit vertex shader
+static const char* GetShaderFileSpvFilename(uint32 shaderFile)
+{
+    return g_ShaderFilenames[shaderFile];
+}
+
+static uint32 FindShaderFileByName(const char* spvFilename)
+{
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles; ++uiFile)
+    {
+        if (strcmp(g_ShaderFilenames[uiFile], spvFilename) == 0)
+            return uiFile;
+    }
+    return SHADER_FILE_INVALID;
+}
+
+// Variant spv files, e.g. "bench_reduce_CS_1a2b3c4d.spv", end in their key instead of a stage suffix
+static bool IsDefaultVariantSpvFilename(const char* spvFilename)
+{
+    const size_t len = strlen(spvFilename);
+    for (uint32 uiSuffix = 0; uiSuffix < ARRAYCOUNT(g_ShaderFileSuffixes); ++uiSuffix)
+    {
+        const size_t suffixLen = strlen(g_ShaderFileSuffixes[uiSuffix]);
+        if (len > suffixLen && strcmp(spvFilename + len - suffixLen, g_ShaderFileSuffixes[uiSuffix]) == 0)
+            return true;
+    }
+    return false;
+}
+
+static uint32 AddShaderFile(const char* spvFilename)
+{
+    uint32 shaderFile = FindShaderFileByName(spvFilename);
+    if (shaderFile != SHADER_FILE_INVALID)
+        return shaderFile;
+
+    if (g_NumShaderFiles == SHADER_FILES_MAX || strlen(spvFilename) >= COMPILED_SHADER_FILENAME_MAX)
+    {
+        Core::Utility::LogMsg("Graphics", "Too many shader files, or the spv filename is too long. Skipping shader.", Core::Utility::LogSeverity::eWarning);
+        return SHADER_FILE_INVALID;
+    }
+
+    shaderFile = g_NumShaderFiles++;
+    memcpy(g_ShaderFilenames[shaderFile], spvFilename, strlen(spvFilename) + 1);
+    g_ShaderBytecode[shaderFile] = {};
+    g_ShaderFileVariants[shaderFile] = {};
+    g_IsShaderReflected[shaderFile] = false;
+    return shaderFile;
+}
+
+static void GetSpvFilepath(const char* spvFilename, Tk::Core::StrFixedBuffer<512>& outFilepath)
+{
+    outFilepath.Clear();
+    outFilepath.Append(SHADERS_SPV_PATH);
+    outFilepath.Append(spvFilename);
+    outFilepath.NullTerminate();
+}
+
+// Reads every loose spv file into g_LooseShaderBlobs and indexes them like archive entries
+static bool ReadLooseShaderFiles()
+{
+    Tk::Core::StrFixedBuffer<512> searchPath;
+    GetSpvFilepath("*.spv", searchPath);
+
+    uint32 numEntries = 0;
+    uint32 totalSizeInBytes = 0;
+    wchar_t foundFilename[COMPILED_SHADER_FILENAME_MAX] = {};
+    Tk::Platform::FileHandle findFileHandle = Tk::Platform::FindFileOpen(searchPath.m_data, foundFilename, ARRAYCOUNT(foundFilename));
+    uint32 findFileError = findFileHandle.h == findFileHandle.eInvalidValue;
+    while (!findFileError && numEntries < SHADER_LOOSE_FILES_MAX)
+    {
+        // Compiled shader names are plain ascii
+        ShaderCompiler::ShaderArchiveEntry& entry = g_LooseShaderEntries[numEntries];
+        entry = {};
+        for (uint32 uiChar = 0; uiChar < ARRAYCOUNT(entry.spvFilename) - 1 && foundFilename[uiChar]; ++uiChar)
+            entry.spvFilename[uiChar] = (char)foundFilename[uiChar];
+
+        Tk::Core::StrFixedBuffer<512> filepath;
+        GetSpvFilepath(entry.spvFilename, filepath);
+        const uint64 sizeInBytes = Tk::Platform::GetEntireFileSize(filepath.m_data);
+        if (sizeInBytes > 0 && sizeInBytes <= 0xFFFFFFFF - SHADER_ARCHIVE_BLOB_ALIGNMENT - totalSizeInBytes)
+        {
+            entry.blobOffset = totalSizeInBytes;
+            entry.blobSizeInBytes = (uint32)sizeInBytes;
+            totalSizeInBytes = (totalSizeInBytes + entry.blobSizeInBytes + SHADER_ARCHIVE_BLOB_ALIGNMENT - 1) & ~(SHADER_ARCHIVE_BLOB_ALIGNMENT - 1);
+            ++numEntries;
+        }
+
+        memset(foundFilename, 0, sizeof(foundFilename));
+        findFileError = Tk::Platform::FindFileNext(findFileHandle, foundFilename, ARRAYCOUNT(foundFilename));
+    }
+    Tk::Platform::FindFileClose(findFileHandle);
+
+    if (!numEntries)
+        return false;
+
+    g_LooseShaderBlobs = (uint8*)Tk::Platform::AllocAlignedRaw(totalSizeInBytes, SHADER_ARCHIVE_BLOB_ALIGNMENT);
+    for (uint32 uiEntry = 0; uiEntry < numEntries; ++uiEntry)
+    {
+        ShaderCompiler::ShaderArchiveEntry& entry = g_LooseShaderEntries[uiEntry];
+        Tk::Core::StrFixedBuffer<512> filepath;
+        GetSpvFilepath(entry.spvFilename, filepath);
+        uint8* blob = g_LooseShaderBlobs + entry.blobOffset;
+        if (Tk::Platform::ReadEntireFile(filepath.m_data, entry.blobSizeInBytes, blob))
+        {
+            // The file changed size or went away since it was found, drop it
+            entry.spvFilename[0] = '\0';
+            entry.blobSizeInBytes = 0;
+            continue;
+        }
+        entry.contentHash = ShaderCompiler::HashSpvContent(blob, entry.blobSizeInBytes);
+    }
+
+    g_ShaderArchiveEntries = g_LooseShaderEntries;
+    g_NumShaderArchiveEntries = numEntries;
+    g_ShaderArchiveBlobs = g_LooseShaderBlobs;
+    return true;
+}
+
+static bool MapShaderArchive()
+{
+    TINKER_ASSERT(!g_ShaderArchive.data && !g_LooseShaderBlobs);
+
+    Tk::Core::StrFixedBuffer<512> archiveFilepath;
+    GetSpvFilepath(SHADER_ARCHIVE_FILENAME, archiveFilepath);
+    if (!Tk::Platform::MapFileReadOnly(archiveFilepath.m_data, Tk::Platform::FileAccessPattern::eSequential, &g_ShaderArchive))
+    {
+        if (ReadLooseShaderFiles())
+        {
+            Core::Utility::LogMsg("Graphics", "No shader archive, loaded the loose spv files instead.", Core::Utility::LogSeverity::eWarning);
+            return true;
+        }
+        Core::Utility::LogMsg("Graphics", "Failed to map shader archive and found no spv files!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    g_ShaderArchiveEntries = ShaderCompiler::GetShaderArchiveEntries(g_ShaderArchive.data, g_ShaderArchive.sizeInBytes, &g_NumShaderArchiveEntries);
+    if (!g_ShaderArchiveEntries)
+    {
+        Core::Utility::LogMsg("Graphics", "Shader archive is invalid, recompile shaders!", Core::Utility::LogSeverity::eCritical);
+        Tk::Platform::UnmapFile(&g_ShaderArchive);
+        return false;
+    }
+    g_ShaderArchiveBlobs = g_ShaderArchive.data;
+
+    // Every blob is about to be read, page the whole archive in at once
+    Tk::Platform::PrefetchMappedFile(&g_ShaderArchive, 0, g_ShaderArchive.sizeInBytes);
+    return true;
+}
+
+static void UnmapShaderArchive()
+{
+    Tk::Platform::UnmapFile(&g_ShaderArchive);
+    if (g_LooseShaderBlobs)
+    {
+        Tk::Platform::FreeAlignedRaw(g_LooseShaderBlobs);
+        g_LooseShaderBlobs = nullptr;
+    }
+    g_ShaderArchiveEntries = nullptr;
+    g_NumShaderArchiveEntries = 0;
+    g_ShaderArchiveBlobs = nullptr;
+
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles; ++uiFile)
+        g_ShaderBytecode[uiFile].data = nullptr;
+}
+
+static const ShaderCompiler::ShaderArchiveEntry* FindShaderArchiveEntry(const char* spvFilename)
+{
+    for (uint32 uiEntry = 0; uiEntry < g_NumShaderArchiveEntries; ++uiEntry)
+    {
+        if (strcmp(g_ShaderArchiveEntries[uiEntry].spvFilename, spvFilename) == 0)
+            return &g_ShaderArchiveEntries[uiEntry];
+    }
+    return nullptr;
+}
+
+// Adds the default variant of every shader in the mapped archive that isn't known yet
+static void DiscoverShaderFiles()
+{
+    for (uint32 uiEntry = 0; uiEntry < g_NumShaderArchiveEntries; ++uiEntry)
+    {
+        const char* spvFilename = g_ShaderArchiveEntries[uiEntry].spvFilename;
+        if (IsDefaultVariantSpvFilename(spvFilename))
+            AddShaderFile(spvFilename);
+    }
+}
+
+static const char* GetActiveSpvFilename(uint32 shaderFile)
+{
+    const ShaderFileVariant& variant = g_ShaderFileVariants[shaderFile];
+    return variant.variantKey == SHADER_VARIANT_KEY_DEFAULT ? GetShaderFileSpvFilename(shaderFile) : variant.spvFilename;
+}
+
+// Points the file at the bytecode of its active variant in the mapped archive, and reflects it if it's different bytecode
+// than last time. Returns whether the bytecode changed.
+static bool ResolveShaderFileBytecode(uint32 shaderFile)
+{
+    const ShaderCompiler::ShaderArchiveEntry* entry = FindShaderArchiveEntry(GetActiveSpvFilename(shaderFile));
+    if (!entry && g_ShaderFileVariants[shaderFile].variantKey != SHADER_VARIANT_KEY_DEFAULT)
+    {
+        // The variant is gone, e.g. its permutation was removed from the source
+        Core::Utility::LogMsg("Graphics", "Shader variant not found, using the default variant.", Core::Utility::LogSeverity::eWarning);
+        g_ShaderFileVariants[shaderFile] = {};
+        entry = FindShaderArchiveEntry(GetActiveSpvFilename(shaderFile));
+    }
+
+    ShaderBytecode& bytecode = g_ShaderBytecode[shaderFile];
+    if (!entry)
+    {
+        Core::Utility::LogMsg("Graphics", "Shader not found in the shader archive:", Core::Utility::LogSeverity::eCritical);
+        Core::Utility::LogMsg("Graphics", GetActiveSpvFilename(shaderFile), Core::Utility::LogSeverity::eCritical);
+        bytecode = {};
+        g_IsShaderReflected[shaderFile] = false;
+        return true;
+    }
+
+    bytecode.data = g_ShaderArchiveBlobs + entry->blobOffset;
+    bytecode.sizeInBytes = entry->blobSizeInBytes;
+    if (g_IsShaderReflected[shaderFile] && bytecode.contentHash == entry->contentHash)
+        return false;
+
+    bytecode.contentHash = entry->contentHash;
+    g_IsShaderReflected[shaderFile] = ShaderReflection::ReflectShader(bytecode.data, bytecode.sizeInBytes, &g_ShaderReflections[shaderFile]);
+    if (!g_IsShaderReflected[shaderFile])
+    {
+        Core::Utility::LogMsg("Graphics", "Failed to reflect shader:", Core::Utility::LogSeverity::eCritical);
+        Core::Utility::LogMsg("Graphics", GetActiveSpvFilename(shaderFile), Core::Utility::LogSeverity::eCritical);
+    }
+    return true;
+}
+
+// Only call while the archive is mapped. Returns the number of files whose bytecode changed.
+static uint32 ResolveAllShaderBytecode(bool* outIsFileChanged)
 {
-    uint8* vertexShaderBuffer = nullptr;
-    uint8* fragmentShaderBuffer = nullptr;
-    uint32 vertexShaderFileSize = 0, fragmentShaderFileSize = 0;
+    uint32 numChangedFiles = 0;
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles; ++uiFile)
+    {
+        outIsFileChanged[uiFile] = ResolveShaderFileBytecode(uiFile);
+        numChangedFiles += outIsFileChanged[uiFile] ? 1 : 0;
+    }
+    return numChangedFiles;
+}
 
-    if (vertexShaderFileName)
+static const ShaderCompiler::ShaderManifest& GetShaderManifest()
+{
+    if (!g_IsShaderManifestLoaded)
     {
-        vertexShaderFileSize = Tk::Platform::GetEntireFileSize(vertexShaderFileName);
-        vertexShaderBuffer = g_ShaderBytecodeAllocator.Alloc(vertexShaderFileSize, 1);
-        TINKER_ASSERT(vertexShaderBuffer);
-        Tk::Platform::ReadEntireFile(vertexShaderFileName, vertexShaderFileSize, vertexShaderBuffer);
+        if (!ShaderCompiler::ReadShaderManifest(&g_ShaderManifest))
+            g_ShaderManifest.numEntries = 0;
+        g_IsShaderManifestLoaded = true;
+    }
+    return g_ShaderManifest;
+}
+
+static void CreateDescLayout(uint32 descLayoutID, const DescriptorLayout& descLayout)
+{
+    bool bOk = Tk::Graphics::CreateDescriptorLayout(descLayoutID, &descLayout);
+    TINKER_ASSERT(bOk);
+    g_DescLayouts[descLayoutID] = descLayout;
+    g_IsDescLayoutCreated[descLayoutID] = true;
+}
+
+// Layout ID of an existing layout with the same bindings, or a new one from the reflected range
+static uint32 FindOrCreateDescLayout(const DescriptorLayout& descLayout)
+{
+    for (uint32 uiLayout = 0; uiLayout < Graphics::DESCLAYOUT_ID_MAX; ++uiLayout)
+    {
+        if (g_IsDescLayoutCreated[uiLayout] && memcmp(&g_DescLayouts[uiLayout], &descLayout, sizeof(DescriptorLayout)) == 0)
+            return uiLayout;
+    }
+
+    if (g_NumReflectedDescLayouts == DESCLAYOUT_REFLECTED_MAX)
+    {
+        Core::Utility::LogMsg("Graphics", "Out of reflected descriptor layout IDs!", Core::Utility::LogSeverity::eCritical);
+        return Graphics::DESCLAYOUT_ID_MAX;
+    }
+
+    const uint32 descLayoutID = Graphics::DESCLAYOUT_ID_REFLECTED_FIRST + g_NumReflectedDescLayouts++;
+    CreateDescLayout(descLayoutID, descLayout);
+    return descLayoutID;
+}
+
+// Bindless sets are declared as unsized arrays at the binding of each array in the backend's bindless set
+static bool IsBindlessBinding(const ShaderReflection::ShaderBinding& binding)
+{
+    switch (binding.binding)
+    {
+        case BINDLESS_BINDING_STORAGE_BUFFERS: return binding.type == DescriptorType::eSSBO;
+        case BINDLESS_BINDING_SAMPLED_IMAGES: return binding.type == DescriptorType::eSampledImage;
+        case BINDLESS_BINDING_STORAGE_IMAGES: return binding.type == DescriptorType::eStorageImage;
+        default: return false;
+    }
+}
+
+// Merges the bindings of every stage of a pipeline into one descriptor layout per set, and validates them against what
+// the backend supports. Sets must be contiguous from set 0.
+static bool GetPipelineDescLayouts(const uint32* shaderFiles, uint32 numShaderFiles, uint32* outDescLayouts, uint32* outNumDescLayouts)
+{
+    DescriptorLayout setLayouts[MAX_DESCRIPTOR_SETS_PER_SHADER];
+    bool isSetUsed[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
+    bool isSetBindless[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
+    for (uint32 uiSet = 0; uiSet < MAX_DESCRIPTOR_SETS_PER_SHADER; ++uiSet)
+        setLayouts[uiSet].InitInvalid();
+
+    uint32 numSets = 0;
+    uint32 pushConstantSize = 0;
+    for (uint32 uiFile = 0; uiFile < numShaderFiles; ++uiFile)
+    {
+        const uint32 shaderFile = shaderFiles[uiFile];
+        if (shaderFile == SHADER_FILE_INVALID || !g_IsShaderReflected[shaderFile])
+            return false;
+
+        const ShaderReflection::ShaderReflectionData& reflection = g_ShaderReflections[shaderFile];
+        pushConstantSize = Max(pushConstantSize, reflection.pushConstantSize);
+        for (uint32 uiBinding = 0; uiBinding < reflection.numBindings; ++uiBinding)
+        {
+            const ShaderReflection::ShaderBinding& binding = reflection.bindings[uiBinding];
+            if (binding.set >= MAX_DESCRIPTOR_SETS_PER_SHADER || binding.binding >= MAX_BINDINGS_PER_SET)
+            {
+                Core::Utility::LogMsg("Graphics", "Shader resource set or binding is out of range!", Core::Utility::LogSeverity::eCritical);
+                return false;
+            }
+
+            const bool isBindless = binding.count == SHADER_REFLECTION_RUNTIME_ARRAY;
+            if (isBindless && !IsBindlessBinding(binding))
+            {
+                Core::Utility::LogMsg("Graphics", "Unsized shader resource array doesn't match the bindless descriptor set!", Core::Utility::LogSeverity::eCritical);
+                return false;
+            }
+
+            DescriptorLayoutParams& params = setLayouts[binding.set].params[binding.binding];
+            if ((isSetUsed[binding.set] && isSetBindless[binding.set] != isBindless) ||
+                (params.type != DescriptorType::eMax && (params.type != binding.type || params.amount != binding.count)))
+            {
+                Core::Utility::LogMsg("Graphics", "Shader stages disagree on a descriptor set's bindings!", Core::Utility::LogSeverity::eCritical);
+                return false;
+            }
+            params.type = binding.type;
+            params.amount = binding.count;
+            isSetUsed[binding.set] = true;
+            isSetBindless[binding.set] = isBindless;
+            numSets = Max(numSets, binding.set + 1);
+        }
     }
 
-    if (fragmentShaderFileName)
+    if (pushConstantSize > MIN_PUSH_CONSTANTS_SIZE)
     {
-        fragmentShaderFileSize = Tk::Platform::GetEntireFileSize(fragmentShaderFileName);
-        fragmentShaderBuffer = g_ShaderBytecodeAllocator.Alloc(fragmentShaderFileSize, 1);
-        TINKER_ASSERT(fragmentShaderBuffer);
-        Tk::Platform::ReadEntireFile(fragmentShaderFileName, fragmentShaderFileSize, fragmentShaderBuffer);
+        Core::Utility::LogMsg("Graphics", "Shader push constants are larger than MIN_PUSH_CONSTANTS_SIZE!", Core::Utility::LogSeverity::eCritical);
+        return false;
     }
 
-    const bool created = Tk::Graphics::CreateGraphicsPipeline(
-        vertexShaderBuffer, vertexShaderFileSize,
-        fragmentShaderBuffer, fragmentShaderFileSize,
-        shaderID, viewportWidth, viewportHeight,
+    for (uint32 uiSet = 0; uiSet < numSets; ++uiSet)
+    {
+        const DescriptorLayout& setLayout = setLayouts[uiSet];
+        if (!isSetUsed[uiSet] || (!isSetBindless[uiSet] && setLayout.params[0].type == DescriptorType::eMax))
+        {
+            Core::Utility::LogMsg("Graphics", "Shader descriptor sets and bindings must be contiguous from 0!", Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+
+        if (isSetBindless[uiSet])
+        {
+            outDescLayouts[uiSet] = Graphics::DESCLAYOUT_ID_BINDLESS;
+            continue;
+        }
+
+        // The backend creates bindings up to the first unused one
+        for (uint32 uiBinding = 1; uiBinding < MAX_BINDINGS_PER_SET; ++uiBinding)
+        {
+            if (setLayout.params[uiBinding].type != DescriptorType::eMax && setLayout.params[uiBinding - 1].type == DescriptorType::eMax)
+            {
+                Core::Utility::LogMsg("Graphics", "Shader descriptor sets and bindings must be contiguous from 0!", Core::Utility::LogSeverity::eCritical);
+                return false;
+            }
+        }
+
+        outDescLayouts[uiSet] = FindOrCreateDescLayout(setLayout);
+        if (outDescLayouts[uiSet] == Graphics::DESCLAYOUT_ID_MAX)
+            return false;
+    }
+
+    for (uint32 uiSet = numSets; uiSet < MAX_DESCRIPTOR_SETS_PER_SHADER; ++uiSet)
+        outDescLayouts[uiSet] = Graphics::DESCLAYOUT_ID_MAX;
+    *outNumDescLayouts = numSets;
+    return true;
+}
+
+// Render target formats are the one part of a graphics pipeline that can't be reflected. Descriptor layouts come from
+// the shaders, so a hotload can rebuild only the pipelines whose shaders changed.
+typedef struct gfx_pipeline_desc
+{
+    uint32 shaderID;
+    const char* vertexSpvFilename;
+    const char* fragmentSpvFilename;
+    uint32 colorRTFormat;
+    uint32 depthFormat;
+} GraphicsPipelineDesc;
+
+static const GraphicsPipelineDesc g_GraphicsPipelineDescs[] =
+{
+    // Swap chain blit
+    { Graphics::SHADER_ID_SWAP_CHAIN_BLIT, "blit_VS.spv", "blit_PS.spv", ImageFormat::TheSwapChainFormat, ImageFormat::Invalid },
+
+    // Imgui debug ui pass
+    { Graphics::SHADER_ID_IMGUI_DEBUGUI, "imgui_VS.spv", "imgui_PS.spv", ImageFormat::RGBA8_SRGB, ImageFormat::Invalid },
+
+    // Pass1
+    { Graphics::SHADER_ID_Pass1, "pass_VS.spv", "pass1_PS.spv", ImageFormat::RGBA8_SRGB, ImageFormat::Invalid },
+
+    // Pass2
+    { Graphics::SHADER_ID_Pass2, "pass_VS.spv", "pass2_PS.spv", ImageFormat::RGBA8_SRGB, ImageFormat::Invalid },
+
+    // Gpu culled instances
+    { Graphics::SHADER_ID_INSTANCES, "instance_VS.spv", "instance_PS.spv", ImageFormat::RGBA8_SRGB, ImageFormat::Invalid },
+};
+
+// Compute shaders that game code dispatches by a fixed shader ID. Every other compute shader in the spv directory gets
+// an ID from the discovered range, see GetDiscoveredComputeShaders.
+typedef struct named_compute_shader
+{
+    uint32 shaderID;
+    const char* computeSpvFilename;
+} NamedComputeShader;
+
+static const NamedComputeShader g_NamedComputeShaders[] =
+{
+    // Instance frustum culling and compaction into indirect draw args
+    { Graphics::SHADER_ID_CULL_INSTANCES_CS, "cull_instances_CS.spv" },
+
+    // Compute kernel benchmarks
+    { Graphics::SHADER_ID_BENCH_REDUCE_CS, "bench_reduce_CS.spv" },
+    { Graphics::SHADER_ID_BENCH_PREFIX_SUM_CS, "bench_prefix_sum_CS.spv" },
+    { Graphics::SHADER_ID_BENCH_BLUR_CS, "bench_blur_CS.spv" },
+};
+
+// Shader ID of each compute shader file, SHADER_ID_MAX for other stages
+static uint32 g_ComputeShaderIDs[SHADER_FILES_MAX] = {};
+static uint32 g_NumDiscoveredComputeShaders = 0;
+
+static bool IsComputeShaderFile(uint32 shaderFile)
+{
+    const char* spvFilename = g_ShaderFilenames[shaderFile];
+    const size_t len = strlen(spvFilename);
+    const size_t suffixLen = strlen(g_ShaderFileSuffixes[ARRAYCOUNT(g_ShaderFileSuffixes) - 1]);
+    return len > suffixLen && strcmp(spvFilename + len - suffixLen, g_ShaderFileSuffixes[ARRAYCOUNT(g_ShaderFileSuffixes) - 1]) == 0;
+}
+
+// Gives compute shader files added since the last call their shader ID
+static void AssignComputeShaderIDs(uint32 firstShaderFile)
+{
+    for (uint32 uiFile = firstShaderFile; uiFile < g_NumShaderFiles; ++uiFile)
+    {
+        g_ComputeShaderIDs[uiFile] = Graphics::SHADER_ID_MAX;
+        if (!IsComputeShaderFile(uiFile))
+            continue;
+
+        for (uint32 uiNamed = 0; uiNamed < ARRAYCOUNT(g_NamedComputeShaders); ++uiNamed)
+        {
+            if (strcmp(g_NamedComputeShaders[uiNamed].computeSpvFilename, g_ShaderFilenames[uiFile]) == 0)
+                g_ComputeShaderIDs[uiFile] = g_NamedComputeShaders[uiNamed].shaderID;
+        }
+
+        if (g_ComputeShaderIDs[uiFile] == Graphics::SHADER_ID_MAX)
+        {
+            if (g_NumDiscoveredComputeShaders == SHADER_DISCOVERED_MAX)
+            {
+                Core::Utility::LogMsg("Graphics", "Out of discovered shader IDs, skipping compute shader.", Core::Utility::LogSeverity::eWarning);
+                continue;
+            }
+            g_ComputeShaderIDs[uiFile] = Graphics::SHADER_ID_DISCOVERED_FIRST + g_NumDiscoveredComputeShaders++;
+        }
+    }
+}
+
+static bool CreatePSO(const GraphicsPipelineDesc& desc)
+{
+    const uint32 shaderFiles[2] = { FindShaderFileByName(desc.vertexSpvFilename), FindShaderFileByName(desc.fragmentSpvFilename) };
+    if (shaderFiles[0] == SHADER_FILE_INVALID || shaderFiles[1] == SHADER_FILE_INVALID)
+    {
+        // E.g. shaders added since the spv directory was last compiled, run TinkerSC
+        Core::Utility::LogMsg("Graphics", "Compiled shader for a graphics pipeline not found, recompile shaders:", Core::Utility::LogSeverity::eCritical);
+        Core::Utility::LogMsg("Graphics", shaderFiles[0] == SHADER_FILE_INVALID ? desc.vertexSpvFilename : desc.fragmentSpvFilename, Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    uint32 descLayouts[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
+    uint32 numDescLayouts = 0;
+    if (!GetPipelineDescLayouts(shaderFiles, ARRAYCOUNT(shaderFiles), descLayouts, &numDescLayouts))
+        return false;
+
+    if (g_ShaderReflections[shaderFiles[0]].stage != ShaderReflection::ShaderStage::eVertex ||
+        g_ShaderReflections[shaderFiles[1]].stage != ShaderReflection::ShaderStage::eFragment)
+    {
+        Core::Utility::LogMsg("Graphics", "Graphics pipeline shaders have the wrong stages!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    GraphicsPipelineAttachmentFormats pipelineFormats;
+    pipelineFormats.Init();
+    pipelineFormats.numColorRTs = 1;
+    pipelineFormats.colorRTFormats[0] = desc.colorRTFormat;
+    pipelineFormats.depthFormat = desc.depthFormat;
+
+    const ShaderBytecode& vertexShader = g_ShaderBytecode[shaderFiles[0]];
+    const ShaderBytecode& fragmentShader = g_ShaderBytecode[shaderFiles[1]];
+    return Tk::Graphics::CreateGraphicsPipeline(
+        vertexShader.data, vertexShader.sizeInBytes,
+        fragmentShader.data, fragmentShader.sizeInBytes,
+        desc.shaderID,
         pipelineFormats.numColorRTs, pipelineFormats.colorRTFormats, pipelineFormats.depthFormat,
         descLayouts, numDescLayouts);
-    return created;
+}
+
+static bool CreateComputePSO(uint32 shaderFile)
+{
+    uint32 descLayouts[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
+    uint32 numDescLayouts = 0;
+    if (!GetPipelineDescLayouts(&shaderFile, 1, descLayouts, &numDescLayouts))
+        return false;
+
+    if (g_ShaderReflections[shaderFile].stage != ShaderReflection::ShaderStage::eCompute)
+    {
+        Core::Utility::LogMsg("Graphics", "Compute shader file has no compute entry point!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    const ShaderBytecode& computeShader = g_ShaderBytecode[shaderFile];
+    return Tk::Graphics::CreateComputePipeline(computeShader.data, computeShader.sizeInBytes, g_ComputeShaderIDs[shaderFile], descLayouts, numDescLayouts);
+}
+
+static void CreateAllPSOs()
+{
+    for (uint32 uiPSO = 0; uiPSO < ARRAYCOUNT(g_GraphicsPipelineDescs); ++uiPSO)
+    {
+        bool bOk = CreatePSO(g_GraphicsPipelineDescs[uiPSO]);
+        TINKER_ASSERT(bOk);
+    }
+
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles; ++uiFile)
+    {
+        if (g_ComputeShaderIDs[uiFile] == Graphics::SHADER_ID_MAX)
+            continue;
+
+        bool bOk = CreateComputePSO(uiFile);
+        TINKER_ASSERT(bOk);
+    }
+}
+
+// Files a pipeline is built from, SHADER_FILE_INVALID where unused
+static void GetShaderFiles(uint32 shaderID, uint32* outShaderFiles)
+{
+    outShaderFiles[0] = SHADER_FILE_INVALID;
+    outShaderFiles[1] = SHADER_FILE_INVALID;
+
+    for (uint32 uiPSO = 0; uiPSO < ARRAYCOUNT(g_GraphicsPipelineDescs); ++uiPSO)
+    {
+        if (g_GraphicsPipelineDescs[uiPSO].shaderID == shaderID)
+        {
+            outShaderFiles[0] = FindShaderFileByName(g_GraphicsPipelineDescs[uiPSO].vertexSpvFilename);
+            outShaderFiles[1] = FindShaderFileByName(g_GraphicsPipelineDescs[uiPSO].fragmentSpvFilename);
+            return;
+        }
+    }
+
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles; ++uiFile)
+    {
+        if (g_ComputeShaderIDs[uiFile] == shaderID)
+        {
+            outShaderFiles[0] = uiFile;
+            return;
+        }
+    }
+}
+
+// Only swap the pipelines that use a changed shader file. Old pipelines are destroyed once the frames using them retire.
+static void RecreatePSOsUsingFiles(const bool* isFileDirty)
+{
+    for (uint32 uiPSO = 0; uiPSO < ARRAYCOUNT(g_GraphicsPipelineDescs); ++uiPSO)
+    {
+        const GraphicsPipelineDesc& desc = g_GraphicsPipelineDescs[uiPSO];
+        uint32 shaderFiles[2] = {};
+        GetShaderFiles(desc.shaderID, shaderFiles);
+        if ((shaderFiles[0] != SHADER_FILE_INVALID && isFileDirty[shaderFiles[0]]) ||
+            (shaderFiles[1] != SHADER_FILE_INVALID && isFileDirty[shaderFiles[1]]))
+        {
+            Graphics::DestroyGraphicsPipeline(desc.shaderID);
+            bool bOk = CreatePSO(desc);
+            TINKER_ASSERT(bOk);
+        }
+    }
+
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles; ++uiFile)
+    {
+        if (isFileDirty[uiFile] && g_ComputeShaderIDs[uiFile] != Graphics::SHADER_ID_MAX)
+        {
+            Graphics::DestroyGraphicsPipeline(g_ComputeShaderIDs[uiFile]);
+            bool bOk = CreateComputePSO(uiFile);
+            TINKER_ASSERT(bOk);
+        }
+    }
 }
 
 void Startup()
 {
-    g_ShaderBytecodeAllocator.Init(totalShaderBytecodeMaxSizeInBytes, 1);
+    g_ShaderArchive = {};
+    g_ShaderArchiveEntries = nullptr;
+    g_NumShaderArchiveEntries = 0;
+    g_ShaderArchiveBlobs = nullptr;
+    g_LooseShaderBlobs = nullptr;
 }
 
 void Shutdown()
 {
-    g_ShaderBytecodeAllocator.ExplicitFree();
+    UnmapShaderArchive();
 }
 
-void ReloadShaders(uint32 newWindowWidth, uint32 newWindowHeight)
+// Picks up shaders added to the archive since the last call
+static void DiscoverNewShaders()
 {
+    const uint32 firstNewShaderFile = g_NumShaderFiles;
+    DiscoverShaderFiles();
+    AssignComputeShaderIDs(firstNewShaderFile);
+
+    // Game code dispatches these by ID, so a missing one means the spv directory is older than the source
+    for (uint32 uiNamed = 0; uiNamed < ARRAYCOUNT(g_NamedComputeShaders); ++uiNamed)
+    {
+        if (FindShaderFileByName(g_NamedComputeShaders[uiNamed].computeSpvFilename) == SHADER_FILE_INVALID)
+        {
+            Core::Utility::LogMsg("Graphics", "Compiled compute shader not found, recompile shaders:", Core::Utility::LogSeverity::eCritical);
+            Core::Utility::LogMsg("Graphics", g_NamedComputeShaders[uiNamed].computeSpvFilename, Core::Utility::LogSeverity::eCritical);
+        }
+    }
+}
+
+void ReloadShaders()
+{
+    TIMED_SCOPED_BLOCK("Reload shaders");
+
+    // Keep the current pipelines if there's nothing to replace them with
+    g_IsShaderManifestLoaded = false;
+    if (!MapShaderArchive())
+        return;
+
     Graphics::DestroyAllPSOPerms();
-    LoadAllShaders(newWindowWidth, newWindowHeight);
+    DiscoverNewShaders();
+    bool isFileChanged[SHADER_FILES_MAX] = {};
+    ResolveAllShaderBytecode(isFileChanged);
+    CreateAllPSOs();
+    UnmapShaderArchive();
 }
 
-void CreateWindowDependentResources(uint32 newWindowWidth, uint32 newWindowHeight)
+void ReloadChangedShaders(const char* const* spvFilenames, uint32 numSpvFilenames)
 {
-    // TODO: don't reload the shader every time we resize, need to be able to reference existing bytecode... which we do already store
-    LoadAllShaders(newWindowWidth, newWindowHeight);
+    TIMED_SCOPED_BLOCK("Reload changed shaders");
+
+    g_IsShaderManifestLoaded = false;
+    if (!MapShaderArchive())
+        return;
+
+    for (uint32 uiSpv = 0; uiSpv < numSpvFilenames; ++uiSpv)
+    {
+        if (FindShaderFileByName(spvFilenames[uiSpv]) == SHADER_FILE_INVALID && IsDefaultVariantSpvFilename(spvFilenames[uiSpv]))
+        {
+            // A shader that was just added, it gets its pipeline without any code changes
+            const uint32 shaderFile = AddShaderFile(spvFilenames[uiSpv]);
+            if (shaderFile != SHADER_FILE_INVALID)
+                AssignComputeShaderIDs(shaderFile);
+        }
+    }
+
+    // A recompile that produced the same bytecode, e.g. after a comment change, keeps its pipelines
+    bool isFileChanged[SHADER_FILES_MAX] = {};
+    if (ResolveAllShaderBytecode(isFileChanged))
+        RecreatePSOsUsingFiles(isFileChanged);
+    UnmapShaderArchive();
 }
 
-void LoadAllShaders(uint32 windowWidth, uint32 windowHeight)
+uint32 GetDiscoveredComputeShaders(const char* spvFilenamePrefix, uint32* outShaderIDs, uint32 maxShaderIDs)
 {
-    g_ShaderBytecodeAllocator.ExplicitFree();
-    g_ShaderBytecodeAllocator.Init(totalShaderBytecodeMaxSizeInBytes, 1);
+    const size_t prefixLen = strlen(spvFilenamePrefix);
+
+    uint32 numShaderIDs = 0;
+    for (uint32 uiFile = 0; uiFile < g_NumShaderFiles && numShaderIDs < maxShaderIDs; ++uiFile)
+    {
+        const uint32 shaderID = g_ComputeShaderIDs[uiFile];
+        if (shaderID >= Graphics::SHADER_ID_DISCOVERED_FIRST && shaderID < Graphics::SHADER_ID_MAX &&
+            strncmp(g_ShaderFilenames[uiFile], spvFilenamePrefix, prefixLen) == 0)
+        {
+            outShaderIDs[numShaderIDs++] = shaderID;
+        }
+    }
+    return numShaderIDs;
+}
 
-    bool bOk = false;
+const char* GetShaderName(uint32 shaderID)
+{
+    uint32 shaderFiles[2] = {};
+    GetShaderFiles(shaderID, shaderFiles);
+    return shaderFiles[0] != SHADER_FILE_INVALID ? GetShaderFileSpvFilename(shaderFiles[0]) : nullptr;
+}
 
-    // Shaders
-    const uint32 numShaderFilepaths = 8;
-    const char* shaderFilePaths[numShaderFilepaths] =
+bool GetThreadGroupSize(uint32 shaderID, uint32* outThreadGroupSize)
+{
+    uint32 shaderFiles[2] = {};
+    GetShaderFiles(shaderID, shaderFiles);
+    const uint32 shaderFile = shaderFiles[0];
+    if (shaderFile == SHADER_FILE_INVALID || !g_IsShaderReflected[shaderFile] ||
+        g_ShaderReflections[shaderFile].stage != ShaderReflection::ShaderStage::eCompute)
     {
-        SHADERS_SPV_PATH "blit_VS.spv",
-        SHADERS_SPV_PATH "blit_PS.spv",
-        SHADERS_SPV_PATH "pass_VS.spv",
-        SHADERS_SPV_PATH "pass1_PS.spv",
-        SHADERS_SPV_PATH "pass2_PS.spv",
-        SHADERS_SPV_PATH "imgui_VS.spv",
-        SHADERS_SPV_PATH "imgui_PS.spv",
-    };
+        return false;
+    }
 
-    uint32 descLayouts[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
-    for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-        descLayouts[i] = Graphics::DESCLAYOUT_ID_MAX;
+    memcpy(outThreadGroupSize, g_ShaderReflections[shaderFile].threadGroupSize, sizeof(g_ShaderReflections[shaderFile].threadGroupSize));
+    return true;
+}
 
-    GraphicsPipelineAttachmentFormats pipelineFormats;
+uint32 GetShaderVariants(uint32 shaderID, ShaderVariantInfo* outVariants, uint32 maxVariants)
+{
+    if (!maxVariants)
+        return 0;
+
+    // The default variant exists even if the manifest doesn't know the shader
+    uint32 numVariants = 1;
+    outVariants[0].variantKey = SHADER_VARIANT_KEY_DEFAULT;
+    outVariants[0].defines[0] = '\0';
+
+    uint32 shaderFiles[2] = {};
+    GetShaderFiles(shaderID, shaderFiles);
+    const ShaderCompiler::ShaderManifest& manifest = GetShaderManifest();
+    for (uint32 uiFile = 0; uiFile < ARRAYCOUNT(shaderFiles); ++uiFile)
+    {
+        if (shaderFiles[uiFile] == SHADER_FILE_INVALID)
+            continue;
 
-    // Swap chain blit
-    descLayouts[0] = Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_TEX;
-    descLayouts[1] = Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_VBS;
-    pipelineFormats.Init();
-    pipelineFormats.numColorRTs = 1;
-    pipelineFormats.colorRTFormats[0] = ImageFormat::TheSwapChainFormat;
-    bOk = LoadShader(shaderFilePaths[0], shaderFilePaths[1], Graphics::SHADER_ID_SWAP_CHAIN_BLIT, windowWidth, windowHeight, pipelineFormats, descLayouts, 2);
-    TINKER_ASSERT(bOk);
+        const char* baseSpvFilename = GetShaderFileSpvFilename(shaderFiles[uiFile]);
+        for (uint32 uiEntry = 0; uiEntry < manifest.numEntries; ++uiEntry)
+        {
+            const ShaderCompiler::ShaderManifestEntry& entry = manifest.entries[uiEntry];
+            if (strcmp(entry.baseSpvFilename, baseSpvFilename) != 0)
+                continue;
+
+            // Variant keys hash the defines, so files declaring the same permutations share their keys
+            uint32 uiVariant = 0;
+            while (uiVariant < numVariants && outVariants[uiVariant].variantKey != entry.variantKey)
+                ++uiVariant;
+
+            if (uiVariant == numVariants)
+            {
+                if (numVariants == maxVariants)
+                    continue;
+                ++numVariants;
+                outVariants[uiVariant].variantKey = entry.variantKey;
+                outVariants[uiVariant].defines[0] = '\0';
+            }
+
+            if (outVariants[uiVariant].defines[0] == '\0')
+                memcpy(outVariants[uiVariant].defines, entry.defines, sizeof(entry.defines));
+        }
+    }
 
-    for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-        descLayouts[i] = Graphics::DESCLAYOUT_ID_MAX;
+    return numVariants;
+}
 
-    // Imgui debug ui pass
-    descLayouts[0] = Graphics::DESCLAYOUT_ID_IMGUI_TEX;
-    descLayouts[1] = Graphics::DESCLAYOUT_ID_IMGUI_VBS;
-    pipelineFormats.Init();
-    pipelineFormats.numColorRTs = 1;
-    pipelineFormats.colorRTFormats[0] = ImageFormat::RGBA8_SRGB;
-    bOk = LoadShader(shaderFilePaths[5], shaderFilePaths[6], Graphics::SHADER_ID_IMGUI_DEBUGUI, windowWidth, windowHeight, pipelineFormats, descLayouts, 2);
-    TINKER_ASSERT(bOk);
+uint32 GetActiveShaderVariant(uint32 shaderID)
+{
+    uint32 shaderFiles[2] = {};
+    GetShaderFiles(shaderID, shaderFiles);
+    for (uint32 uiFile = 0; uiFile < ARRAYCOUNT(shaderFiles); ++uiFile)
+    {
+        if (shaderFiles[uiFile] != SHADER_FILE_INVALID && g_ShaderFileVariants[shaderFiles[uiFile]].variantKey != SHADER_VARIANT_KEY_DEFAULT)
+            return g_ShaderFileVariants[shaderFiles[uiFile]].variantKey;
+    }
+    return SHADER_VARIANT_KEY_DEFAULT;
+}
 
-    for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-        descLayouts[i] = Graphics::DESCLAYOUT_ID_MAX;
+bool SetShaderVariant(uint32 shaderID, uint32 variantKey)
+{
+    uint32 shaderFiles[2] = {};
+    GetShaderFiles(shaderID, shaderFiles);
+    const ShaderCompiler::ShaderManifest& manifest = GetShaderManifest();
 
-    // Pass1
-    descLayouts[0] = Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_VBS;
-    pipelineFormats.Init();
-    pipelineFormats.numColorRTs = 1;
-    pipelineFormats.colorRTFormats[0] = ImageFormat::RGBA8_SRGB;
-    bOk = LoadShader(shaderFilePaths[2], shaderFilePaths[3], Graphics::SHADER_ID_Pass1, windowWidth, windowHeight, pipelineFormats, descLayouts, 1);
-    TINKER_ASSERT(bOk);
+    uint32 numDirtyFiles = 0;
+    for (uint32 uiFile = 0; uiFile < ARRAYCOUNT(shaderFiles); ++uiFile)
+    {
+        const uint32 shaderFile = shaderFiles[uiFile];
+        if (shaderFile == SHADER_FILE_INVALID)
+            continue;
 
-    for (uint32 i = 0; i < MAX_DESCRIPTOR_SETS_PER_SHADER; ++i)
-        descLayouts[i] = Graphics::DESCLAYOUT_ID_MAX;
+        ShaderFileVariant newVariant = {};
+        if (variantKey != SHADER_VARIANT_KEY_DEFAULT)
+        {
+            const char* baseSpvFilename = GetShaderFileSpvFilename(shaderFile);
+            for (uint32 uiEntry = 0; uiEntry < manifest.numEntries; ++uiEntry)
+            {
+                const ShaderCompiler::ShaderManifestEntry& entry = manifest.entries[uiEntry];
+                if (entry.variantKey == variantKey && strcmp(entry.baseSpvFilename, baseSpvFilename) == 0)
+                {
+                    newVariant.variantKey = variantKey;
+                    memcpy(newVariant.spvFilename, entry.spvFilename, sizeof(entry.spvFilename));
+                    break;
+                }
+            }
+        }
 
-    // Pass2
-    descLayouts[0] = Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_VBS;
-    pipelineFormats.Init();
-    pipelineFormats.numColorRTs = 1;
-    pipelineFormats.colorRTFormats[0] = ImageFormat::RGBA8_SRGB;
-    bOk = LoadShader(shaderFilePaths[2], shaderFilePaths[4], Graphics::SHADER_ID_Pass2, windowWidth, windowHeight, pipelineFormats, descLayouts, 1);
-    TINKER_ASSERT(bOk);
+        if (newVariant.variantKey != g_ShaderFileVariants[shaderFile].variantKey)
+        {
+            g_ShaderFileVariants[shaderFile] = newVariant;
+            ++numDirtyFiles;
+        }
+    }
+
+    if (numDirtyFiles && MapShaderArchive())
+    {
+        TIMED_SCOPED_BLOCK("Switch shader variant");
+
+        // Variants that compiled to the same bytecode as the previous one keep their pipelines
+        bool isFileChanged[SHADER_FILES_MAX] = {};
+        if (ResolveAllShaderBytecode(isFileChanged))
+            RecreatePSOsUsingFiles(isFileChanged);
+        UnmapShaderArchive();
+    }
+
+    return GetActiveShaderVariant(shaderID) == variantKey;
 }
 
-void LoadAllShaderResources(uint32 windowWidth, uint32 windowHeight)
+void LoadAllShaders()
 {
-    bool bOk = false;
+    TIMED_SCOPED_BLOCK("Load all shaders and create PSOs");
 
-    // Descriptor layouts
-    Tk::Graphics::DescriptorLayout descriptorLayout = {};
+    if (!MapShaderArchive())
+        return;
 
-    descriptorLayout.InitInvalid();
-    descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eSampledImage;
-    descriptorLayout.params[0].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_TEX, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    DiscoverNewShaders();
+    bool isFileChanged[SHADER_FILES_MAX] = {};
+    ResolveAllShaderBytecode(isFileChanged);
+    CreateAllPSOs();
+    UnmapShaderArchive();
+}
+
+void LoadAllShaderResources()
+{
+    // Descriptor layouts that game code creates descriptors with. Pipeline layouts are reflected from the shaders, and
+    // a shader set with the same bindings as one of these uses its ID. DESCLAYOUT_ID_BINDLESS is owned by the graphics backend.
+    Tk::Graphics::DescriptorLayout descriptorLayout = {};
 
     descriptorLayout.InitInvalid();
     descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eSSBO;
@@ -180,36 +941,22 @@ void LoadAllShaderResources(uint32 windowWidth, uint32 windowHeight)
     descriptorLayout.params[1].amount = 1;
     descriptorLayout.params[2].type = Tk::Graphics::DescriptorType::eSSBO;
     descriptorLayout.params[2].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_IMGUI_VBS, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    CreateDescLayout(Graphics::DESCLAYOUT_ID_IMGUI_VBS, descriptorLayout);
 
     descriptorLayout.InitInvalid();
     descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eSampledImage;
     descriptorLayout.params[0].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_IMGUI_TEX, &descriptorLayout);
-    TINKER_ASSERT(bOk);
-
-    descriptorLayout.InitInvalid();
-    descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eSSBO;
-    descriptorLayout.params[0].amount = 1;
-    descriptorLayout.params[1].type = Tk::Graphics::DescriptorType::eSSBO;
-    descriptorLayout.params[1].amount = 1;
-    descriptorLayout.params[2].type = Tk::Graphics::DescriptorType::eSSBO;
-    descriptorLayout.params[2].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_SWAP_CHAIN_BLIT_VBS, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    CreateDescLayout(Graphics::DESCLAYOUT_ID_IMGUI_TEX, descriptorLayout);
 
     descriptorLayout.InitInvalid();
     descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eBuffer;
     descriptorLayout.params[0].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_VIEW_GLOBAL, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    CreateDescLayout(Graphics::DESCLAYOUT_ID_VIEW_GLOBAL, descriptorLayout);
 
     descriptorLayout.InitInvalid();
     descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eBuffer;
     descriptorLayout.params[0].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_ASSET_INSTANCE, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    CreateDescLayout(Graphics::DESCLAYOUT_ID_ASSET_INSTANCE, descriptorLayout);
 
     descriptorLayout.InitInvalid();
     descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eSSBO;
@@ -218,16 +965,14 @@ void LoadAllShaderResources(uint32 windowWidth, uint32 windowHeight)
     descriptorLayout.params[1].amount = 1;
     descriptorLayout.params[2].type = Tk::Graphics::DescriptorType::eSSBO;
     descriptorLayout.params[2].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_ASSET_VBS, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    CreateDescLayout(Graphics::DESCLAYOUT_ID_ASSET_VBS, descriptorLayout);
 
     descriptorLayout.InitInvalid();
     descriptorLayout.params[0].type = Tk::Graphics::DescriptorType::eSSBO;
     descriptorLayout.params[0].amount = 1;
-    bOk = Tk::Graphics::CreateDescriptorLayout(Graphics::DESCLAYOUT_ID_POSONLY_VBS, &descriptorLayout);
-    TINKER_ASSERT(bOk);
+    CreateDescLayout(Graphics::DESCLAYOUT_ID_POSONLY_VBS, descriptorLayout);
 
-    LoadAllShaders(windowWidth, windowHeight);
+    LoadAllShaders();
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreDefines.h"
+#include "ShaderCompiler/ShaderCompiler.h"
 
 namespace Tk
 {
@@ -11,10 +12,32 @@ namespace ShaderManager
     void Startup();
     void Shutdown();
 
-    void LoadAllShaders(uint32 windowWidth, uint32 windowHeight);
-    void LoadAllShaderResources(uint32 windowWidth, uint32 windowHeight);
-    void CreateWindowDependentResources(uint32 newWindowWidth, uint32 newWindowHeight);
-    void ReloadShaders(uint32 newWindowWidth, uint32 newWindowHeight);
+    void LoadAllShaders();
+    void LoadAllShaderResources();
+    void ReloadShaders();
+    // Picks up new shaders among the given spv files, e.g. "blit_VS.spv", and recreates only the pipelines whose bytecode
+    // in the shader archive changed
+    void ReloadChangedShaders(const char* const* spvFilenames, uint32 numSpvFilenames);
+
+    // Compute shaders found in the shader archive that have no named shader ID, and whose spv filename starts with the prefix.
+    // IDs are stable for the session, shaders added while running are appended.
+    uint32 GetDiscoveredComputeShaders(const char* spvFilenamePrefix, uint32* outShaderIDs, uint32 maxShaderIDs);
+    // Spv filename of the shader's first stage, e.g. "blit_VS.spv", nullptr if no loaded shader has this ID
+    const char* GetShaderName(uint32 shaderID);
+    // numthreads of a compute shader, reflected from its bytecode. False if the shader isn't loaded.
+    bool GetThreadGroupSize(uint32 shaderID, uint32* outThreadGroupSize);
+
+    // Compiled variants of a shader's files, from the shader manifest. SHADER_VARIANT_KEY_DEFAULT is always valid.
+    typedef struct shader_variant_info
+    {
+        uint32 variantKey;
+        char defines[SHADER_VARIANT_DEFINES_MAX];
+    } ShaderVariantInfo;
+    uint32 GetShaderVariants(uint32 shaderID, ShaderVariantInfo* outVariants, uint32 maxVariants);
+    uint32 GetActiveShaderVariant(uint32 shaderID);
+    // Switches each file of the shader that has a variant with this key, and recreates every pipeline using those files.
+    // Files without it use their default variant.
+    bool SetShaderVariant(uint32 shaderID, uint32 variantKey);
 }
 }
 }
@@ -0,0 +1,481 @@
+#include "ShaderReflection.h"
+#include "GraphicsCommon.h"
+#include "Utility/Logging.h"
+#include "Mem.h"
+
+#include <string.h>
+
+namespace Tk
+{
+namespace Graphics
+{
+namespace ShaderReflection
+{
+
+// Only the parts of the SPIR-V spec needed to walk the resource interface
+#define SPIRV_MAGIC 0x07230203
+#define SPIRV_HEADER_WORDS 5
+
+namespace SpvOp
+{
+    enum : uint32
+    {
+        EntryPoint = 15,
+        ExecutionMode = 16,
+        TypeBool = 20,
+        TypeInt = 21,
+        TypeFloat = 22,
+        TypeVector = 23,
+        TypeMatrix = 24,
+        TypeImage = 25,
+        TypeSampler = 26,
+        TypeSampledImage = 27,
+        TypeArray = 28,
+        TypeRuntimeArray = 29,
+        TypeStruct = 30,
+        TypePointer = 32,
+        Constant = 43,
+        Variable = 59,
+        Decorate = 71,
+        MemberDecorate = 72,
+    };
+}
+
+namespace SpvDecoration
+{
+    enum : uint32
+    {
+        Block = 2,
+        BufferBlock = 3,
+        ArrayStride = 6,
+        MatrixStride = 7,
+        Binding = 33,
+        DescriptorSet = 34,
+        Offset = 35,
+    };
+}
+
+namespace SpvStorageClass
+{
+    enum : uint32
+    {
+        UniformConstant = 0,
+        Uniform = 2,
+        PushConstant = 9,
+        StorageBuffer = 12,
+    };
+}
+
+namespace SpvExecutionModel
+{
+    enum : uint32
+    {
+        Vertex = 0,
+        Fragment = 4,
+        GLCompute = 5,
+    };
+}
+
+#define SPIRV_EXECUTION_MODE_LOCAL_SIZE 17
+#define SPIRV_IMAGE_DIM_BUFFER 5
+
+// Per id state gathered in one pass over the module, definitions are word offsets of the instruction defining the id
+typedef struct spirv_id_info
+{
+    uint32 defWord;
+    uint32 set;
+    uint32 binding;
+    uint32 arrayStride;
+    uint32 blockDecoration; // SpvDecoration::Block, BufferBlock or 0
+} SpirvIdInfo;
+
+typedef struct spirv_module
+{
+    const uint32* words;
+    uint32 numWords;
+    uint32 idBound;
+    SpirvIdInfo* ids;
+
+    uint32 Opcode(uint32 word) const { return words[word] & 0xFFFF; }
+    uint32 WordCount(uint32 word) const { return words[word] >> 16; }
+    const uint32* Def(uint32 id) const { return id < idBound && ids[id].defWord ? &words[ids[id].defWord] : nullptr; }
+} SpirvModule;
+
+// Fewest words the instruction needs for every operand reflection reads from it, 1 for instructions that aren't read
+static uint32 GetMinWordCount(const SpirvModule& spirv, uint32 word)
+{
+    const uint32 wordCount = spirv.WordCount(word);
+    switch (spirv.Opcode(word))
+    {
+        case SpvOp::TypeBool:
+        case SpvOp::TypeSampler:
+        case SpvOp::TypeStruct:
+            return 2;
+        case SpvOp::ExecutionMode:
+        case SpvOp::TypeFloat:
+        case SpvOp::TypeSampledImage:
+        case SpvOp::TypeRuntimeArray:
+            return 3;
+        case SpvOp::EntryPoint:
+        case SpvOp::TypeInt:
+        case SpvOp::TypeVector:
+        case SpvOp::TypeMatrix:
+        case SpvOp::TypeArray:
+        case SpvOp::TypePointer:
+        case SpvOp::Constant:
+        case SpvOp::Variable:
+            return 4;
+        case SpvOp::TypeImage:
+            return 9;
+        case SpvOp::Decorate:
+        {
+            if (wordCount < 3)
+                return 3;
+            const uint32 decoration = spirv.words[word + 2];
+            return (decoration == SpvDecoration::DescriptorSet || decoration == SpvDecoration::Binding ||
+                decoration == SpvDecoration::ArrayStride) ? 4 : 3;
+        }
+        case SpvOp::MemberDecorate:
+        {
+            if (wordCount < 4)
+                return 4;
+            const uint32 decoration = spirv.words[word + 3];
+            return (decoration == SpvDecoration::Offset || decoration == SpvDecoration::MatrixStride) ? 5 : 4;
+        }
+        default:
+            return 1;
+    }
+}
+
+static uint32 GetConstantValue(const SpirvModule& spirv, uint32 id)
+{
+    const uint32* def = spirv.Def(id);
+    if (!def || (def[0] & 0xFFFF) != SpvOp::Constant)
+        return 0;
+    return def[3];
+}
+
+static uint32 GetTypeSize(const SpirvModule& spirv, uint32 typeID, uint32 matrixStride);
+
+// Offset of the struct's last byte, members are placed by their Offset decorations
+static uint32 GetStructSize(const SpirvModule& spirv, uint32 structID)
+{
+    const uint32* def = spirv.Def(structID);
+    if (!def)
+        return 0;
+    const uint32 numMembers = (def[0] >> 16) - 2;
+
+    uint32 size = 0;
+    for (uint32 uiMember = 0; uiMember < numMembers; ++uiMember)
+    {
+        uint32 offset = 0;
+        uint32 matrixStride = 0;
+        for (uint32 word = SPIRV_HEADER_WORDS; word < spirv.numWords; word += spirv.WordCount(word))
+        {
+            if (spirv.Opcode(word) != SpvOp::MemberDecorate || spirv.words[word + 1] != structID || spirv.words[word + 2] != uiMember)
+                continue;
+
+            if (spirv.words[word + 3] == SpvDecoration::Offset)
+                offset = spirv.words[word + 4];
+            else if (spirv.words[word + 3] == SpvDecoration::MatrixStride)
+                matrixStride = spirv.words[word + 4];
+        }
+        size = Max(size, offset + GetTypeSize(spirv, def[2 + uiMember], matrixStride));
+    }
+    return size;
+}
+
+static uint32 GetTypeSize(const SpirvModule& spirv, uint32 typeID, uint32 matrixStride)
+{
+    const uint32* def = spirv.Def(typeID);
+    if (!def)
+        return 0;
+
+    switch (def[0] & 0xFFFF)
+    {
+        case SpvOp::TypeBool:
+            return 4;
+        case SpvOp::TypeInt:
+        case SpvOp::TypeFloat:
+            return def[2] / 8;
+        case SpvOp::TypeVector:
+            return def[3] * GetTypeSize(spirv, def[2], 0);
+        case SpvOp::TypeMatrix:
+            return def[3] * (matrixStride ? matrixStride : GetTypeSize(spirv, def[2], 0));
+        case SpvOp::TypeArray:
+        {
+            const uint32 stride = spirv.ids[typeID].arrayStride;
+            return GetConstantValue(spirv, def[3]) * (stride ? stride : GetTypeSize(spirv, def[2], 0));
+        }
+        case SpvOp::TypeStruct:
+            return GetStructSize(spirv, typeID);
+        default:
+            return 0;
+    }
+}
+
+// Descriptor type of a resource variable's type with arrays stripped, DescriptorType::eMax if there is none
+static uint32 GetDescriptorType(const SpirvModule& spirv, uint32 storageClass, uint32 typeID)
+{
+    const uint32* def = spirv.Def(typeID);
+    if (!def)
+        return DescriptorType::eMax;
+
+    switch (storageClass)
+    {
+        case SpvStorageClass::StorageBuffer:
+            return DescriptorType::eSSBO;
+
+        case SpvStorageClass::Uniform:
+            return spirv.ids[typeID].blockDecoration == SpvDecoration::BufferBlock ? DescriptorType::eSSBO : DescriptorType::eBuffer;
+
+        case SpvStorageClass::UniformConstant:
+        {
+            switch (def[0] & 0xFFFF)
+            {
+                case SpvOp::TypeImage:
+                {
+                    if (def[3] == SPIRV_IMAGE_DIM_BUFFER)
+                        return DescriptorType::eMax;
+                    return def[7] == 2 ? DescriptorType::eStorageImage : DescriptorType::eSampledImage;
+                }
+                case SpvOp::TypeSampledImage:
+                    return DescriptorType::eSampledImage;
+                case SpvOp::TypeSampler:
+                    return DescriptorType::eSampler;
+                default:
+                    return DescriptorType::eMax;
+            }
+        }
+
+        default:
+            return DescriptorType::eMax;
+    }
+}
+
+static bool AddBinding(ShaderReflectionData* outData, const ShaderBinding& newBinding)
+{
+    uint32 uiInsert = 0;
+    while (uiInsert < outData->numBindings &&
+        (outData->bindings[uiInsert].set < newBinding.set ||
+        (outData->bindings[uiInsert].set == newBinding.set && outData->bindings[uiInsert].binding < newBinding.binding)))
+    {
+        ++uiInsert;
+    }
+
+    if (uiInsert < outData->numBindings &&
+        outData->bindings[uiInsert].set == newBinding.set && outData->bindings[uiInsert].binding == newBinding.binding)
+    {
+        // Image and sampler declared separately at the same binding, together they are a combined image sampler
+        ShaderBinding& binding = outData->bindings[uiInsert];
+        const bool isImageAndSampler =
+            (binding.type == DescriptorType::eSampledImage && newBinding.type == DescriptorType::eSampler) ||
+            (binding.type == DescriptorType::eSampler && newBinding.type == DescriptorType::eSampledImage);
+        if ((binding.type != newBinding.type && !isImageAndSampler) || binding.count != newBinding.count)
+        {
+            Core::Utility::LogMsg("Graphics", "Shader declares two different resources at the same set and binding!", Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+        if (isImageAndSampler)
+            binding.type = DescriptorType::eSampledImage;
+        return true;
+    }
+
+    if (outData->numBindings == SHADER_REFLECTION_BINDINGS_MAX)
+    {
+        Core::Utility::LogMsg("Graphics", "Too many shader resource bindings to reflect!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    for (uint32 uiBinding = outData->numBindings; uiBinding > uiInsert; --uiBinding)
+    {
+        outData->bindings[uiBinding] = outData->bindings[uiBinding - 1];
+    }
+    outData->bindings[uiInsert] = newBinding;
+    ++outData->numBindings;
+    return true;
+}
+
+static bool ReflectVariable(const SpirvModule& spirv, uint32 varID, uint32 storageClass, uint32 pointerTypeID, ShaderReflectionData* outData)
+{
+    const uint32* pointerDef = spirv.Def(pointerTypeID);
+    if (!pointerDef || (pointerDef[0] & 0xFFFF) != SpvOp::TypePointer)
+        return true;
+    uint32 typeID = pointerDef[3];
+
+    if (storageClass == SpvStorageClass::PushConstant)
+    {
+        outData->pushConstantSize = Max(outData->pushConstantSize, GetTypeSize(spirv, typeID, 0));
+        return true;
+    }
+
+    if (storageClass != SpvStorageClass::UniformConstant && storageClass != SpvStorageClass::Uniform &&
+        storageClass != SpvStorageClass::StorageBuffer)
+    {
+        return true;
+    }
+
+    ShaderBinding binding = {};
+    binding.set = spirv.ids[varID].set;
+    binding.binding = spirv.ids[varID].binding;
+    binding.count = 1;
+
+    const uint32* typeDef = spirv.Def(typeID);
+    if (typeDef && (typeDef[0] & 0xFFFF) == SpvOp::TypeArray)
+    {
+        binding.count = GetConstantValue(spirv, typeDef[3]);
+        typeID = typeDef[2];
+    }
+    else if (typeDef && (typeDef[0] & 0xFFFF) == SpvOp::TypeRuntimeArray)
+    {
+        binding.count = SHADER_REFLECTION_RUNTIME_ARRAY;
+        typeID = typeDef[2];
+    }
+
+    binding.type = GetDescriptorType(spirv, storageClass, typeID);
+    if (binding.type == DescriptorType::eMax || binding.set == MAX_UINT32 || binding.binding == MAX_UINT32)
+    {
+        Core::Utility::LogMsg("Graphics", "Shader resource has no supported descriptor type or is missing its set and binding!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    return AddBinding(outData, binding);
+}
+
+bool ReflectShader(const void* spirvCode, uint32 sizeInBytes, ShaderReflectionData* outData)
+{
+    *outData = {};
+    outData->stage = ShaderStage::eMax;
+
+    SpirvModule spirv = {};
+    spirv.words = (const uint32*)spirvCode;
+    spirv.numWords = sizeInBytes / (uint32)sizeof(uint32);
+    if (!spirvCode || spirv.numWords < SPIRV_HEADER_WORDS || spirv.words[0] != SPIRV_MAGIC)
+    {
+        Core::Utility::LogMsg("Graphics", "Shader bytecode is not SPIR-V!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    // Check every instruction fits, and has the operands that are read from it, before reading any operands
+    for (uint32 word = SPIRV_HEADER_WORDS; word < spirv.numWords; word += spirv.WordCount(word))
+    {
+        if (!spirv.WordCount(word) || word + spirv.WordCount(word) > spirv.numWords)
+        {
+            Core::Utility::LogMsg("Graphics", "Truncated SPIR-V shader bytecode!", Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+        if (spirv.WordCount(word) < GetMinWordCount(spirv, word))
+        {
+            Core::Utility::LogMsg("Graphics", "Malformed SPIR-V instruction in shader bytecode!", Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+    }
+
+    spirv.idBound = spirv.words[3];
+    spirv.ids = (SpirvIdInfo*)Tk::Core::CoreMalloc(spirv.idBound * sizeof(SpirvIdInfo));
+    for (uint32 id = 0; id < spirv.idBound; ++id)
+    {
+        spirv.ids[id] = {};
+        spirv.ids[id].set = MAX_UINT32;
+        spirv.ids[id].binding = MAX_UINT32;
+    }
+
+    // Gather definitions and decorations, they can come in any order relative to each other
+    uint32 entryPointID = 0;
+    for (uint32 word = SPIRV_HEADER_WORDS; word < spirv.numWords; word += spirv.WordCount(word))
+    {
+        const uint32* inst = &spirv.words[word];
+        switch (spirv.Opcode(word))
+        {
+            case SpvOp::EntryPoint:
+            {
+                if (outData->stage != ShaderStage::eMax)
+                    break;
+                entryPointID = inst[2];
+                if (inst[1] == SpvExecutionModel::Vertex)
+                    outData->stage = ShaderStage::eVertex;
+                else if (inst[1] == SpvExecutionModel::Fragment)
+                    outData->stage = ShaderStage::eFragment;
+                else if (inst[1] == SpvExecutionModel::GLCompute)
+                    outData->stage = ShaderStage::eCompute;
+                break;
+            }
+
+            case SpvOp::ExecutionMode:
+            {
+                // LocalSize is the mode plus three literal sizes
+                if (spirv.WordCount(word) >= 6 && inst[1] == entryPointID && inst[2] == SPIRV_EXECUTION_MODE_LOCAL_SIZE)
+                {
+                    outData->threadGroupSize[0] = inst[3];
+                    outData->threadGroupSize[1] = inst[4];
+                    outData->threadGroupSize[2] = inst[5];
+                }
+                break;
+            }
+
+            case SpvOp::Decorate:
+            {
+                const uint32 id = inst[1];
+                if (id >= spirv.idBound)
+                    break;
+                if (inst[2] == SpvDecoration::DescriptorSet)
+                    spirv.ids[id].set = inst[3];
+                else if (inst[2] == SpvDecoration::Binding)
+                    spirv.ids[id].binding = inst[3];
+                else if (inst[2] == SpvDecoration::ArrayStride)
+                    spirv.ids[id].arrayStride = inst[3];
+                else if (inst[2] == SpvDecoration::Block || inst[2] == SpvDecoration::BufferBlock)
+                    spirv.ids[id].blockDecoration = inst[2];
+                break;
+            }
+
+            case SpvOp::TypeBool:
+            case SpvOp::TypeInt:
+            case SpvOp::TypeFloat:
+            case SpvOp::TypeVector:
+            case SpvOp::TypeMatrix:
+            case SpvOp::TypeImage:
+            case SpvOp::TypeSampler:
+            case SpvOp::TypeSampledImage:
+            case SpvOp::TypeArray:
+            case SpvOp::TypeRuntimeArray:
+            case SpvOp::TypeStruct:
+            case SpvOp::TypePointer:
+            {
+                if (inst[1] < spirv.idBound)
+                    spirv.ids[inst[1]].defWord = word;
+                break;
+            }
+
+            case SpvOp::Constant:
+            {
+                if (inst[2] < spirv.idBound)
+                    spirv.ids[inst[2]].defWord = word;
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    // Global resource variables
+    bool bOk = outData->stage != ShaderStage::eMax;
+    if (!bOk)
+        Core::Utility::LogMsg("Graphics", "Shader has no vertex, fragment or compute entry point!", Core::Utility::LogSeverity::eCritical);
+
+    for (uint32 word = SPIRV_HEADER_WORDS; bOk && word < spirv.numWords; word += spirv.WordCount(word))
+    {
+        if (spirv.Opcode(word) == SpvOp::Variable && spirv.words[word + 2] < spirv.idBound)
+        {
+            bOk = ReflectVariable(spirv, spirv.words[word + 2], spirv.words[word + 3], spirv.words[word + 1], outData);
+        }
+    }
+
+    Tk::Core::CoreFree(spirv.ids);
+    return bOk;
+}
+
+}
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreDefines.h"
+
+namespace Tk
+{
+namespace Graphics
+{
+namespace ShaderReflection
+{
+    namespace ShaderStage
+    {
+        enum : uint32
+        {
+            eVertex = 0,
+            eFragment,
+            eCompute,
+            eMax
+        };
+    }
+
+    #define SHADER_REFLECTION_BINDINGS_MAX 16
+    #define SHADER_REFLECTION_RUNTIME_ARRAY 0 // descriptor count of unsized arrays, e.g. the bindless arrays
+
+    typedef struct shader_binding
+    {
+        uint32 set;
+        uint32 binding;
+        uint32 type; // DescriptorType
+        uint32 count; // SHADER_REFLECTION_RUNTIME_ARRAY for unsized arrays
+    } ShaderBinding;
+
+    // Resource interface of a compiled shader, read straight from the SPIR-V words
+    typedef struct shader_reflection_data
+    {
+        uint32 stage;
+        uint32 threadGroupSize[3]; // compute only
+        uint32 pushConstantSize; // bytes, 0 if the shader has no push constants
+        uint32 numBindings;
+        ShaderBinding bindings[SHADER_REFLECTION_BINDINGS_MAX]; // sorted by set then binding
+    } ShaderReflectionData;
+
+    // Returns false and logs if the bytecode isn't valid SPIR-V or uses resources that have no DescriptorType.
+    // A separate image and sampler at the same binding are one eSampledImage, like the combined image samplers the
+    // backend creates for them. A sampler on its own binding is an eSampler.
+    bool ReflectShader(const void* spirvCode, uint32 sizeInBytes, ShaderReflectionData* outData);
+}
+}
+}
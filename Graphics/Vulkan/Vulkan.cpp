@@ -2,8 +2,11 @@
 #include "Graphics/Vulkan/VulkanTypes.h"
 #include "Graphics/Vulkan/VulkanCreation.h"
 #include "Utility/Logging.h"
+#include "Utility/ScopedTimer.h"
+#include "Mem.h"
 
 #include <iostream>
+#include <cstring>
 // TODO: move this to be a compile define or ini config entry
 //#define ENABLE_VULKAN_VALIDATION_LAYERS // enables validation layers
 
@@ -15,9 +18,13 @@
 #include <vulkan/vulkan_win32.h>
 #endif
 
-#define DEVICE_LOCAL_BUFFER_HEAP_SIZE 512 * 1024 * 1024 // 512 MiB
-#define HOST_VISIBLE_HEAP_SIZE 256 * 1024 * 1024 // 120 MiB
-#define DEVICE_LOCAL_IMAGE_HEAP_SIZE 512 * 1024 * 1024 // 512 MiB
+// Size of each block that the gpu mem allocators sub-allocate from. More blocks are created as needed.
+#define DEVICE_LOCAL_BUFFER_BLOCK_SIZE 256ull * 1024 * 1024 // 256 MiB
+#define HOST_VISIBLE_BLOCK_SIZE 128ull * 1024 * 1024 // 128 MiB
+#define DEVICE_LOCAL_IMAGE_BLOCK_SIZE 256ull * 1024 * 1024 // 256 MiB
+
+#define VULKAN_PIPELINE_CACHE_FILENAME "TinkerVkPipelineCache.bin"
+#define VULKAN_PIPELINE_CACHE_MAGIC 0x434F5054 // "TPOC"
 
 namespace Tk
 {
@@ -68,7 +75,7 @@ static void InitGPUMemAllocators()
         vkDestroyBuffer(g_vulkanContextResources.device, TestBuffer, nullptr);
 
         uint32 memoryTypeIndex = ChooseMemoryTypeBits(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalBuffers].Init(DEVICE_LOCAL_BUFFER_HEAP_SIZE, memoryTypeIndex, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, properties.limits.nonCoherentAtomSize);
+        g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalBuffers].Init(DEVICE_LOCAL_BUFFER_BLOCK_SIZE, memoryTypeIndex, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, properties.limits.nonCoherentAtomSize, g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalBuffers);
     }
 
     {
@@ -86,15 +93,8 @@ static void InitGPUMemAllocators()
         vkDestroyBuffer(g_vulkanContextResources.device, TestBuffer, nullptr);
 
         uint32 memoryTypeIndex = ChooseMemoryTypeBits(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-        g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers].Init(HOST_VISIBLE_HEAP_SIZE, memoryTypeIndex, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, properties.limits.nonCoherentAtomSize);
-
-        // Note: special!!! this memory block is going to be persistently mapped for now
-        result = vkMapMemory(g_vulkanContextResources.device, g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers].m_GPUMemory, 0, VK_WHOLE_SIZE, 0, &g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers].m_MappedMemPtr);
-        if (result != VK_SUCCESS)
-        {
-            Core::Utility::LogMsg("Platform", "Failed to map gpu memory!", Core::Utility::LogSeverity::eCritical);
-            TINKER_ASSERT(0);
-        }
+        g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers].Init(HOST_VISIBLE_BLOCK_SIZE, memoryTypeIndex, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, properties.limits.nonCoherentAtomSize, g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers);
+        // Note: host visible blocks are persistently mapped by the allocator
     }
 
     {
@@ -112,8 +112,207 @@ static void InitGPUMemAllocators()
         vkDestroyImage(g_vulkanContextResources.device, TestImage, nullptr);
 
         uint32 memoryTypeIndex = ChooseMemoryTypeBits(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalImages].Init(DEVICE_LOCAL_IMAGE_HEAP_SIZE, memoryTypeIndex, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, properties.limits.nonCoherentAtomSize);
+        g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalImages].Init(DEVICE_LOCAL_IMAGE_BLOCK_SIZE, memoryTypeIndex, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, properties.limits.nonCoherentAtomSize, g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalImages);
+    }
+}
+
+// Header prepended to the driver's pipeline cache blob on disk. A cache is only handed back to the driver if it was
+// written by the exact same device and driver version, since drivers are not required to reject stale data gracefully.
+typedef struct vulkan_pipeline_cache_file_header
+{
+    uint32 magic;
+    uint32 vendorID;
+    uint32 deviceID;
+    uint32 driverVersion;
+    uint8 pipelineCacheUUID[VK_UUID_SIZE];
+    uint32 dataSize;
+} VulkanPipelineCacheFileHeader;
+
+static void FillPipelineCacheFileHeader(VulkanPipelineCacheFileHeader* header)
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(g_vulkanContextResources.physicalDevice, &properties);
+
+    *header = {};
+    header->magic = VULKAN_PIPELINE_CACHE_MAGIC;
+    header->vendorID = properties.vendorID;
+    header->deviceID = properties.deviceID;
+    header->driverVersion = properties.driverVersion;
+    memcpy(header->pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+static void CreatePipelineCache()
+{
+    TIMED_SCOPED_BLOCK("Create Vulkan pipeline cache");
+
+    VulkanPipelineCacheFileHeader expectedHeader;
+    FillPipelineCacheFileHeader(&expectedHeader);
+
+    // The driver copies the initial data, so it's read straight from a mapped view of the file
+    Tk::Platform::MappedFile cacheFile = {};
+    const uint8* fileBuffer = nullptr;
+    uint64 fileSize = 0;
+    if (Tk::Platform::MapFileReadOnly(VULKAN_PIPELINE_CACHE_FILENAME, Tk::Platform::FileAccessPattern::eSequential, &cacheFile) &&
+        cacheFile.sizeInBytes > sizeof(VulkanPipelineCacheFileHeader))
+    {
+        fileBuffer = cacheFile.data;
+        fileSize = cacheFile.sizeInBytes;
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+    pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    if (fileBuffer)
+    {
+        VulkanPipelineCacheFileHeader fileHeader;
+        memcpy(&fileHeader, fileBuffer, sizeof(VulkanPipelineCacheFileHeader));
+        const bool headerMatches =
+            fileHeader.magic == expectedHeader.magic &&
+            fileHeader.vendorID == expectedHeader.vendorID &&
+            fileHeader.deviceID == expectedHeader.deviceID &&
+            fileHeader.driverVersion == expectedHeader.driverVersion &&
+            memcmp(fileHeader.pipelineCacheUUID, expectedHeader.pipelineCacheUUID, VK_UUID_SIZE) == 0 &&
+            fileHeader.dataSize == fileSize - sizeof(VulkanPipelineCacheFileHeader);
+
+        if (headerMatches)
+        {
+            pipelineCacheCreateInfo.initialDataSize = fileHeader.dataSize;
+            pipelineCacheCreateInfo.pInitialData = fileBuffer + sizeof(VulkanPipelineCacheFileHeader);
+            Core::Utility::LogMsg("Graphics", "Loaded Vulkan pipeline cache from disk.", Core::Utility::LogSeverity::eInfo);
+        }
+        else
+        {
+            Core::Utility::LogMsg("Graphics", "Vulkan pipeline cache on disk is from a different device/driver, ignoring it.", Core::Utility::LogSeverity::eInfo);
+        }
+    }
+
+    VkResult result = vkCreatePipelineCache(g_vulkanContextResources.device, &pipelineCacheCreateInfo, nullptr, &g_vulkanContextResources.pipelineCache);
+    if (result != VK_SUCCESS)
+    {
+        // Try again without the initial data, the driver might have rejected it
+        pipelineCacheCreateInfo.initialDataSize = 0;
+        pipelineCacheCreateInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(g_vulkanContextResources.device, &pipelineCacheCreateInfo, nullptr, &g_vulkanContextResources.pipelineCache);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Graphics", "Failed to create Vulkan pipeline cache!", Core::Utility::LogSeverity::eCritical);
+            g_vulkanContextResources.pipelineCache = VK_NULL_HANDLE;
+        }
     }
+
+    Tk::Platform::UnmapFile(&cacheFile);
+}
+
+static void SaveAndDestroyPipelineCache()
+{
+    if (g_vulkanContextResources.pipelineCache == VK_NULL_HANDLE)
+        return;
+
+    size_t dataSize = 0;
+    VkResult result = vkGetPipelineCacheData(g_vulkanContextResources.device, g_vulkanContextResources.pipelineCache, &dataSize, nullptr);
+    if (result == VK_SUCCESS && dataSize > 0)
+    {
+        const uint32 fileSize = SafeTruncateUint64(sizeof(VulkanPipelineCacheFileHeader) + dataSize);
+        uint8* fileBuffer = (uint8*)Tk::Core::CoreMalloc(fileSize);
+
+        VulkanPipelineCacheFileHeader* header = (VulkanPipelineCacheFileHeader*)fileBuffer;
+        FillPipelineCacheFileHeader(header);
+        header->dataSize = (uint32)dataSize;
+
+        result = vkGetPipelineCacheData(g_vulkanContextResources.device, g_vulkanContextResources.pipelineCache, &dataSize, fileBuffer + sizeof(VulkanPipelineCacheFileHeader));
+        if (result == VK_SUCCESS)
+        {
+            Tk::Platform::WriteEntireFile(VULKAN_PIPELINE_CACHE_FILENAME, fileSize, fileBuffer);
+        }
+        else
+        {
+            Core::Utility::LogMsg("Graphics", "Failed to get Vulkan pipeline cache data!", Core::Utility::LogSeverity::eWarning);
+        }
+
+        Tk::Core::CoreFree(fileBuffer);
+    }
+
+    vkDestroyPipelineCache(g_vulkanContextResources.device, g_vulkanContextResources.pipelineCache, nullptr);
+    g_vulkanContextResources.pipelineCache = VK_NULL_HANDLE;
+}
+
+static void CreateTransientUploadRing()
+{
+    ResourceDesc desc;
+    desc.resourceType = ResourceType::eBuffer1D;
+    desc.dims = v3ui(VULKAN_TRANSIENT_UPLOAD_RING_SIZE, 0, 0);
+    desc.bufferUsage = BufferUsage::eTransientUpload;
+    desc.debugLabel = "Transient upload ring";
+    g_vulkanContextResources.transientUploadRing = VulkanCreateResource(desc);
+    g_vulkanContextResources.transientUploadRingOffset = 0;
+}
+
+// Command buffers and the 2 binary semaphores for acquire/present of virtual frames [firstFrame, lastFrame)
+static void CreateVirtualFrameCommandsAndSync(uint32 firstFrame, uint32 lastFrame)
+{
+    VkCommandBufferAllocateInfo commandBufferAllocInfo = {};
+    commandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandBufferAllocInfo.commandPool = g_vulkanContextResources.commandPool;
+    commandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandBufferAllocInfo.commandBufferCount = lastFrame - firstFrame;
+
+    VkResult result = vkAllocateCommandBuffers(g_vulkanContextResources.device,
+        &commandBufferAllocInfo,
+        &g_vulkanContextResources.commandBuffers[firstFrame]);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to allocate Vulkan primary frame command buffers!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    if (VulkanHasDedicatedComputeQueue())
+    {
+        commandBufferAllocInfo.commandPool = g_vulkanContextResources.computeCommandPool;
+        result = vkAllocateCommandBuffers(g_vulkanContextResources.device, &commandBufferAllocInfo, &g_vulkanContextResources.computeCommandBuffers[firstFrame]);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to allocate Vulkan compute command buffers!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+        }
+    }
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    for (uint32 uiFrame = firstFrame; uiFrame < lastFrame; ++uiFrame)
+    {
+        result = vkCreateSemaphore(g_vulkanContextResources.device,
+            &semaphoreCreateInfo,
+            nullptr,
+            &g_vulkanContextResources.virtualFrameSyncData[uiFrame].GPUWorkCompleteSema);
+
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to create Vulkan gpu work complete semaphore!", Core::Utility::LogSeverity::eCritical);
+        }
+
+        result = vkCreateSemaphore(g_vulkanContextResources.device,
+            &semaphoreCreateInfo,
+            nullptr,
+            &g_vulkanContextResources.virtualFrameSyncData[uiFrame].ImageAvailableSema);
+
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to create Vulkan present semaphore!", Core::Utility::LogSeverity::eCritical);
+        }
+    }
+}
+
+void VulkanAllocateFramesInFlight(uint32 numFramesInFlight)
+{
+    TINKER_ASSERT(numFramesInFlight <= MAX_FRAMES_IN_FLIGHT);
+
+    // Lowering the number of frames in flight keeps the extra copies around for when it is raised again
+    const uint32 numAllocatedFramesInFlight = g_vulkanContextResources.numAllocatedFramesInFlight;
+    if (numFramesInFlight <= numAllocatedFramesInFlight)
+        return;
+
+    CreateVirtualFrameCommandsAndSync(numAllocatedFramesInFlight, numFramesInFlight);
+    g_vulkanContextResources.numAllocatedFramesInFlight = numFramesInFlight;
+    VulkanCreateFrameCopies(numAllocatedFramesInFlight, numFramesInFlight);
 }
 
 int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32 width, uint32 height)
@@ -130,15 +329,9 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
     for (uint32 sid = 0; sid < VulkanContextResources::eMaxShaders; ++sid)
     {
         g_vulkanContextResources.psoPermutations.pipelineLayout[sid] = VK_NULL_HANDLE;
-
-        for (uint32 bs = 0; bs < VulkanContextResources::eMaxBlendStates; ++bs)
-        {
-            for (uint32 ds = 0; ds < VulkanContextResources::eMaxDepthStates; ++ds)
-            {
-                g_vulkanContextResources.psoPermutations.graphicsPipeline[sid][bs][ds] = VK_NULL_HANDLE;
-            }
-        }
     }
+    g_vulkanContextResources.psoPermutations.graphicsPipelines.Reserve(VULKAN_GRAPHICS_PSO_CACHE_SIZE);
+    g_vulkanContextResources.shaderModules.Reserve(VULKAN_SHADER_MODULE_CACHE_SIZE);
     //-----
 
     VkApplicationInfo applicationInfo = {};
@@ -338,7 +531,11 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
 
     VkPhysicalDeviceProperties physicalDeviceProperties = {};
     VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {};
+    VkPhysicalDeviceVulkan12Features physicalDeviceVulkan12Features = {};
     VkPhysicalDeviceVulkan13Features physicalDeviceVulkan13Features = {};
+    VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {};
+    VkPhysicalDeviceVulkan12Properties physicalDeviceVulkan12Properties = {};
+    bool supportsExtendedDynamicState3 = false;
 
     for (uint32 uiPhysicalDevice = 0; uiPhysicalDevice < numPhysicalDevices; ++uiPhysicalDevice)
     {
@@ -351,11 +548,48 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
         physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
         physicalDeviceVulkan13Features = {};
         physicalDeviceVulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
-        physicalDeviceFeatures2.pNext = &physicalDeviceVulkan13Features;
+        physicalDeviceVulkan12Features = {};
+        physicalDeviceVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        physicalDeviceVulkan12Features.pNext = &physicalDeviceVulkan13Features;
+        physicalDeviceFeatures2.pNext = &physicalDeviceVulkan12Features;
         vkGetPhysicalDeviceFeatures2(currPhysicalDevice, &physicalDeviceFeatures2);
+
+        physicalDeviceProperties2 = {};
+        physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        physicalDeviceVulkan12Properties = {};
+        physicalDeviceVulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+        physicalDeviceProperties2.pNext = &physicalDeviceVulkan12Properties;
+        vkGetPhysicalDeviceProperties2(currPhysicalDevice, &physicalDeviceProperties2);
         
-        // Required device feature - can't use this device if not available
-        if (physicalDeviceVulkan13Features.dynamicRendering == VK_FALSE)
+        // Required device features - can't use this device if not available
+        if (physicalDeviceVulkan13Features.dynamicRendering == VK_FALSE ||
+            physicalDeviceVulkan13Features.synchronization2 == VK_FALSE ||
+            physicalDeviceVulkan12Features.timelineSemaphore == VK_FALSE)
+        {
+            continue;
+        }
+
+        // Required, bindless descriptor set
+        if (physicalDeviceFeatures2.features.shaderStorageBufferArrayDynamicIndexing == VK_FALSE ||
+            physicalDeviceFeatures2.features.shaderSampledImageArrayDynamicIndexing == VK_FALSE ||
+            physicalDeviceFeatures2.features.shaderStorageImageArrayDynamicIndexing == VK_FALSE ||
+            physicalDeviceVulkan12Features.runtimeDescriptorArray == VK_FALSE ||
+            physicalDeviceVulkan12Features.descriptorBindingPartiallyBound == VK_FALSE ||
+            physicalDeviceVulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_FALSE ||
+            physicalDeviceVulkan12Features.descriptorBindingStorageBufferUpdateAfterBind == VK_FALSE ||
+            physicalDeviceVulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_FALSE ||
+            physicalDeviceVulkan12Features.descriptorBindingStorageImageUpdateAfterBind == VK_FALSE ||
+            physicalDeviceVulkan12Properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers < VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE ||
+            physicalDeviceVulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages < VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE ||
+            physicalDeviceVulkan12Properties.maxPerStageDescriptorUpdateAfterBindStorageImages < VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE ||
+            physicalDeviceVulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers < VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE)
+        {
+            continue;
+        }
+
+        // Required, gpu driven indirect draws
+        if (physicalDeviceFeatures2.features.multiDrawIndirect == VK_FALSE ||
+            physicalDeviceVulkan12Features.drawIndirectCount == VK_FALSE)
         {
             continue;
         }
@@ -390,6 +624,31 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
                 }
             }
 
+            // Uploads prefer a dedicated transfer (DMA) queue family so they can overlap rendering, otherwise they share the graphics queue
+            g_vulkanContextResources.transferQueueIndex = g_vulkanContextResources.graphicsQueueIndex;
+            for (uint32 uiQueueFamily = 0; uiQueueFamily < numQueueFamilies; ++uiQueueFamily)
+            {
+                const VkQueueFlags queueFlags = queueFamilyProperties[uiQueueFamily].queueFlags;
+                if ((queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+                {
+                    g_vulkanContextResources.transferQueueIndex = uiQueueFamily;
+                    break;
+                }
+            }
+
+            // Async compute prefers a compute family without graphics so that its work can overlap the graphics queue,
+            // otherwise it is recorded into the graphics frame
+            g_vulkanContextResources.computeQueueIndex = g_vulkanContextResources.graphicsQueueIndex;
+            for (uint32 uiQueueFamily = 0; uiQueueFamily < numQueueFamilies; ++uiQueueFamily)
+            {
+                const VkQueueFlags queueFlags = queueFamilyProperties[uiQueueFamily].queueFlags;
+                if ((queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFlags & VK_QUEUE_GRAPHICS_BIT))
+                {
+                    g_vulkanContextResources.computeQueueIndex = uiQueueFamily;
+                    break;
+                }
+            }
+
             uint32 numAvailablePhysicalDeviceExtensions = 0;
             vkEnumerateDeviceExtensionProperties(currPhysicalDevice,
                 nullptr,
@@ -436,6 +695,17 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
                 }
             }
 
+            // Optional, dynamic blend state
+            supportsExtendedDynamicState3 = false;
+            for (uint32 uiAvailExt = 0; uiAvailExt < numAvailablePhysicalDeviceExtensions; ++uiAvailExt)
+            {
+                if (!strcmp(availablePhysicalDeviceExtensions[uiAvailExt].extensionName, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+                {
+                    supportsExtendedDynamicState3 = true;
+                    break;
+                }
+            }
+
             // Extension support assumed at this point
             if (graphicsSupport && presentationSupport)
             {
@@ -452,6 +722,26 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
         TINKER_ASSERT(0);
     }
 
+    // Blend state is only dynamic if all of it can be. Otherwise pipelines are also keyed by blend state.
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features = {};
+    extendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    if (supportsExtendedDynamicState3)
+    {
+        VkPhysicalDeviceFeatures2 extendedDynamicState3Features2 = {};
+        extendedDynamicState3Features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        extendedDynamicState3Features2.pNext = &extendedDynamicState3Features;
+        vkGetPhysicalDeviceFeatures2(g_vulkanContextResources.physicalDevice, &extendedDynamicState3Features2);
+
+        g_vulkanContextResources.isExtendedDynamicState3Enabled =
+            extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable == VK_TRUE &&
+            extendedDynamicState3Features.extendedDynamicState3ColorBlendEquation == VK_TRUE &&
+            extendedDynamicState3Features.extendedDynamicState3ColorWriteMask == VK_TRUE;
+    }
+    if (!g_vulkanContextResources.isExtendedDynamicState3Enabled)
+    {
+        Core::Utility::LogMsg("Graphics", "Extended dynamic state 3 not supported, pipelines are created per blend state", Core::Utility::LogSeverity::eInfo);
+    }
+
     const bool timestampsAvailable = physicalDeviceProperties.limits.timestampComputeAndGraphics;
     if (!timestampsAvailable)
     {
@@ -519,29 +809,89 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
     }
 
     // Logical device
-    const uint32 numQueues = 1;
-    VkDeviceQueueCreateInfo deviceQueueCreateInfos[numQueues] = {};
+    const uint32 maxQueues = 3;
+    VkDeviceQueueCreateInfo deviceQueueCreateInfos[maxQueues] = {};
+    uint32 numQueues = 0;
 
     // Create graphics queue
-    deviceQueueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    deviceQueueCreateInfos[0].queueFamilyIndex = g_vulkanContextResources.graphicsQueueIndex;
-    deviceQueueCreateInfos[0].queueCount = 1;
+    deviceQueueCreateInfos[numQueues].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    deviceQueueCreateInfos[numQueues].queueFamilyIndex = g_vulkanContextResources.graphicsQueueIndex;
+    deviceQueueCreateInfos[numQueues].queueCount = 1;
     float graphicsQueuePriority = 1.0f;
-    deviceQueueCreateInfos[0].pQueuePriorities = &graphicsQueuePriority;
+    deviceQueueCreateInfos[numQueues].pQueuePriorities = &graphicsQueuePriority;
+    ++numQueues;
+
+    // Create transfer queue
+    float transferQueuePriority = 0.5f;
+    if (g_vulkanContextResources.transferQueueIndex != g_vulkanContextResources.graphicsQueueIndex)
+    {
+        deviceQueueCreateInfos[numQueues].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        deviceQueueCreateInfos[numQueues].queueFamilyIndex = g_vulkanContextResources.transferQueueIndex;
+        deviceQueueCreateInfos[numQueues].queueCount = 1;
+        deviceQueueCreateInfos[numQueues].pQueuePriorities = &transferQueuePriority;
+        ++numQueues;
+    }
+
+    // Create async compute queue
+    float computeQueuePriority = 0.5f;
+    if (g_vulkanContextResources.computeQueueIndex != g_vulkanContextResources.graphicsQueueIndex)
+    {
+        deviceQueueCreateInfos[numQueues].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        deviceQueueCreateInfos[numQueues].queueFamilyIndex = g_vulkanContextResources.computeQueueIndex;
+        deviceQueueCreateInfos[numQueues].queueCount = 1;
+        deviceQueueCreateInfos[numQueues].pQueuePriorities = &computeQueuePriority;
+        ++numQueues;
+    }
 
     VkDeviceCreateInfo deviceCreateInfo = {};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceCreateInfo.pQueueCreateInfos = deviceQueueCreateInfos;
     deviceCreateInfo.queueCreateInfoCount = numQueues;
     VkPhysicalDeviceFeatures requestedPhysicalDeviceFeatures = {};
-    // TODO: request physical device features
+    requestedPhysicalDeviceFeatures.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+    requestedPhysicalDeviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+    requestedPhysicalDeviceFeatures.shaderStorageImageArrayDynamicIndexing = VK_TRUE;
+    requestedPhysicalDeviceFeatures.multiDrawIndirect = VK_TRUE;
     deviceCreateInfo.pEnabledFeatures = &requestedPhysicalDeviceFeatures;
     deviceCreateInfo.enabledLayerCount = 0;
     deviceCreateInfo.ppEnabledLayerNames = nullptr;
-    deviceCreateInfo.enabledExtensionCount = numRequiredPhysicalDeviceExtensions;
-    deviceCreateInfo.ppEnabledExtensionNames = requiredPhysicalDeviceExtensions;
+    const char* enabledDeviceExtensions[numRequiredPhysicalDeviceExtensions + 1] = {};
+    uint32 numEnabledDeviceExtensions = 0;
+    for (uint32 uiReqExt = 0; uiReqExt < numRequiredPhysicalDeviceExtensions; ++uiReqExt)
+    {
+        enabledDeviceExtensions[numEnabledDeviceExtensions++] = requiredPhysicalDeviceExtensions[uiReqExt];
+    }
+    if (g_vulkanContextResources.isExtendedDynamicState3Enabled)
+    {
+        enabledDeviceExtensions[numEnabledDeviceExtensions++] = VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME;
+    }
+    deviceCreateInfo.enabledExtensionCount = numEnabledDeviceExtensions;
+    deviceCreateInfo.ppEnabledExtensionNames = enabledDeviceExtensions;
+    extendedDynamicState3Features = {};
+    extendedDynamicState3Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+    extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable = VK_TRUE;
+    extendedDynamicState3Features.extendedDynamicState3ColorBlendEquation = VK_TRUE;
+    extendedDynamicState3Features.extendedDynamicState3ColorWriteMask = VK_TRUE;
+    physicalDeviceVulkan13Features = {};
+    physicalDeviceVulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
     physicalDeviceVulkan13Features.dynamicRendering = VK_TRUE;
-    deviceCreateInfo.pNext = &physicalDeviceVulkan13Features;
+    physicalDeviceVulkan13Features.synchronization2 = VK_TRUE;
+    if (g_vulkanContextResources.isExtendedDynamicState3Enabled)
+    {
+        physicalDeviceVulkan13Features.pNext = &extendedDynamicState3Features;
+    }
+    physicalDeviceVulkan12Features = {};
+    physicalDeviceVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    physicalDeviceVulkan12Features.timelineSemaphore = VK_TRUE;
+    physicalDeviceVulkan12Features.runtimeDescriptorArray = VK_TRUE;
+    physicalDeviceVulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+    physicalDeviceVulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    physicalDeviceVulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    physicalDeviceVulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    physicalDeviceVulkan12Features.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+    physicalDeviceVulkan12Features.drawIndirectCount = VK_TRUE;
+    physicalDeviceVulkan12Features.pNext = &physicalDeviceVulkan13Features;
+    deviceCreateInfo.pNext = &physicalDeviceVulkan12Features;
 
     result = vkCreateDevice(g_vulkanContextResources.physicalDevice,
         &deviceCreateInfo,
@@ -571,11 +921,34 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
     }
     #endif
 
+    if (g_vulkanContextResources.isExtendedDynamicState3Enabled)
+    {
+        g_vulkanContextResources.pfnCmdSetColorBlendEnableEXT = (PFN_vkCmdSetColorBlendEnableEXT)vkGetDeviceProcAddr(g_vulkanContextResources.device, "vkCmdSetColorBlendEnableEXT");
+        g_vulkanContextResources.pfnCmdSetColorBlendEquationEXT = (PFN_vkCmdSetColorBlendEquationEXT)vkGetDeviceProcAddr(g_vulkanContextResources.device, "vkCmdSetColorBlendEquationEXT");
+        g_vulkanContextResources.pfnCmdSetColorWriteMaskEXT = (PFN_vkCmdSetColorWriteMaskEXT)vkGetDeviceProcAddr(g_vulkanContextResources.device, "vkCmdSetColorWriteMaskEXT");
+
+        if (!g_vulkanContextResources.pfnCmdSetColorBlendEnableEXT ||
+            !g_vulkanContextResources.pfnCmdSetColorBlendEquationEXT ||
+            !g_vulkanContextResources.pfnCmdSetColorWriteMaskEXT)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to get extended dynamic state 3 proc addr!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+        }
+    }
+
     // Queues
     vkGetDeviceQueue(g_vulkanContextResources.device,
         g_vulkanContextResources.graphicsQueueIndex,
         0,
         &g_vulkanContextResources.graphicsQueue);
+    vkGetDeviceQueue(g_vulkanContextResources.device,
+        g_vulkanContextResources.transferQueueIndex,
+        0,
+        &g_vulkanContextResources.transferQueue);
+    vkGetDeviceQueue(g_vulkanContextResources.device,
+        g_vulkanContextResources.computeQueueIndex,
+        0,
+        &g_vulkanContextResources.computeQueue);
 
     // Swap chain
     VulkanCreateSwapChain();
@@ -597,26 +970,11 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
         TINKER_ASSERT(0);
     }
 
-    // Command buffers for per-frame submission
+    // Command buffers for per-frame submission, allocated with the rest of the per-frame objects
     g_vulkanContextResources.commandBuffers = (VkCommandBuffer*)g_vulkanContextResources.DataAllocator.Alloc(sizeof(VkCommandBuffer) * MAX_FRAMES_IN_FLIGHT, 1);
 
-    VkCommandBufferAllocateInfo commandBufferAllocInfo = {};
-    commandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    commandBufferAllocInfo.commandPool = g_vulkanContextResources.commandPool;
-    commandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    commandBufferAllocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
-
-    result = vkAllocateCommandBuffers(g_vulkanContextResources.device,
-        &commandBufferAllocInfo,
-        g_vulkanContextResources.commandBuffers);
-    if (result != VK_SUCCESS)
-    {
-        Core::Utility::LogMsg("Platform", "Failed to allocate Vulkan primary frame command buffers!", Core::Utility::LogSeverity::eCritical);
-        TINKER_ASSERT(0);
-    }
-
     // Command buffer for immediate submission
-    commandBufferAllocInfo = {};
+    VkCommandBufferAllocateInfo commandBufferAllocInfo = {};
     commandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     commandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     commandBufferAllocInfo.commandPool = g_vulkanContextResources.commandPool;
@@ -628,46 +986,50 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
         TINKER_ASSERT(0);
     }
 
-    // Virtual frame synchronization data initialization - 2 semaphores and fence
-    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
-    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+    // Command pool for the async compute queue
+    if (VulkanHasDedicatedComputeQueue())
     {
-        result = vkCreateSemaphore(g_vulkanContextResources.device,
-            &semaphoreCreateInfo,
-            nullptr,
-            &g_vulkanContextResources.virtualFrameSyncData[uiFrame].GPUWorkCompleteSema);
-
+        commandPoolCreateInfo.queueFamilyIndex = g_vulkanContextResources.computeQueueIndex;
+        result = vkCreateCommandPool(g_vulkanContextResources.device, &commandPoolCreateInfo, nullptr, &g_vulkanContextResources.computeCommandPool);
         if (result != VK_SUCCESS)
         {
-            Core::Utility::LogMsg("Platform", "Failed to create Vulkan gpu work complete semaphore!", Core::Utility::LogSeverity::eCritical);
+            Core::Utility::LogMsg("Platform", "Failed to create Vulkan compute command pool!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
         }
+    }
 
-        result = vkCreateSemaphore(g_vulkanContextResources.device,
-            &semaphoreCreateInfo,
-            nullptr,
-            &g_vulkanContextResources.virtualFrameSyncData[uiFrame].ImageAvailableSema);
+    CreateVirtualFrameCommandsAndSync(0, g_vulkanContextResources.numAllocatedFramesInFlight);
 
-        if (result != VK_SUCCESS)
-        {
-            Core::Utility::LogMsg("Platform", "Failed to create Vulkan present semaphore!", Core::Utility::LogSeverity::eCritical);
-        }
-    }
+    // Single timeline semaphore that every frame submission signals with its frame number + 1
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceCreateInfo = {};
-    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {};
+    semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphoreTypeCreateInfo.initialValue = 0;
+    semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
 
-    for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+    result = vkCreateSemaphore(g_vulkanContextResources.device, &semaphoreCreateInfo, nullptr, &g_vulkanContextResources.frameTimelineSema);
+    if (result != VK_SUCCESS)
     {
-        result = vkCreateFence(g_vulkanContextResources.device, &fenceCreateInfo, nullptr, &g_vulkanContextResources.virtualFrameSyncData[uiFrame].Fence);
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan frame timeline semaphore!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    // Signaled with frame number + 1 by every frame's compute queue submission, even frames without async compute work
+    if (VulkanHasDedicatedComputeQueue())
+    {
+        result = vkCreateSemaphore(g_vulkanContextResources.device, &semaphoreCreateInfo, nullptr, &g_vulkanContextResources.computeTimelineSema);
         if (result != VK_SUCCESS)
         {
-            Core::Utility::LogMsg("Platform", "Failed to create Vulkan fence!", Core::Utility::LogSeverity::eCritical);
+            Core::Utility::LogMsg("Platform", "Failed to create Vulkan compute timeline semaphore!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
         }
     }
 
-    // Timestamp query pool
+    // Timestamp query pools. Unlike the other per-frame objects they are sized for MAX_FRAMES_IN_FLIGHT up front, that is
+    // only (GPU_TIMESTAMP_NUM_MAX + VulkanFrameTimingQuery::eMax) * 8 bytes per frame and saves recreating them.
     if (timestampsAvailable)
     {
         const uint32 timestampQueryCount = MAX_FRAMES_IN_FLIGHT * GPU_TIMESTAMP_NUM_MAX;
@@ -685,14 +1047,39 @@ int InitVulkan(const Tk::Platform::WindowHandles* platformWindowHandles, uint32
         {
             Core::Utility::LogMsg("Graphics", "Failed to timestamp query pool!", Core::Utility::LogSeverity::eCritical);
         }
+
+        // Graphics and compute queue timings, timestampComputeAndGraphics means every compute queue supports timestamps
+        queryPoolCreateInfo.queryCount = MAX_FRAMES_IN_FLIGHT * VulkanFrameTimingQuery::eMax;
+        result = vkCreateQueryPool(g_vulkanContextResources.device, &queryPoolCreateInfo, NULL, &g_vulkanContextResources.queryPoolFrameTiming);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Graphics", "Failed to create frame timing query pool!", Core::Utility::LogSeverity::eCritical);
+        }
     }
     
     CreateSamplers();
 
+    // Before any resources are created, they get their bindless slots on creation
+    VulkanCreateBindlessDescriptors();
+
+    // Persistent sets can be freed back to their pool when their layout's free list is full
+    g_vulkanContextResources.descriptorPools.Init(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+    for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+    {
+        g_vulkanContextResources.transientDescriptorPools[uiFrame].Init(0);
+        g_vulkanContextResources.numTransientDescriptorSets[uiFrame] = 0;
+    }
+
     InitVulkanDataTypesPerEnum();
 
     InitGPUMemAllocators();
 
+    CreatePipelineCache();
+
+    CreateTransientUploadRing();
+
+    VulkanInitUploads();
+
     g_vulkanContextResources.isInitted = true;
     return 0;
 }
@@ -705,21 +1092,44 @@ void DestroyVulkan()
     vkDeviceWaitIdle(g_vulkanContextResources.device); // TODO: move this?
 
     vkDestroyQueryPool(g_vulkanContextResources.device, g_vulkanContextResources.queryPoolTimestamp, nullptr);
+    vkDestroyQueryPool(g_vulkanContextResources.device, g_vulkanContextResources.queryPoolFrameTiming, nullptr);
+    g_vulkanContextResources.queryPoolFrameTiming = VK_NULL_HANDLE;
 
     VulkanDestroySwapChain();
 
     vkDestroyCommandPool(g_vulkanContextResources.device, g_vulkanContextResources.commandPool, nullptr);
     g_vulkanContextResources.commandBuffers = nullptr;
+    vkDestroyCommandPool(g_vulkanContextResources.device, g_vulkanContextResources.computeCommandPool, nullptr);
+    g_vulkanContextResources.computeCommandPool = VK_NULL_HANDLE;
 
     VulkanDestroyAllPSOPerms();
-    DestroyAllDescLayouts();
 
+    VulkanDestroyUploads();
+
+    VulkanDestroyResource(g_vulkanContextResources.transientUploadRing);
+    g_vulkanContextResources.transientUploadRing = DefaultResHandle_Invalid;
+    g_vulkanContextResources.numPendingFlushRanges = 0;
+
+    // Device is idle, nothing left in the deferred destroy queue has to wait
+    VulkanProcessDeferredDestroys(true);
+
+    SaveAndDestroyPipelineCache();
+    VulkanDestroyBindlessDescriptors();
+    VulkanDestroyAllDescriptors();
     for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+    {
+        g_vulkanContextResources.transientDescriptorPools[uiFrame].Destroy();
+    }
+    DestroyAllDescLayouts();
+
+    for (uint32 uiFrame = 0; uiFrame < g_vulkanContextResources.numAllocatedFramesInFlight; ++uiFrame)
     {
         vkDestroySemaphore(g_vulkanContextResources.device, g_vulkanContextResources.virtualFrameSyncData[uiFrame].GPUWorkCompleteSema, nullptr);
         vkDestroySemaphore(g_vulkanContextResources.device, g_vulkanContextResources.virtualFrameSyncData[uiFrame].ImageAvailableSema, nullptr);
-        vkDestroyFence(g_vulkanContextResources.device, g_vulkanContextResources.virtualFrameSyncData[uiFrame].Fence, nullptr);
     }
+    vkDestroySemaphore(g_vulkanContextResources.device, g_vulkanContextResources.frameTimelineSema, nullptr);
+    vkDestroySemaphore(g_vulkanContextResources.device, g_vulkanContextResources.computeTimelineSema, nullptr);
+    g_vulkanContextResources.computeTimelineSema = VK_NULL_HANDLE;
 
     vkDestroySampler(g_vulkanContextResources.device, g_vulkanContextResources.linearSampler, nullptr);
 
@@ -750,6 +1160,8 @@ void DestroyVulkan()
 
     g_vulkanContextResources.vulkanMemResourcePool.ExplicitFree();
     g_vulkanContextResources.vulkanDescriptorResourcePool.ExplicitFree();
+    g_vulkanContextResources.numMultiBufferedResources = 0;
+    g_vulkanContextResources.numPersistentDescriptors = 0;
 }
 
 float GetGPUTimestampPeriod()
@@ -762,5 +1174,47 @@ uint32 GetCurrentFrameInFlightIndex()
     return g_vulkanContextResources.currentVirtualFrame;
 }
 
+void GetGraphicsStats(GraphicsStats* outStats)
+{
+    outStats->numDeferredDestroysPending = g_vulkanContextResources.numDeferredDestroys;
+    outStats->numDeferredDestroysTotal = g_vulkanContextResources.numDeferredDestroysTotal;
+    outStats->numDeviceStallsAvoided = g_vulkanContextResources.numDeviceStallsAvoided;
+
+    outStats->numFramesInFlight = g_vulkanContextResources.numFramesInFlight;
+    outStats->framePacingMode = g_vulkanContextResources.framePacingMode;
+    outStats->avgFrameTimeMS = g_vulkanContextResources.avgFrameTimeMS;
+    outStats->avgInputToGPUCompleteMS = g_vulkanContextResources.avgInputToGPUCompleteMS;
+
+    outStats->transientUploadBytesUsed = g_vulkanContextResources.transientUploadBytesUsed;
+    outStats->transientUploadRingSize = VULKAN_TRANSIENT_UPLOAD_RING_SIZE;
+    outStats->numMappedRangeFlushes = g_vulkanContextResources.numMappedRangeFlushesLastFrame;
+
+    outStats->hasDedicatedTransferQueue = g_vulkanContextResources.transferQueueIndex != g_vulkanContextResources.graphicsQueueIndex;
+    outStats->numUploadBatchesInFlight = (uint32)(g_vulkanContextResources.uploadValueOpen - 1 - g_vulkanContextResources.uploadValueRetired);
+    outStats->numUploadBatchesTotal = g_vulkanContextResources.numUploadBatchesTotal;
+    outStats->numUploadBytesTotal = g_vulkanContextResources.numUploadBytesTotal;
+
+    outStats->hasDedicatedComputeQueue = VulkanHasDedicatedComputeQueue();
+    outStats->isAsyncComputeEnabled = g_vulkanContextResources.isAsyncComputeEnabled;
+    outStats->wasAsyncComputeOnComputeQueue = g_vulkanContextResources.wasAsyncComputeOnComputeQueue;
+    outStats->avgGraphicsQueueGPUTimeMS = g_vulkanContextResources.avgGraphicsQueueGPUTimeMS;
+    outStats->avgAsyncComputeGPUTimeMS = g_vulkanContextResources.avgAsyncComputeGPUTimeMS;
+
+    outStats->numDescriptorPools = g_vulkanContextResources.descriptorPools.m_NumPools;
+    outStats->numDescriptorSetsAllocated = g_vulkanContextResources.numDescriptorSetsAllocated;
+    outStats->numDescriptorSetsRecycled = g_vulkanContextResources.numDescriptorSetsRecycled;
+    outStats->numTransientDescriptors = g_vulkanContextResources.numTransientDescriptorSetsLastFrame;
+
+    outStats->maxBindlessBuffers = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    outStats->numBindlessBuffers = outStats->maxBindlessBuffers - g_vulkanContextResources.bindlessBufferSlots.m_NumFreeSlots;
+    outStats->maxBindlessImages = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    outStats->numBindlessImages = outStats->maxBindlessImages - g_vulkanContextResources.bindlessImageSlots.m_NumFreeSlots;
+
+    outStats->numGraphicsPSOs = VulkanGetNumGraphicsPSOs();
+    outStats->numShaderModules = VulkanGetNumShaderModules();
+    outStats->isBlendStateDynamic = g_vulkanContextResources.isExtendedDynamicState3Enabled;
+    outStats->numDescriptorSetLayouts = VulkanGetNumDescriptorSetLayouts();
+}
+
 }
 }
@@ -35,25 +35,44 @@ void VulkanDestroySwapChain();
 // Frame command recording
 bool VulkanAcquireFrame();
 void VulkanSubmitFrame();
+void VulkanSetFramePacing(uint32 numFramesInFlight, uint32 framePacingMode);
+void VulkanSetAsyncComputeEnabled(bool enabled);
+TransientAllocation VulkanAllocTransient(uint32 sizeInBytes, uint32 alignment);
+ResourceHandle VulkanGetTransientUploadRing();
+
+// Staged uploads
+uint64 VulkanUploadBufferData(ResourceHandle dstBufferHandle, uint32 dstOffset, const void* data, uint32 sizeInBytes);
+uint64 VulkanUploadImageData(ResourceHandle dstImageHandle, const void* data, uint32 sizeInBytes);
+uint64 VulkanSubmitUploads();
+bool VulkanIsUploadComplete(uint64 uploadValue);
+void VulkanWaitForUpload(uint64 uploadValue);
 
 void BeginVulkanCommandRecording();
 void EndVulkanCommandRecording();
+void BeginVulkanAsyncComputeRecording();
+void EndVulkanAsyncComputeRecording();
 void BeginVulkanCommandRecordingImmediate();
 void EndVulkanCommandRecordingImmediate();
 
 // Graphics API - resource create/destroy functions
 ResourceHandle VulkanCreateResource(const ResourceDesc& resDesc);
 void VulkanDestroyResource(ResourceHandle handle);
+void VulkanGetImageMemoryRequirements(ResourceHandle imageHandle, uint64* outSizeInBytes, uint64* outAlignment);
+ResourceHandle VulkanCreateTransientHeap(uint64 sizeInBytes, const ResourceHandle* imageHandles, const uint64* imageOffsets, uint32 numImages, const char* debugLabel);
+uint32 VulkanGetBindlessIndex(ResourceHandle handle);
 
-bool VulkanCreateGraphicsPipeline(void* vertexShaderCode, uint32 numVertexShaderBytes,
-    void* fragmentShaderCode, uint32 numFragmentShaderBytes,
-    uint32 shaderID, uint32 viewportWidth, uint32 viewportHeight,
+bool VulkanCreateGraphicsPipeline(const void* vertexShaderCode, uint32 numVertexShaderBytes,
+    const void* fragmentShaderCode, uint32 numFragmentShaderBytes,
+    uint32 shaderID,
     uint32 numColorRTs, const uint32* colorRTFormats, uint32 depthFormat,
     uint32* descriptorLayoutHandles, uint32 numDescriptorLayoutHandles);
+bool VulkanCreateComputePipeline(const void* computeShaderCode, uint32 numComputeShaderBytes, uint32 shaderID,
+    uint32* descriptorLayoutHandles, uint32 numDescriptorLayoutHandles);
 void DestroyPSOPerms(uint32 shaderID);
 void VulkanDestroyAllPSOPerms();
 
 DescriptorHandle VulkanCreateDescriptor(uint32 descriptorLayoutID);
+DescriptorHandle VulkanCreateTransientDescriptor(uint32 descriptorLayoutID);
 bool VulkanCreateDescriptorLayout(uint32 descriptorLayoutID, const DescriptorLayout* descriptorLayout);
 void VulkanDestroyDescriptor(DescriptorHandle handle);
 void VulkanDestroyAllDescriptors();
@@ -3,26 +3,200 @@
 #include "Graphics/Vulkan/VulkanTypes.h"
 #include "Utility/Logging.h"
 
+#include <chrono>
+
 namespace Tk
 {
 namespace Graphics
 {
 
-bool VulkanAcquireFrame()
+static uint64 GetTimeUS()
+{
+    return (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool VulkanHasDedicatedComputeQueue()
+{
+    return g_vulkanContextResources.computeQueueIndex != g_vulkanContextResources.graphicsQueueIndex;
+}
+
+// Blocks until frames [0, numFramesComplete) have completed on the gpu, on the compute queue too
+static bool WaitForFramesComplete(uint64 numFramesComplete)
+{
+    if (numFramesComplete == 0)
+        return true;
+
+    const VkSemaphore semaphores[2] = { g_vulkanContextResources.frameTimelineSema, g_vulkanContextResources.computeTimelineSema };
+    const uint64 values[2] = { numFramesComplete, numFramesComplete };
+
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = VulkanHasDedicatedComputeQueue() ? 2 : 1;
+    waitInfo.pSemaphores = semaphores;
+    waitInfo.pValues = values;
+    return vkWaitSemaphores(g_vulkanContextResources.device, &waitInfo, (uint64)-1) == VK_SUCCESS;
+}
+
+uint64 VulkanGetNumFramesCompleted()
+{
+    uint64 value = 0;
+    vkGetSemaphoreCounterValue(g_vulkanContextResources.device, g_vulkanContextResources.frameTimelineSema, &value);
+    if (VulkanHasDedicatedComputeQueue())
+    {
+        uint64 computeValue = 0;
+        vkGetSemaphoreCounterValue(g_vulkanContextResources.device, g_vulkanContextResources.computeTimelineSema, &computeValue);
+        value = Min(value, computeValue);
+    }
+    return value;
+}
+
+static void UpdateFrameLatencyStats(uint64 frameStartTimeUS)
+{
+    static const float smoothing = 0.05f;
+
+    // Any frame whose gpu work has completed by now is done, the observed latency is an upper bound by up to one frame
+    const uint64 numFramesCompleted = VulkanGetNumFramesCompleted();
+    for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
+    {
+        VulkanVirtualFrameSyncData& syncData = g_vulkanContextResources.virtualFrameSyncData[uiFrame];
+        if (syncData.isLatencyPending && syncData.frameNumber < numFramesCompleted)
+        {
+            const float latencyMS = (float)(frameStartTimeUS - syncData.frameStartTimeUS) * 1e-3f;
+            g_vulkanContextResources.avgInputToGPUCompleteMS += (latencyMS - g_vulkanContextResources.avgInputToGPUCompleteMS) * smoothing;
+            syncData.isLatencyPending = false;
+        }
+    }
+
+    if (g_vulkanContextResources.lastFrameStartTimeUS)
+    {
+        const float frameTimeMS = (float)(frameStartTimeUS - g_vulkanContextResources.lastFrameStartTimeUS) * 1e-3f;
+        g_vulkanContextResources.avgFrameTimeMS += (frameTimeMS - g_vulkanContextResources.avgFrameTimeMS) * smoothing;
+    }
+    g_vulkanContextResources.lastFrameStartTimeUS = frameStartTimeUS;
+}
+
+// Flushes every range written since the last flush with a single call
+static void FlushPendingMappedRanges()
 {
-    const VulkanVirtualFrameSyncData& virtualFrameSyncData = g_vulkanContextResources.virtualFrameSyncData[g_vulkanContextResources.currentVirtualFrame];
+    if (g_vulkanContextResources.numPendingFlushRanges == 0)
+        return;
 
-    VkResult result = vkWaitForFences(g_vulkanContextResources.device, 1, &virtualFrameSyncData.Fence, VK_FALSE, (uint64)-1);
+    VkResult result = vkFlushMappedMemoryRanges(g_vulkanContextResources.device, g_vulkanContextResources.numPendingFlushRanges, g_vulkanContextResources.pendingFlushRanges);
     if (result != VK_SUCCESS)
     {
-        Core::Utility::LogMsg("Platform", "Waiting for virtual frame fence took too long!", Core::Utility::LogSeverity::eInfo);
+        Core::Utility::LogMsg("Platform", "Failed to flush mapped gpu memory!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    g_vulkanContextResources.numPendingFlushRanges = 0;
+    ++g_vulkanContextResources.numMappedRangeFlushes;
+}
+
+static void AddPendingFlushRange(const VulkanMemAlloc& memAlloc, VkDeviceSize sizeInBytes)
+{
+    if (g_vulkanContextResources.numPendingFlushRanges == VULKAN_MAX_PENDING_FLUSH_RANGES)
+    {
+        FlushPendingMappedRanges();
+    }
+
+    // Flushed ranges have to be multiples of nonCoherentAtomSize, which the allocator already aligns allocations to
+    const VkDeviceSize atomSize = g_vulkanContextResources.GPUMemAllocators[memAlloc.allocatorIndex].m_AllocGranularity;
+    sizeInBytes = atomSize ? (sizeInBytes + atomSize - 1) & ~(atomSize - 1) : sizeInBytes;
+
+    VkMappedMemoryRange& memoryRange = g_vulkanContextResources.pendingFlushRanges[g_vulkanContextResources.numPendingFlushRanges++];
+    memoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    memoryRange.pNext = NULL;
+    memoryRange.memory = memAlloc.allocMem;
+    memoryRange.offset = memAlloc.allocOffset;
+    memoryRange.size = Min(sizeInBytes, memAlloc.allocSize);
+}
+
+TransientAllocation VulkanAllocTransient(uint32 sizeInBytes, uint32 alignment)
+{
+    TINKER_ASSERT(alignment && !(alignment & (alignment - 1)));
+
+    TransientAllocation transientAlloc = {};
+
+    const uint64 offset = ((uint64)g_vulkanContextResources.transientUploadRingOffset + alignment - 1) & ~((uint64)alignment - 1);
+    if (offset + sizeInBytes > VULKAN_TRANSIENT_UPLOAD_RING_SIZE)
+    {
+        Core::Utility::LogMsg("Graphics", "Transient upload ring is full for this frame!", Core::Utility::LogSeverity::eWarning);
+        return transientAlloc;
+    }
+    g_vulkanContextResources.transientUploadRingOffset = (uint32)(offset + sizeInBytes);
+
+    transientAlloc.cpuPtr = (uint8*)VulkanMapResource(g_vulkanContextResources.transientUploadRing) + offset;
+    transientAlloc.offset = (uint32)offset;
+    transientAlloc.sizeInBytes = sizeInBytes;
+    return transientAlloc;
+}
+
+ResourceHandle VulkanGetTransientUploadRing()
+{
+    return g_vulkanContextResources.transientUploadRing;
+}
+
+void VulkanSetFramePacing(uint32 numFramesInFlight, uint32 framePacingMode)
+{
+    TINKER_ASSERT(numFramesInFlight >= 1 && numFramesInFlight <= MAX_FRAMES_IN_FLIGHT);
+    TINKER_ASSERT(framePacingMode < FramePacingMode::eMax);
+
+    g_vulkanContextResources.requestedNumFramesInFlight = CLAMP(numFramesInFlight, 1u, (uint32)MAX_FRAMES_IN_FLIGHT);
+    g_vulkanContextResources.requestedFramePacingMode = framePacingMode < FramePacingMode::eMax ? framePacingMode : FramePacingMode::eThroughput;
+}
+
+void VulkanSetAsyncComputeEnabled(bool enabled)
+{
+    g_vulkanContextResources.isAsyncComputeEnabled = enabled;
+}
+
+bool VulkanAcquireFrame()
+{
+    const uint64 frameCounter = g_vulkanContextResources.frameCounter;
+
+    // Changing the number of frames in flight changes which frame last used each virtual frame, so let the gpu catch up first
+    if (g_vulkanContextResources.requestedNumFramesInFlight != g_vulkanContextResources.numFramesInFlight)
+    {
+        if (!WaitForFramesComplete(frameCounter))
+        {
+            Core::Utility::LogMsg("Platform", "Waiting for frames in flight to complete failed!", Core::Utility::LogSeverity::eCritical);
+            return false;
+        }
+        VulkanAllocateFramesInFlight(g_vulkanContextResources.requestedNumFramesInFlight);
+        g_vulkanContextResources.numFramesInFlight = g_vulkanContextResources.requestedNumFramesInFlight;
+        g_vulkanContextResources.currentVirtualFrame = 0;
+    }
+    g_vulkanContextResources.framePacingMode = g_vulkanContextResources.requestedFramePacingMode;
+
+    // Throughput: only wait for the frame that last used this virtual frame's resources.
+    // Low latency: wait for every submitted frame, so that input gets sampled as late as possible.
+    const uint64 numFramesInFlight = g_vulkanContextResources.numFramesInFlight;
+    uint64 numFramesToWaitFor = frameCounter;
+    if (g_vulkanContextResources.framePacingMode == FramePacingMode::eThroughput)
+    {
+        numFramesToWaitFor = frameCounter >= numFramesInFlight ? frameCounter - numFramesInFlight + 1 : 0;
+    }
+
+    if (!WaitForFramesComplete(numFramesToWaitFor))
+    {
+        Core::Utility::LogMsg("Platform", "Waiting for virtual frame timeline semaphore took too long!", Core::Utility::LogSeverity::eInfo);
         return false;
     }
-    vkResetFences(g_vulkanContextResources.device, 1, &virtualFrameSyncData.Fence);
+
+    const uint64 frameStartTimeUS = GetTimeUS();
+    UpdateFrameLatencyStats(frameStartTimeUS);
+
+    VulkanProcessDeferredDestroys(false);
+
+    // The frame that last used this virtual frame's copy of the upload ring has retired
+    g_vulkanContextResources.transientUploadRingOffset = 0;
+    VulkanResetTransientDescriptors();
+
+    VulkanVirtualFrameSyncData& virtualFrameSyncData = g_vulkanContextResources.virtualFrameSyncData[g_vulkanContextResources.currentVirtualFrame];
 
     uint32 currentSwapChainImageIndex = TINKER_INVALID_HANDLE;
 
-    result = vkAcquireNextImageKHR(g_vulkanContextResources.device,
+    VkResult result = vkAcquireNextImageKHR(g_vulkanContextResources.device,
         g_vulkanContextResources.swapChain,
         (uint64)-1,
         virtualFrameSyncData.ImageAvailableSema,
@@ -45,41 +219,133 @@ bool VulkanAcquireFrame()
         return false; // Don't present on this frame
     }
 
+    virtualFrameSyncData.frameNumber = frameCounter;
+    virtualFrameSyncData.frameStartTimeUS = frameStartTimeUS;
+
     g_vulkanContextResources.currentSwapChainImage = currentSwapChainImageIndex;
     return true;
 }
 
+// Signals the compute timeline every frame, with an empty batch if no async compute work was recorded
+static void SubmitAsyncCompute()
+{
+    // Only overlaps the graphics work of its own frame: waits for the previous graphics frame and the same uploads
+    const VkSemaphore waitSemaphores[2] = { g_vulkanContextResources.frameTimelineSema, g_vulkanContextResources.uploadTimelineSema };
+    const VkPipelineStageFlags waitStages[2] = { VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+    const uint64 waitValues[2] = { (uint64)g_vulkanContextResources.frameCounter, g_vulkanContextResources.uploadValueFrameWait };
+    const uint64 signalValue = (uint64)g_vulkanContextResources.frameCounter + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+    timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineSubmitInfo.waitSemaphoreValueCount = 2;
+    timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+    timelineSubmitInfo.signalSemaphoreValueCount = 1;
+    timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.waitSemaphoreCount = 2;
+    submitInfo.pWaitSemaphores = waitSemaphores;
+    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.commandBufferCount = g_vulkanContextResources.isAsyncComputeRecorded ? 1 : 0;
+    submitInfo.pCommandBuffers = &g_vulkanContextResources.computeCommandBuffers[g_vulkanContextResources.currentVirtualFrame];
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &g_vulkanContextResources.computeTimelineSema;
+
+    VkResult result = vkQueueSubmit(g_vulkanContextResources.computeQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to submit command buffer to compute queue!", Core::Utility::LogSeverity::eCritical);
+    }
+    g_vulkanContextResources.isAsyncComputeRecorded = false;
+}
+
 void VulkanSubmitFrame()
 {
-    const VulkanVirtualFrameSyncData& virtualFrameSyncData = g_vulkanContextResources.virtualFrameSyncData[g_vulkanContextResources.currentVirtualFrame];
+    VulkanVirtualFrameSyncData& virtualFrameSyncData = g_vulkanContextResources.virtualFrameSyncData[g_vulkanContextResources.currentVirtualFrame];
+
+    // Make this frame's host writes visible, only the bytes of the upload ring that were actually handed out
+    const uint32 transientUploadBytesUsed = g_vulkanContextResources.transientUploadRingOffset;
+    if (transientUploadBytesUsed > 0)
+    {
+        VulkanMemResourceChain* ringChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(g_vulkanContextResources.transientUploadRing.m_hRes);
+        AddPendingFlushRange(ringChain->resourceChain[g_vulkanContextResources.currentVirtualFrame].GpuMemAlloc, transientUploadBytesUsed);
+    }
+    FlushPendingMappedRanges();
+    g_vulkanContextResources.transientUploadBytesUsed = transientUploadBytesUsed;
+    g_vulkanContextResources.numMappedRangeFlushesLastFrame = g_vulkanContextResources.numMappedRangeFlushes;
+    g_vulkanContextResources.numMappedRangeFlushes = 0;
+    g_vulkanContextResources.numTransientDescriptorSetsLastFrame = g_vulkanContextResources.numTransientDescriptorSets[g_vulkanContextResources.currentVirtualFrame];
+
+    // Async compute goes first, its work overlaps the graphics work submitted below
+    if (VulkanHasDedicatedComputeQueue())
+    {
+        SubmitAsyncCompute();
+    }
 
     // Submit
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[1] = { virtualFrameSyncData.ImageAvailableSema };
-    VkPipelineStageFlags waitStages[1] = { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT };
-    submitInfo.waitSemaphoreCount = 1;
+    VkSemaphore waitSemaphores[3] = { virtualFrameSyncData.ImageAvailableSema };
+    VkPipelineStageFlags waitStages[3] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    uint64 waitValues[3] = { 0 };
+    uint32 numWaitSemaphores = 1;
+
+    // The upload timeline value has already been reached, waiting on it makes the upload's writes visible to this frame
+    if (g_vulkanContextResources.uploadValueFrameWait > 0)
+    {
+        waitSemaphores[numWaitSemaphores] = g_vulkanContextResources.uploadTimelineSema;
+        waitStages[numWaitSemaphores] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitValues[numWaitSemaphores] = g_vulkanContextResources.uploadValueFrameWait;
+        ++numWaitSemaphores;
+    }
+
+    // The previous frame's async compute work has to be done with the resources this frame might use
+    if (VulkanHasDedicatedComputeQueue() && g_vulkanContextResources.frameCounter > 0)
+    {
+        waitSemaphores[numWaitSemaphores] = g_vulkanContextResources.computeTimelineSema;
+        waitStages[numWaitSemaphores] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitValues[numWaitSemaphores] = (uint64)g_vulkanContextResources.frameCounter;
+        ++numWaitSemaphores;
+    }
+    submitInfo.waitSemaphoreCount = numWaitSemaphores;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame];
 
-    VkSemaphore signalSemaphores[1] = { virtualFrameSyncData.GPUWorkCompleteSema };
-    submitInfo.signalSemaphoreCount = 1;
+    // Binary semaphore for present, timeline value marks this frame as complete
+    VkSemaphore signalSemaphores[2] = { virtualFrameSyncData.GPUWorkCompleteSema, g_vulkanContextResources.frameTimelineSema };
+    const uint64 signalValues[2] = { 0, (uint64)g_vulkanContextResources.frameCounter + 1 };
+    submitInfo.signalSemaphoreCount = 2;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    VkResult result = vkQueueSubmit(g_vulkanContextResources.graphicsQueue, 1, &submitInfo, virtualFrameSyncData.Fence);
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+    timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineSubmitInfo.waitSemaphoreValueCount = numWaitSemaphores;
+    timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+    timelineSubmitInfo.signalSemaphoreValueCount = 2;
+    timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+    submitInfo.pNext = &timelineSubmitInfo;
+
+    VkResult result = vkQueueSubmit(g_vulkanContextResources.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
     if (result != VK_SUCCESS)
     {
         Core::Utility::LogMsg("Platform", "Failed to submit command buffer to queue!", Core::Utility::LogSeverity::eCritical);
     }
 
+    // The timeline value has been used even if present fails, so the frame always advances
+    virtualFrameSyncData.isLatencyPending = true;
+    g_vulkanContextResources.currentVirtualFrame = (g_vulkanContextResources.currentVirtualFrame + 1) % g_vulkanContextResources.numFramesInFlight;
+    ++g_vulkanContextResources.frameCounter;
+
     // Present
     VkPresentInfoKHR presentInfo = {};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+    presentInfo.pWaitSemaphores = &signalSemaphores[0];
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &g_vulkanContextResources.swapChain;
     presentInfo.pImageIndices = &g_vulkanContextResources.currentSwapChainImage;
@@ -101,9 +367,6 @@ void VulkanSubmitFrame()
         }
         return; // don't present on this frame
     }
-
-    g_vulkanContextResources.currentVirtualFrame = (g_vulkanContextResources.currentVirtualFrame + 1) % MAX_FRAMES_IN_FLIGHT;
-    ++g_vulkanContextResources.frameCounter;
 }
 
 void* VulkanMapResource(ResourceHandle handle)
@@ -139,19 +402,8 @@ void VulkanUnmapResource(ResourceHandle handle)
     const ResourceDesc& desc = resourceChain->resDesc;
     VulkanMemResource* resource = &resourceChain->resourceChain[IsBufferUsageMultiBuffered(desc.bufferUsage) ? g_vulkanContextResources.currentVirtualFrame : 0];
 
-    // Flush right before unmapping
-    VkMappedMemoryRange memoryRange = {};
-    memoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-    memoryRange.memory = resource->GpuMemAlloc.allocMem;
-    memoryRange.offset = resource->GpuMemAlloc.allocOffset;
-    memoryRange.size = resource->GpuMemAlloc.allocSize;
-
-    VkResult result = vkFlushMappedMemoryRanges(g_vulkanContextResources.device, 1, &memoryRange);
-    if (result != VK_SUCCESS)
-    {
-        Core::Utility::LogMsg("Platform", "Failed to flush mapped gpu memory!", Core::Utility::LogSeverity::eCritical);
-        TINKER_ASSERT(0);
-    }
+    // Batched with every other range written this frame, flushed once before the next submit
+    AddPendingFlushRange(resource->GpuMemAlloc, resource->GpuMemAlloc.allocSize);
 
     if (0)
     {
@@ -163,10 +415,25 @@ void VulkanWriteDescriptor(uint32 descriptorLayoutID, DescriptorHandle descSetHa
 {
     DescriptorLayout* descLayout = &g_vulkanContextResources.descLayouts[descriptorLayoutID].bindings;
 
-    for (uint32 uiImage = 0; uiImage < MAX_FRAMES_IN_FLIGHT; ++uiImage)
+    // Transient descriptors only have a set for the current frame
+    uint32 firstImage = 0;
+    uint32 lastImage = g_vulkanContextResources.numAllocatedFramesInFlight;
+    if (descSetHandle.m_hDesc & VULKAN_TRANSIENT_DESCRIPTOR_BIT)
+    {
+        firstImage = g_vulkanContextResources.currentVirtualFrame;
+        lastImage = firstImage + 1;
+    }
+    else
+    {
+        // Kept for the sets of frames in flight that get allocated later
+        VulkanDescriptorChain* descriptorChain = g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(descSetHandle.m_hDesc);
+        descriptorChain->writtenHandles = *descSetDataHandles;
+        descriptorChain->isWritten = true;
+    }
+
+    for (uint32 uiImage = firstImage; uiImage < lastImage; ++uiImage)
     {
-        VkDescriptorSet* descriptorSet =
-            &g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(descSetHandle.m_hDesc)->resourceChain[uiImage].descriptorSet;
+        const VkDescriptorSet descriptorSet = VulkanGetDescriptorSet(descSetHandle, uiImage);
 
         // Descriptor layout
         VkWriteDescriptorSet descSetWrites[MAX_BINDINGS_PER_SET] = {};
@@ -183,7 +450,9 @@ void VulkanWriteDescriptor(uint32 descriptorLayoutID, DescriptorHandle descSetHa
             uint32 type = descLayout->params[uiDesc].type;
             if (type != DescriptorType::eMax)
             {
-                VulkanMemResourceChain* resChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(descSetDataHandles->handles[uiDesc].m_hRes);
+                // Samplers don't take a resource
+                VulkanMemResourceChain* resChain = type == DescriptorType::eSampler ? nullptr :
+                    g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(descSetDataHandles->handles[uiDesc].m_hRes);
                 uint32 resIndex = 0;
 
                 switch (type)
@@ -199,7 +468,7 @@ void VulkanWriteDescriptor(uint32 descriptorLayoutID, DescriptorHandle descSetHa
                         descBufferInfo[descriptorCount].offset = 0;
                         descBufferInfo[descriptorCount].range = VK_WHOLE_SIZE;
 
-                        descSetWrites[descriptorCount].dstSet = *descriptorSet;
+                        descSetWrites[descriptorCount].dstSet = descriptorSet;
                         descSetWrites[descriptorCount].dstBinding = descriptorCount;
                         descSetWrites[descriptorCount].dstArrayElement = 0;
                         descSetWrites[descriptorCount].descriptorType = GetVkDescriptorType(type);
@@ -216,7 +485,7 @@ void VulkanWriteDescriptor(uint32 descriptorLayoutID, DescriptorHandle descSetHa
                         descImageInfo[descriptorCount].imageView = *imageView;
                         descImageInfo[descriptorCount].sampler = g_vulkanContextResources.linearSampler;
 
-                        descSetWrites[descriptorCount].dstSet = *descriptorSet;
+                        descSetWrites[descriptorCount].dstSet = descriptorSet;
                         descSetWrites[descriptorCount].dstBinding = descriptorCount;
                         descSetWrites[descriptorCount].dstArrayElement = 0;
                         descSetWrites[descriptorCount].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -225,6 +494,36 @@ void VulkanWriteDescriptor(uint32 descriptorLayoutID, DescriptorHandle descSetHa
                         break;
                     }
 
+                    case DescriptorType::eSampler:
+                    {
+                        descImageInfo[descriptorCount].sampler = g_vulkanContextResources.linearSampler;
+
+                        descSetWrites[descriptorCount].dstSet = descriptorSet;
+                        descSetWrites[descriptorCount].dstBinding = descriptorCount;
+                        descSetWrites[descriptorCount].dstArrayElement = 0;
+                        descSetWrites[descriptorCount].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+                        descSetWrites[descriptorCount].descriptorCount = 1;
+                        descSetWrites[descriptorCount].pImageInfo = &descImageInfo[descriptorCount];
+                        break;
+                    }
+
+                    case DescriptorType::eStorageImage:
+                    {
+                        TINKER_ASSERT(resChain->resDesc.isStorage);
+                        VkImageView* imageView = &resChain->resourceChain[resIndex].imageView;
+
+                        descImageInfo[descriptorCount].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+                        descImageInfo[descriptorCount].imageView = *imageView;
+
+                        descSetWrites[descriptorCount].dstSet = descriptorSet;
+                        descSetWrites[descriptorCount].dstBinding = descriptorCount;
+                        descSetWrites[descriptorCount].dstArrayElement = 0;
+                        descSetWrites[descriptorCount].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                        descSetWrites[descriptorCount].descriptorCount = 1;
+                        descSetWrites[descriptorCount].pImageInfo = &descImageInfo[descriptorCount];
+                        break;
+                    }
+
                     default:
                     {
                         break;
@@ -241,6 +540,58 @@ void VulkanWriteDescriptor(uint32 descriptorLayoutID, DescriptorHandle descSetHa
     }
 }
 
+// Resets the pair of frame timing queries starting at firstQuery and writes the first one
+static void BeginFrameTimingQueries(VkCommandBuffer commandBuffer, uint32 firstQuery)
+{
+    if (g_vulkanContextResources.queryPoolFrameTiming == VK_NULL_HANDLE)
+        return;
+
+    const uint32 queryOffset = g_vulkanContextResources.currentVirtualFrame * VulkanFrameTimingQuery::eMax + firstQuery;
+    vkCmdResetQueryPool(commandBuffer, g_vulkanContextResources.queryPoolFrameTiming, queryOffset, 2);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, g_vulkanContextResources.queryPoolFrameTiming, queryOffset);
+}
+
+static void EndFrameTimingQueries(VkCommandBuffer commandBuffer, uint32 firstQuery)
+{
+    if (g_vulkanContextResources.queryPoolFrameTiming == VK_NULL_HANDLE)
+        return;
+
+    const uint32 queryOffset = g_vulkanContextResources.currentVirtualFrame * VulkanFrameTimingQuery::eMax + firstQuery + 1;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, g_vulkanContextResources.queryPoolFrameTiming, queryOffset);
+    g_vulkanContextResources.frameTimingQueriesWritten[g_vulkanContextResources.currentVirtualFrame] |= 1u << firstQuery;
+}
+
+// 0 if the pair wasn't written
+static float ReadFrameTimingMS(uint32 virtualFrame, uint32 firstQuery)
+{
+    if (!(g_vulkanContextResources.frameTimingQueriesWritten[virtualFrame] & (1u << firstQuery)))
+        return 0.0f;
+
+    uint64 timestamps[2] = {};
+    VkResult result = vkGetQueryPoolResults(g_vulkanContextResources.device, g_vulkanContextResources.queryPoolFrameTiming,
+        virtualFrame * VulkanFrameTimingQuery::eMax + firstQuery, 2, sizeof(timestamps), timestamps, sizeof(uint64), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+        return 0.0f;
+
+    return (float)((double)(timestamps[1] - timestamps[0]) * (double)g_vulkanContextResources.timestampPeriod * 1e-6);
+}
+
+// The frame that last used the current virtual frame has retired on every queue, so its timings are available
+static void ResolveFrameTimings()
+{
+    static const float smoothing = 0.05f;
+
+    const uint32 virtualFrame = g_vulkanContextResources.currentVirtualFrame;
+    if (!g_vulkanContextResources.frameTimingQueriesWritten[virtualFrame])
+        return;
+
+    const float graphicsTimeMS = ReadFrameTimingMS(virtualFrame, VulkanFrameTimingQuery::eGraphicsBegin);
+    const float asyncComputeTimeMS = ReadFrameTimingMS(virtualFrame, VulkanFrameTimingQuery::eAsyncComputeBegin);
+    g_vulkanContextResources.avgGraphicsQueueGPUTimeMS += (graphicsTimeMS - g_vulkanContextResources.avgGraphicsQueueGPUTimeMS) * smoothing;
+    g_vulkanContextResources.avgAsyncComputeGPUTimeMS += (asyncComputeTimeMS - g_vulkanContextResources.avgAsyncComputeGPUTimeMS) * smoothing;
+    g_vulkanContextResources.frameTimingQueriesWritten[virtualFrame] = 0;
+}
+
 void BeginVulkanCommandRecording()
 {
     VkCommandBufferBeginInfo commandBufferBeginInfo = {};
@@ -254,6 +605,16 @@ void BeginVulkanCommandRecording()
         Core::Utility::LogMsg("Platform", "Failed to begin Vulkan command buffer!", Core::Utility::LogSeverity::eCritical);
         TINKER_ASSERT(0);
     }
+
+    // Uploads that completed before this frame started are visible to it
+    VulkanRecordUploadAcquires(g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame]);
+
+    ResolveFrameTimings();
+    BeginFrameTimingQueries(g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame], VulkanFrameTimingQuery::eGraphicsBegin);
+
+    g_vulkanContextResources.isBindlessSetBound = false;
+    g_vulkanContextResources.isBindlessSetBoundCompute = false;
+    g_vulkanContextResources.boundGraphicsPipeline = VK_NULL_HANDLE;
 }
 
 void EndVulkanCommandRecording()
@@ -262,6 +623,9 @@ void EndVulkanCommandRecording()
     {
         TINKER_ASSERT(0);
     }
+    TINKER_ASSERT(!g_vulkanContextResources.isRecordingAsyncCompute);
+
+    EndFrameTimingQueries(g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame], VulkanFrameTimingQuery::eGraphicsBegin);
 
     VkResult result = vkEndCommandBuffer(g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame]);
     if (result != VK_SUCCESS)
@@ -287,6 +651,8 @@ void BeginVulkanCommandRecordingImmediate()
 
 void EndVulkanCommandRecordingImmediate()
 {
+    FlushPendingMappedRanges();
+
     VkResult result = vkEndCommandBuffer(g_vulkanContextResources.commandBuffer_Immediate);
     if (result != VK_SUCCESS)
     {
@@ -315,12 +681,61 @@ VkCommandBuffer ChooseAppropriateCommandBuffer(bool immediateSubmit)
     if (!immediateSubmit)
     {
         TINKER_ASSERT(g_vulkanContextResources.currentSwapChainImage != TINKER_INVALID_HANDLE && g_vulkanContextResources.currentVirtualFrame != TINKER_INVALID_HANDLE);
-        commandBuffer = g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame];
+        commandBuffer = g_vulkanContextResources.isRecordingAsyncCompute ?
+            g_vulkanContextResources.computeCommandBuffers[g_vulkanContextResources.currentVirtualFrame] :
+            g_vulkanContextResources.commandBuffers[g_vulkanContextResources.currentVirtualFrame];
     }
 
     return commandBuffer;
 }
 
+// Without a dedicated compute family, or with async compute disabled, the commands go to the graphics command buffer
+void BeginVulkanAsyncComputeRecording()
+{
+    TINKER_ASSERT(!g_vulkanContextResources.isRecordingAsyncCompute);
+
+    const bool isOnComputeQueue = VulkanHasDedicatedComputeQueue() && g_vulkanContextResources.isAsyncComputeEnabled;
+    g_vulkanContextResources.wasAsyncComputeOnComputeQueue = isOnComputeQueue;
+    if (isOnComputeQueue)
+    {
+        VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+        commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkResult result = vkBeginCommandBuffer(g_vulkanContextResources.computeCommandBuffers[g_vulkanContextResources.currentVirtualFrame], &commandBufferBeginInfo);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to begin Vulkan compute command buffer!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+        }
+
+        g_vulkanContextResources.isRecordingAsyncCompute = true;
+        g_vulkanContextResources.isAsyncComputeRecorded = true;
+        g_vulkanContextResources.isBindlessSetBoundCompute = false;
+    }
+
+    BeginFrameTimingQueries(ChooseAppropriateCommandBuffer(false), VulkanFrameTimingQuery::eAsyncComputeBegin);
+}
+
+void EndVulkanAsyncComputeRecording()
+{
+    EndFrameTimingQueries(ChooseAppropriateCommandBuffer(false), VulkanFrameTimingQuery::eAsyncComputeBegin);
+
+    if (!g_vulkanContextResources.isRecordingAsyncCompute)
+        return;
+
+    VkResult result = vkEndCommandBuffer(g_vulkanContextResources.computeCommandBuffers[g_vulkanContextResources.currentVirtualFrame]);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to end Vulkan compute command buffer!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    // The bind tracking was for the compute command buffer, the graphics one has to bind again
+    g_vulkanContextResources.isRecordingAsyncCompute = false;
+    g_vulkanContextResources.isBindlessSetBoundCompute = false;
+}
+
 void RecordCommandPushConstant(const uint8* data, uint32 sizeInBytes, uint32 shaderID)
 {
     TINKER_ASSERT(data && sizeInBytes);
@@ -329,7 +744,9 @@ void RecordCommandPushConstant(const uint8* data, uint32 sizeInBytes, uint32 sha
     const VkPipelineLayout& pipelineLayout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
     TINKER_ASSERT(pipelineLayout != VK_NULL_HANDLE);
 
-    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeInBytes, data);
+    const VkShaderStageFlags stageFlags = g_vulkanContextResources.psoPermutations.isCompute[shaderID] ?
+        VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    vkCmdPushConstants(commandBuffer, pipelineLayout, stageFlags, 0, sizeInBytes, data);
 }
 
 void RecordCommandSetScissor(int32 offsetX, int32 offsetY, uint32 width, uint32 height)
@@ -356,14 +773,126 @@ void RecordCommandDrawCall(ResourceHandle indexBufferHandle, uint32 numIndices,
     vkCmdDrawIndexed(commandBuffer, numIndices, numInstances, indexOffset, vertOffset, 0);
 }
 
+// The current frame's copy of a buffer
+static VkBuffer GetCurrentBuffer(ResourceHandle bufferHandle)
+{
+    VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(bufferHandle.m_hRes);
+    TINKER_ASSERT(resourceChain->resDesc.resourceType == ResourceType::eBuffer1D);
+    return resourceChain->resourceChain[IsBufferUsageMultiBuffered(resourceChain->resDesc.bufferUsage) ? g_vulkanContextResources.currentVirtualFrame : 0].buffer;
+}
+
+void RecordCommandDrawIndirect(ResourceHandle indexBufferHandle, ResourceHandle argsBufferHandle, uint32 argsOffset,
+    ResourceHandle countBufferHandle, uint32 countOffset, uint32 maxDrawCount, const char* debugLabel, bool immediateSubmit)
+{
+    TINKER_ASSERT(indexBufferHandle != DefaultResHandle_Invalid && argsBufferHandle != DefaultResHandle_Invalid);
+
+    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
+
+    DbgStartMarker(commandBuffer, debugLabel);
+    vkCmdBindIndexBuffer(commandBuffer, GetCurrentBuffer(indexBufferHandle), 0, VK_INDEX_TYPE_UINT32);
+    if (countBufferHandle != DefaultResHandle_Invalid)
+    {
+        vkCmdDrawIndexedIndirectCount(commandBuffer, GetCurrentBuffer(argsBufferHandle), argsOffset,
+            GetCurrentBuffer(countBufferHandle), countOffset, maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+    else
+    {
+        vkCmdDrawIndexedIndirect(commandBuffer, GetCurrentBuffer(argsBufferHandle), argsOffset, maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+    DbgEndMarker(commandBuffer);
+}
+
+void RecordCommandBindComputeShader(uint32 shaderID, bool immediateSubmit)
+{
+    TINKER_ASSERT(g_vulkanContextResources.psoPermutations.isCompute[shaderID]);
+    const VkPipeline pipeline = g_vulkanContextResources.psoPermutations.computePipeline[shaderID];
+    TINKER_ASSERT(pipeline != VK_NULL_HANDLE);
+
+    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+    if (g_vulkanContextResources.psoPermutations.isBindless[shaderID] && (immediateSubmit || !g_vulkanContextResources.isBindlessSetBoundCompute))
+    {
+        const VkPipelineLayout& pipelineLayout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &g_vulkanContextResources.bindlessDescriptorSet, 0, nullptr);
+        if (!immediateSubmit)
+            g_vulkanContextResources.isBindlessSetBoundCompute = true;
+    }
+}
+
+void RecordCommandDispatch(uint32 groupCountX, uint32 groupCountY, uint32 groupCountZ, const char* debugLabel, bool immediateSubmit)
+{
+    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
+
+    DbgStartMarker(commandBuffer, debugLabel);
+    vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    DbgEndMarker(commandBuffer);
+}
+
+void RecordCommandDispatchIndirect(ResourceHandle argsBufferHandle, uint32 argsOffset, const char* debugLabel, bool immediateSubmit)
+{
+    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
+
+    DbgStartMarker(commandBuffer, debugLabel);
+    vkCmdDispatchIndirect(commandBuffer, GetCurrentBuffer(argsBufferHandle), argsOffset);
+    DbgEndMarker(commandBuffer);
+}
+
 void RecordCommandBindShader(uint32 shaderID, uint32 blendState, uint32 depthState, bool immediateSubmit)
 {
-    const VkPipeline& pipeline = g_vulkanContextResources.psoPermutations.graphicsPipeline[shaderID][blendState][depthState];
+    const VkPipeline pipeline = VulkanGetOrCreatePSOPerm(shaderID, blendState);
     TINKER_ASSERT(pipeline != VK_NULL_HANDLE);
 
     VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    // Permutations that only differ in dynamic state share a pipeline, so only their dynamic state has to change
+    if (immediateSubmit || g_vulkanContextResources.boundGraphicsPipeline != pipeline)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        if (!immediateSubmit)
+            g_vulkanContextResources.boundGraphicsPipeline = pipeline;
+    }
+
+    const DepthCullState& depthCullState = GetVkDepthCullState(depthState);
+    vkCmdSetCullMode(commandBuffer, depthCullState.cullMode);
+    vkCmdSetFrontFace(commandBuffer, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+    vkCmdSetDepthTestEnable(commandBuffer, depthCullState.depthState.depthTestEnable);
+    vkCmdSetDepthWriteEnable(commandBuffer, depthCullState.depthState.depthWriteEnable);
+    vkCmdSetDepthCompareOp(commandBuffer, depthCullState.depthState.depthCompareOp);
+
+    const uint32 numColorRTs = g_vulkanContextResources.psoPermutations.createDesc[shaderID].numColorRTs;
+    if (g_vulkanContextResources.isExtendedDynamicState3Enabled && numColorRTs > 0)
+    {
+        const VkPipelineColorBlendAttachmentState& blendAttachment = GetVkBlendState(blendState);
+
+        VkBool32 blendEnables[MAX_MULTIPLE_RENDERTARGETS];
+        VkColorBlendEquationEXT blendEquations[MAX_MULTIPLE_RENDERTARGETS];
+        VkColorComponentFlags writeMasks[MAX_MULTIPLE_RENDERTARGETS];
+        for (uint32 uiRT = 0; uiRT < numColorRTs; ++uiRT)
+        {
+            blendEnables[uiRT] = blendAttachment.blendEnable;
+            blendEquations[uiRT].srcColorBlendFactor = blendAttachment.srcColorBlendFactor;
+            blendEquations[uiRT].dstColorBlendFactor = blendAttachment.dstColorBlendFactor;
+            blendEquations[uiRT].colorBlendOp = blendAttachment.colorBlendOp;
+            blendEquations[uiRT].srcAlphaBlendFactor = blendAttachment.srcAlphaBlendFactor;
+            blendEquations[uiRT].dstAlphaBlendFactor = blendAttachment.dstAlphaBlendFactor;
+            blendEquations[uiRT].alphaBlendOp = blendAttachment.alphaBlendOp;
+            writeMasks[uiRT] = blendAttachment.colorWriteMask;
+        }
+        g_vulkanContextResources.pfnCmdSetColorBlendEnableEXT(commandBuffer, 0, numColorRTs, blendEnables);
+        g_vulkanContextResources.pfnCmdSetColorBlendEquationEXT(commandBuffer, 0, numColorRTs, blendEquations);
+        g_vulkanContextResources.pfnCmdSetColorWriteMaskEXT(commandBuffer, 0, numColorRTs, writeMasks);
+    }
+
+    // Bindless pipeline layouts all share set 0, so the set stays bound across them until a classic set replaces it
+    if (g_vulkanContextResources.psoPermutations.isBindless[shaderID] && (immediateSubmit || !g_vulkanContextResources.isBindlessSetBound))
+    {
+        const VkPipelineLayout& pipelineLayout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &g_vulkanContextResources.bindlessDescriptorSet, 0, nullptr);
+        if (!immediateSubmit)
+            g_vulkanContextResources.isBindlessSetBound = true;
+    }
 }
 
 void RecordCommandBindDescriptor(uint32 shaderID, const DescriptorHandle descSetHandle, uint32 descSetIndex, bool immediateSubmit)
@@ -374,10 +903,11 @@ void RecordCommandBindDescriptor(uint32 shaderID, const DescriptorHandle descSet
 
     VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
 
-    VkDescriptorSet* descSet =
-        &g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(descSetHandle.m_hDesc)->resourceChain[g_vulkanContextResources.currentVirtualFrame].descriptorSet;
+    VkDescriptorSet descSet = VulkanGetDescriptorSet(descSetHandle, g_vulkanContextResources.currentVirtualFrame);
 
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, descSetIndex, 1, descSet, 0, nullptr);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, descSetIndex, 1, &descSet, 0, nullptr);
+    if (!immediateSubmit)
+        g_vulkanContextResources.isBindlessSetBound = false;
 
     /*for (uint32 uiDesc = 0; uiDesc < MAX_DESCRIPTOR_SETS_PER_SHADER; ++uiDesc)
     {
@@ -394,7 +924,7 @@ void RecordCommandBindDescriptor(uint32 shaderID, const DescriptorHandle descSet
     }*/
 }
 
-void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHandle, ResourceHandle dstBufferHandle,
+void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHandle, uint32 srcOffset, ResourceHandle dstBufferHandle, uint32 dstOffset,
     const char* debugLabel, bool immediateSubmit)
 {
     VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
@@ -407,9 +937,9 @@ void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHan
         case ResourceType::eBuffer1D:
         {
             VkBufferCopy bufferCopy = {};
-            bufferCopy.srcOffset = 0; // TODO: make this stuff a function param?
+            bufferCopy.srcOffset = srcOffset;
             bufferCopy.size = sizeInBytes;
-            bufferCopy.dstOffset = 0;
+            bufferCopy.dstOffset = dstOffset;
 
             uint32 srcIndex = IsBufferUsageMultiBuffered(srcResourceChain->resDesc.bufferUsage) ? g_vulkanContextResources.currentVirtualFrame : 0u;
             uint32 dstIndex = IsBufferUsageMultiBuffered(dstResourceChain->resDesc.bufferUsage) ? g_vulkanContextResources.currentVirtualFrame : 0u;
@@ -432,6 +962,12 @@ void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHan
                     break;
                 }
 
+                case ImageFormat::RGBA16_Float:
+                {
+                    bytesPerPixel = 64 / 8;
+                    break;
+                }
+
                 default:
                 {
                     Core::Utility::LogMsg("Platform", "Unsupported image copy dst format!", Core::Utility::LogSeverity::eCritical);
@@ -447,7 +983,7 @@ void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHan
 
                 // TODO: make some of these into function params
                 VkBufferImageCopy region = {};
-                region.bufferOffset = 0;
+                region.bufferOffset = srcOffset;
                 region.bufferRowLength = 0;
                 region.bufferImageHeight = 0;
                 region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -467,6 +1003,8 @@ void RecordCommandMemoryTransfer(uint32 sizeInBytes, ResourceHandle srcBufferHan
 void RecordCommandRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colorRTs, ResourceHandle depthRT, uint32 renderWidth, uint32 renderHeight,
     const char* debugLabel, bool immediateSubmit)
 {
+    // Compute queues can't render
+    TINKER_ASSERT(!g_vulkanContextResources.isRecordingAsyncCompute);
     const bool HasDepth = depthRT.m_hRes != TINKER_INVALID_HANDLE;
     const uint32 numAttachments = numColorRTs + (HasDepth ? 1u : 0u);
 
@@ -482,7 +1020,7 @@ void RecordCommandRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colo
     {
         VkRenderingAttachmentInfo& colorAttachment = colorAttachments[i];
         colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_ATTACHMENT_OPTIMAL;
+        colorAttachment.imageLayout = GetVkImageLayout(ImageLayout::eRenderOptimal);
         colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
         colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
         colorAttachment.clearValue.color = { 0.0f, 0.0f, 0.0f, 0.0f };
@@ -500,7 +1038,7 @@ void RecordCommandRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colo
 
     VkRenderingAttachmentInfo depthAttachment = {};
     depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depthAttachment.imageLayout = GetVkImageLayout(ImageLayout::eDepthOptimal);
     depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     depthAttachment.clearValue.color = { DEPTH_MAX, 0 };
@@ -522,6 +1060,16 @@ void RecordCommandRenderPassBegin(uint32 numColorRTs, const ResourceHandle* colo
     DbgStartMarker(commandBuffer, debugLabel);
 
     vkCmdBeginRendering(commandBuffer, &renderingInfo);
+
+    // Viewport is dynamic state, covers the whole render area. Flipped y to match the projection convention.
+    VkViewport viewport = {};
+    viewport.x = 0.0f;
+    viewport.y = (float)renderHeight;
+    viewport.width = (float)renderWidth;
+    viewport.height = -(float)renderHeight;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 }
 
 void RecordCommandRenderPassEnd(bool immediateSubmit)
@@ -531,176 +1079,193 @@ void RecordCommandRenderPassEnd(bool immediateSubmit)
     DbgEndMarker(commandBuffer);
 }
 
-void RecordCommandTransitionLayout(ResourceHandle imageHandle,
-    uint32 startLayout, uint32 endLayout, const char* debugLabel, bool immediateSubmit)
+// Image, aspect and layer count covered by a barrier on imageHandle
+static bool GetBarrierImage(ResourceHandle imageHandle, VkImage* outImage, VkImageAspectFlags* outAspectMask, uint32* outNumArrayEles)
 {
-    if (startLayout == endLayout)
+    if (imageHandle == IMAGE_HANDLE_SWAP_CHAIN)
     {
-        // Useless transition / error transition, don't record it
-        TINKER_ASSERT(0);
-        return;
+        *outImage = g_vulkanContextResources.swapChainImages[g_vulkanContextResources.currentSwapChainImage];
+        *outAspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        *outNumArrayEles = 1;
+        return true;
     }
 
-    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
-
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.oldLayout = GetVkImageLayout(startLayout);
-    barrier.newLayout = GetVkImageLayout(endLayout);
+    VulkanMemResourceChain* memResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(imageHandle.m_hRes);
+    VulkanMemResource* memResource = &memResourceChain->resourceChain[0]; // Currently, all image resources are not duplicated per frame in flight
+    *outImage = memResource->image;
+    *outNumArrayEles = memResourceChain->resDesc.arrayEles;
 
-    VkPipelineStageFlags srcStage;
-    VkPipelineStageFlags dstStage;
-
-    switch (startLayout)
+    switch (memResourceChain->resDesc.imageFormat)
     {
-        case ImageLayout::eUndefined:
-        {
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.srcAccessMask = 0;
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            break;
-        }
-
-        case ImageLayout::eShaderRead:
-        {
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            break;
-        }
-
-        case ImageLayout::eTransferDst:
-        {
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            break;
-        }
-
-        case ImageLayout::eDepthOptimal:
+        case ImageFormat::BGRA8_SRGB:
+        case ImageFormat::RGBA8_SRGB:
+        case ImageFormat::RGBA16_Float:
         {
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-            barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            srcStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            break;
+            *outAspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            return true;
         }
 
-        case ImageLayout::eRenderOptimal:
+        case ImageFormat::Depth_32F:
         {
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            break;
+            *outAspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+            return true;
         }
 
         default:
         {
-            Core::Utility::LogMsg("Platform", "Invalid dst image resource layout specified for layout transition!", Core::Utility::LogSeverity::eCritical);
+            Core::Utility::LogMsg("Platform", "Invalid image format for image barrier!", Core::Utility::LogSeverity::eCritical);
             TINKER_ASSERT(0);
-            return;
+            return false;
         }
     }
+}
 
-    switch (endLayout)
-    {
-        case ImageLayout::eUndefined:
-        {
-            TINKER_ASSERT(0);
-            // Can't transition to undefined according to Vulkan spec
-            return;
-        }
+void RecordCommandImageBarriers(const ImageBarrier* barriers, uint32 numBarriers, const char* debugLabel, bool immediateSubmit)
+{
+    TINKER_ASSERT(numBarriers <= MAX_IMAGE_BARRIERS_PER_COMMAND);
 
-        case ImageLayout::eShaderRead:
+    VkImageMemoryBarrier2 imageBarriers[MAX_IMAGE_BARRIERS_PER_COMMAND];
+    uint32 numImageBarriers = 0;
+    for (uint32 uiBarrier = 0; uiBarrier < Min(numBarriers, (uint32)MAX_IMAGE_BARRIERS_PER_COMMAND); ++uiBarrier)
+    {
+        const ImageBarrier& barrier = barriers[uiBarrier];
+        TINKER_ASSERT(barrier.dstAccess != ImageAccess::eNone && barrier.dstAccess < ImageAccess::eMax);
+
+        VkImage image = VK_NULL_HANDLE;
+        VkImageAspectFlags aspectMask = 0;
+        uint32 numArrayEles = 0;
+        if (!GetBarrierImage(barrier.imageHandle, &image, &aspectMask, &numArrayEles))
+            continue;
+
+        const AccessScope& srcScope = GetVkImageAccessScope(barrier.srcAccess);
+        const AccessScope& dstScope = GetVkImageAccessScope(barrier.dstAccess);
+
+        VkImageMemoryBarrier2& imageBarrier = imageBarriers[numImageBarriers++];
+        imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        imageBarrier.srcStageMask = srcScope.stageMask;
+        // Only writes have to be made available, reads just need the execution dependency
+        imageBarrier.srcAccessMask = IsImageAccessWrite(barrier.srcAccess) ? srcScope.accessMask : VK_ACCESS_2_NONE;
+        for (uint32 uiAccess = 0; uiAccess < ImageAccess::eMax; ++uiAccess)
         {
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-            break;
+            if (!(barrier.aliasSrcAccesses & (1u << uiAccess)))
+                continue;
+
+            // Accesses of other images bound to the same memory
+            const AccessScope& aliasScope = GetVkImageAccessScope(uiAccess);
+            imageBarrier.srcStageMask |= aliasScope.stageMask;
+            if (IsImageAccessWrite(uiAccess))
+                imageBarrier.srcAccessMask |= aliasScope.accessMask;
         }
+        imageBarrier.dstStageMask = dstScope.stageMask;
+        imageBarrier.dstAccessMask = dstScope.accessMask;
+        imageBarrier.oldLayout = barrier.discardContents ? VK_IMAGE_LAYOUT_UNDEFINED : GetVkImageLayout(GetImageAccessLayout(barrier.srcAccess));
+        imageBarrier.newLayout = GetVkImageLayout(GetImageAccessLayout(barrier.dstAccess));
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = image;
+        imageBarrier.subresourceRange.aspectMask = aspectMask;
+        imageBarrier.subresourceRange.baseMipLevel = 0;
+        imageBarrier.subresourceRange.levelCount = 1;
+        imageBarrier.subresourceRange.baseArrayLayer = 0;
+        imageBarrier.subresourceRange.layerCount = numArrayEles;
+    }
 
-        case ImageLayout::eTransferDst:
-        {
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            break;
-        }
+    if (numImageBarriers == 0)
+        return;
 
-        case ImageLayout::eDepthOptimal:
-        {
-            barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            dstStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            break;
-        }
+    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
 
-        case ImageLayout::eRenderOptimal:
-        {
-            barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            break;
-        }
+    VkDependencyInfo dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.imageMemoryBarrierCount = numImageBarriers;
+    dependencyInfo.pImageMemoryBarriers = imageBarriers;
 
-        case ImageLayout::ePresent:
-        {
-            barrier.dstAccessMask = 0;
-            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-            break;
-        }
+    DbgStartMarker(commandBuffer, debugLabel);
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    DbgEndMarker(commandBuffer);
+}
 
-        default:
-        {
-            Core::Utility::LogMsg("Platform", "Invalid src image resource layout specified for layout transition!", Core::Utility::LogSeverity::eCritical);
-            TINKER_ASSERT(0);
-            return;
-        }
-    }
+void RecordCommandBufferBarriers(const BufferBarrier* barriers, uint32 numBarriers, const char* debugLabel, bool immediateSubmit)
+{
+    TINKER_ASSERT(numBarriers <= MAX_BUFFER_BARRIERS_PER_COMMAND);
 
-    VkImage image = VK_NULL_HANDLE;
-    uint32 numArrayEles = 0;
-    if (imageHandle == IMAGE_HANDLE_SWAP_CHAIN)
+    VkBufferMemoryBarrier2 bufferBarriers[MAX_BUFFER_BARRIERS_PER_COMMAND];
+    const uint32 numBufferBarriers = Min(numBarriers, (uint32)MAX_BUFFER_BARRIERS_PER_COMMAND);
+    for (uint32 uiBarrier = 0; uiBarrier < numBufferBarriers; ++uiBarrier)
     {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        image = g_vulkanContextResources.swapChainImages[g_vulkanContextResources.currentSwapChainImage];
-        numArrayEles = 1;
+        const BufferBarrier& barrier = barriers[uiBarrier];
+        TINKER_ASSERT(barrier.dstAccess != BufferAccess::eNone && barrier.dstAccess < BufferAccess::eMax);
+
+        const AccessScope& srcScope = GetVkBufferAccessScope(barrier.srcAccess);
+        const AccessScope& dstScope = GetVkBufferAccessScope(barrier.dstAccess);
+
+        VkBufferMemoryBarrier2& bufferBarrier = bufferBarriers[uiBarrier];
+        bufferBarrier = {};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+        bufferBarrier.srcStageMask = srcScope.stageMask;
+        bufferBarrier.srcAccessMask = IsBufferAccessWrite(barrier.srcAccess) ? srcScope.accessMask : VK_ACCESS_2_NONE;
+        bufferBarrier.dstStageMask = dstScope.stageMask;
+        bufferBarrier.dstAccessMask = dstScope.accessMask;
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = GetCurrentBuffer(barrier.bufferHandle);
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = VK_WHOLE_SIZE;
     }
-    else
-    {
-        VulkanMemResourceChain* memResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(imageHandle.m_hRes);
-        VulkanMemResource* memResource = &memResourceChain->resourceChain[0]; // Currently, all image resources are not duplicated per frame in flight
-        image = memResource->image;
-        numArrayEles = memResourceChain->resDesc.arrayEles;
 
-        switch (memResourceChain->resDesc.imageFormat)
-        {
-            case ImageFormat::BGRA8_SRGB:
-            case ImageFormat::RGBA8_SRGB:
-            {
-                barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                break;
-            }
+    if (numBufferBarriers == 0)
+        return;
 
-            case ImageFormat::Depth_32F:
-            {
-                barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-                break;
-            }
+    VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
 
-            default:
-            {
-                Core::Utility::LogMsg("Platform", "Invalid image format for layout transition command!", Core::Utility::LogSeverity::eCritical);
-                TINKER_ASSERT(0);
-                return;
-            }
-        }
+    VkDependencyInfo dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.bufferMemoryBarrierCount = numBufferBarriers;
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers;
+
+    DbgStartMarker(commandBuffer, debugLabel);
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    DbgEndMarker(commandBuffer);
+}
+
+static uint32 ImageAccessFromLayout(uint32 imageLayout)
+{
+    switch (imageLayout)
+    {
+        case ImageLayout::eShaderRead: return ImageAccess::eFragmentShaderRead;
+        case ImageLayout::eTransferDst: return ImageAccess::eTransferDst;
+        case ImageLayout::eRenderOptimal: return ImageAccess::eColorAttachment;
+        case ImageLayout::eDepthOptimal: return ImageAccess::eDepthAttachment;
+        case ImageLayout::ePresent: return ImageAccess::ePresent;
+        default: return ImageAccess::eNone;
     }
+}
 
-    barrier.image = image;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = numArrayEles;
+// Explicit transitions use the same access scopes as the render graph's barriers
+void RecordCommandTransitionLayout(ResourceHandle imageHandle,
+    uint32 startLayout, uint32 endLayout, const char* debugLabel, bool immediateSubmit)
+{
+    if (startLayout == endLayout)
+    {
+        // Useless transition / error transition, don't record it
+        TINKER_ASSERT(0);
+        return;
+    }
+
+    if (endLayout == ImageLayout::eUndefined)
+    {
+        TINKER_ASSERT(0);
+        // Can't transition to undefined according to Vulkan spec
+        return;
+    }
 
-    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    ImageBarrier barrier = {};
+    barrier.imageHandle = imageHandle;
+    barrier.srcAccess = ImageAccessFromLayout(startLayout);
+    barrier.dstAccess = ImageAccessFromLayout(endLayout);
+    barrier.discardContents = startLayout == ImageLayout::eUndefined;
+    RecordCommandImageBarriers(&barrier, 1, debugLabel, immediateSubmit);
 }
 
 void RecordCommandClearImage(ResourceHandle imageHandle,
@@ -737,6 +1302,7 @@ void RecordCommandClearImage(ResourceHandle imageHandle,
     {
         case ImageFormat::BGRA8_SRGB:
         case ImageFormat::RGBA8_SRGB:
+        case ImageFormat::RGBA16_Float:
         {
             range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
             for (uint32 i = 0; i < 4; ++i)
@@ -780,6 +1346,8 @@ void RecordCommandClearImage(ResourceHandle imageHandle,
 
 void RecordCommandGPUTimestamp(uint32 gpuTimestampID, bool immediateSubmit)
 {
+    // The timestamp query pool is reset in the graphics command buffer
+    TINKER_ASSERT(!g_vulkanContextResources.isRecordingAsyncCompute);
     VkCommandBuffer commandBuffer = ChooseAppropriateCommandBuffer(immediateSubmit);
 
     uint32 currQueryOffset = g_vulkanContextResources.currentVirtualFrame * GPU_TIMESTAMP_NUM_MAX + gpuTimestampID;
@@ -791,7 +1359,7 @@ void ResolveMostRecentAvailableTimestamps(void* gpuTimestampCPUSideBuffer, uint3
     uint32 currQueryOffset = g_vulkanContextResources.currentVirtualFrame * GPU_TIMESTAMP_NUM_MAX;
 
     // Need every virtual frame to happen once before reading real values from older frames
-    if (g_vulkanContextResources.frameCounter > MAX_FRAMES_IN_FLIGHT - 1)
+    if (g_vulkanContextResources.frameCounter >= g_vulkanContextResources.numFramesInFlight && numTimestampsInQuery > 0)
     {
         VkResult result = vkGetQueryPoolResults(g_vulkanContextResources.device, g_vulkanContextResources.queryPoolTimestamp, currQueryOffset, numTimestampsInQuery, numTimestampsInQuery * sizeof(uint64), gpuTimestampCPUSideBuffer, sizeof(uint64), VK_QUERY_RESULT_64_BIT);
         if (result != VK_SUCCESS)
@@ -1,14 +1,40 @@
 #include "Graphics/Vulkan/Vulkan.h"
 #include "Graphics/Vulkan/VulkanTypes.h"
 #include "Utility/Logging.h"
+#include "MurmurHash3.h"
 
 namespace Tk
 {
 namespace Graphics
 {
 
-static void CreateDescriptorPool()
+void VulkanDescriptorPoolChain::Init(VkDescriptorPoolCreateFlags poolFlags)
 {
+    m_NumPools = 0;
+    m_CurrentPool = 0;
+    m_PoolFlags = poolFlags;
+}
+
+void VulkanDescriptorPoolChain::Destroy()
+{
+    for (uint32 uiPool = 0; uiPool < m_NumPools; ++uiPool)
+    {
+        vkDestroyDescriptorPool(g_vulkanContextResources.device, m_Pools[uiPool], nullptr);
+        m_Pools[uiPool] = VK_NULL_HANDLE;
+    }
+    m_NumPools = 0;
+    m_CurrentPool = 0;
+    ++m_Generation;
+}
+
+bool VulkanDescriptorPoolChain::CreatePool()
+{
+    if (m_NumPools == VULKAN_MAX_DESCRIPTOR_POOLS_PER_CHAIN)
+    {
+        Core::Utility::LogMsg("Platform", "Out of descriptor pools!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
     VkDescriptorPoolSize descPoolSizes[VULKAN_NUM_SUPPORTED_DESCRIPTOR_TYPES] = {};
     descPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     descPoolSizes[0].descriptorCount = VULKAN_DESCRIPTOR_POOL_MAX_UNIFORM_BUFFERS;
@@ -16,19 +42,170 @@ static void CreateDescriptorPool()
     descPoolSizes[1].descriptorCount = VULKAN_DESCRIPTOR_POOL_MAX_SAMPLED_IMAGES;
     descPoolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     descPoolSizes[2].descriptorCount = VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_BUFFERS;
+    descPoolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descPoolSizes[3].descriptorCount = VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_IMAGES;
+    descPoolSizes[4].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    descPoolSizes[4].descriptorCount = VULKAN_DESCRIPTOR_POOL_MAX_SAMPLERS;
 
     VkDescriptorPoolCreateInfo descPoolCreateInfo = {};
     descPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descPoolCreateInfo.flags = m_PoolFlags;
     descPoolCreateInfo.poolSizeCount = VULKAN_NUM_SUPPORTED_DESCRIPTOR_TYPES;
     descPoolCreateInfo.pPoolSizes = descPoolSizes;
-    descPoolCreateInfo.maxSets = VULKAN_DESCRIPTOR_POOL_MAX_UNIFORM_BUFFERS + VULKAN_DESCRIPTOR_POOL_MAX_SAMPLED_IMAGES;
+    descPoolCreateInfo.maxSets = VULKAN_DESCRIPTOR_POOL_MAX_SETS;
 
-    VkResult result = vkCreateDescriptorPool(g_vulkanContextResources.device, &descPoolCreateInfo, nullptr, &g_vulkanContextResources.descriptorPool);
+    VkResult result = vkCreateDescriptorPool(g_vulkanContextResources.device, &descPoolCreateInfo, nullptr, &m_Pools[m_NumPools]);
     if (result != VK_SUCCESS)
     {
-        Core::Utility::LogMsg("Platform", "Failed to create descriptor pool!", Core::Utility::LogSeverity::eInfo);
-        return;
+        Core::Utility::LogMsg("Platform", "Failed to create descriptor pool!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+    ++m_NumPools;
+    return true;
+}
+
+VkDescriptorSet VulkanDescriptorPoolChain::Alloc(VkDescriptorSetLayout layout, uint32* outPoolIndex)
+{
+    VkDescriptorSetAllocateInfo descSetAllocInfo = {};
+    descSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descSetAllocInfo.descriptorSetCount = 1;
+    descSetAllocInfo.pSetLayouts = &layout;
+
+    // Every existing pool gets a try before the chain grows. A pool that was full can have room again once sets are freed
+    // to it, or still have room for a layout that needs different descriptor types than the one that filled it.
+    const uint32 numPools = m_NumPools;
+    for (uint32 uiAttempt = 0; uiAttempt <= numPools; ++uiAttempt)
+    {
+        // The last attempt goes to a new pool
+        const uint32 uiPool = uiAttempt < numPools ? (m_CurrentPool + uiAttempt) % numPools : numPools;
+        if (uiPool == m_NumPools && !CreatePool())
+        {
+            return VK_NULL_HANDLE;
+        }
+
+        descSetAllocInfo.descriptorPool = m_Pools[uiPool];
+        VkDescriptorSet descSet = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(g_vulkanContextResources.device, &descSetAllocInfo, &descSet);
+        if (result == VK_SUCCESS)
+        {
+            m_CurrentPool = uiPool;
+            *outPoolIndex = uiPool;
+            return descSet;
+        }
+        else if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to create Vulkan descriptor set!", Core::Utility::LogSeverity::eCritical);
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    // A new, empty pool couldn't fit the set
+    Core::Utility::LogMsg("Platform", "Descriptor set doesn't fit in a descriptor pool!", Core::Utility::LogSeverity::eCritical);
+    return VK_NULL_HANDLE;
+}
+
+void VulkanDescriptorPoolChain::Free(VkDescriptorSet descSet, uint32 poolIndex)
+{
+    TINKER_ASSERT(m_PoolFlags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+    TINKER_ASSERT(poolIndex < m_NumPools);
+
+    vkFreeDescriptorSets(g_vulkanContextResources.device, m_Pools[poolIndex], 1, &descSet);
+
+    // The next allocation goes where there is known to be room
+    m_CurrentPool = poolIndex;
+}
+
+void VulkanDescriptorPoolChain::Reset()
+{
+    for (uint32 uiPool = 0; uiPool < m_NumPools; ++uiPool)
+    {
+        vkResetDescriptorPool(g_vulkanContextResources.device, m_Pools[uiPool], 0);
+    }
+    m_CurrentPool = 0;
+}
+
+void VulkanBindlessSlots::Init()
+{
+    // Hand out low slots first
+    m_NumFreeSlots = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    for (uint32 uiSlot = 0; uiSlot < m_NumFreeSlots; ++uiSlot)
+    {
+        m_FreeSlots[uiSlot] = m_NumFreeSlots - 1 - uiSlot;
+    }
+}
+
+uint32 VulkanBindlessSlots::Alloc()
+{
+    if (m_NumFreeSlots == 0)
+    {
+        Core::Utility::LogMsg("Platform", "Out of bindless descriptor slots!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return BINDLESS_INDEX_INVALID;
     }
+    return m_FreeSlots[--m_NumFreeSlots];
+}
+
+void VulkanBindlessSlots::Free(uint32 slot)
+{
+    TINKER_ASSERT(slot < VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE && m_NumFreeSlots < VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE);
+    m_FreeSlots[m_NumFreeSlots++] = slot;
+}
+
+static uint32 WriteBindlessBuffer(VkBuffer buffer)
+{
+    const uint32 slot = g_vulkanContextResources.bindlessBufferSlots.Alloc();
+    if (slot == BINDLESS_INDEX_INVALID)
+        return slot;
+
+    VkDescriptorBufferInfo descBufferInfo = {};
+    descBufferInfo.buffer = buffer;
+    descBufferInfo.offset = 0;
+    descBufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet descSetWrite = {};
+    descSetWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descSetWrite.dstSet = g_vulkanContextResources.bindlessDescriptorSet;
+    descSetWrite.dstBinding = VULKAN_BINDLESS_BINDING_STORAGE_BUFFERS;
+    descSetWrite.dstArrayElement = slot;
+    descSetWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descSetWrite.descriptorCount = 1;
+    descSetWrite.pBufferInfo = &descBufferInfo;
+    vkUpdateDescriptorSets(g_vulkanContextResources.device, 1, &descSetWrite, 0, nullptr);
+
+    return slot;
+}
+
+static uint32 WriteBindlessImage(VkImageView imageView, bool isStorage)
+{
+    const uint32 slot = g_vulkanContextResources.bindlessImageSlots.Alloc();
+    if (slot == BINDLESS_INDEX_INVALID)
+        return slot;
+
+    VkDescriptorImageInfo descImageInfos[2] = {};
+    descImageInfos[0].imageView = imageView;
+    descImageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    descImageInfos[0].sampler = g_vulkanContextResources.linearSampler;
+    descImageInfos[1].imageView = imageView;
+    descImageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet descSetWrites[2] = {};
+    descSetWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descSetWrites[0].dstSet = g_vulkanContextResources.bindlessDescriptorSet;
+    descSetWrites[0].dstBinding = VULKAN_BINDLESS_BINDING_SAMPLED_IMAGES;
+    descSetWrites[0].dstArrayElement = slot;
+    descSetWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descSetWrites[0].descriptorCount = 1;
+    descSetWrites[0].pImageInfo = &descImageInfos[0];
+
+    // Same slot in the storage image array, so one bindless index covers both ways of accessing the image
+    descSetWrites[1] = descSetWrites[0];
+    descSetWrites[1].dstBinding = VULKAN_BINDLESS_BINDING_STORAGE_IMAGES;
+    descSetWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descSetWrites[1].pImageInfo = &descImageInfos[1];
+
+    vkUpdateDescriptorSets(g_vulkanContextResources.device, isStorage ? 2 : 1, descSetWrites, 0, nullptr);
+
+    return slot;
 }
 
 static void CreateImageView(VkDevice device, VkFormat format, VkImageAspectFlags aspectMask, VkImage image, VkImageView* imageView, uint32 arrayEles)
@@ -73,6 +250,77 @@ static VkShaderModule CreateShaderModule(const char* shaderCode, uint32 numShade
     return shaderModule;
 }
 
+static uint64 HashShaderCode(const void* shaderCode, uint32 numShaderCodeBytes)
+{
+    return ((uint64)MurmurHash3_x86_32(shaderCode, (int)numShaderCodeBytes, VULKAN_SHADER_MODULE_HASH_SEED_HI) << 32) |
+            (uint64)MurmurHash3_x86_32(shaderCode, (int)numShaderCodeBytes, VULKAN_SHADER_MODULE_HASH_SEED);
+}
+
+// Returns the module for this bytecode, only creating one if no live pipeline uses the same bytecode.
+// Each acquire is paired with a ReleaseShaderModule when the pipeline is destroyed.
+static VkShaderModule AcquireShaderModule(const void* shaderCode, uint32 numShaderCodeBytes, uint64* outHash)
+{
+    const uint64 hash = HashShaderCode(shaderCode, numShaderCodeBytes);
+    *outHash = hash;
+
+    Core::HashMap<uint64, VulkanShaderModule, Hash64>& shaderModules = g_vulkanContextResources.shaderModules;
+    uint32 index = shaderModules.FindIndex(hash);
+    if (index != shaderModules.eInvalidIndex && shaderModules.DataAtIndex(index).module != VK_NULL_HANDLE)
+    {
+        ++shaderModules.DataAtIndex(index).refCount;
+        return shaderModules.DataAtIndex(index).module;
+    }
+
+    VkShaderModule shaderModule = CreateShaderModule((const char*)shaderCode, numShaderCodeBytes, g_vulkanContextResources.device);
+    if (shaderModule == VK_NULL_HANDLE)
+        return VK_NULL_HANDLE;
+
+    // Keys stay in the cache once their module is destroyed, a full cache only means the module isn't shared
+    if (index == shaderModules.eInvalidIndex)
+        index = shaderModules.Insert(hash, { VK_NULL_HANDLE, 0 });
+    if (index != shaderModules.eInvalidIndex)
+    {
+        shaderModules.DataAtIndex(index).module = shaderModule;
+        shaderModules.DataAtIndex(index).refCount = 1;
+    }
+    return shaderModule;
+}
+
+static void ReleaseShaderModule(VkShaderModule shaderModule, uint64 hash)
+{
+    if (shaderModule == VK_NULL_HANDLE)
+        return;
+
+    Core::HashMap<uint64, VulkanShaderModule, Hash64>& shaderModules = g_vulkanContextResources.shaderModules;
+    const uint32 index = shaderModules.FindIndex(hash);
+    if (index != shaderModules.eInvalidIndex && shaderModules.DataAtIndex(index).module == shaderModule)
+    {
+        VulkanShaderModule& cachedModule = shaderModules.DataAtIndex(index);
+        TINKER_ASSERT(cachedModule.refCount > 0);
+        if (--cachedModule.refCount > 0)
+            return;
+        cachedModule.module = VK_NULL_HANDLE;
+    }
+
+    VulkanDeferDestroy(VulkanDeferredDestroyType::eShaderModule, (uint64)shaderModule);
+}
+
+uint32 VulkanGetNumShaderModules()
+{
+    const Core::HashMap<uint64, VulkanShaderModule, Hash64>& shaderModules = g_vulkanContextResources.shaderModules;
+
+    uint32 numModules = 0;
+    for (uint32 uiSlot = 0; uiSlot < shaderModules.Size(); ++uiSlot)
+    {
+        if (shaderModules.KeyAtIndex(uiSlot) != shaderModules.GetInvalidKey() &&
+            shaderModules.DataAtIndex(uiSlot).module != VK_NULL_HANDLE)
+        {
+            ++numModules;
+        }
+    }
+    return numModules;
+}
+
 void VulkanCreateSwapChain()
 {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -240,39 +488,30 @@ void VulkanDestroySwapChain()
 }
 
 
-bool VulkanCreateGraphicsPipeline(
-    void* vertexShaderCode, uint32 numVertexShaderBytes,
-    void* fragmentShaderCode, uint32 numFragmentShaderBytes,
-    uint32 shaderID, uint32 viewportWidth, uint32 viewportHeight,
-    uint32 numColorRTs, const uint32* colorRTFormats, uint32 depthFormat,
-    uint32* descriptorLayoutHandles, uint32 numDescriptorLayoutHandles)
+// Blend state only selects a pipeline when it can't be set dynamically
+static uint32 GetPSOPermKey(uint32 shaderID, uint32 blendState)
 {
-    VkShaderModule vertexShaderModule = VK_NULL_HANDLE;
-    VkShaderModule fragmentShaderModule = VK_NULL_HANDLE;
+    TINKER_ASSERT(shaderID < VulkanContextResources::eMaxShaders && blendState < VulkanContextResources::eMaxBlendStates);
+    if (g_vulkanContextResources.isExtendedDynamicState3Enabled)
+        blendState = 0;
+    return (shaderID << 16) | blendState;
+}
+
+static bool CreatePSOPerm(uint32 shaderID, uint32 blendState, VkPipeline& graphicsPipeline)
+{
+    const VulkanContextResources::PSOCreateDesc& createDesc = g_vulkanContextResources.psoPermutations.createDesc[shaderID];
 
-    uint32 numStages = 0;
-    if (numVertexShaderBytes > 0)
-    {
-        vertexShaderModule = CreateShaderModule((const char*)vertexShaderCode, numVertexShaderBytes, g_vulkanContextResources.device);
-        ++numStages;
-    }
-    if (numFragmentShaderBytes > 0)
-    {
-        fragmentShaderModule = CreateShaderModule((const char*)fragmentShaderCode, numFragmentShaderBytes, g_vulkanContextResources.device);
-        ++numStages;
-    }
-    
     // Programmable shader stages
     const uint32 maxNumStages = 2;
     VkPipelineShaderStageCreateInfo shaderStages[maxNumStages] = {};
     shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-    shaderStages[0].module = vertexShaderModule;
+    shaderStages[0].module = createDesc.vertexShaderModule;
     shaderStages[0].pName = "main";
 
     shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    shaderStages[1].module = fragmentShaderModule;
+    shaderStages[1].module = createDesc.fragmentShaderModule;
     shaderStages[1].pName = "main";
 
     // Fixed function
@@ -290,25 +529,12 @@ bool VulkanCreateGraphicsPipeline(
     inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = (float)viewportHeight;
-    viewport.width = (float)viewportWidth;
-    viewport.height = -(float)viewportHeight;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    //VkRect2D scissor = {};
-    //scissor.offset = { 0, 0 };
-    //scissor.extent = { viewportWidth, viewportHeight };
-
     VkPipelineViewportStateCreateInfo viewportState = {};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
+    viewportState.pViewports = nullptr; // Set dynamically at render pass begin
     viewportState.scissorCount = 1; // Must be set dynamically
     viewportState.pScissors = nullptr;
-    //viewportState.pScissors = &scissor;
 
     VkPipelineMultisampleStateCreateInfo multisampling = {};
     multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
@@ -328,20 +554,174 @@ bool VulkanCreateGraphicsPipeline(
     colorBlending.blendConstants[2] = 0.0f;
     colorBlending.blendConstants[3] = 0.0f;
 
-    const uint32 numDynamicStates = 1;
-    VkDynamicState dynamicStates[numDynamicStates] =
+    // Depth and cull state are core dynamic state (extended dynamic state) since Vulkan 1.3
+    const uint32 maxNumDynamicStates = 10;
+    VkDynamicState dynamicStates[maxNumDynamicStates] =
     {
+        VK_DYNAMIC_STATE_VIEWPORT,
         VK_DYNAMIC_STATE_SCISSOR,
+        VK_DYNAMIC_STATE_CULL_MODE,
+        VK_DYNAMIC_STATE_FRONT_FACE,
+        VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
     };
+    uint32 numDynamicStates = 7;
+    if (g_vulkanContextResources.isExtendedDynamicState3Enabled)
+    {
+        dynamicStates[numDynamicStates++] = VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT;
+        dynamicStates[numDynamicStates++] = VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT;
+        dynamicStates[numDynamicStates++] = VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT;
+    }
+    TINKER_ASSERT(numDynamicStates <= maxNumDynamicStates);
 
     VkPipelineDynamicStateCreateInfo dynamicState = {};
     dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
     dynamicState.dynamicStateCount = numDynamicStates;
     dynamicState.pDynamicStates = dynamicStates;
 
+    // Only the static parts of the depth stencil state are used, the rest is set when the shader is bound
+    const DepthCullState& depthCullState = GetVkDepthCullState(DepthState::eOff_CCW);
+    VkPipelineColorBlendAttachmentState colorBlendAttachments[MAX_MULTIPLE_RENDERTARGETS];
+    for (uint32 uiRT = 0; uiRT < createDesc.numColorRTs; ++uiRT)
+    {
+        colorBlendAttachments[uiRT] = GetVkBlendState(blendState);
+    }
+
+    if (createDesc.numColorRTs == 0)
+    {
+        colorBlending.attachmentCount = 0;
+        colorBlending.pAttachments = nullptr;
+    }
+    else
+    {
+        colorBlending.attachmentCount = createDesc.numColorRTs;
+        colorBlending.pAttachments = colorBlendAttachments;
+    }
+
+    VkPipelineRenderingCreateInfo pipelineRenderingCreateInfo = {};
+    pipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    pipelineRenderingCreateInfo.colorAttachmentCount = createDesc.numColorRTs;
+    pipelineRenderingCreateInfo.pColorAttachmentFormats = createDesc.colorRTFormats;
+    pipelineRenderingCreateInfo.depthAttachmentFormat = createDesc.depthFormat;
+    pipelineRenderingCreateInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = depthCullState.cullMode;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = VK_FALSE;
+    rasterizer.depthBiasConstantFactor = 0.0f;
+    rasterizer.depthBiasClamp = 0.0f;
+    rasterizer.depthBiasSlopeFactor = 0.0f;
+
+    VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo; // for dynamic rendering
+    pipelineCreateInfo.stageCount = createDesc.numStages;
+    pipelineCreateInfo.pStages = shaderStages;
+    pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
+    pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+    pipelineCreateInfo.pViewportState = &viewportState;
+    pipelineCreateInfo.pRasterizationState = &rasterizer;
+    pipelineCreateInfo.pMultisampleState = &multisampling;
+    pipelineCreateInfo.pDepthStencilState = &depthCullState.depthState;
+    pipelineCreateInfo.pColorBlendState = &colorBlending;
+    pipelineCreateInfo.pDynamicState = &dynamicState;
+    pipelineCreateInfo.layout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
+    pipelineCreateInfo.renderPass = VK_NULL_HANDLE; // for dynamic rendering
+    pipelineCreateInfo.subpass = 0;
+    pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineCreateInfo.basePipelineIndex = -1;
+
+    // Note: the pipeline cache is internally synchronized, so this is safe to call from several threads at once
+    VkResult result = vkCreateGraphicsPipelines(g_vulkanContextResources.device,
+        g_vulkanContextResources.pipelineCache,
+        1,
+        &pipelineCreateInfo,
+        nullptr,
+        &graphicsPipeline);
+
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan graphics pipeline!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        graphicsPipeline = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
+// Compile all in-use permutations of a shader, spread across the worker threads
+static void CreateInUsePSOPerms(uint32 shaderID)
+{
+    Platform::WorkerJobList jobs;
+    jobs.Init(0);
+
+    // Nothing is inserted into the cache while the jobs run, so each job can write its own slot
+    Core::HashMap<uint32, VkPipeline, Hash32>& graphicsPipelines = g_vulkanContextResources.psoPermutations.graphicsPipelines;
+    for (uint32 uiSlot = 0; uiSlot < graphicsPipelines.Size(); ++uiSlot)
+    {
+        const uint32 key = graphicsPipelines.KeyAtIndex(uiSlot);
+        if (key == graphicsPipelines.GetInvalidKey() || (key >> 16) != shaderID)
+            continue;
+
+        TINKER_ASSERT(jobs.m_numJobs < ARRAYCOUNT(jobs.m_jobs));
+        jobs.m_jobs[jobs.m_numJobs++] = Platform::CreateNewThreadJob([=]()
+            {
+                CreatePSOPerm(shaderID, key & 0xFFFF, g_vulkanContextResources.psoPermutations.graphicsPipelines.DataAtIndex(uiSlot));
+            });
+    }
+
+    if (jobs.m_numJobs > 0)
+    {
+        Platform::EnqueueWorkerThreadJobList_Assisted(&jobs);
+        jobs.WaitOnJobs();
+        jobs.FreeList();
+    }
+}
+
+bool VulkanCreateGraphicsPipeline(
+    const void* vertexShaderCode, uint32 numVertexShaderBytes,
+    const void* fragmentShaderCode, uint32 numFragmentShaderBytes,
+    uint32 shaderID,
+    uint32 numColorRTs, const uint32* colorRTFormats, uint32 depthFormat,
+    uint32* descriptorLayoutHandles, uint32 numDescriptorLayoutHandles)
+{
+    // Shader modules are kept alive until the PSOs are destroyed so that permutations can be created lazily
+    VulkanContextResources::PSOCreateDesc& createDesc = g_vulkanContextResources.psoPermutations.createDesc[shaderID];
+    createDesc = {};
+
+    if (numVertexShaderBytes > 0)
+    {
+        createDesc.vertexShaderModule = AcquireShaderModule(vertexShaderCode, numVertexShaderBytes, &createDesc.vertexShaderHash);
+        ++createDesc.numStages;
+    }
+    if (numFragmentShaderBytes > 0)
+    {
+        createDesc.fragmentShaderModule = AcquireShaderModule(fragmentShaderCode, numFragmentShaderBytes, &createDesc.fragmentShaderHash);
+        ++createDesc.numStages;
+    }
+
+    createDesc.numColorRTs = Min(numColorRTs, (uint32)ARRAYCOUNT(createDesc.colorRTFormats));
+    for (uint32 uiFmt = 0; uiFmt < createDesc.numColorRTs; ++uiFmt)
+    {
+        createDesc.colorRTFormats[uiFmt] = GetVkImageFormat(colorRTFormats[uiFmt]);
+    }
+    createDesc.depthFormat = GetVkImageFormat(depthFormat);
+
     // Descriptor layouts
     TINKER_ASSERT(numDescriptorLayoutHandles <= MAX_DESCRIPTOR_SETS_PER_SHADER);
 
+    g_vulkanContextResources.psoPermutations.isBindless[shaderID] =
+        numDescriptorLayoutHandles > 0 && descriptorLayoutHandles[0] == DESCLAYOUT_ID_BINDLESS;
+    g_vulkanContextResources.psoPermutations.isCompute[shaderID] = false;
+
     VkDescriptorSetLayout descriptorSetLayouts[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
     for (uint32 uiDesc = 0; uiDesc < numDescriptorLayoutHandles; ++uiDesc)
     {
@@ -376,185 +756,452 @@ bool VulkanCreateGraphicsPipeline(
         TINKER_ASSERT(0);
     }
 
-    for (uint32 blendState = 0; blendState < VulkanContextResources::eMaxBlendStates; ++blendState)
+    CreateInUsePSOPerms(shaderID);
+
+    return true;
+}
+
+// Compute pipelines have no blend or depth state, so there is a single pipeline per shader that is created up front
+bool VulkanCreateComputePipeline(const void* computeShaderCode, uint32 numComputeShaderBytes, uint32 shaderID,
+    uint32* descriptorLayoutHandles, uint32 numDescriptorLayoutHandles)
+{
+    TINKER_ASSERT(numComputeShaderBytes > 0);
+    TINKER_ASSERT(numDescriptorLayoutHandles <= MAX_DESCRIPTOR_SETS_PER_SHADER);
+
+    VulkanContextResources::PSOCreateDesc& createDesc = g_vulkanContextResources.psoPermutations.createDesc[shaderID];
+    createDesc = {};
+    createDesc.computeShaderModule = AcquireShaderModule(computeShaderCode, numComputeShaderBytes, &createDesc.computeShaderHash);
+    createDesc.numStages = 1;
+
+    g_vulkanContextResources.psoPermutations.isBindless[shaderID] =
+        numDescriptorLayoutHandles > 0 && descriptorLayoutHandles[0] == DESCLAYOUT_ID_BINDLESS;
+    g_vulkanContextResources.psoPermutations.isCompute[shaderID] = true;
+
+    VkDescriptorSetLayout descriptorSetLayouts[MAX_DESCRIPTOR_SETS_PER_SHADER] = {};
+    for (uint32 uiDesc = 0; uiDesc < numDescriptorLayoutHandles; ++uiDesc)
     {
-        for (uint32 depthState = 0; depthState < VulkanContextResources::eMaxDepthStates; ++depthState)
-        {
-            VkPipeline& graphicsPipeline = g_vulkanContextResources.psoPermutations.graphicsPipeline[shaderID][blendState][depthState];
+        uint32 descLayoutID = descriptorLayoutHandles[uiDesc];
+        if (descLayoutID != DESCLAYOUT_ID_MAX)
+            descriptorSetLayouts[uiDesc] = g_vulkanContextResources.descLayouts[descLayoutID].layout;
+    }
 
-            DepthCullState depthCullState = GetVkDepthCullState(depthState);
-            VkPipelineColorBlendAttachmentState colorBlendAttachment = GetVkBlendState(blendState);
+    VkPushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = MIN_PUSH_CONSTANTS_SIZE;
 
-            if (numColorRTs == 0)
-            {
-                colorBlending.attachmentCount = 0;
-                colorBlending.pAttachments = nullptr;
-            }
-            else
-            {
-                colorBlending.attachmentCount = numColorRTs;
-                colorBlending.pAttachments = &colorBlendAttachment;
-            }
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = numDescriptorLayoutHandles;
+    pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-            VkPipelineRenderingCreateInfo pipelineRenderingCreateInfo = {};
-            pipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
-            pipelineRenderingCreateInfo.colorAttachmentCount = numColorRTs;
-            VkFormat formats[MAX_MULTIPLE_RENDERTARGETS] = {};
-            for (uint32 uiFmt = 0; uiFmt < Min(numColorRTs, (uint32)ARRAYCOUNT(formats)); ++uiFmt)
-            {
-                formats[uiFmt] = GetVkImageFormat(colorRTFormats[uiFmt]);
-            }
-            pipelineRenderingCreateInfo.pColorAttachmentFormats = formats;
-
-            pipelineRenderingCreateInfo.depthAttachmentFormat = GetVkImageFormat(depthFormat);
-            pipelineRenderingCreateInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
-
-            VkPipelineRasterizationStateCreateInfo rasterizer = {};
-            rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-            rasterizer.depthClampEnable = VK_FALSE;
-            rasterizer.rasterizerDiscardEnable = VK_FALSE;
-            rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-            rasterizer.lineWidth = 1.0f;
-            rasterizer.cullMode = depthCullState.cullMode;
-            rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-            rasterizer.depthBiasEnable = VK_FALSE;
-            rasterizer.depthBiasConstantFactor = 0.0f;
-            rasterizer.depthBiasClamp = 0.0f;
-            rasterizer.depthBiasSlopeFactor = 0.0f;
-
-            VkGraphicsPipelineCreateInfo pipelineCreateInfo = {};
-            pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-            pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo; // for dynamic rendering
-            pipelineCreateInfo.stageCount = numStages;
-            pipelineCreateInfo.pStages = shaderStages;
-            pipelineCreateInfo.pVertexInputState = &vertexInputInfo;
-            pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
-            pipelineCreateInfo.pViewportState = &viewportState;
-            pipelineCreateInfo.pRasterizationState = &rasterizer;
-            pipelineCreateInfo.pMultisampleState = &multisampling;
-            pipelineCreateInfo.pDepthStencilState = &depthCullState.depthState;
-            pipelineCreateInfo.pColorBlendState = &colorBlending;
-            pipelineCreateInfo.pDynamicState = &dynamicState;
-            pipelineCreateInfo.layout = pipelineLayout;
-            pipelineCreateInfo.renderPass = VK_NULL_HANDLE; // for dynamic rendering
-            pipelineCreateInfo.subpass = 0;
-            pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-            pipelineCreateInfo.basePipelineIndex = -1;
-
-            result = vkCreateGraphicsPipelines(g_vulkanContextResources.device,
-                VK_NULL_HANDLE,
-                1,
-                &pipelineCreateInfo,
-                nullptr,
-                &graphicsPipeline);
-
-            if (result != VK_SUCCESS)
-            {
-                Core::Utility::LogMsg("Platform", "Failed to create Vulkan graphics pipeline!", Core::Utility::LogSeverity::eCritical);
-                TINKER_ASSERT(0);
-            }
-        }
+    VkPipelineLayout& pipelineLayout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
+    VkResult result = vkCreatePipelineLayout(g_vulkanContextResources.device,
+        &pipelineLayoutInfo,
+        nullptr,
+        &pipelineLayout);
+
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan pipeline layout!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return false;
     }
 
-    vkDestroyShaderModule(g_vulkanContextResources.device, vertexShaderModule, nullptr);
-    vkDestroyShaderModule(g_vulkanContextResources.device, fragmentShaderModule, nullptr);
+    VkComputePipelineCreateInfo pipelineCreateInfo = {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCreateInfo.stage.module = createDesc.computeShaderModule;
+    pipelineCreateInfo.stage.pName = "main";
+    pipelineCreateInfo.layout = pipelineLayout;
+    pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineCreateInfo.basePipelineIndex = -1;
+
+    VkPipeline& computePipeline = g_vulkanContextResources.psoPermutations.computePipeline[shaderID];
+    result = vkCreateComputePipelines(g_vulkanContextResources.device,
+        g_vulkanContextResources.pipelineCache,
+        1,
+        &pipelineCreateInfo,
+        nullptr,
+        &computePipeline);
+
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan compute pipeline!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        computePipeline = VK_NULL_HANDLE;
+        return false;
+    }
 
     return true;
 }
 
-void DestroyPSOPerms(uint32 shaderID)
+VkPipeline VulkanGetOrCreatePSOPerm(uint32 shaderID, uint32 blendState)
 {
-    vkDeviceWaitIdle(g_vulkanContextResources.device); // TODO: move this?
+    Core::HashMap<uint32, VkPipeline, Hash32>& graphicsPipelines = g_vulkanContextResources.psoPermutations.graphicsPipelines;
+    const uint32 key = GetPSOPermKey(shaderID, blendState);
 
-    VkPipelineLayout& pipelineLayout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
-    if (pipelineLayout != VK_NULL_HANDLE)
+    uint32 index = graphicsPipelines.FindIndex(key);
+    if (index == graphicsPipelines.eInvalidIndex)
     {
-        vkDestroyPipelineLayout(g_vulkanContextResources.device, pipelineLayout, nullptr);
-        pipelineLayout = VK_NULL_HANDLE;
+        // First use of this permutation, the key stays for the next reload
+        index = graphicsPipelines.Insert(key, VK_NULL_HANDLE);
+        if (index == graphicsPipelines.eInvalidIndex)
+        {
+            Core::Utility::LogMsg("Platform", "Graphics PSO cache is full!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+            return VK_NULL_HANDLE;
+        }
     }
 
-    for (uint32 uiblendState = 0; uiblendState < VulkanContextResources::eMaxBlendStates; ++uiblendState)
+    VkPipeline& graphicsPipeline = graphicsPipelines.DataAtIndex(index);
+    if (graphicsPipeline == VK_NULL_HANDLE)
     {
-        for (uint32 uiDepthState = 0; uiDepthState < VulkanContextResources::eMaxDepthStates; ++uiDepthState)
-        {
-            VkPipeline& graphicsPipeline = g_vulkanContextResources.psoPermutations.graphicsPipeline[shaderID][uiblendState][uiDepthState];
-            if (graphicsPipeline != VK_NULL_HANDLE)
-            {
-                vkDestroyPipeline(g_vulkanContextResources.device, graphicsPipeline, nullptr);
-                graphicsPipeline = VK_NULL_HANDLE;
-            }
-        }
+        CreatePSOPerm(shaderID, key & 0xFFFF, graphicsPipeline);
     }
+    return graphicsPipeline;
 }
 
-void VulkanDestroyAllPSOPerms()
+uint32 VulkanGetNumGraphicsPSOs()
 {
-    vkDeviceWaitIdle(g_vulkanContextResources.device); // TODO: move this?
+    const Core::HashMap<uint32, VkPipeline, Hash32>& graphicsPipelines = g_vulkanContextResources.psoPermutations.graphicsPipelines;
 
-    for (uint32 shaderID = 0; shaderID < VulkanContextResources::eMaxShaders; ++shaderID)
+    uint32 numPSOs = 0;
+    for (uint32 uiSlot = 0; uiSlot < graphicsPipelines.Size(); ++uiSlot)
     {
-        DestroyPSOPerms(shaderID);
+        if (graphicsPipelines.KeyAtIndex(uiSlot) != graphicsPipelines.GetInvalidKey() &&
+            graphicsPipelines.DataAtIndex(uiSlot) != VK_NULL_HANDLE)
+        {
+            ++numPSOs;
+        }
     }
+    return numPSOs;
 }
 
-static ResourceHandle CreateBufferResource(uint32 sizeInBytes, uint32 bufferUsage, const char* debugLabel)
-{
-    uint32 newResourceHandle =
-        g_vulkanContextResources.vulkanMemResourcePool.Alloc();
-    TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
-    VulkanMemResourceChain* newResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(newResourceHandle);
-    *newResourceChain = {};
-
-    uint32 isMultiBufferedResource = IsBufferUsageMultiBuffered(bufferUsage);
-    const uint32 NumCopies = isMultiBufferedResource ? MAX_FRAMES_IN_FLIGHT : 1u;
-
-    const VkBufferUsageFlags usageFlags = GetVkBufferUsageFlags(bufferUsage);
-    const VkMemoryPropertyFlags propertyFlags = GetVkMemoryPropertyFlags(bufferUsage);
+static void DestroyResourceChain(uint32 hRes);
 
-    // Pick the correct gpu memory allocator
-    // TODO: this will change once the user can create allocators via the graphics layer
-    uint32 AllocatorIndex = 0xFFFFFFFF;
-    if (propertyFlags == VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-        AllocatorIndex = g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalBuffers;
-    else
-        AllocatorIndex = g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers;
+static void RecycleDescriptorChain(uint32 hDesc)
+{
+    VulkanDescriptorChain* descriptorChain = g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(hDesc);
 
-    for (uint32 uiBuf = 0; uiBuf < NumCopies; ++uiBuf)
+    // Sets go on the free list of their layout. If that is full they go back to their pool.
+    if (descriptorChain->poolGeneration == g_vulkanContextResources.descriptorPools.m_Generation)
     {
-        VulkanMemResource* newResource = &newResourceChain->resourceChain[uiBuf];
-
-        VkBufferCreateInfo bufferCreateInfo = {};
-        bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferCreateInfo.size = sizeInBytes;
-        bufferCreateInfo.usage = usageFlags;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        VkResult result = vkCreateBuffer(g_vulkanContextResources.device, &bufferCreateInfo, nullptr, &newResource->buffer);
-        if (result != VK_SUCCESS)
+        const uint32 descLayoutID = descriptorChain->descLayoutID;
+        for (uint32 uiImage = 0; uiImage < MAX_FRAMES_IN_FLIGHT; ++uiImage)
         {
-            Core::Utility::LogMsg("Platform", "Failed to create buffer!", Core::Utility::LogSeverity::eCritical);
-            TINKER_ASSERT(0);
-        }
+            const VulkanDescriptorResource& descResource = descriptorChain->resourceChain[uiImage];
+            if (descResource.descriptorSet == VK_NULL_HANDLE)
+                continue;
 
-        VkMemoryRequirements memRequirements = {};
-        vkGetBufferMemoryRequirements(g_vulkanContextResources.device, newResource->buffer, &memRequirements);
-
-        VulkanMemAlloc newAlloc = g_vulkanContextResources.GPUMemAllocators[AllocatorIndex].Alloc(memRequirements);
-        result = vkBindBufferMemory(g_vulkanContextResources.device, newResource->buffer, newAlloc.allocMem, newAlloc.allocOffset);
-        if (result != VK_SUCCESS)
-        {
-            Core::Utility::LogMsg("Platform", "Failed to bind buffer memory!", Core::Utility::LogSeverity::eCritical);
-            TINKER_ASSERT(0);
+            uint32& numFreeSets = g_vulkanContextResources.numFreeDescriptorSets[descLayoutID];
+            if (numFreeSets < VULKAN_DESCRIPTOR_FREE_LIST_MAX)
+            {
+                VulkanFreeDescriptorSet& freeSet = g_vulkanContextResources.freeDescriptorSets[descLayoutID][numFreeSets++];
+                freeSet.descriptorSet = descResource.descriptorSet;
+                freeSet.poolIndex = descResource.poolIndex;
+            }
+            else
+            {
+                g_vulkanContextResources.descriptorPools.Free(descResource.descriptorSet, descResource.poolIndex);
+            }
         }
-        newResource->GpuMemAlloc = newAlloc;
-
-        DbgSetBufferObjectName((uint64)newResource->buffer, debugLabel);
     }
 
-    return ResourceHandle(newResourceHandle);
+    *descriptorChain = {};
+    g_vulkanContextResources.vulkanDescriptorResourcePool.Dealloc(hDesc);
 }
 
-static ResourceHandle CreateImageResource(uint32 imageFormat, uint32 width, uint32 height, uint32 numArrayEles, const char* debugLabel)
+static void DestroyDeferredObject(const VulkanDeferredDestroy& entry)
+{
+    switch (entry.type)
+    {
+        case VulkanDeferredDestroyType::ePipeline:
+        {
+            vkDestroyPipeline(g_vulkanContextResources.device, (VkPipeline)entry.handle, nullptr);
+            break;
+        }
+
+        case VulkanDeferredDestroyType::ePipelineLayout:
+        {
+            vkDestroyPipelineLayout(g_vulkanContextResources.device, (VkPipelineLayout)entry.handle, nullptr);
+            break;
+        }
+
+        case VulkanDeferredDestroyType::eShaderModule:
+        {
+            vkDestroyShaderModule(g_vulkanContextResources.device, (VkShaderModule)entry.handle, nullptr);
+            break;
+        }
+
+        case VulkanDeferredDestroyType::eResource:
+        {
+            DestroyResourceChain((uint32)entry.handle);
+            break;
+        }
+
+        case VulkanDeferredDestroyType::eDescriptor:
+        {
+            RecycleDescriptorChain((uint32)entry.handle);
+            break;
+        }
+
+        default:
+        {
+            Core::Utility::LogMsg("Platform", "Invalid deferred destroy type!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+            break;
+        }
+    }
+}
+
+void VulkanDeferDestroy(uint32 deferredDestroyType, uint64 handle)
+{
+    const bool isPoolHandle = deferredDestroyType == VulkanDeferredDestroyType::eResource || deferredDestroyType == VulkanDeferredDestroyType::eDescriptor;
+    if (isPoolHandle ? handle == TINKER_INVALID_HANDLE : handle == 0)
+        return;
+
+    if (g_vulkanContextResources.numDeferredDestroys == VULKAN_DEFERRED_DESTROY_QUEUE_MAX)
+    {
+        // Should basically never happen, but don't leak - drain the gpu and flush the whole queue
+        Core::Utility::LogMsg("Platform", "Deferred destroy queue full, waiting for device idle!", Core::Utility::LogSeverity::eWarning);
+        vkDeviceWaitIdle(g_vulkanContextResources.device);
+        VulkanProcessDeferredDestroys(true);
+    }
+
+    VulkanDeferredDestroy& entry = g_vulkanContextResources.deferredDestroyQueue[g_vulkanContextResources.numDeferredDestroys++];
+    entry.handle = handle;
+    entry.type = deferredDestroyType;
+    entry.frameRetired = g_vulkanContextResources.frameCounter;
+    ++g_vulkanContextResources.numDeferredDestroysTotal;
+}
+
+void VulkanProcessDeferredDestroys(bool destroyAll)
+{
+    // An object retired during frame n could be referenced by any frame up to and including n
+    const uint64 numFramesCompleted = VulkanGetNumFramesCompleted();
+
+    uint32 numRemaining = 0;
+    for (uint32 uiEntry = 0; uiEntry < g_vulkanContextResources.numDeferredDestroys; ++uiEntry)
+    {
+        const VulkanDeferredDestroy& entry = g_vulkanContextResources.deferredDestroyQueue[uiEntry];
+        if (destroyAll || (uint64)entry.frameRetired < numFramesCompleted)
+        {
+            DestroyDeferredObject(entry);
+        }
+        else
+        {
+            g_vulkanContextResources.deferredDestroyQueue[numRemaining++] = entry;
+        }
+    }
+    g_vulkanContextResources.numDeferredDestroys = numRemaining;
+}
+
+static void DeferDestroyPSOPerms(uint32 shaderID)
+{
+    // Frames in flight may still reference these, so their destruction is deferred
+    VkPipelineLayout& pipelineLayout = g_vulkanContextResources.psoPermutations.pipelineLayout[shaderID];
+    if (pipelineLayout != VK_NULL_HANDLE)
+    {
+        VulkanDeferDestroy(VulkanDeferredDestroyType::ePipelineLayout, (uint64)pipelineLayout);
+        pipelineLayout = VK_NULL_HANDLE;
+    }
+
+    Core::HashMap<uint32, VkPipeline, Hash32>& graphicsPipelines = g_vulkanContextResources.psoPermutations.graphicsPipelines;
+    for (uint32 uiSlot = 0; uiSlot < graphicsPipelines.Size(); ++uiSlot)
+    {
+        const uint32 key = graphicsPipelines.KeyAtIndex(uiSlot);
+        if (key == graphicsPipelines.GetInvalidKey() || (key >> 16) != shaderID)
+            continue;
+
+        VkPipeline& graphicsPipeline = graphicsPipelines.DataAtIndex(uiSlot);
+        if (graphicsPipeline != VK_NULL_HANDLE)
+        {
+            VulkanDeferDestroy(VulkanDeferredDestroyType::ePipeline, (uint64)graphicsPipeline);
+            graphicsPipeline = VK_NULL_HANDLE;
+        }
+    }
+
+    VkPipeline& computePipeline = g_vulkanContextResources.psoPermutations.computePipeline[shaderID];
+    if (computePipeline != VK_NULL_HANDLE)
+    {
+        VulkanDeferDestroy(VulkanDeferredDestroyType::ePipeline, (uint64)computePipeline);
+        computePipeline = VK_NULL_HANDLE;
+    }
+
+    VulkanContextResources::PSOCreateDesc& createDesc = g_vulkanContextResources.psoPermutations.createDesc[shaderID];
+    ReleaseShaderModule(createDesc.vertexShaderModule, createDesc.vertexShaderHash);
+    ReleaseShaderModule(createDesc.fragmentShaderModule, createDesc.fragmentShaderHash);
+    ReleaseShaderModule(createDesc.computeShaderModule, createDesc.computeShaderHash);
+    createDesc = {};
+}
+
+void DestroyPSOPerms(uint32 shaderID)
+{
+    DeferDestroyPSOPerms(shaderID);
+    ++g_vulkanContextResources.numDeviceStallsAvoided;
+}
+
+void VulkanDestroyAllPSOPerms()
+{
+    for (uint32 shaderID = 0; shaderID < VulkanContextResources::eMaxShaders; ++shaderID)
+    {
+        DeferDestroyPSOPerms(shaderID);
+    }
+    ++g_vulkanContextResources.numDeviceStallsAvoided;
+}
+
+// Storage buffers and storage images can be used by async compute work on the compute queue. Instead of ownership
+// transfers around every use, they are shared by every queue family in use. Returns the number of families, 0 means
+// exclusive ownership since there's no dedicated compute family.
+static void AddUniqueQueueFamily(uint32 queueFamily, uint32* outQueueFamilies, uint32* numQueueFamilies)
+{
+    for (uint32 i = 0; i < *numQueueFamilies; ++i)
+    {
+        if (outQueueFamilies[i] == queueFamily)
+            return;
+    }
+    outQueueFamilies[(*numQueueFamilies)++] = queueFamily;
+}
+
+// Returns 0 if the resource is only ever touched by the graphics queue family and can stay exclusive
+static uint32 GetConcurrentQueueFamilies(bool usedByCompute, bool usedByTransfer, uint32* outQueueFamilies)
+{
+    uint32 numQueueFamilies = 0;
+    AddUniqueQueueFamily(g_vulkanContextResources.graphicsQueueIndex, outQueueFamilies, &numQueueFamilies);
+    if (usedByCompute)
+        AddUniqueQueueFamily(g_vulkanContextResources.computeQueueIndex, outQueueFamilies, &numQueueFamilies);
+    if (usedByTransfer)
+        AddUniqueQueueFamily(g_vulkanContextResources.transferQueueIndex, outQueueFamilies, &numQueueFamilies);
+    return numQueueFamilies > 1 ? numQueueFamilies : 0;
+}
+
+// Multi-buffered buffers get copies for new virtual frames when more frames in flight are allocated
+static void AddMultiBufferedResource(uint32 hRes)
+{
+    VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(hRes);
+    resourceChain->frameCopyListIndex = g_vulkanContextResources.numMultiBufferedResources;
+    g_vulkanContextResources.multiBufferedResources[g_vulkanContextResources.numMultiBufferedResources++] = hRes;
+}
+
+static void RemoveMultiBufferedResource(uint32 hRes)
+{
+    const uint32 listIndex = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(hRes)->frameCopyListIndex;
+    const uint32 hLast = g_vulkanContextResources.multiBufferedResources[--g_vulkanContextResources.numMultiBufferedResources];
+    g_vulkanContextResources.multiBufferedResources[listIndex] = hLast;
+    g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(hLast)->frameCopyListIndex = listIndex;
+}
+
+// Creates copy uiCopy of a buffer resource, with its memory and bindless slot
+static void CreateBufferCopy(VulkanMemResourceChain* resourceChain, uint32 uiCopy, uint32 sizeInBytes, uint32 bufferUsage, const char* debugLabel)
+{
+    const VkBufferUsageFlags usageFlags = GetVkBufferUsageFlags(bufferUsage);
+    const VkMemoryPropertyFlags propertyFlags = GetVkMemoryPropertyFlags(bufferUsage);
+
+    uint32 queueFamilies[3] = {};
+    // Buffers written by the transfer queue are concurrent so repeated and partial uploads need no ownership transfers
+    const uint32 numQueueFamilies = GetConcurrentQueueFamilies((usageFlags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0,
+        (usageFlags & VK_BUFFER_USAGE_TRANSFER_DST_BIT) != 0, queueFamilies);
+    resourceChain->isConcurrent = numQueueFamilies > 0;
+
+    // Pick the correct gpu memory allocator
+    // TODO: this will change once the user can create allocators via the graphics layer
+    uint32 AllocatorIndex = 0xFFFFFFFF;
+    if (propertyFlags == VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        AllocatorIndex = g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalBuffers;
+    else
+        AllocatorIndex = g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers;
+
+    VulkanMemResource* newResource = &resourceChain->resourceChain[uiCopy];
+
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.size = sizeInBytes;
+    bufferCreateInfo.usage = usageFlags;
+    bufferCreateInfo.sharingMode = resourceChain->isConcurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    bufferCreateInfo.queueFamilyIndexCount = numQueueFamilies;
+    bufferCreateInfo.pQueueFamilyIndices = queueFamilies;
+
+    VkResult result = vkCreateBuffer(g_vulkanContextResources.device, &bufferCreateInfo, nullptr, &newResource->buffer);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create buffer!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    VkMemoryRequirements memRequirements = {};
+    vkGetBufferMemoryRequirements(g_vulkanContextResources.device, newResource->buffer, &memRequirements);
+
+    VulkanMemAlloc newAlloc = g_vulkanContextResources.GPUMemAllocators[AllocatorIndex].Alloc(memRequirements);
+    result = vkBindBufferMemory(g_vulkanContextResources.device, newResource->buffer, newAlloc.allocMem, newAlloc.allocOffset);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to bind buffer memory!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+    newResource->GpuMemAlloc = newAlloc;
+
+    newResource->bindlessIndex = BINDLESS_INDEX_INVALID;
+    if (usageFlags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+        newResource->bindlessIndex = WriteBindlessBuffer(newResource->buffer);
+
+    DbgSetBufferObjectName((uint64)newResource->buffer, debugLabel);
+}
+
+static ResourceHandle CreateBufferResource(uint32 sizeInBytes, uint32 bufferUsage, const char* debugLabel)
+{
+    uint32 newResourceHandle =
+        g_vulkanContextResources.vulkanMemResourcePool.Alloc();
+    TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
+    VulkanMemResourceChain* newResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(newResourceHandle);
+    *newResourceChain = {};
+
+    // Copies for frames beyond the allocated ones are created if that many frames in flight are ever requested
+    uint32 isMultiBufferedResource = IsBufferUsageMultiBuffered(bufferUsage);
+    const uint32 NumCopies = isMultiBufferedResource ? g_vulkanContextResources.numAllocatedFramesInFlight : 1u;
+
+    for (uint32 uiBuf = 0; uiBuf < NumCopies; ++uiBuf)
+    {
+        CreateBufferCopy(newResourceChain, uiBuf, sizeInBytes, bufferUsage, debugLabel);
+    }
+
+    if (isMultiBufferedResource)
+        AddMultiBufferedResource(newResourceHandle);
+
+    return ResourceHandle(newResourceHandle);
+}
+
+static VkImageAspectFlags GetImageAspectMask(uint32 imageFormat)
+{
+    // TODO: collapse this switch into an array of data
+    switch (imageFormat)
+    {
+        case ImageFormat::BGRA8_SRGB:
+        case ImageFormat::RGBA8_SRGB:
+        case ImageFormat::RGBA16_Float:
+        {
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+        }
+
+        case ImageFormat::Depth_32F:
+        {
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+
+        case ImageFormat::Invalid:
+        default:
+        {
+            Core::Utility::LogMsg("Platform", "Invalid image resource format specified!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+            return 0;
+        }
+    }
+}
+
+static ResourceHandle CreateImageResource(uint32 imageFormat, uint32 width, uint32 height, uint32 numArrayEles, bool isTransient, bool isStorage, const char* debugLabel)
 {
     uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Alloc();
     TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
@@ -563,6 +1210,7 @@ static ResourceHandle CreateImageResource(uint32 imageFormat, uint32 width, uint
 
     // Images not duplicated per frame in flight
     VulkanMemResource* newResource = &newResourceChain->resourceChain[0];
+    newResource->bindlessIndex = BINDLESS_INDEX_INVALID;
 
     // Create image
     VkImageCreateInfo imageCreateInfo = {};
@@ -582,6 +1230,7 @@ static ResourceHandle CreateImageResource(uint32 imageFormat, uint32 width, uint
     {
         case ImageFormat::BGRA8_SRGB:
         case ImageFormat::RGBA8_SRGB:
+        case ImageFormat::RGBA16_Float:
         {
             imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT; // TODO: make this a parameter?
             break;
@@ -602,6 +1251,20 @@ static ResourceHandle CreateImageResource(uint32 imageFormat, uint32 width, uint
         }
     }
 
+    if (isStorage)
+    {
+        // Srgb formats can't be storage images
+        TINKER_ASSERT(imageFormat == ImageFormat::RGBA16_Float);
+        imageCreateInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    uint32 queueFamilies[3] = {};
+    const uint32 numQueueFamilies = isStorage ? GetConcurrentQueueFamilies(true, true, queueFamilies) : 0;
+    newResourceChain->isConcurrent = numQueueFamilies > 0;
+    imageCreateInfo.sharingMode = newResourceChain->isConcurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    imageCreateInfo.queueFamilyIndexCount = numQueueFamilies;
+    imageCreateInfo.pQueueFamilyIndices = queueFamilies;
+
     VkResult result = vkCreateImage(g_vulkanContextResources.device, &imageCreateInfo, nullptr, &newResource->image);
     if (result != VK_SUCCESS)
     {
@@ -609,55 +1272,52 @@ static ResourceHandle CreateImageResource(uint32 imageFormat, uint32 width, uint
         TINKER_ASSERT(0);
     }
 
+    // Transient images get their memory and image view when they are bound into a transient heap
+    if (isTransient)
+    {
+        DbgSetImageObjectName((uint64)newResource->image, debugLabel);
+        return ResourceHandle(newResourceHandle);
+    }
+
     // Pick the correct gpu memory allocator
     // TODO: this will change once the user can create allocators via the graphics layer
     const uint32 AllocatorIndex = g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalImages;
-    VkMemoryRequirements memRequirements = {};
-    vkGetImageMemoryRequirements(g_vulkanContextResources.device, newResource->image, &memRequirements);
+    VkMemoryDedicatedRequirements dedicatedRequirements = {};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 memRequirements2 = {};
+    memRequirements2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    memRequirements2.pNext = &dedicatedRequirements;
+    VkImageMemoryRequirementsInfo2 imageMemReqsInfo = {};
+    imageMemReqsInfo.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    imageMemReqsInfo.image = newResource->image;
+    vkGetImageMemoryRequirements2(g_vulkanContextResources.device, &imageMemReqsInfo, &memRequirements2);
+    const VkMemoryRequirements& memRequirements = memRequirements2.memoryRequirements;
+
+    // Large images (e.g. render targets) get their own device memory if the driver asks for it
+    VulkanMemAlloc newAlloc;
+    if (dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation)
+        newAlloc = g_vulkanContextResources.GPUMemAllocators[AllocatorIndex].AllocDedicated(memRequirements, newResource->image, VK_NULL_HANDLE);
+    else
+        newAlloc = g_vulkanContextResources.GPUMemAllocators[AllocatorIndex].Alloc(memRequirements);
 
-    VulkanMemAlloc newAlloc = g_vulkanContextResources.GPUMemAllocators[AllocatorIndex].Alloc(memRequirements);
     result = vkBindImageMemory(g_vulkanContextResources.device, newResource->image, newAlloc.allocMem, newAlloc.allocOffset);
     if (result != VK_SUCCESS)
     {
         Core::Utility::LogMsg("Platform", "Failed to bind image memory!", Core::Utility::LogSeverity::eCritical);
         TINKER_ASSERT(0);
     }
+    newResource->GpuMemAlloc = newAlloc;
 
     DbgSetImageObjectName((uint64)newResource->image, debugLabel);
 
     // Create image view
-    VkImageAspectFlags aspectMask = {};
-    // TODO: collapse this switch into an array of data
-    switch (imageFormat)
-    {
-        case ImageFormat::BGRA8_SRGB:
-        case ImageFormat::RGBA8_SRGB:
-        {
-            aspectMask |= VK_IMAGE_ASPECT_COLOR_BIT;
-            break;
-        }
-
-        case ImageFormat::Depth_32F:
-        {
-            aspectMask |= VK_IMAGE_ASPECT_DEPTH_BIT;
-            break;
-        }
-
-        case ImageFormat::Invalid:
-        default:
-        {
-            Core::Utility::LogMsg("Platform", "Invalid image resource format specified!", Core::Utility::LogSeverity::eCritical);
-            TINKER_ASSERT(0);
-            break;
-        }
-    }
-
     CreateImageView(g_vulkanContextResources.device,
         GetVkImageFormat(imageFormat),
-        aspectMask,
+        GetImageAspectMask(imageFormat),
         newResource->image,
         &newResource->imageView,
         numArrayEles);
+    newResource->bindlessIndex = WriteBindlessImage(newResource->imageView, isStorage);
 
     return ResourceHandle(newResourceHandle);
 }
@@ -676,7 +1336,7 @@ ResourceHandle VulkanCreateResource(const ResourceDesc& resDesc)
 
         case ResourceType::eImage2D:
         {
-            newHandle = CreateImageResource(resDesc.imageFormat, resDesc.dims.x, resDesc.dims.y, resDesc.arrayEles, resDesc.debugLabel);
+            newHandle = CreateImageResource(resDesc.imageFormat, resDesc.dims.x, resDesc.dims.y, resDesc.arrayEles, resDesc.isTransient, resDesc.isStorage, resDesc.debugLabel);
             break;
         }
 
@@ -694,15 +1354,103 @@ ResourceHandle VulkanCreateResource(const ResourceDesc& resDesc)
     return newHandle;
 }
 
-void VulkanDestroyResource(ResourceHandle handle)
+void VulkanGetImageMemoryRequirements(ResourceHandle imageHandle, uint64* outSizeInBytes, uint64* outAlignment)
 {
-    vkDeviceWaitIdle(g_vulkanContextResources.device); // TODO: move this?
+    VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(imageHandle.m_hRes);
+    TINKER_ASSERT(resourceChain->resDesc.resourceType == ResourceType::eImage2D);
 
+    VkMemoryRequirements memRequirements = {};
+    vkGetImageMemoryRequirements(g_vulkanContextResources.device, resourceChain->resourceChain[0].image, &memRequirements);
+    *outSizeInBytes = memRequirements.size;
+    *outAlignment = memRequirements.alignment;
+}
+
+ResourceHandle VulkanCreateTransientHeap(uint64 sizeInBytes, const ResourceHandle* imageHandles, const uint64* imageOffsets, uint32 numImages, const char* debugLabel)
+{
+    // The heap has to satisfy every image that gets bound into it
+    VkMemoryRequirements heapRequirements = {};
+    heapRequirements.size = sizeInBytes;
+    heapRequirements.alignment = 1;
+    heapRequirements.memoryTypeBits = MAX_UINT32;
+    for (uint32 uiImage = 0; uiImage < numImages; ++uiImage)
+    {
+        VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(imageHandles[uiImage].m_hRes);
+        TINKER_ASSERT(resourceChain->resDesc.resourceType == ResourceType::eImage2D && resourceChain->resDesc.isTransient);
+
+        VkMemoryRequirements memRequirements = {};
+        vkGetImageMemoryRequirements(g_vulkanContextResources.device, resourceChain->resourceChain[0].image, &memRequirements);
+        TINKER_ASSERT(imageOffsets[uiImage] % memRequirements.alignment == 0);
+        TINKER_ASSERT(imageOffsets[uiImage] + memRequirements.size <= sizeInBytes);
+        heapRequirements.alignment = Max(heapRequirements.alignment, memRequirements.alignment);
+        heapRequirements.memoryTypeBits &= memRequirements.memoryTypeBits;
+    }
+
+    uint32 newResourceHandle = g_vulkanContextResources.vulkanMemResourcePool.Alloc();
+    TINKER_ASSERT(newResourceHandle != TINKER_INVALID_HANDLE);
+    VulkanMemResourceChain* newResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(newResourceHandle);
+    *newResourceChain = {};
+    newResourceChain->resDesc.resourceType = ResourceType::eTransientHeap;
+    newResourceChain->resDesc.debugLabel = debugLabel;
+    newResourceChain->resourceChain[0].bindlessIndex = BINDLESS_INDEX_INVALID;
+
+    const uint32 AllocatorIndex = g_vulkanContextResources.eVulkanMemoryAllocatorDeviceLocalImages;
+    VulkanMemAlloc heapAlloc = g_vulkanContextResources.GPUMemAllocators[AllocatorIndex].Alloc(heapRequirements);
+    newResourceChain->resourceChain[0].GpuMemAlloc = heapAlloc;
+    if (heapAlloc.allocMem == VK_NULL_HANDLE)
+    {
+        // The images would be left with no memory bound
+        Core::Utility::LogMsg("Platform", "Failed to allocate transient heap memory!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        g_vulkanContextResources.vulkanMemResourcePool.Dealloc(newResourceHandle);
+        return DefaultResHandle_Invalid;
+    }
+
+    for (uint32 uiImage = 0; uiImage < numImages; ++uiImage)
+    {
+        VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(imageHandles[uiImage].m_hRes);
+        VulkanMemResource* resource = &resourceChain->resourceChain[0];
+
+        VkResult result = vkBindImageMemory(g_vulkanContextResources.device, resource->image, heapAlloc.allocMem, heapAlloc.allocOffset + imageOffsets[uiImage]);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to bind transient image memory!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+            continue;
+        }
+        resource->GpuMemAlloc = heapAlloc;
+        resource->GpuMemAlloc.allocOffset += imageOffsets[uiImage];
+
+        CreateImageView(g_vulkanContextResources.device,
+            GetVkImageFormat(resourceChain->resDesc.imageFormat),
+            GetImageAspectMask(resourceChain->resDesc.imageFormat),
+            resource->image,
+            &resource->imageView,
+            resourceChain->resDesc.arrayEles);
+        resource->bindlessIndex = WriteBindlessImage(resource->imageView, resourceChain->resDesc.isStorage);
+    }
+
+    return ResourceHandle(newResourceHandle);
+}
+
+uint32 VulkanGetBindlessIndex(ResourceHandle handle)
+{
     VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(handle.m_hRes);
+    uint32 index = 0;
+    if (resourceChain->resDesc.resourceType == ResourceType::eBuffer1D && IsBufferUsageMultiBuffered(resourceChain->resDesc.bufferUsage))
+        index = g_vulkanContextResources.currentVirtualFrame;
+
+    const uint32 bindlessIndex = resourceChain->resourceChain[index].bindlessIndex;
+    TINKER_ASSERT(bindlessIndex != BINDLESS_INDEX_INVALID);
+    return bindlessIndex;
+}
+
+static void DestroyResourceChain(uint32 hRes)
+{
+    VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(hRes);
 
     for (uint32 uiFrame = 0; uiFrame < MAX_FRAMES_IN_FLIGHT; ++uiFrame)
     {
-        VulkanMemResource* resource = &g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(handle.m_hRes)->resourceChain[uiFrame];
+        VulkanMemResource* resource = &resourceChain->resourceChain[uiFrame];
 
         switch (resourceChain->resDesc.resourceType)
         {
@@ -711,6 +1459,9 @@ void VulkanDestroyResource(ResourceHandle handle)
                 if (resource->buffer != VK_NULL_HANDLE)
                 {
                     vkDestroyBuffer(g_vulkanContextResources.device, resource->buffer, nullptr);
+                    g_vulkanContextResources.GPUMemAllocators[resource->GpuMemAlloc.allocatorIndex].Free(resource->GpuMemAlloc);
+                    if (resource->bindlessIndex != BINDLESS_INDEX_INVALID)
+                        g_vulkanContextResources.bindlessBufferSlots.Free(resource->bindlessIndex);
                 }
                 break;
             }
@@ -721,12 +1472,37 @@ void VulkanDestroyResource(ResourceHandle handle)
                 {
                     vkDestroyImage(g_vulkanContextResources.device, resource->image, nullptr);
                     vkDestroyImageView(g_vulkanContextResources.device, resource->imageView, nullptr);
+                    if (resource->bindlessIndex != BINDLESS_INDEX_INVALID)
+                        g_vulkanContextResources.bindlessImageSlots.Free(resource->bindlessIndex);
+
+                    // Transient image memory belongs to the transient heap
+                    if (!resourceChain->resDesc.isTransient)
+                        g_vulkanContextResources.GPUMemAllocators[resource->GpuMemAlloc.allocatorIndex].Free(resource->GpuMemAlloc);
+                }
+                break;
+            }
+
+            case ResourceType::eTransientHeap:
+            {
+                if (resource->GpuMemAlloc.allocMem != VK_NULL_HANDLE)
+                {
+                    g_vulkanContextResources.GPUMemAllocators[resource->GpuMemAlloc.allocatorIndex].Free(resource->GpuMemAlloc);
                 }
                 break;
             }
         }
     }
-    g_vulkanContextResources.vulkanMemResourcePool.Dealloc(handle.m_hRes);
+    g_vulkanContextResources.vulkanMemResourcePool.Dealloc(hRes);
+}
+
+void VulkanDestroyResource(ResourceHandle handle)
+{
+    const VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(handle.m_hRes);
+    if (resourceChain->resDesc.resourceType == ResourceType::eBuffer1D && IsBufferUsageMultiBuffered(resourceChain->resDesc.bufferUsage))
+        RemoveMultiBufferedResource(handle.m_hRes);
+
+    VulkanDeferDestroy(VulkanDeferredDestroyType::eResource, handle.m_hRes);
+    ++g_vulkanContextResources.numDeviceStallsAvoided;
 }
 
 void CreateSamplers()
@@ -758,41 +1534,151 @@ void CreateSamplers()
     }
 }
 
-DescriptorHandle VulkanCreateDescriptor(uint32 descriptorLayoutID)
+static void AddPersistentDescriptor(uint32 hDesc)
 {
-    if (g_vulkanContextResources.descriptorPool == VK_NULL_HANDLE)
+    VulkanDescriptorChain* descriptorChain = g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(hDesc);
+    descriptorChain->frameCopyListIndex = g_vulkanContextResources.numPersistentDescriptors;
+    g_vulkanContextResources.persistentDescriptors[g_vulkanContextResources.numPersistentDescriptors++] = hDesc;
+}
+
+static void RemovePersistentDescriptor(uint32 hDesc)
+{
+    const uint32 listIndex = g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(hDesc)->frameCopyListIndex;
+    const uint32 hLast = g_vulkanContextResources.persistentDescriptors[--g_vulkanContextResources.numPersistentDescriptors];
+    g_vulkanContextResources.persistentDescriptors[listIndex] = hLast;
+    g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(hLast)->frameCopyListIndex = listIndex;
+}
+
+static void AllocDescriptorSet(VulkanDescriptorChain* descriptorChain, uint32 uiImage)
+{
+    const uint32 descriptorLayoutID = descriptorChain->descLayoutID;
+    VulkanDescriptorResource* descResource = &descriptorChain->resourceChain[uiImage];
+
+    // Recycle a set of a destroyed descriptor with the same layout before allocating
+    uint32& numFreeSets = g_vulkanContextResources.numFreeDescriptorSets[descriptorLayoutID];
+    if (numFreeSets > 0)
     {
-        // Allocate the descriptor pool
-        CreateDescriptorPool();
+        const VulkanFreeDescriptorSet& freeSet = g_vulkanContextResources.freeDescriptorSets[descriptorLayoutID][--numFreeSets];
+        descResource->descriptorSet = freeSet.descriptorSet;
+        descResource->poolIndex = freeSet.poolIndex;
+        ++g_vulkanContextResources.numDescriptorSetsRecycled;
+        return;
+    }
+
+    descResource->descriptorSet = g_vulkanContextResources.descriptorPools.Alloc(g_vulkanContextResources.descLayouts[descriptorLayoutID].layout, &descResource->poolIndex);
+    if (descResource->descriptorSet == VK_NULL_HANDLE)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan descriptor set!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
     }
+    ++g_vulkanContextResources.numDescriptorSetsAllocated;
+}
+
+DescriptorHandle VulkanCreateDescriptor(uint32 descriptorLayoutID)
+{
+    const VkDescriptorSetLayout& descriptorSetLayout = g_vulkanContextResources.descLayouts[descriptorLayoutID].layout;
+    TINKER_ASSERT(descriptorSetLayout != VK_NULL_HANDLE);
+    if (descriptorSetLayout == VK_NULL_HANDLE)
+        return DefaultDescHandle_Invalid;
 
     uint32 newDescriptorHandle = g_vulkanContextResources.vulkanDescriptorResourcePool.Alloc();
+    TINKER_ASSERT(newDescriptorHandle != TINKER_INVALID_HANDLE && !(newDescriptorHandle & VULKAN_TRANSIENT_DESCRIPTOR_BIT));
+    VulkanDescriptorChain* newDescriptorChain = g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(newDescriptorHandle);
+    *newDescriptorChain = {};
+    newDescriptorChain->descLayoutID = descriptorLayoutID;
+    newDescriptorChain->poolGeneration = g_vulkanContextResources.descriptorPools.m_Generation;
 
-    for (uint32 uiImage = 0; uiImage < MAX_FRAMES_IN_FLIGHT; ++uiImage)
+    for (uint32 uiImage = 0; uiImage < g_vulkanContextResources.numAllocatedFramesInFlight; ++uiImage)
     {
-        const VkDescriptorSetLayout& descriptorSetLayout = g_vulkanContextResources.descLayouts[descriptorLayoutID].layout;
-        TINKER_ASSERT(descriptorSetLayout != VK_NULL_HANDLE);
+        AllocDescriptorSet(newDescriptorChain, uiImage);
+    }
+    AddPersistentDescriptor(newDescriptorHandle);
 
-        if (descriptorSetLayout != VK_NULL_HANDLE)
+    return DescriptorHandle(newDescriptorHandle);
+}
+
+void VulkanCreateFrameCopies(uint32 firstFrame, uint32 lastFrame)
+{
+    TINKER_ASSERT(lastFrame <= g_vulkanContextResources.numAllocatedFramesInFlight);
+
+    // Multi-buffered buffers are written by the cpu each frame they are used, so the new copies start out empty
+    for (uint32 uiRes = 0; uiRes < g_vulkanContextResources.numMultiBufferedResources; ++uiRes)
+    {
+        VulkanMemResourceChain* resourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(g_vulkanContextResources.multiBufferedResources[uiRes]);
+        const ResourceDesc& resDesc = resourceChain->resDesc;
+        for (uint32 uiFrame = firstFrame; uiFrame < lastFrame; ++uiFrame)
         {
-            VkDescriptorSetAllocateInfo descSetAllocInfo = {};
-            descSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            descSetAllocInfo.descriptorPool = g_vulkanContextResources.descriptorPool;
-            descSetAllocInfo.descriptorSetCount = 1;
-            descSetAllocInfo.pSetLayouts = &descriptorSetLayout;
+            CreateBufferCopy(resourceChain, uiFrame, resDesc.dims.x, resDesc.bufferUsage, resDesc.debugLabel);
+        }
+    }
 
-            VkResult result = vkAllocateDescriptorSets(g_vulkanContextResources.device,
-                &descSetAllocInfo,
-                &g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(newDescriptorHandle)->resourceChain[uiImage].descriptorSet);
-            if (result != VK_SUCCESS)
-            {
-                Core::Utility::LogMsg("Platform", "Failed to create Vulkan descriptor set!", Core::Utility::LogSeverity::eCritical);
-                TINKER_ASSERT(0);
-            }
+    // New sets get the same contents as the existing ones, pointing at the new copies of multi-buffered buffers
+    for (uint32 uiDesc = 0; uiDesc < g_vulkanContextResources.numPersistentDescriptors; ++uiDesc)
+    {
+        const uint32 hDesc = g_vulkanContextResources.persistentDescriptors[uiDesc];
+        VulkanDescriptorChain* descriptorChain = g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(hDesc);
+        if (descriptorChain->poolGeneration != g_vulkanContextResources.descriptorPools.m_Generation)
+            continue;
+
+        for (uint32 uiFrame = firstFrame; uiFrame < lastFrame; ++uiFrame)
+        {
+            AllocDescriptorSet(descriptorChain, uiFrame);
+        }
+
+        if (descriptorChain->isWritten)
+        {
+            const DescriptorSetDataHandles writtenHandles = descriptorChain->writtenHandles;
+            VulkanWriteDescriptor(descriptorChain->descLayoutID, DescriptorHandle(hDesc), &writtenHandles);
         }
     }
+}
 
-    return DescriptorHandle(newDescriptorHandle);
+DescriptorHandle VulkanCreateTransientDescriptor(uint32 descriptorLayoutID)
+{
+    const VkDescriptorSetLayout& descriptorSetLayout = g_vulkanContextResources.descLayouts[descriptorLayoutID].layout;
+    TINKER_ASSERT(descriptorSetLayout != VK_NULL_HANDLE);
+
+    const uint32 currentVirtualFrame = g_vulkanContextResources.currentVirtualFrame;
+    uint32& numTransientSets = g_vulkanContextResources.numTransientDescriptorSets[currentVirtualFrame];
+    if (descriptorSetLayout == VK_NULL_HANDLE || numTransientSets == VULKAN_MAX_TRANSIENT_DESCRIPTORS_PER_FRAME)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create transient descriptor!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return DefaultDescHandle_Invalid;
+    }
+
+    uint32 poolIndex = 0;
+    VkDescriptorSet descSet = g_vulkanContextResources.transientDescriptorPools[currentVirtualFrame].Alloc(descriptorSetLayout, &poolIndex);
+    if (descSet == VK_NULL_HANDLE)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create transient descriptor set!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return DefaultDescHandle_Invalid;
+    }
+
+    g_vulkanContextResources.transientDescriptorSets[currentVirtualFrame][numTransientSets] = descSet;
+    return DescriptorHandle(VULKAN_TRANSIENT_DESCRIPTOR_BIT | numTransientSets++);
+}
+
+VkDescriptorSet VulkanGetDescriptorSet(DescriptorHandle handle, uint32 virtualFrame)
+{
+    if (handle.m_hDesc & VULKAN_TRANSIENT_DESCRIPTOR_BIT)
+    {
+        // Only valid in the frame it was created in
+        const uint32 transientIndex = handle.m_hDesc & ~VULKAN_TRANSIENT_DESCRIPTOR_BIT;
+        TINKER_ASSERT(virtualFrame == g_vulkanContextResources.currentVirtualFrame);
+        TINKER_ASSERT(transientIndex < g_vulkanContextResources.numTransientDescriptorSets[virtualFrame]);
+        return g_vulkanContextResources.transientDescriptorSets[virtualFrame][transientIndex];
+    }
+
+    return g_vulkanContextResources.vulkanDescriptorResourcePool.PtrFromHandle(handle.m_hDesc)->resourceChain[virtualFrame].descriptorSet;
+}
+
+void VulkanResetTransientDescriptors()
+{
+    const uint32 currentVirtualFrame = g_vulkanContextResources.currentVirtualFrame;
+    g_vulkanContextResources.transientDescriptorPools[currentVirtualFrame].Reset();
+    g_vulkanContextResources.numTransientDescriptorSets[currentVirtualFrame] = 0;
 }
 
 bool VulkanCreateDescriptorLayout(uint32 descriptorLayoutID, const DescriptorLayout* descriptorLayout)
@@ -809,7 +1695,7 @@ bool VulkanCreateDescriptorLayout(uint32 descriptorLayoutID, const DescriptorLay
             descLayoutBinding[numBindings].descriptorType = GetVkDescriptorType(type);
             descLayoutBinding[numBindings].descriptorCount = descriptorLayout->params[uiDesc].amount;
             descLayoutBinding[numBindings].binding = uiDesc;
-            descLayoutBinding[numBindings].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+            descLayoutBinding[numBindings].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
             descLayoutBinding[numBindings].pImmutableSamplers = nullptr;
             ++numBindings;
         }
@@ -817,19 +1703,30 @@ bool VulkanCreateDescriptorLayout(uint32 descriptorLayoutID, const DescriptorLay
             break;
     }
 
-    uint32 newDescriptorHandle = TINKER_INVALID_HANDLE;
-    if (numBindings > 0)
-    {
-        newDescriptorHandle = g_vulkanContextResources.vulkanDescriptorResourcePool.Alloc();
-    }
-    else
+    if (numBindings == 0)
     {
         Core::Utility::LogMsg("Platform", "No descriptors passed to VulkanCreateDescriptorLayout()!", Core::Utility::LogSeverity::eCritical);
         TINKER_ASSERT(0);
     }
 
-    VkDescriptorSetLayout* descriptorSetLayout = &g_vulkanContextResources.descLayouts[descriptorLayoutID].layout;
+    VulkanDescriptorLayout& vulkanDescLayout = g_vulkanContextResources.descLayouts[descriptorLayoutID];
+    VkDescriptorSetLayout* descriptorSetLayout = &vulkanDescLayout.layout;
     *descriptorSetLayout = VK_NULL_HANDLE;
+    vulkanDescLayout.isShared = false;
+    memcpy(&vulkanDescLayout.bindings, &descriptorLayout->params[0], sizeof(DescriptorLayout));
+
+    // IDs with identical bindings share one set layout, their descriptor sets and pipeline layouts are compatible anyway
+    for (uint32 uiLayout = 0; uiLayout < VulkanContextResources::eMaxDescLayouts; ++uiLayout)
+    {
+        const VulkanDescriptorLayout& other = g_vulkanContextResources.descLayouts[uiLayout];
+        if (uiLayout != descriptorLayoutID && uiLayout != DESCLAYOUT_ID_BINDLESS && other.layout != VK_NULL_HANDLE && !other.isShared &&
+            memcmp(&other.bindings, &vulkanDescLayout.bindings, sizeof(DescriptorLayout)) == 0)
+        {
+            *descriptorSetLayout = other.layout;
+            vulkanDescLayout.isShared = true;
+            return true;
+        }
+    }
 
     VkDescriptorSetLayoutCreateInfo descLayoutInfo = {};
     descLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -843,18 +1740,29 @@ bool VulkanCreateDescriptorLayout(uint32 descriptorLayoutID, const DescriptorLay
         TINKER_ASSERT(0);
     }
 
-    memcpy(&g_vulkanContextResources.descLayouts[descriptorLayoutID].bindings, &descriptorLayout->params[0], sizeof(DescriptorLayout));
     return true;
 }
 
 void VulkanDestroyDescriptor(DescriptorHandle handle)
 {
-    vkDeviceWaitIdle(g_vulkanContextResources.device); // TODO: move this?
-    for (uint32 uiImage = 0; uiImage < MAX_FRAMES_IN_FLIGHT; ++uiImage)
+    // Transient descriptors go away with their frame's pool
+    if (handle.m_hDesc & VULKAN_TRANSIENT_DESCRIPTOR_BIT)
+        return;
+
+    RemovePersistentDescriptor(handle.m_hDesc);
+    VulkanDeferDestroy(VulkanDeferredDestroyType::eDescriptor, handle.m_hDesc);
+    ++g_vulkanContextResources.numDeviceStallsAvoided;
+}
+
+uint32 VulkanGetNumDescriptorSetLayouts()
+{
+    uint32 numLayouts = 0;
+    for (uint32 desc = 0; desc < VulkanContextResources::eMaxDescLayouts; ++desc)
     {
-        // TODO: destroy something?
+        if (g_vulkanContextResources.descLayouts[desc].layout != VK_NULL_HANDLE && !g_vulkanContextResources.descLayouts[desc].isShared)
+            ++numLayouts;
     }
-    g_vulkanContextResources.vulkanDescriptorResourcePool.Dealloc(handle.m_hDesc);
+    return numLayouts;
 }
 
 void DestroyAllDescLayouts()
@@ -862,18 +1770,123 @@ void DestroyAllDescLayouts()
     for (uint32 desc = 0; desc < VulkanContextResources::eMaxDescLayouts; ++desc)
     {
         VkDescriptorSetLayout& descLayout = g_vulkanContextResources.descLayouts[desc].layout;
-        if (descLayout != VK_NULL_HANDLE)
+        if (descLayout != VK_NULL_HANDLE && !g_vulkanContextResources.descLayouts[desc].isShared)
         {
             vkDestroyDescriptorSetLayout(g_vulkanContextResources.device, descLayout, nullptr);
-            descLayout = VK_NULL_HANDLE;
         }
+        descLayout = VK_NULL_HANDLE;
+        g_vulkanContextResources.descLayouts[desc].isShared = false;
+    }
+}
+
+void VulkanCreateBindlessDescriptors()
+{
+    // Every slot of the arrays doesn't have to be written, and slots can be written while the set is bound to command
+    // buffers that are still pending, as long as those don't use the slots
+    const VkDescriptorBindingFlags bindingFlags =
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+    const uint32 numBindings = 3;
+    VkDescriptorSetLayoutBinding descLayoutBindings[numBindings] = {};
+    VkDescriptorBindingFlags descBindingFlags[numBindings] = {};
+
+    descLayoutBindings[0].binding = VULKAN_BINDLESS_BINDING_STORAGE_BUFFERS;
+    descLayoutBindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descLayoutBindings[0].descriptorCount = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    descLayoutBindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+    descBindingFlags[0] = bindingFlags;
+
+    descLayoutBindings[1].binding = VULKAN_BINDLESS_BINDING_SAMPLED_IMAGES;
+    descLayoutBindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descLayoutBindings[1].descriptorCount = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    descLayoutBindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+    descBindingFlags[1] = bindingFlags;
+
+    descLayoutBindings[2].binding = VULKAN_BINDLESS_BINDING_STORAGE_IMAGES;
+    descLayoutBindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descLayoutBindings[2].descriptorCount = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    descLayoutBindings[2].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    descBindingFlags[2] = bindingFlags;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo descBindingFlagsInfo = {};
+    descBindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    descBindingFlagsInfo.bindingCount = numBindings;
+    descBindingFlagsInfo.pBindingFlags = descBindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo descLayoutInfo = {};
+    descLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descLayoutInfo.pNext = &descBindingFlagsInfo;
+    descLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    descLayoutInfo.bindingCount = numBindings;
+    descLayoutInfo.pBindings = descLayoutBindings;
+
+    VkDescriptorSetLayout& descriptorSetLayout = g_vulkanContextResources.descLayouts[DESCLAYOUT_ID_BINDLESS].layout;
+    VkResult result = vkCreateDescriptorSetLayout(g_vulkanContextResources.device, &descLayoutInfo, nullptr, &descriptorSetLayout);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create bindless descriptor set layout!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return;
+    }
+
+    VkDescriptorPoolSize descPoolSizes[numBindings] = {};
+    descPoolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descPoolSizes[0].descriptorCount = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    descPoolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descPoolSizes[1].descriptorCount = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+    descPoolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descPoolSizes[2].descriptorCount = VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE;
+
+    VkDescriptorPoolCreateInfo descPoolCreateInfo = {};
+    descPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    descPoolCreateInfo.poolSizeCount = numBindings;
+    descPoolCreateInfo.pPoolSizes = descPoolSizes;
+    descPoolCreateInfo.maxSets = 1;
+
+    result = vkCreateDescriptorPool(g_vulkanContextResources.device, &descPoolCreateInfo, nullptr, &g_vulkanContextResources.bindlessDescriptorPool);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create bindless descriptor pool!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return;
+    }
+
+    VkDescriptorSetAllocateInfo descSetAllocInfo = {};
+    descSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descSetAllocInfo.descriptorPool = g_vulkanContextResources.bindlessDescriptorPool;
+    descSetAllocInfo.descriptorSetCount = 1;
+    descSetAllocInfo.pSetLayouts = &descriptorSetLayout;
+
+    result = vkAllocateDescriptorSets(g_vulkanContextResources.device, &descSetAllocInfo, &g_vulkanContextResources.bindlessDescriptorSet);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create bindless descriptor set!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
     }
+
+    g_vulkanContextResources.bindlessBufferSlots.Init();
+    g_vulkanContextResources.bindlessImageSlots.Init();
+    g_vulkanContextResources.isBindlessSetBound = false;
+}
+
+void VulkanDestroyBindlessDescriptors()
+{
+    // The layout is destroyed with the other descriptor layouts
+    vkDestroyDescriptorPool(g_vulkanContextResources.device, g_vulkanContextResources.bindlessDescriptorPool, nullptr);
+    g_vulkanContextResources.bindlessDescriptorPool = VK_NULL_HANDLE;
+    g_vulkanContextResources.bindlessDescriptorSet = VK_NULL_HANDLE;
 }
 
 void VulkanDestroyAllDescriptors()
 {
-    vkDestroyDescriptorPool(g_vulkanContextResources.device, g_vulkanContextResources.descriptorPool, nullptr);
-    g_vulkanContextResources.descriptorPool = VK_NULL_HANDLE;
+    g_vulkanContextResources.descriptorPools.Destroy();
+    for (uint32 uiLayout = 0; uiLayout < VulkanContextResources::eMaxDescLayouts; ++uiLayout)
+    {
+        g_vulkanContextResources.numFreeDescriptorSets[uiLayout] = 0;
+    }
 }
 
 }
@@ -6,6 +6,10 @@ namespace Graphics
 {
 
 void CreateSamplers();
+void VulkanCreateBindlessDescriptors();
+void VulkanDestroyBindlessDescriptors();
+// Creates the copies of multi-buffered buffers and persistent descriptor sets for virtual frames [firstFrame, lastFrame)
+void VulkanCreateFrameCopies(uint32 firstFrame, uint32 lastFrame);
 
 }
 }
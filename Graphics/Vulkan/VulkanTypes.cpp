@@ -10,21 +10,28 @@ namespace Graphics
 
 VulkanContextResources g_vulkanContextResources = {};
 
-void VulkanMemoryAllocator::Init(uint32 TotalAllocSize, uint32 MemoryTypeIndex, VkMemoryPropertyFlagBits MemPropertyFlags, VkDeviceSize AllocGranularity)
+void VulkanMemoryAllocator::Init(uint64 BlockSize, uint32 MemoryTypeIndex, VkMemoryPropertyFlagBits MemPropertyFlags, VkDeviceSize AllocGranularity, uint32 AllocatorIndex)
 {
-    m_GPUMemory = VK_NULL_HANDLE;
-    m_AllocSizeLimit = TotalAllocSize;
-    m_LastAllocOffset = 0;
-    m_NumAllocs = 0;
+    for (uint32 uiBlock = 0; uiBlock < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS; ++uiBlock)
+    {
+        m_Blocks[uiBlock].m_GPUMemory = VK_NULL_HANDLE;
+        m_Blocks[uiBlock].m_Size = 0;
+        m_Blocks[uiBlock].m_BytesUsed = 0;
+        m_Blocks[uiBlock].m_MappedMemPtr = nullptr;
+        m_Blocks[uiBlock].m_NumAllocs = 0;
+        m_Blocks[uiBlock].m_NumFreeRanges = 0;
+    }
+    m_NumBlocks = 0;
+    m_NumDedicatedAllocs = 0;
+    m_DedicatedBytes = 0;
+    m_BlockSize = BlockSize;
+    m_MemoryTypeIndex = MemoryTypeIndex;
+    m_AllocatorIndex = AllocatorIndex;
     m_MemFlags = MemPropertyFlags;
     m_AllocGranularity = AllocGranularity;
 
-    VkMemoryAllocateInfo memAllocInfo = {};
-    memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    memAllocInfo.allocationSize = m_AllocSizeLimit;
-    memAllocInfo.memoryTypeIndex = MemoryTypeIndex;
-    VkResult result = vkAllocateMemory(g_vulkanContextResources.device, &memAllocInfo, nullptr, &m_GPUMemory);
-    if (result != VK_SUCCESS)
+    // Preallocate the first block so that the first resource creations don't hit vkAllocateMemory
+    if (!CreateBlock(m_BlockSize))
     {
         Core::Utility::LogMsg("Platform", "GPU mem allocator failed to allocate gpu memory!", Core::Utility::LogSeverity::eCritical);
         TINKER_ASSERT(0);
@@ -33,36 +40,359 @@ void VulkanMemoryAllocator::Init(uint32 TotalAllocSize, uint32 MemoryTypeIndex,
 
 void VulkanMemoryAllocator::Destroy()
 {
-    vkFreeMemory(g_vulkanContextResources.device, m_GPUMemory, nullptr);
-    m_GPUMemory = VK_NULL_HANDLE;
+    if (m_NumDedicatedAllocs > 0)
+    {
+        Core::Utility::LogMsg("Platform", "GPU mem allocator destroyed with dedicated allocations still live!", Core::Utility::LogSeverity::eWarning);
+    }
+
+    for (uint32 uiBlock = 0; uiBlock < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS; ++uiBlock)
+    {
+        if (m_Blocks[uiBlock].m_GPUMemory != VK_NULL_HANDLE)
+        {
+            DestroyBlock(uiBlock);
+        }
+    }
+}
+
+bool VulkanMemoryAllocator::CreateBlock(VkDeviceSize size)
+{
+    uint32 blockIndex = TINKER_INVALID_HANDLE;
+    for (uint32 uiBlock = 0; uiBlock < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS; ++uiBlock)
+    {
+        if (m_Blocks[uiBlock].m_GPUMemory == VK_NULL_HANDLE)
+        {
+            blockIndex = uiBlock;
+            break;
+        }
+    }
+
+    if (blockIndex == TINKER_INVALID_HANDLE)
+    {
+        Core::Utility::LogMsg("Platform", "GPU mem allocator ran out of blocks!", Core::Utility::LogSeverity::eCritical);
+        return false;
+    }
+
+    VulkanMemBlock& block = m_Blocks[blockIndex];
+
+    VkMemoryAllocateInfo memAllocInfo = {};
+    memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memAllocInfo.allocationSize = size;
+    memAllocInfo.memoryTypeIndex = m_MemoryTypeIndex;
+    VkResult result = vkAllocateMemory(g_vulkanContextResources.device, &memAllocInfo, nullptr, &block.m_GPUMemory);
+    if (result != VK_SUCCESS)
+    {
+        block.m_GPUMemory = VK_NULL_HANDLE;
+        return false;
+    }
+
+    // Host visible memory is left persistently mapped
+    block.m_MappedMemPtr = nullptr;
+    if (m_MemFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        result = vkMapMemory(g_vulkanContextResources.device, block.m_GPUMemory, 0, VK_WHOLE_SIZE, 0, &block.m_MappedMemPtr);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to map gpu memory!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+        }
+    }
+
+    block.m_Size = size;
+    block.m_BytesUsed = 0;
+    block.m_NumAllocs = 0;
+    block.m_NumFreeRanges = 1;
+    block.m_FreeRanges[0].offset = 0;
+    block.m_FreeRanges[0].size = size;
+    ++m_NumBlocks;
+    return true;
+}
+
+void VulkanMemoryAllocator::DestroyBlock(uint32 blockIndex)
+{
+    VulkanMemBlock& block = m_Blocks[blockIndex];
+    vkFreeMemory(g_vulkanContextResources.device, block.m_GPUMemory, nullptr); // implicitly unmaps
+    block.m_GPUMemory = VK_NULL_HANDLE;
+    block.m_MappedMemPtr = nullptr;
+    block.m_Size = 0;
+    block.m_BytesUsed = 0;
+    block.m_NumAllocs = 0;
+    block.m_NumFreeRanges = 0;
+    --m_NumBlocks;
+}
+
+bool VulkanMemoryAllocator::AllocFromBlock(uint32 blockIndex, VkDeviceSize size, VkDeviceSize alignment, VulkanMemAlloc* outAlloc)
+{
+    VulkanMemBlock& block = m_Blocks[blockIndex];
+    if (block.m_GPUMemory == VK_NULL_HANDLE || block.m_Size - block.m_BytesUsed < size || block.m_NumAllocs == VULKAN_MEM_BLOCK_MAX_ALLOCS)
+        return false;
+
+    // First fit
+    for (uint32 uiRange = 0; uiRange < block.m_NumFreeRanges; ++uiRange)
+    {
+        VulkanMemFreeRange& range = block.m_FreeRanges[uiRange];
+        const VkDeviceSize alignedOffset = RoundValueToPow2(range.offset, alignment);
+        const VkDeviceSize padding = alignedOffset - range.offset;
+        if (padding + size > range.size)
+            continue;
+
+        const VkDeviceSize tailSize = range.size - padding - size;
+        if (padding == 0 && tailSize == 0)
+        {
+            // Consumes the whole range
+            for (uint32 uiMove = uiRange; uiMove < block.m_NumFreeRanges - 1; ++uiMove)
+            {
+                block.m_FreeRanges[uiMove] = block.m_FreeRanges[uiMove + 1];
+            }
+            --block.m_NumFreeRanges;
+        }
+        else if (padding == 0)
+        {
+            range.offset += size;
+            range.size = tailSize;
+        }
+        else if (tailSize == 0)
+        {
+            range.size = padding;
+        }
+        else
+        {
+            // Splits the range in two, keep both the alignment padding and the tail
+            if (block.m_NumFreeRanges == VULKAN_MEM_BLOCK_MAX_FREE_RANGES)
+                continue;
+
+            for (uint32 uiMove = block.m_NumFreeRanges; uiMove > uiRange + 1; --uiMove)
+            {
+                block.m_FreeRanges[uiMove] = block.m_FreeRanges[uiMove - 1];
+            }
+            ++block.m_NumFreeRanges;
+            block.m_FreeRanges[uiRange + 1].offset = alignedOffset + size;
+            block.m_FreeRanges[uiRange + 1].size = tailSize;
+            range.size = padding;
+        }
+
+        block.m_BytesUsed += size;
+        ++block.m_NumAllocs;
+        TINKER_ASSERT(IsBlockValid(blockIndex));
+
+        outAlloc->allocMem = block.m_GPUMemory;
+        outAlloc->allocOffset = alignedOffset;
+        outAlloc->allocSize = size;
+        outAlloc->mappedMemPtr = block.m_MappedMemPtr; // may be nullptr
+        outAlloc->allocatorIndex = m_AllocatorIndex;
+        outAlloc->blockIndex = blockIndex;
+        return true;
+    }
+
+    return false;
 }
 
 VulkanMemAlloc VulkanMemoryAllocator::Alloc(VkMemoryRequirements allocReqs)
 {
-    uint64 allocSize = RoundValueToPow2(allocReqs.size, m_AllocGranularity);
+    VulkanMemAlloc alloc = {};
+    alloc.blockIndex = TINKER_INVALID_HANDLE;
+    alloc.allocatorIndex = m_AllocatorIndex;
+
+    if (!(allocReqs.memoryTypeBits & (1 << m_MemoryTypeIndex)))
+    {
+        Core::Utility::LogMsg("Platform", "Vulkan gpu mem allocator memory type not compatible with resource!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return alloc;
+    }
 
+    uint64 allocSize = RoundValueToPow2(allocReqs.size, m_AllocGranularity);
     uint64 alignment = Max(m_AllocGranularity, allocReqs.alignment);
     TINKER_ASSERT(ISPOW2(alignment));
-    uint64 nextAllocOffset = RoundValueToPow2(m_LastAllocOffset, alignment); // ensure alloc offset is aligned
-    uint64 nextAllocEnd = nextAllocOffset + allocSize;
 
-    if (nextAllocEnd > m_AllocSizeLimit)
+    // Allocations that would take up most of a block are better off on their own
+    if (allocSize > m_BlockSize / 2)
+    {
+        return AllocDedicated(allocReqs, VK_NULL_HANDLE, VK_NULL_HANDLE);
+    }
+
+    for (uint32 uiBlock = 0; uiBlock < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS; ++uiBlock)
+    {
+        if (AllocFromBlock(uiBlock, allocSize, alignment, &alloc))
+            return alloc;
+    }
+
+    // No room in any existing block, make a new one
+    if (CreateBlock(m_BlockSize))
     {
+        for (uint32 uiBlock = 0; uiBlock < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS; ++uiBlock)
+        {
+            if (m_Blocks[uiBlock].m_NumAllocs == 0 && AllocFromBlock(uiBlock, allocSize, alignment, &alloc))
+                return alloc;
+        }
+    }
+
+    Core::Utility::LogMsg("Platform", "Vulkan gpu mem allocator ran out of memory!", Core::Utility::LogSeverity::eCritical);
+    TINKER_ASSERT(0);
+    return alloc;
+}
+
+VulkanMemAlloc VulkanMemoryAllocator::AllocDedicated(VkMemoryRequirements allocReqs, VkImage image, VkBuffer buffer)
+{
+    VulkanMemAlloc alloc = {};
+    alloc.allocatorIndex = m_AllocatorIndex;
+    alloc.blockIndex = VULKAN_MEM_DEDICATED_BLOCK_INDEX;
+
+    VkMemoryDedicatedAllocateInfo dedicatedAllocInfo = {};
+    dedicatedAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedAllocInfo.image = image;
+    dedicatedAllocInfo.buffer = buffer;
+
+    VkMemoryAllocateInfo memAllocInfo = {};
+    memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memAllocInfo.pNext = (image != VK_NULL_HANDLE || buffer != VK_NULL_HANDLE) ? &dedicatedAllocInfo : nullptr;
+    memAllocInfo.allocationSize = allocReqs.size;
+    memAllocInfo.memoryTypeIndex = m_MemoryTypeIndex;
+    VkResult result = vkAllocateMemory(g_vulkanContextResources.device, &memAllocInfo, nullptr, &alloc.allocMem);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Vulkan gpu mem allocator failed to make dedicated allocation!", Core::Utility::LogSeverity::eCritical);
         TINKER_ASSERT(0);
-        Core::Utility::LogMsg("Platform", "Vulkan gpu mem allocator ran out of memory!", Core::Utility::LogSeverity::eInfo);
+        alloc.allocMem = VK_NULL_HANDLE;
+        return alloc;
     }
 
-    m_LastAllocOffset = nextAllocEnd;
-    ++m_NumAllocs;
+    if (m_MemFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        result = vkMapMemory(g_vulkanContextResources.device, alloc.allocMem, 0, VK_WHOLE_SIZE, 0, &alloc.mappedMemPtr);
+        if (result != VK_SUCCESS)
+        {
+            Core::Utility::LogMsg("Platform", "Failed to map gpu memory!", Core::Utility::LogSeverity::eCritical);
+            TINKER_ASSERT(0);
+        }
+    }
 
-    VulkanMemAlloc alloc;
-    alloc.allocMem = m_GPUMemory;
-    alloc.allocOffset = nextAllocOffset;
-    alloc.allocSize = allocSize;
-    alloc.mappedMemPtr = m_MappedMemPtr; // may be nullptr
+    alloc.allocOffset = 0;
+    alloc.allocSize = allocReqs.size;
+    ++m_NumDedicatedAllocs;
+    m_DedicatedBytes += allocReqs.size;
     return alloc;
 }
 
+void VulkanMemoryAllocator::Free(const VulkanMemAlloc& alloc)
+{
+    if (alloc.allocMem == VK_NULL_HANDLE)
+        return;
+
+    TINKER_ASSERT(alloc.allocatorIndex == m_AllocatorIndex);
+
+    if (alloc.blockIndex == VULKAN_MEM_DEDICATED_BLOCK_INDEX)
+    {
+        TINKER_ASSERT(m_NumDedicatedAllocs > 0);
+        vkFreeMemory(g_vulkanContextResources.device, alloc.allocMem, nullptr);
+        --m_NumDedicatedAllocs;
+        m_DedicatedBytes -= alloc.allocSize;
+        return;
+    }
+
+    TINKER_ASSERT(alloc.blockIndex < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS);
+    VulkanMemBlock& block = m_Blocks[alloc.blockIndex];
+    TINKER_ASSERT(block.m_GPUMemory == alloc.allocMem);
+    TINKER_ASSERT(block.m_NumAllocs > 0);
+
+    // Find the first free range after this alloc
+    uint32 insertIdx = 0;
+    while (insertIdx < block.m_NumFreeRanges && block.m_FreeRanges[insertIdx].offset < alloc.allocOffset)
+    {
+        ++insertIdx;
+    }
+
+    const VkDeviceSize allocEnd = alloc.allocOffset + alloc.allocSize;
+    const bool mergePrev = insertIdx > 0 && block.m_FreeRanges[insertIdx - 1].offset + block.m_FreeRanges[insertIdx - 1].size == alloc.allocOffset;
+    const bool mergeNext = insertIdx < block.m_NumFreeRanges && block.m_FreeRanges[insertIdx].offset == allocEnd;
+
+    if (mergePrev && mergeNext)
+    {
+        block.m_FreeRanges[insertIdx - 1].size += alloc.allocSize + block.m_FreeRanges[insertIdx].size;
+        for (uint32 uiMove = insertIdx; uiMove < block.m_NumFreeRanges - 1; ++uiMove)
+        {
+            block.m_FreeRanges[uiMove] = block.m_FreeRanges[uiMove + 1];
+        }
+        --block.m_NumFreeRanges;
+    }
+    else if (mergePrev)
+    {
+        block.m_FreeRanges[insertIdx - 1].size += alloc.allocSize;
+    }
+    else if (mergeNext)
+    {
+        block.m_FreeRanges[insertIdx].offset = alloc.allocOffset;
+        block.m_FreeRanges[insertIdx].size += alloc.allocSize;
+    }
+    else
+    {
+        // Can't be full, see VULKAN_MEM_BLOCK_MAX_ALLOCS
+        TINKER_ASSERT(block.m_NumFreeRanges < VULKAN_MEM_BLOCK_MAX_FREE_RANGES);
+        for (uint32 uiMove = block.m_NumFreeRanges; uiMove > insertIdx; --uiMove)
+        {
+            block.m_FreeRanges[uiMove] = block.m_FreeRanges[uiMove - 1];
+        }
+        ++block.m_NumFreeRanges;
+        block.m_FreeRanges[insertIdx].offset = alloc.allocOffset;
+        block.m_FreeRanges[insertIdx].size = alloc.allocSize;
+    }
+
+    block.m_BytesUsed -= alloc.allocSize;
+    --block.m_NumAllocs;
+    TINKER_ASSERT(IsBlockValid(alloc.blockIndex));
+
+    // Give empty blocks back to the driver, but always keep one around
+    if (block.m_NumAllocs == 0 && m_NumBlocks > 1)
+    {
+        DestroyBlock(alloc.blockIndex);
+    }
+}
+
+// Free ranges sorted, in bounds and coalesced, and together with the used bytes they cover the whole block
+bool VulkanMemoryAllocator::IsBlockValid(uint32 blockIndex) const
+{
+    const VulkanMemBlock& block = m_Blocks[blockIndex];
+    if (block.m_NumFreeRanges > block.m_NumAllocs + 1 || block.m_NumAllocs > VULKAN_MEM_BLOCK_MAX_ALLOCS)
+        return false;
+
+    VkDeviceSize freeBytes = 0;
+    for (uint32 uiRange = 0; uiRange < block.m_NumFreeRanges; ++uiRange)
+    {
+        const VulkanMemFreeRange& range = block.m_FreeRanges[uiRange];
+        if (range.size == 0 || range.offset + range.size > block.m_Size)
+            return false;
+        if (uiRange > 0 && block.m_FreeRanges[uiRange - 1].offset + block.m_FreeRanges[uiRange - 1].size >= range.offset)
+            return false;
+        freeBytes += range.size;
+    }
+    return freeBytes + block.m_BytesUsed == block.m_Size;
+}
+
+void VulkanMemoryAllocator::GetStats(VulkanMemAllocatorStats* outStats) const
+{
+    *outStats = {};
+    outStats->numBlocks = m_NumBlocks;
+    outStats->numDedicatedAllocs = m_NumDedicatedAllocs;
+    outStats->numAllocs = m_NumDedicatedAllocs;
+    outStats->bytesDedicated = m_DedicatedBytes;
+    outStats->bytesReserved = m_DedicatedBytes;
+    outStats->bytesUsed = m_DedicatedBytes;
+
+    for (uint32 uiBlock = 0; uiBlock < VULKAN_MEM_ALLOCATOR_MAX_BLOCKS; ++uiBlock)
+    {
+        const VulkanMemBlock& block = m_Blocks[uiBlock];
+        if (block.m_GPUMemory == VK_NULL_HANDLE)
+            continue;
+
+        outStats->numAllocs += block.m_NumAllocs;
+        outStats->numFreeRanges += block.m_NumFreeRanges;
+        outStats->bytesReserved += block.m_Size;
+        outStats->bytesUsed += block.m_BytesUsed;
+        for (uint32 uiRange = 0; uiRange < block.m_NumFreeRanges; ++uiRange)
+        {
+            outStats->largestFreeRange = Max(outStats->largestFreeRange, (uint64)block.m_FreeRanges[uiRange].size);
+        }
+    }
+}
+
 uint32 ChooseMemoryTypeBits(uint32 requiredMemoryTypeBits, VkMemoryPropertyFlags memPropertyFlags)
 {
     VkPhysicalDeviceMemoryProperties memProperties;
@@ -165,6 +495,8 @@ static VkFormat                              VulkanImageFormats    [ImageFormat:
 static VkDescriptorType                      VulkanDescriptorTypes [DescriptorType::eMax] = {};
 static VkBufferUsageFlags                    VulkanBufferUsageFlags[BufferUsage::eMax]    = {};
 static VkMemoryPropertyFlagBits              VulkanMemPropertyFlags[BufferUsage::eMax]    = {};
+static AccessScope                           VulkanImageAccessScopes[ImageAccess::eMax]   = {};
+static AccessScope                           VulkanBufferAccessScopes[BufferAccess::eMax] = {};
 
 void InitVulkanDataTypesPerEnum()
 {
@@ -220,16 +552,20 @@ void InitVulkanDataTypesPerEnum()
     VulkanImageLayouts[ImageLayout::eDepthOptimal] = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     VulkanImageLayouts[ImageLayout::eRenderOptimal] = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     VulkanImageLayouts[ImageLayout::ePresent] = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VulkanImageLayouts[ImageLayout::eGeneral] = VK_IMAGE_LAYOUT_GENERAL;
 
     VulkanImageFormats[ImageFormat::Invalid] = VK_FORMAT_UNDEFINED;
     VulkanImageFormats[ImageFormat::BGRA8_SRGB] = VK_FORMAT_B8G8R8A8_SRGB;
     VulkanImageFormats[ImageFormat::RGBA8_SRGB] = VK_FORMAT_R8G8B8A8_SRGB;
     VulkanImageFormats[ImageFormat::Depth_32F] = VK_FORMAT_D32_SFLOAT;
+    VulkanImageFormats[ImageFormat::RGBA16_Float] = VK_FORMAT_R16G16B16A16_SFLOAT;
     VulkanImageFormats[ImageFormat::TheSwapChainFormat] = g_vulkanContextResources.swapChainFormat;
 
     VulkanDescriptorTypes[DescriptorType::eBuffer] = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     VulkanDescriptorTypes[DescriptorType::eSampledImage] = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     VulkanDescriptorTypes[DescriptorType::eSSBO] = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    VulkanDescriptorTypes[DescriptorType::eStorageImage] = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    VulkanDescriptorTypes[DescriptorType::eSampler] = VK_DESCRIPTOR_TYPE_SAMPLER;
 
     VulkanBufferUsageFlags[BufferUsage::eVertex] = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT; // vertex buffers are actually SSBOs for now
     VulkanBufferUsageFlags[BufferUsage::eIndex] = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
@@ -237,6 +573,8 @@ void InitVulkanDataTypesPerEnum()
     VulkanBufferUsageFlags[BufferUsage::eTransientIndex] = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
     VulkanBufferUsageFlags[BufferUsage::eStaging] = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     VulkanBufferUsageFlags[BufferUsage::eUniform] = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    VulkanBufferUsageFlags[BufferUsage::eTransientUpload] = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    VulkanBufferUsageFlags[BufferUsage::eIndirectArgs] = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
     VulkanMemPropertyFlags[BufferUsage::eVertex] = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
     VulkanMemPropertyFlags[BufferUsage::eIndex] = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -244,6 +582,26 @@ void InitVulkanDataTypesPerEnum()
     VulkanMemPropertyFlags[BufferUsage::eTransientIndex] = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     VulkanMemPropertyFlags[BufferUsage::eStaging] = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     VulkanMemPropertyFlags[BufferUsage::eUniform] = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    VulkanMemPropertyFlags[BufferUsage::eTransientUpload] = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    VulkanMemPropertyFlags[BufferUsage::eIndirectArgs] = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    VulkanImageAccessScopes[ImageAccess::eNone] = { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+    VulkanImageAccessScopes[ImageAccess::eTransferDst] = { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+    VulkanImageAccessScopes[ImageAccess::eColorAttachment] = { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+    VulkanImageAccessScopes[ImageAccess::eDepthAttachment] = { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+    VulkanImageAccessScopes[ImageAccess::eFragmentShaderRead] = { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+    // The presentation engine is synchronized with semaphores. The acquire semaphore wait is at color attachment output, so
+    // barriers from present start there to chain with it.
+    VulkanImageAccessScopes[ImageAccess::ePresent] = { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE };
+    VulkanImageAccessScopes[ImageAccess::eComputeRead] = { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+    VulkanImageAccessScopes[ImageAccess::eComputeReadWrite] = { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+
+    VulkanBufferAccessScopes[BufferAccess::eNone] = { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+    VulkanBufferAccessScopes[BufferAccess::eTransferDst] = { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+    VulkanBufferAccessScopes[BufferAccess::eComputeRead] = { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
+    VulkanBufferAccessScopes[BufferAccess::eComputeReadWrite] = { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+    VulkanBufferAccessScopes[BufferAccess::eIndirectArgs] = { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT };
+    VulkanBufferAccessScopes[BufferAccess::eVertexShaderRead] = { VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
 }
 
 const VkPipelineColorBlendAttachmentState& GetVkBlendState(uint32 gameBlendState)
@@ -264,6 +622,18 @@ const VkImageLayout& GetVkImageLayout(uint32 gameImageLayout)
     return VulkanImageLayouts[gameImageLayout];
 }
 
+const AccessScope& GetVkImageAccessScope(uint32 imageAccess)
+{
+    TINKER_ASSERT(imageAccess < ImageAccess::eMax);
+    return VulkanImageAccessScopes[imageAccess];
+}
+
+const AccessScope& GetVkBufferAccessScope(uint32 bufferAccess)
+{
+    TINKER_ASSERT(bufferAccess < BufferAccess::eMax);
+    return VulkanBufferAccessScopes[bufferAccess];
+}
+
 const VkFormat& GetVkImageFormat(uint32 gameImageFormat)
 {
     TINKER_ASSERT(gameImageFormat < ImageFormat::eMax);
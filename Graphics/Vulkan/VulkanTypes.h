@@ -2,6 +2,7 @@
 
 #include "CoreDefines.h"
 #include "Allocators.h"
+#include "DataStructures/HashMap.h"
 #include "Graphics/Common/GraphicsCommon.h"
 
 
@@ -14,10 +15,37 @@
 
 #define VULKAN_RESOURCE_POOL_MAX 512
 
-#define VULKAN_NUM_SUPPORTED_DESCRIPTOR_TYPES 3
-#define VULKAN_DESCRIPTOR_POOL_MAX_UNIFORM_BUFFERS 64
-#define VULKAN_DESCRIPTOR_POOL_MAX_SAMPLED_IMAGES 64
-#define VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_BUFFERS 64
+#define VULKAN_TRANSIENT_UPLOAD_RING_SIZE (4u * 1024 * 1024) // 4 MiB per frame in flight
+#define VULKAN_MAX_PENDING_FLUSH_RANGES 256
+
+#define VULKAN_NUM_SUPPORTED_DESCRIPTOR_TYPES 5
+// Per pool in a descriptor pool chain. Each descriptor allocates a set per allocated frame in flight, the chain gets
+// more pools if more frames in flight are allocated.
+#define VULKAN_DESCRIPTOR_POOL_MAX_UNIFORM_BUFFERS (32 * DEFAULT_FRAMES_IN_FLIGHT)
+#define VULKAN_DESCRIPTOR_POOL_MAX_SAMPLED_IMAGES (32 * DEFAULT_FRAMES_IN_FLIGHT)
+#define VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_BUFFERS (32 * DEFAULT_FRAMES_IN_FLIGHT)
+#define VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_IMAGES (8 * DEFAULT_FRAMES_IN_FLIGHT)
+#define VULKAN_DESCRIPTOR_POOL_MAX_SAMPLERS (8 * DEFAULT_FRAMES_IN_FLIGHT)
+#define VULKAN_DESCRIPTOR_POOL_MAX_SETS (VULKAN_DESCRIPTOR_POOL_MAX_UNIFORM_BUFFERS + VULKAN_DESCRIPTOR_POOL_MAX_SAMPLED_IMAGES + VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_BUFFERS + VULKAN_DESCRIPTOR_POOL_MAX_STORAGE_IMAGES + VULKAN_DESCRIPTOR_POOL_MAX_SAMPLERS)
+#define VULKAN_MAX_DESCRIPTOR_POOLS_PER_CHAIN 16
+#define VULKAN_DESCRIPTOR_FREE_LIST_MAX 64 // recycled sets kept per descriptor layout
+#define VULKAN_MAX_TRANSIENT_DESCRIPTORS_PER_FRAME 1024
+// Transient descriptor handles index the current frame's transient sets instead of the descriptor pool allocator
+#define VULKAN_TRANSIENT_DESCRIPTOR_BIT 0x80000000u
+
+// Bindless descriptor set, one array per descriptor type. Multi-buffered buffers take one slot per frame in flight.
+#define VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE 8192
+#define VULKAN_BINDLESS_BINDING_STORAGE_BUFFERS BINDLESS_BINDING_STORAGE_BUFFERS
+#define VULKAN_BINDLESS_BINDING_SAMPLED_IMAGES BINDLESS_BINDING_SAMPLED_IMAGES
+#define VULKAN_BINDLESS_BINDING_STORAGE_IMAGES BINDLESS_BINDING_STORAGE_IMAGES // storage images share their slot with the sampled image array
+
+// Hashed graphics pipeline cache. Pipelines are keyed by shader and any state that can't be set dynamically.
+#define VULKAN_GRAPHICS_PSO_CACHE_SIZE 1024
+
+// Shader modules keyed by a hash of their bytecode, so that pipelines built from the same bytecode share one module
+#define VULKAN_SHADER_MODULE_CACHE_SIZE 512
+#define VULKAN_SHADER_MODULE_HASH_SEED 0x2F6B11D3
+#define VULKAN_SHADER_MODULE_HASH_SEED_HI 0x9E3779B9
 
 #define VULKAN_MAX_RENDERTARGETS MAX_MULTIPLE_RENDERTARGETS
 #define VULKAN_MAX_RENDERTARGETS_WITH_DEPTH VULKAN_MAX_RENDERTARGETS + 1 // +1 for depth
@@ -27,27 +55,79 @@ namespace Tk
 namespace Graphics
 {
 
+#define VULKAN_MEM_ALLOCATOR_MAX_BLOCKS 16
+#define VULKAN_MEM_BLOCK_MAX_FREE_RANGES 256
+// Free ranges are coalesced, so there is an alloc between any two of them and a block never has more free ranges than
+// allocs + 1. Capping the allocs keeps a free from ever finding the free range list full.
+#define VULKAN_MEM_BLOCK_MAX_ALLOCS (VULKAN_MEM_BLOCK_MAX_FREE_RANGES - 1)
+#define VULKAN_MEM_DEDICATED_BLOCK_INDEX MAX_UINT32
+
 typedef struct vulkan_mem_alloc
 {
     VkDeviceMemory allocMem;
     VkDeviceSize allocSize;
     VkDeviceSize allocOffset;
     void* mappedMemPtr;
+    uint32 allocatorIndex; // which of the context's gpu mem allocators this came from
+    uint32 blockIndex; // VULKAN_MEM_DEDICATED_BLOCK_INDEX if this alloc owns its device memory
 } VulkanMemAlloc;
 
-typedef struct vulkan_mem_allocator
+typedef struct vulkan_mem_free_range
+{
+    VkDeviceSize offset;
+    VkDeviceSize size;
+} VulkanMemFreeRange;
+
+// One VkDeviceMemory that gets sub-allocated. Free ranges are kept sorted by offset so that neighbors can be coalesced on free.
+typedef struct vulkan_mem_block
 {
     VkDeviceMemory m_GPUMemory;
-    uint64 m_AllocSizeLimit;
-    uint64 m_LastAllocOffset;
+    VkDeviceSize m_Size;
+    VkDeviceSize m_BytesUsed;
+    void* m_MappedMemPtr;
     uint32 m_NumAllocs;
+    uint32 m_NumFreeRanges;
+    VulkanMemFreeRange m_FreeRanges[VULKAN_MEM_BLOCK_MAX_FREE_RANGES];
+} VulkanMemBlock;
+
+typedef struct vulkan_mem_allocator_stats
+{
+    uint32 numBlocks;
+    uint32 numAllocs;
+    uint32 numDedicatedAllocs;
+    uint32 numFreeRanges;
+    uint64 bytesReserved; // total device memory owned by this allocator, including dedicated allocs
+    uint64 bytesUsed;
+    uint64 bytesDedicated;
+    uint64 largestFreeRange;
+} VulkanMemAllocatorStats;
+
+// Sub-allocates device memory of a single memory type out of large blocks, which are created on demand.
+// Allocations that are large or that the driver prefers to be dedicated get their own VkDeviceMemory.
+typedef struct vulkan_mem_allocator
+{
+    VulkanMemBlock m_Blocks[VULKAN_MEM_ALLOCATOR_MAX_BLOCKS];
+    uint32 m_NumBlocks;
+    uint32 m_NumDedicatedAllocs;
+    uint64 m_DedicatedBytes;
+    uint64 m_BlockSize;
+    uint32 m_MemoryTypeIndex;
+    uint32 m_AllocatorIndex;
     VkMemoryPropertyFlags m_MemFlags;
-    void* m_MappedMemPtr;
     VkDeviceSize m_AllocGranularity;
 
-    void Init(uint32 TotalAllocSize, uint32 MemoryTypeIndex, VkMemoryPropertyFlagBits MemPropertyFlags, VkDeviceSize AllocGranularity);
+    void Init(uint64 BlockSize, uint32 MemoryTypeIndex, VkMemoryPropertyFlagBits MemPropertyFlags, VkDeviceSize AllocGranularity, uint32 AllocatorIndex);
     void Destroy();
     VulkanMemAlloc Alloc(VkMemoryRequirements allocReqs);
+    VulkanMemAlloc AllocDedicated(VkMemoryRequirements allocReqs, VkImage image, VkBuffer buffer);
+    void Free(const VulkanMemAlloc& alloc);
+    void GetStats(VulkanMemAllocatorStats* outStats) const;
+
+private:
+    bool CreateBlock(VkDeviceSize size);
+    void DestroyBlock(uint32 blockIndex);
+    bool AllocFromBlock(uint32 blockIndex, VkDeviceSize size, VkDeviceSize alignment, VulkanMemAlloc* outAlloc);
+    bool IsBlockValid(uint32 blockIndex) const;
 
 } VulkanMemoryAllocator;
 
@@ -66,36 +146,153 @@ typedef struct vulkan_mem_resource
             VkImageView imageView;
         };
     };
+
+    uint32 bindlessIndex; // BINDLESS_INDEX_INVALID if this resource has no slot in the bindless descriptor set
 } VulkanMemResource;
 
 typedef struct vulkan_descriptor_resource
 {
     VkDescriptorSet descriptorSet;
+    uint32 poolIndex; // in the persistent descriptor pool chain
 } VulkanDescriptorResource;
 
 // Chains of resources for multiple swap chain images
 typedef struct
 {
-    VulkanMemResource resourceChain[MAX_FRAMES_IN_FLIGHT];
+    VulkanMemResource resourceChain[MAX_FRAMES_IN_FLIGHT]; // multi-buffered buffers have numAllocatedFramesInFlight copies
     ResourceDesc resDesc;
+    bool isConcurrent; // shared by every queue family in use, never needs queue family ownership transfers
+    uint32 frameCopyListIndex; // into multiBufferedResources
 } VulkanMemResourceChain;
 
 typedef struct
 {
-    VulkanDescriptorResource resourceChain[MAX_FRAMES_IN_FLIGHT];
+    VulkanDescriptorResource resourceChain[MAX_FRAMES_IN_FLIGHT]; // numAllocatedFramesInFlight sets
+    uint32 descLayoutID;
+    uint32 poolGeneration; // sets from a pool chain that has since been destroyed are not recycled
+    uint32 frameCopyListIndex; // into persistentDescriptors
+    bool isWritten;
+    DescriptorSetDataHandles writtenHandles; // rewritten into the sets of newly allocated frames
 } VulkanDescriptorChain;
 
 typedef struct
 {
     VkDescriptorSetLayout layout;
     DescriptorLayout bindings;
+    bool isShared; // layout is owned by another descriptor layout ID with identical bindings
 } VulkanDescriptorLayout;
 
+typedef struct vulkan_shader_module
+{
+    VkShaderModule module; // VK_NULL_HANDLE once the last pipeline using it is destroyed
+    uint32 refCount;
+} VulkanShaderModule;
+
+// Descriptor pools chained together, another pool is created whenever the existing ones are out of memory
+typedef struct vulkan_descriptor_pool_chain
+{
+    VkDescriptorPool m_Pools[VULKAN_MAX_DESCRIPTOR_POOLS_PER_CHAIN];
+    uint32 m_NumPools;
+    uint32 m_CurrentPool; // tried first, the last pool a set was allocated from or freed to
+    uint32 m_Generation; // incremented every time the chain is destroyed
+    VkDescriptorPoolCreateFlags m_PoolFlags;
+
+    void Init(VkDescriptorPoolCreateFlags poolFlags);
+    void Destroy();
+    // Returns VK_NULL_HANDLE if every pool is full and the chain can't grow
+    VkDescriptorSet Alloc(VkDescriptorSetLayout layout, uint32* outPoolIndex);
+    // Only for chains created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+    void Free(VkDescriptorSet descSet, uint32 poolIndex);
+    // Frees every set allocated from the chain, the pools are kept
+    void Reset();
+
+private:
+    bool CreatePool();
+
+} VulkanDescriptorPoolChain;
+
+typedef struct vulkan_free_descriptor_set
+{
+    VkDescriptorSet descriptorSet;
+    uint32 poolIndex;
+} VulkanFreeDescriptorSet;
+
+// Vulkan objects that may still be referenced by frames in flight get destroyed once those frames have retired
+namespace VulkanDeferredDestroyType
+{
+    enum : uint32
+    {
+        ePipeline = 0,
+        ePipelineLayout,
+        eShaderModule,
+        eResource, // handle is a vulkanMemResourcePool index, the pool slot is kept until destruction
+        eDescriptor, // handle is a vulkanDescriptorResourcePool index
+        eMax
+    };
+}
+
+#define VULKAN_DEFERRED_DESTROY_QUEUE_MAX 1024
+
+#define VULKAN_UPLOAD_STAGING_RING_SIZE (32u * 1024 * 1024) // 32 MiB
+#define VULKAN_MAX_UPLOAD_BATCHES 8 // submitted batches that can be in flight on the transfer queue
+#define VULKAN_MAX_PENDING_UPLOAD_ACQUIRES 256
+
+typedef struct vulkan_upload_batch
+{
+    VkCommandBuffer commandBuffer;
+    uint64 stagingEnd; // staging ring position that gets released once the batch completes
+    uint32 numUploads;
+} VulkanUploadBatch;
+
+// Queue family ownership acquire of an uploaded image, recorded into the first graphics frame after the releasing batch completes.
+// Buffers never need one, they are concurrent whenever the transfer family is dedicated.
+typedef struct vulkan_upload_acquire
+{
+    uint64 uploadValue;
+    VkImage image;
+    uint32 numArrayEles;
+} VulkanUploadAcquire;
+
+// Free list of slots in one array of the bindless descriptor set
+typedef struct vulkan_bindless_slots
+{
+    uint32 m_FreeSlots[VULKAN_BINDLESS_MAX_DESCRIPTORS_PER_TYPE];
+    uint32 m_NumFreeSlots;
+
+    void Init();
+    uint32 Alloc();
+    void Free(uint32 slot);
+} VulkanBindlessSlots;
+
+// Timestamps bracketing each queue's work, per frame in flight
+namespace VulkanFrameTimingQuery
+{
+    enum : uint32
+    {
+        eGraphicsBegin = 0,
+        eGraphicsEnd,
+        eAsyncComputeBegin,
+        eAsyncComputeEnd,
+        eMax
+    };
+}
+
+typedef struct vulkan_deferred_destroy
+{
+    uint64 handle;
+    uint32 type;
+    uint32 frameRetired;
+} VulkanDeferredDestroy;
+
 typedef struct
 {
-    VkFence Fence;
     VkSemaphore GPUWorkCompleteSema;
     VkSemaphore ImageAvailableSema;
+
+    // For input to gpu completion latency tracking of the last frame submitted with this virtual frame
+    uint64 frameNumber;
+    uint64 frameStartTimeUS;
+    bool isLatencyPending;
 } VulkanVirtualFrameSyncData;
 
 struct VulkanContextResources
@@ -111,10 +308,20 @@ struct VulkanContextResources
     PFN_vkCmdInsertDebugUtilsLabelEXT pfnCmdInsertDebugUtilsLabelEXT = NULL;
     PFN_vkSetDebugUtilsObjectNameEXT  pfnSetDebugUtilsObjectNameEXT  = NULL;
 
+    // VK_EXT_extended_dynamic_state3, optional. Makes blend state dynamic so that it is not part of the pipeline.
+    bool isExtendedDynamicState3Enabled = false;
+    PFN_vkCmdSetColorBlendEnableEXT   pfnCmdSetColorBlendEnableEXT   = NULL;
+    PFN_vkCmdSetColorBlendEquationEXT pfnCmdSetColorBlendEquationEXT = NULL;
+    PFN_vkCmdSetColorWriteMaskEXT     pfnCmdSetColorWriteMaskEXT     = NULL;
+
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
     uint32 graphicsQueueIndex = TINKER_INVALID_HANDLE;
+    uint32 transferQueueIndex = TINKER_INVALID_HANDLE; // same as the graphics family if there is no dedicated transfer family
+    uint32 computeQueueIndex = TINKER_INVALID_HANDLE; // same as the graphics family if there is no dedicated compute family
     VkDevice device = VK_NULL_HANDLE;
     VkQueue graphicsQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    VkQueue computeQueue = VK_NULL_HANDLE;
     VkQueue presentationQueue = VK_NULL_HANDLE;
 
     VkSurfaceKHR surface = VK_NULL_HANDLE;
@@ -131,15 +338,58 @@ struct VulkanContextResources
     uint32 windowWidth = 0;
     uint32 windowHeight = 0;
 
-    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
     VkSampler linearSampler = VK_NULL_HANDLE;
     Tk::Core::PoolAllocator<VulkanMemResourceChain> vulkanMemResourcePool;
     Tk::Core::PoolAllocator<VulkanDescriptorChain> vulkanDescriptorResourcePool;
     VulkanVirtualFrameSyncData virtualFrameSyncData[MAX_FRAMES_IN_FLIGHT];
+    VkSemaphore frameTimelineSema = VK_NULL_HANDLE; // value n means frames [0, n) have completed on the gpu
+
+    // Frame pacing, changes requested at runtime get applied at the start of the next frame
+    uint32 numFramesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+    uint32 framePacingMode = FramePacingMode::eThroughput;
+    uint32 requestedNumFramesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+    uint32 requestedFramePacingMode = FramePacingMode::eThroughput;
+    // Per-frame objects exist for this many virtual frames. Only grows, when more frames in flight are requested.
+    uint32 numAllocatedFramesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+    // Live objects with a copy per virtual frame, which get copies for the new frames when more are allocated
+    uint32 multiBufferedResources[VULKAN_RESOURCE_POOL_MAX] = {};
+    uint32 numMultiBufferedResources = 0;
+    uint32 persistentDescriptors[VULKAN_RESOURCE_POOL_MAX] = {};
+    uint32 numPersistentDescriptors = 0;
+    uint64 lastFrameStartTimeUS = 0;
+    float avgFrameTimeMS = 0.0f;
+    float avgInputToGPUCompleteMS = 0.0f;
+
+    // Per-frame linear upload ring, one persistently mapped copy per frame in flight
+    ResourceHandle transientUploadRing = DefaultResHandle_Invalid;
+    uint32 transientUploadRingOffset = 0; // bump offset into the current virtual frame's copy
+    uint32 transientUploadBytesUsed = 0;
+
+    // Host writes waiting to be made visible, flushed with a single call before the next submit
+    VkMappedMemoryRange pendingFlushRanges[VULKAN_MAX_PENDING_FLUSH_RANGES] = {};
+    uint32 numPendingFlushRanges = 0;
+    uint32 numMappedRangeFlushes = 0;
+    uint32 numMappedRangeFlushesLastFrame = 0;
     VkCommandBuffer* commandBuffers = nullptr;
     VkCommandPool commandPool = VK_NULL_HANDLE;
     VkCommandBuffer commandBuffer_Immediate = VK_NULL_HANDLE;
 
+    // Async compute, one command buffer per frame in flight submitted to the compute queue ahead of the graphics frame.
+    // Without a dedicated compute family the async compute stream is recorded at the start of the graphics frame instead.
+    VkCommandPool computeCommandPool = VK_NULL_HANDLE;
+    VkCommandBuffer computeCommandBuffers[MAX_FRAMES_IN_FLIGHT] = {};
+    VkSemaphore computeTimelineSema = VK_NULL_HANDLE; // value n means the async compute work of frames [0, n) has completed
+    bool isAsyncComputeEnabled = true;
+    bool isRecordingAsyncCompute = false; // commands go to the current frame's compute command buffer
+    bool isAsyncComputeRecorded = false; // the current frame has a compute command buffer to submit
+
+    // Queue timings of each frame, resolved once the frame has retired
+    VkQueryPool queryPoolFrameTiming = VK_NULL_HANDLE;
+    uint32 frameTimingQueriesWritten[MAX_FRAMES_IN_FLIGHT] = {}; // bit per VulkanFrameTimingQuery pair
+    float avgGraphicsQueueGPUTimeMS = 0.0f;
+    float avgAsyncComputeGPUTimeMS = 0.0f;
+    bool wasAsyncComputeOnComputeQueue = false; // last frame with async compute work
+
     enum
     {
         eMaxShaders      = SHADER_ID_MAX,
@@ -147,13 +397,82 @@ struct VulkanContextResources
         eMaxDepthStates  = DepthState::eMax,
         eMaxDescLayouts  = DESCLAYOUT_ID_MAX,
     };
+    // Everything needed to create any permutation of a shader's pipeline on demand
+    struct PSOCreateDesc
+    {
+        VkShaderModule vertexShaderModule;
+        VkShaderModule fragmentShaderModule;
+        VkShaderModule computeShaderModule;
+        uint64 vertexShaderHash; // shader module cache keys
+        uint64 fragmentShaderHash;
+        uint64 computeShaderHash;
+        uint32 numStages;
+        uint32 numColorRTs;
+        VkFormat colorRTFormats[MAX_MULTIPLE_RENDERTARGETS];
+        VkFormat depthFormat;
+    };
     struct PSOPerms
     {
-        VkPipeline       graphicsPipeline[eMaxShaders][eMaxBlendStates][eMaxDepthStates];
+        // Graphics pipelines, created on first bind. Depth and cull state are always dynamic, blend state is dynamic
+        // with extended dynamic state 3, so most shaders end up with a single pipeline.
+        // Keys stay in the cache when their pipelines are destroyed, so that a shader reload recompiles (in parallel)
+        // exactly the permutations that are in use.
+        Core::HashMap<uint32, VkPipeline, Hash32> graphicsPipelines;
+        VkPipeline       computePipeline[eMaxShaders];
         VkPipelineLayout pipelineLayout[eMaxShaders];
+        bool             isBindless[eMaxShaders]; // first descriptor layout is DESCLAYOUT_ID_BINDLESS
+        bool             isCompute[eMaxShaders];
+        PSOCreateDesc    createDesc[eMaxShaders];
     } psoPermutations;
+    Core::HashMap<uint64, VulkanShaderModule, Hash64> shaderModules;
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+    VulkanDeferredDestroy deferredDestroyQueue[VULKAN_DEFERRED_DESTROY_QUEUE_MAX];
+    uint32 numDeferredDestroys = 0;
+    uint64 numDeferredDestroysTotal = 0;
+    uint64 numDeviceStallsAvoided = 0; // destroy calls that would previously have waited for device idle
+
+    // Staged uploads, batched and submitted on the transfer queue
+    VkCommandPool uploadCommandPool = VK_NULL_HANDLE;
+    VkSemaphore uploadTimelineSema = VK_NULL_HANDLE; // value n means upload batches [1, n] have completed
+    VulkanUploadBatch uploadBatches[VULKAN_MAX_UPLOAD_BATCHES] = {};
+    uint64 uploadValueOpen = 1; // value the batch being recorded signals once submitted
+    uint64 uploadValueRetired = 0; // batches up to here have completed and released their staging memory
+    uint64 uploadValueFrameWait = 0; // the current frame's submit waits for this value, its uploads are visible to the frame
+    bool isUploadBatchOpen = false;
+    ResourceHandle uploadStagingRing = DefaultResHandle_Invalid;
+    uint64 uploadStagingHead = 0; // monotonic byte positions, mod ring size for the actual offset
+    uint64 uploadStagingTail = 0;
+    uint64 uploadStagingBatchBegin = 0;
+    VulkanUploadAcquire pendingUploadAcquires[VULKAN_MAX_PENDING_UPLOAD_ACQUIRES] = {};
+    uint32 numPendingUploadAcquires = 0;
+    uint64 numUploadBytesTotal = 0;
+    uint64 numUploadBatchesTotal = 0;
+
     VulkanDescriptorLayout descLayouts[eMaxDescLayouts];
 
+    // Persistent descriptor sets. Sets of destroyed descriptors are recycled for the next descriptor with the same layout.
+    VulkanDescriptorPoolChain descriptorPools;
+    VulkanFreeDescriptorSet freeDescriptorSets[eMaxDescLayouts][VULKAN_DESCRIPTOR_FREE_LIST_MAX];
+    uint32 numFreeDescriptorSets[eMaxDescLayouts] = {};
+    uint64 numDescriptorSetsAllocated = 0;
+    uint64 numDescriptorSetsRecycled = 0;
+
+    // Transient descriptor sets, one pool chain per frame in flight that is reset wholesale once its frame has retired
+    VulkanDescriptorPoolChain transientDescriptorPools[MAX_FRAMES_IN_FLIGHT];
+    VkDescriptorSet transientDescriptorSets[MAX_FRAMES_IN_FLIGHT][VULKAN_MAX_TRANSIENT_DESCRIPTORS_PER_FRAME];
+    uint32 numTransientDescriptorSets[MAX_FRAMES_IN_FLIGHT] = {};
+    uint32 numTransientDescriptorSetsLastFrame = 0;
+
+    // Bindless descriptor set, written when resources are created and bound once per command buffer
+    VkDescriptorPool bindlessDescriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet bindlessDescriptorSet = VK_NULL_HANDLE;
+    VulkanBindlessSlots bindlessBufferSlots;
+    VulkanBindlessSlots bindlessImageSlots;
+    bool isBindlessSetBound = false; // in the current frame's command buffer
+    bool isBindlessSetBoundCompute = false; // same, at the compute bind point
+    VkPipeline boundGraphicsPipeline = VK_NULL_HANDLE; // in the current frame's command buffer
+
     Tk::Core::LinearAllocator DataAllocator;
 
     enum
@@ -180,6 +499,33 @@ uint32 ChooseMemoryTypeBits(uint32 requiredMemoryTypeBits, VkMemoryPropertyFlags
 VkResult CreateBuffer(VkBufferCreateFlags flags, VkDeviceSize size, VkBufferUsageFlags usage, VkSharingMode sharingMode, VkBuffer* outBuffer);
 VkResult CreateImage(VkImageCreateFlags flags, VkImageType imageType, VkFormat format, VkExtent3D extent, uint32 mipLevels, uint32 arrayLayers, VkImageTiling tiling, VkImageUsageFlags usage, VkSharingMode sharingMode, VkImage* outImage);
 
+// Resolves persistent and transient descriptor handles
+VkDescriptorSet VulkanGetDescriptorSet(DescriptorHandle handle, uint32 virtualFrame);
+// Called once the frame that last used the current virtual frame has retired
+void VulkanResetTransientDescriptors();
+// Allocates per-frame objects for up to numFramesInFlight virtual frames. Only call while no frame is in flight.
+void VulkanAllocateFramesInFlight(uint32 numFramesInFlight);
+
+// Number of frames whose gpu work has completed on every queue, read from the frame and compute timeline semaphores
+uint64 VulkanGetNumFramesCompleted();
+bool VulkanHasDedicatedComputeQueue();
+
+void VulkanInitUploads();
+void VulkanDestroyUploads();
+// Records ownership acquires for completed uploads and picks the upload value the current frame has to wait for
+void VulkanRecordUploadAcquires(VkCommandBuffer commandBuffer);
+
+// Queue a Vulkan object for destruction once all frames currently in flight have retired
+void VulkanDeferDestroy(uint32 deferredDestroyType, uint64 handle);
+// Destroy everything whose frames have retired. Pass destroyAll only when the device is known to be idle.
+void VulkanProcessDeferredDestroys(bool destroyAll);
+
+// Returns the pipeline for this permutation, creating it if this is its first use
+VkPipeline VulkanGetOrCreatePSOPerm(uint32 shaderID, uint32 blendState);
+uint32 VulkanGetNumGraphicsPSOs();
+uint32 VulkanGetNumShaderModules();
+uint32 VulkanGetNumDescriptorSetLayouts();
+
 void InitVulkanDataTypesPerEnum();
 const VkPipelineColorBlendAttachmentState& GetVkBlendState(uint32 gameBlendState);
 
@@ -196,5 +542,13 @@ const VkDescriptorType& GetVkDescriptorType(uint32 gameDescriptorType);
 VkBufferUsageFlags GetVkBufferUsageFlags(uint32 bufferUsage);
 VkMemoryPropertyFlags GetVkMemoryPropertyFlags(uint32 memUsage);
 
+typedef struct
+{
+    VkPipelineStageFlags2 stageMask;
+    VkAccessFlags2 accessMask;
+} AccessScope;
+const AccessScope& GetVkImageAccessScope(uint32 imageAccess);
+const AccessScope& GetVkBufferAccessScope(uint32 bufferAccess);
+
 }
 }
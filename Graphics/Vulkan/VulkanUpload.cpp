@@ -0,0 +1,476 @@
+#include "Graphics/Common/GraphicsCommon.h"
+#include "Graphics/Vulkan/Vulkan.h"
+#include "Graphics/Vulkan/VulkanTypes.h"
+#include "Utility/Logging.h"
+
+#include <string.h>
+
+namespace Tk
+{
+namespace Graphics
+{
+
+static bool HasDedicatedTransferQueue()
+{
+    return g_vulkanContextResources.transferQueueIndex != g_vulkanContextResources.graphicsQueueIndex;
+}
+
+static uint64 GetUploadStagingAlignment()
+{
+    // Staging allocations double as flush ranges, so they have to respect nonCoherentAtomSize too
+    const uint64 atomSize = g_vulkanContextResources.GPUMemAllocators[g_vulkanContextResources.eVulkanMemoryAllocatorHostVisibleBuffers].m_AllocGranularity;
+    return Max(atomSize, (uint64)16);
+}
+
+static uint64 GetNumUploadsCompleted()
+{
+    uint64 value = 0;
+    vkGetSemaphoreCounterValue(g_vulkanContextResources.device, g_vulkanContextResources.uploadTimelineSema, &value);
+    return value;
+}
+
+// Releases the staging memory of every batch that has completed
+static void RetireCompletedUploads()
+{
+    const uint64 numCompleted = GetNumUploadsCompleted();
+    while (g_vulkanContextResources.uploadValueRetired < numCompleted)
+    {
+        ++g_vulkanContextResources.uploadValueRetired;
+        const VulkanUploadBatch& batch = g_vulkanContextResources.uploadBatches[(g_vulkanContextResources.uploadValueRetired - 1) % VULKAN_MAX_UPLOAD_BATCHES];
+        g_vulkanContextResources.uploadStagingTail = batch.stagingEnd;
+    }
+}
+
+static void WaitForUploadValue(uint64 uploadValue)
+{
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &g_vulkanContextResources.uploadTimelineSema;
+    waitInfo.pValues = &uploadValue;
+    VkResult result = vkWaitSemaphores(g_vulkanContextResources.device, &waitInfo, (uint64)-1);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Waiting for upload timeline semaphore failed!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+    RetireCompletedUploads();
+}
+
+static void FlushStagingRange(uint64 begin, uint64 end)
+{
+    if (begin == end)
+        return;
+
+    const VulkanMemAlloc& stagingAlloc = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(g_vulkanContextResources.uploadStagingRing.m_hRes)->resourceChain[0].GpuMemAlloc;
+
+    // The batch's range can wrap around the end of the ring
+    VkMappedMemoryRange memoryRanges[2] = {};
+    uint32 numRanges = 0;
+    const uint64 beginOffset = begin % VULKAN_UPLOAD_STAGING_RING_SIZE;
+    const uint64 size = end - begin;
+    const uint64 sizeBeforeWrap = Min(size, VULKAN_UPLOAD_STAGING_RING_SIZE - beginOffset);
+
+    memoryRanges[numRanges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    memoryRanges[numRanges].memory = stagingAlloc.allocMem;
+    memoryRanges[numRanges].offset = stagingAlloc.allocOffset + beginOffset;
+    memoryRanges[numRanges].size = sizeBeforeWrap;
+    ++numRanges;
+    if (sizeBeforeWrap < size)
+    {
+        memoryRanges[numRanges].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        memoryRanges[numRanges].memory = stagingAlloc.allocMem;
+        memoryRanges[numRanges].offset = stagingAlloc.allocOffset;
+        memoryRanges[numRanges].size = size - sizeBeforeWrap;
+        ++numRanges;
+    }
+
+    VkResult result = vkFlushMappedMemoryRanges(g_vulkanContextResources.device, numRanges, memoryRanges);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to flush upload staging memory!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+}
+
+static void SubmitUploadBatch()
+{
+    if (!g_vulkanContextResources.isUploadBatchOpen)
+        return;
+
+    const uint64 uploadValue = g_vulkanContextResources.uploadValueOpen;
+    VulkanUploadBatch& batch = g_vulkanContextResources.uploadBatches[(uploadValue - 1) % VULKAN_MAX_UPLOAD_BATCHES];
+
+    FlushStagingRange(g_vulkanContextResources.uploadStagingBatchBegin, g_vulkanContextResources.uploadStagingHead);
+
+    VkResult result = vkEndCommandBuffer(batch.commandBuffer);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to end Vulkan upload command buffer!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {};
+    timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineSubmitInfo.signalSemaphoreValueCount = 1;
+    timelineSubmitInfo.pSignalSemaphoreValues = &uploadValue;
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &g_vulkanContextResources.uploadTimelineSema;
+
+    result = vkQueueSubmit(g_vulkanContextResources.transferQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to submit upload command buffer to transfer queue!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    batch.stagingEnd = g_vulkanContextResources.uploadStagingHead;
+    g_vulkanContextResources.isUploadBatchOpen = false;
+    ++g_vulkanContextResources.uploadValueOpen;
+    ++g_vulkanContextResources.numUploadBatchesTotal;
+}
+
+// Returns the ring position of sizeInBytes of contiguous staging memory, waiting on older batches if the ring is full
+static bool AllocUploadStaging(uint32 sizeInBytes, uint64* outStagingPos)
+{
+    const uint64 alignment = GetUploadStagingAlignment();
+    const uint64 allocSize = ((uint64)sizeInBytes + alignment - 1) & ~(alignment - 1);
+    if (allocSize > VULKAN_UPLOAD_STAGING_RING_SIZE)
+    {
+        Core::Utility::LogMsg("Graphics", "Upload is larger than the whole staging ring!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return false;
+    }
+
+    for (;;)
+    {
+        RetireCompletedUploads();
+
+        // Allocations never straddle the end of the ring, skip to the start instead
+        const uint64 head = g_vulkanContextResources.uploadStagingHead;
+        const uint64 ringOffset = head % VULKAN_UPLOAD_STAGING_RING_SIZE;
+        const uint64 padding = ringOffset + allocSize > VULKAN_UPLOAD_STAGING_RING_SIZE ? VULKAN_UPLOAD_STAGING_RING_SIZE - ringOffset : 0;
+        if (head + padding + allocSize - g_vulkanContextResources.uploadStagingTail <= VULKAN_UPLOAD_STAGING_RING_SIZE)
+        {
+            *outStagingPos = head + padding;
+            g_vulkanContextResources.uploadStagingHead = head + padding + allocSize;
+            return true;
+        }
+
+        // Out of staging memory, the oldest batch in flight has to complete first
+        const uint64 oldestInFlight = g_vulkanContextResources.uploadValueRetired + 1;
+        if (oldestInFlight < g_vulkanContextResources.uploadValueOpen)
+        {
+            WaitForUploadValue(oldestInFlight);
+        }
+        else if (g_vulkanContextResources.isUploadBatchOpen)
+        {
+            SubmitUploadBatch();
+        }
+        else
+        {
+            TINKER_ASSERT(0); // nothing in flight, the ring should be empty
+            return false;
+        }
+    }
+}
+
+static VkCommandBuffer OpenUploadBatch(uint64 stagingPos)
+{
+    const uint64 uploadValue = g_vulkanContextResources.uploadValueOpen;
+    VulkanUploadBatch& batch = g_vulkanContextResources.uploadBatches[(uploadValue - 1) % VULKAN_MAX_UPLOAD_BATCHES];
+    if (g_vulkanContextResources.isUploadBatchOpen)
+        return batch.commandBuffer;
+
+    // The batch that last used this command buffer has to be done with it
+    if (uploadValue > VULKAN_MAX_UPLOAD_BATCHES)
+    {
+        WaitForUploadValue(uploadValue - VULKAN_MAX_UPLOAD_BATCHES);
+    }
+
+    vkResetCommandBuffer(batch.commandBuffer, 0);
+
+    VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VkResult result = vkBeginCommandBuffer(batch.commandBuffer, &commandBufferBeginInfo);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to begin Vulkan upload command buffer!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    batch.numUploads = 0;
+    g_vulkanContextResources.uploadStagingBatchBegin = stagingPos;
+    g_vulkanContextResources.isUploadBatchOpen = true;
+    return batch.commandBuffer;
+}
+
+static void AddPendingUploadAcquire(VkImage image, uint32 numArrayEles)
+{
+    if (g_vulkanContextResources.numPendingUploadAcquires == VULKAN_MAX_PENDING_UPLOAD_ACQUIRES)
+    {
+        Core::Utility::LogMsg("Graphics", "Too many uploads waiting to be acquired by the graphics queue!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+        return;
+    }
+
+    VulkanUploadAcquire& acquire = g_vulkanContextResources.pendingUploadAcquires[g_vulkanContextResources.numPendingUploadAcquires++];
+    acquire.uploadValue = g_vulkanContextResources.uploadValueOpen;
+    acquire.image = image;
+    acquire.numArrayEles = numArrayEles;
+}
+
+// Stages the data and returns the command buffer to record the copy into, or VK_NULL_HANDLE on failure
+static VkCommandBuffer StageUpload(const void* data, uint32 sizeInBytes, uint64* outStagingOffset)
+{
+    uint64 stagingPos = 0;
+    if (!AllocUploadStaging(sizeInBytes, &stagingPos))
+        return VK_NULL_HANDLE;
+
+    const uint64 stagingOffset = stagingPos % VULKAN_UPLOAD_STAGING_RING_SIZE;
+    memcpy((uint8*)VulkanMapResource(g_vulkanContextResources.uploadStagingRing) + stagingOffset, data, sizeInBytes);
+
+    VkCommandBuffer commandBuffer = OpenUploadBatch(stagingPos);
+    ++g_vulkanContextResources.uploadBatches[(g_vulkanContextResources.uploadValueOpen - 1) % VULKAN_MAX_UPLOAD_BATCHES].numUploads;
+    g_vulkanContextResources.numUploadBytesTotal += sizeInBytes;
+
+    *outStagingOffset = stagingOffset;
+    return commandBuffer;
+}
+
+uint64 VulkanUploadBufferData(ResourceHandle dstBufferHandle, uint32 dstOffset, const void* data, uint32 sizeInBytes)
+{
+    VulkanMemResourceChain* dstResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(dstBufferHandle.m_hRes);
+    TINKER_ASSERT(dstResourceChain->resDesc.resourceType == ResourceType::eBuffer1D);
+    TINKER_ASSERT(!IsBufferUsageMultiBuffered(dstResourceChain->resDesc.bufferUsage));
+    TINKER_ASSERT(dstOffset + sizeInBytes <= dstResourceChain->resDesc.dims.x);
+
+    uint64 stagingOffset = 0;
+    VkCommandBuffer commandBuffer = StageUpload(data, sizeInBytes, &stagingOffset);
+    if (commandBuffer == VK_NULL_HANDLE)
+        return 0;
+
+    VkBuffer stagingBuffer = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(g_vulkanContextResources.uploadStagingRing.m_hRes)->resourceChain[0].buffer;
+    VkBuffer dstBuffer = dstResourceChain->resourceChain[0].buffer;
+
+    VkBufferCopy bufferCopy = {};
+    bufferCopy.srcOffset = stagingOffset;
+    bufferCopy.dstOffset = dstOffset;
+    bufferCopy.size = sizeInBytes;
+    vkCmdCopyBuffer(commandBuffer, stagingBuffer, dstBuffer, 1, &bufferCopy);
+
+    // Upload destinations are created concurrent whenever the transfer family is dedicated, so no ownership
+    // transfer is needed and the buffer can be uploaded to again or in parts at any time
+    TINKER_ASSERT(!HasDedicatedTransferQueue() || dstResourceChain->isConcurrent);
+
+    return g_vulkanContextResources.uploadValueOpen;
+}
+
+uint64 VulkanUploadImageData(ResourceHandle dstImageHandle, const void* data, uint32 sizeInBytes)
+{
+    VulkanMemResourceChain* dstResourceChain = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(dstImageHandle.m_hRes);
+    const ResourceDesc& dstDesc = dstResourceChain->resDesc;
+    TINKER_ASSERT(dstDesc.resourceType == ResourceType::eImage2D);
+
+    uint64 stagingOffset = 0;
+    VkCommandBuffer commandBuffer = StageUpload(data, sizeInBytes, &stagingOffset);
+    if (commandBuffer == VK_NULL_HANDLE)
+        return 0;
+
+    VkBuffer stagingBuffer = g_vulkanContextResources.vulkanMemResourcePool.PtrFromHandle(g_vulkanContextResources.uploadStagingRing.m_hRes)->resourceChain[0].buffer;
+    VkImage dstImage = dstResourceChain->resourceChain[0].image;
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = dstImage;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = dstDesc.arrayEles;
+
+    // Previous contents are discarded
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = stagingOffset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = dstDesc.arrayEles;
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent = { dstDesc.dims.x, dstDesc.dims.y, dstDesc.dims.z };
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // Leave the image ready to sample. Visibility to the graphics queue comes from the frame waiting on the upload timeline.
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    if (HasDedicatedTransferQueue() && !dstResourceChain->isConcurrent)
+    {
+        barrier.srcQueueFamilyIndex = g_vulkanContextResources.transferQueueIndex;
+        barrier.dstQueueFamilyIndex = g_vulkanContextResources.graphicsQueueIndex;
+        AddPendingUploadAcquire(dstImage, dstDesc.arrayEles);
+    }
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    return g_vulkanContextResources.uploadValueOpen;
+}
+
+uint64 VulkanSubmitUploads()
+{
+    SubmitUploadBatch();
+    return g_vulkanContextResources.uploadValueOpen - 1;
+}
+
+bool VulkanIsUploadComplete(uint64 uploadValue)
+{
+    return uploadValue < g_vulkanContextResources.uploadValueOpen && uploadValue <= GetNumUploadsCompleted();
+}
+
+void VulkanWaitForUpload(uint64 uploadValue)
+{
+    if (uploadValue >= g_vulkanContextResources.uploadValueOpen)
+    {
+        SubmitUploadBatch();
+    }
+    WaitForUploadValue(uploadValue);
+}
+
+void VulkanRecordUploadAcquires(VkCommandBuffer commandBuffer)
+{
+    RetireCompletedUploads();
+    const uint64 numCompleted = g_vulkanContextResources.uploadValueRetired;
+    g_vulkanContextResources.uploadValueFrameWait = numCompleted;
+
+    // Acquires are stored in submission order, so the completed ones are a prefix
+    uint32 numAcquires = 0;
+    while (numAcquires < g_vulkanContextResources.numPendingUploadAcquires &&
+        g_vulkanContextResources.pendingUploadAcquires[numAcquires].uploadValue <= numCompleted)
+    {
+        const VulkanUploadAcquire& acquire = g_vulkanContextResources.pendingUploadAcquires[numAcquires];
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = g_vulkanContextResources.transferQueueIndex;
+        barrier.dstQueueFamilyIndex = g_vulkanContextResources.graphicsQueueIndex;
+        barrier.image = acquire.image;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = acquire.numArrayEles;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        ++numAcquires;
+    }
+
+    if (numAcquires > 0)
+    {
+        g_vulkanContextResources.numPendingUploadAcquires -= numAcquires;
+        memmove(&g_vulkanContextResources.pendingUploadAcquires[0], &g_vulkanContextResources.pendingUploadAcquires[numAcquires],
+            sizeof(VulkanUploadAcquire) * g_vulkanContextResources.numPendingUploadAcquires);
+    }
+}
+
+void VulkanInitUploads()
+{
+    ResourceDesc desc;
+    desc.resourceType = ResourceType::eBuffer1D;
+    desc.dims = v3ui(VULKAN_UPLOAD_STAGING_RING_SIZE, 0, 0);
+    desc.bufferUsage = BufferUsage::eStaging;
+    desc.debugLabel = "Upload staging ring";
+    g_vulkanContextResources.uploadStagingRing = VulkanCreateResource(desc);
+
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+    commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolCreateInfo.queueFamilyIndex = g_vulkanContextResources.transferQueueIndex;
+    commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VkResult result = vkCreateCommandPool(g_vulkanContextResources.device, &commandPoolCreateInfo, nullptr, &g_vulkanContextResources.uploadCommandPool);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan upload command pool!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    VkCommandBuffer commandBuffers[VULKAN_MAX_UPLOAD_BATCHES] = {};
+    VkCommandBufferAllocateInfo commandBufferAllocInfo = {};
+    commandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandBufferAllocInfo.commandPool = g_vulkanContextResources.uploadCommandPool;
+    commandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandBufferAllocInfo.commandBufferCount = VULKAN_MAX_UPLOAD_BATCHES;
+    result = vkAllocateCommandBuffers(g_vulkanContextResources.device, &commandBufferAllocInfo, commandBuffers);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to allocate Vulkan upload command buffers!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+    for (uint32 uiBatch = 0; uiBatch < VULKAN_MAX_UPLOAD_BATCHES; ++uiBatch)
+    {
+        g_vulkanContextResources.uploadBatches[uiBatch] = {};
+        g_vulkanContextResources.uploadBatches[uiBatch].commandBuffer = commandBuffers[uiBatch];
+    }
+
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {};
+    semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphoreTypeCreateInfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+    result = vkCreateSemaphore(g_vulkanContextResources.device, &semaphoreCreateInfo, nullptr, &g_vulkanContextResources.uploadTimelineSema);
+    if (result != VK_SUCCESS)
+    {
+        Core::Utility::LogMsg("Platform", "Failed to create Vulkan upload timeline semaphore!", Core::Utility::LogSeverity::eCritical);
+        TINKER_ASSERT(0);
+    }
+
+    g_vulkanContextResources.uploadValueOpen = 1;
+    g_vulkanContextResources.uploadValueRetired = 0;
+    g_vulkanContextResources.uploadValueFrameWait = 0;
+    g_vulkanContextResources.isUploadBatchOpen = false;
+    g_vulkanContextResources.uploadStagingHead = 0;
+    g_vulkanContextResources.uploadStagingTail = 0;
+    g_vulkanContextResources.uploadStagingBatchBegin = 0;
+    g_vulkanContextResources.numPendingUploadAcquires = 0;
+}
+
+// Expects the device to be idle
+void VulkanDestroyUploads()
+{
+    if (g_vulkanContextResources.isUploadBatchOpen)
+    {
+        vkEndCommandBuffer(g_vulkanContextResources.uploadBatches[(g_vulkanContextResources.uploadValueOpen - 1) % VULKAN_MAX_UPLOAD_BATCHES].commandBuffer);
+        g_vulkanContextResources.isUploadBatchOpen = false;
+    }
+
+    vkDestroyCommandPool(g_vulkanContextResources.device, g_vulkanContextResources.uploadCommandPool, nullptr);
+    g_vulkanContextResources.uploadCommandPool = VK_NULL_HANDLE;
+    vkDestroySemaphore(g_vulkanContextResources.device, g_vulkanContextResources.uploadTimelineSema, nullptr);
+    g_vulkanContextResources.uploadTimelineSema = VK_NULL_HANDLE;
+
+    VulkanDestroyResource(g_vulkanContextResources.uploadStagingRing);
+    g_vulkanContextResources.uploadStagingRing = DefaultResHandle_Invalid;
+    g_vulkanContextResources.numPendingUploadAcquires = 0;
+}
+
+}
+}
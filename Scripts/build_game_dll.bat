@@ -88,13 +88,16 @@ set SourceListGame=
 set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Game/GameMain.cpp 
 set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Graphics/Common/GraphicsCommon.cpp 
 set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Graphics/Common/ShaderManager.cpp 
+set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Graphics/Common/ShaderReflection.cpp 
 set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Graphics/Common/GPUTimestamps.cpp 
+set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Graphics/Common/RenderGraph.cpp 
 set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../Tools/ShaderCompiler/ShaderCompiler.cpp 
 if "%GraphicsAPI%" == "VK" (
     set SourceListGame=!SourceListGame! %AbsolutePathPrefix%/../Graphics/Vulkan/Vulkan.cpp 
     set SourceListGame=!SourceListGame! %AbsolutePathPrefix%/../Graphics/Vulkan/VulkanCmds.cpp 
     set SourceListGame=!SourceListGame! %AbsolutePathPrefix%/../Graphics/Vulkan/VulkanTypes.cpp 
     set SourceListGame=!SourceListGame! %AbsolutePathPrefix%/../Graphics/Vulkan/VulkanCreation.cpp 
+    set SourceListGame=!SourceListGame! %AbsolutePathPrefix%/../Graphics/Vulkan/VulkanUpload.cpp 
 )
 set SourceListGame=%SourceListGame% %AbsolutePathPrefix%/../ThirdParty/MurmurHash3/MurmurHash3.cpp 
 if "%GraphicsAPI%" == "D3D12" ( echo No source files available for D3D12. )
@@ -120,7 +123,7 @@ set GameDllPdbName=TinkerGame_%BuildTimestamp%.pdb
 if "%BuildConfig%" == "Debug" (
     set DebugCompileFlagsGame=/Fd%GameDllPdbName%
     set DebugLinkFlagsGame=/pdb:%GameDllPdbName% 
-    set CompileDefines=!CompileDefines! 
+    set CompileDefines=!CompileDefines! /DENABLE_GRAPHICS_COMMAND_LABELS 
     ) else (
     set DebugCompileFlagsGame=/Fd%GameDllPdbName%
     set DebugLinkFlagsGame=/pdb:%GameDllPdbName% 
@@ -0,0 +1,101 @@
+@echo off
+setlocal
+setlocal enabledelayedexpansion
+
+if "%1" == "-h" (goto PrintHelp)
+if "%1" == "-help" (goto PrintHelp)
+if "%1" == "help" (goto PrintHelp)
+goto StartScript
+
+:PrintHelp
+echo Usage: build_meshcooker.bat ^<build_mode^> 
+echo.
+echo build_mode:
+echo   Release
+echo   Debug
+echo.
+echo For example:
+echo build_meshcooker.bat Release
+echo.
+goto EndScript
+
+:StartScript
+set BuildConfig=%1
+if "%BuildConfig%" NEQ "Debug" (
+    if "%BuildConfig%" NEQ "Release" (
+        echo Invalid build config specified.
+        goto DoneBuild
+        )
+    )
+
+echo ***** Building Tinker Mesh Cooker *****
+
+pushd ..
+pushd .\ToolsBin
+del TinkerMC.pdb > NUL 2> NUL
+
+rem *********************************************************************************************************
+rem /FAs for .asm file output
+set CommonCompileFlags=/nologo /std:c++20 /W4 /WX /wd4127 /wd4530 /wd4201 /wd4324 /wd4100 /wd4189 /EHa- /GR- /Gm- /GS- /fp:fast /Zi /FS
+set CommonLinkFlags=/incremental:no /opt:ref /DEBUG
+
+if "%BuildConfig%" == "Debug" (
+    echo Debug mode specified.
+    set CommonCompileFlags=%CommonCompileFlags% /Od /MTd
+    set CommonLinkFlags=%CommonLinkFlags% /debug:full
+    ) else (
+    echo Release mode specified.
+    set CommonCompileFlags=%CommonCompileFlags% /O2 /MT
+    )
+
+rem *********************************************************************************************************
+rem TinkerMC - primary exe
+set AbsolutePathPrefix=%cd%
+
+set SourceListMC= 
+set SourceListMC=%SourceListMC% %AbsolutePathPrefix%/../Tools/MeshCooker/Main.cpp 
+set SourceListMC=%SourceListMC% %AbsolutePathPrefix%/../Core/AssetFileParsing.cpp 
+set SourceListMC=%SourceListMC% %AbsolutePathPrefix%/../Core/Mem.cpp 
+set SourceListMC=%SourceListMC% %AbsolutePathPrefix%/../Core/Platform/Win32File.cpp 
+set SourceListMC=%SourceListMC% %AbsolutePathPrefix%/../Core/Platform/Win32Logging.cpp 
+set SourceListMC=%SourceListMC% %AbsolutePathPrefix%/../Core/Platform/Win32PlatformGameAPI.cpp 
+
+rem Calculate absolute path prefix for application path parameters here
+set AbsolutePathPrefix=%AbsolutePathPrefix:\=\\%
+set CompileDefines=/DASSERTS_ENABLE=1
+
+if "%BuildConfig%" == "Debug" (
+    set DebugCompileFlagsMC=/FdTinkerMC.pdb
+    set DebugLinkFlagsMC=/pdb:TinkerMC.pdb 
+    set CompileDefines=!CompileDefines!
+    ) else (
+    set DebugCompileFlagsMC=/FdTinkerMC.pdb
+    set DebugLinkFlagsMC=/pdb:TinkerMC.pdb 
+    set CompileDefines=!CompileDefines!
+    )
+
+set CompileIncludePaths= /I ../Core
+set LibsToLink=user32.lib ws2_32.lib
+
+echo.
+echo Building TinkerMC.exe...
+
+set OBJDir=%cd%\obj_mc\
+if NOT EXIST %OBJDir% mkdir %OBJDir%
+set CommonCompileFlags=%CommonCompileFlags% /Fo:%OBJDir%
+
+cl %CommonCompileFlags% %CompileIncludePaths% %CompileDefines% %DebugCompileFlagsMC% %SourceListMC% /link %LibsToLink% %CommonLinkFlags% %DebugLinkFlagsMC% /out:TinkerMC.exe
+
+echo.
+if EXIST TinkerMC.exp (
+    echo Deleting unnecessary file TinkerMC.exp
+    echo.
+    del TinkerMC.exp
+    )
+
+:DoneBuild
+echo.
+popd
+popd
+
+:EndScript
@@ -0,0 +1,43 @@
+struct PushConstantData
+{
+    uint SrcIndex;
+    uint DstIndex;
+    uint ResultBufferIndex;
+    uint NumElements;
+    uint ImageDim;
+    uint IsVertical;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
+
+[[vk::binding(2, 0)]] [[vk::image_format("rgba16f")]] RWTexture2D<float4> BindlessStorageImages[];
+
+// Let the compiler unroll the taps, or keep the loop
+// TK_PERMUTATION UNROLL_TAPS 0 1
+
+// 9 tap gaussian, center weight first
+static const float Weights[5] = { 0.227027f, 0.1945946f, 0.1216216f, 0.054054f, 0.016216f };
+
+[numthreads(8, 8, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID)
+{
+    const int MaxCoord = int(PushConstants.ImageDim) - 1;
+    const int2 Pixel = int2(DispatchThreadID.xy);
+    if (any(Pixel > MaxCoord))
+        return;
+
+    const int2 Step = PushConstants.IsVertical ? int2(0, 1) : int2(1, 0);
+    float4 Sum = BindlessStorageImages[PushConstants.SrcIndex][Pixel] * Weights[0];
+#if UNROLL_TAPS
+    [unroll]
+#else
+    [loop]
+#endif
+    for (int i = 1; i < 5; ++i)
+    {
+        Sum += BindlessStorageImages[PushConstants.SrcIndex][clamp(Pixel + Step * i, 0, MaxCoord)] * Weights[i];
+        Sum += BindlessStorageImages[PushConstants.SrcIndex][clamp(Pixel - Step * i, 0, MaxCoord)] * Weights[i];
+    }
+    BindlessStorageImages[PushConstants.DstIndex][Pixel] = Sum;
+}
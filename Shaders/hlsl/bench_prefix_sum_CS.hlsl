@@ -0,0 +1,44 @@
+struct PushConstantData
+{
+    uint SrcIndex;
+    uint DstIndex;
+    uint ResultBufferIndex;
+    uint NumElements;
+    uint ImageDim;
+    uint IsVertical;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
+
+[[vk::binding(0, 0)]] RWByteAddressBuffer BindlessBuffers[];
+
+#define GROUP_SIZE 256
+
+groupshared uint WaveTotals[GROUP_SIZE];
+
+// Inclusive scan of each group of GROUP_SIZE elements. A full scan would add the scanned group totals in a second
+// pass, the group local scan is the part worth timing.
+[numthreads(GROUP_SIZE, 1, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+    uint Value = 0;
+    if (DispatchThreadID.x < PushConstants.NumElements)
+        Value = BindlessBuffers[PushConstants.SrcIndex].Load(DispatchThreadID.x * 4);
+
+    const uint LaneCount = WaveGetLaneCount();
+    const uint WaveIndex = GroupIndex / LaneCount;
+    const uint WaveScan = WavePrefixSum(Value) + Value;
+
+    // The group size is a multiple of any wave size, so every wave has a last lane
+    if (WaveGetLaneIndex() == LaneCount - 1)
+        WaveTotals[WaveIndex] = WaveScan;
+    GroupMemoryBarrierWithGroupSync();
+
+    uint WaveOffset = 0;
+    for (uint i = 0; i < WaveIndex; ++i)
+        WaveOffset += WaveTotals[i];
+
+    if (DispatchThreadID.x < PushConstants.NumElements)
+        BindlessBuffers[PushConstants.DstIndex].Store(DispatchThreadID.x * 4, WaveOffset + WaveScan);
+}
@@ -0,0 +1,67 @@
+struct PushConstantData
+{
+    uint SrcIndex;
+    uint DstIndex;
+    uint ResultBufferIndex;
+    uint NumElements;
+    uint ImageDim;
+    uint IsVertical;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
+
+[[vk::binding(0, 0)]] RWByteAddressBuffer BindlessBuffers[];
+
+// Wave intrinsics, or a plain groupshared tree reduction to compare against
+// TK_PERMUTATION USE_WAVE_OPS 1 0
+
+#define GROUP_SIZE 256
+// Byte offset of the result, after the VkDispatchIndirectCommand
+#define RESULT_OFFSET 12
+
+groupshared uint WaveSums[GROUP_SIZE];
+
+[numthreads(GROUP_SIZE, 1, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID, uint GroupIndex : SV_GroupIndex)
+{
+    uint Value = 0;
+    if (DispatchThreadID.x < PushConstants.NumElements)
+        Value = BindlessBuffers[PushConstants.SrcIndex].Load(DispatchThreadID.x * 4);
+
+#if !USE_WAVE_OPS
+    WaveSums[GroupIndex] = Value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint Stride = GROUP_SIZE / 2; Stride > 0; Stride >>= 1)
+    {
+        if (GroupIndex < Stride)
+            WaveSums[GroupIndex] += WaveSums[GroupIndex + Stride];
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (GroupIndex == 0)
+        BindlessBuffers[PushConstants.ResultBufferIndex].InterlockedAdd(RESULT_OFFSET, WaveSums[0]);
+#else
+    // Sum within each wave, then across the waves of the group, then one atomic per group
+    const uint LaneCount = WaveGetLaneCount();
+    const uint WaveIndex = GroupIndex / LaneCount;
+    const uint WaveSum = WaveActiveSum(Value);
+    if (WaveIsFirstLane())
+        WaveSums[WaveIndex] = WaveSum;
+    GroupMemoryBarrierWithGroupSync();
+
+    if (WaveIndex == 0)
+    {
+        const uint NumWaves = GROUP_SIZE / LaneCount;
+        uint LaneSum = 0;
+        for (uint i = WaveGetLaneIndex(); i < NumWaves; i += LaneCount)
+            LaneSum += WaveSums[i];
+
+        const uint GroupSum = WaveActiveSum(LaneSum);
+        if (WaveIsFirstLane())
+            BindlessBuffers[PushConstants.ResultBufferIndex].InterlockedAdd(RESULT_OFFSET, GroupSum);
+    }
+#endif
+}
@@ -1,5 +1,14 @@
-[[vk::binding(0, 0)]] Texture2D SrcImage;
-[[vk::binding(0, 0)]] SamplerState SamplerLinearWrap;
+struct PushConstantData
+{
+    uint PositionBufferIndex;
+    uint SrcImageIndex;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
+
+[[vk::binding(1, 0)]] Texture2D BindlessImages[];
+[[vk::binding(1, 0)]] SamplerState BindlessSamplers[];
 
 struct PSInput
 {
@@ -9,5 +18,6 @@ struct PSInput
 
 float4 main(PSInput Input) : SV_Target0
 {
-    return float4(SrcImage.SampleLevel(SamplerLinearWrap, Input.UV, 0).rgb, 1.0);
+    const uint SrcImageIndex = PushConstants.SrcImageIndex;
+    return float4(BindlessImages[SrcImageIndex].SampleLevel(BindlessSamplers[SrcImageIndex], Input.UV, 0).rgb, 1.0);
 }
@@ -1,8 +1,13 @@
-#define PositionDataType float4
-#define UVDataType float2
-#define NormalDataType float4
+struct PushConstantData
+{
+    uint PositionBufferIndex;
+    uint SrcImageIndex;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
 
-[[vk::binding(0, 1)]] StructuredBuffer<PositionDataType> PositionData;
+[[vk::binding(0, 0)]] ByteAddressBuffer BindlessBuffers[];
 
 struct VSOutput
 {
@@ -12,7 +17,8 @@ struct VSOutput
 
 VSOutput main(uint VertexIndex : SV_VertexID)
 {
-    float4 ModelPos = float4(PositionData.Load(VertexIndex).xyz, 1.0f);
+    // Positions are float4s
+    float4 ModelPos = float4(asfloat(BindlessBuffers[PushConstants.PositionBufferIndex].Load3(VertexIndex * 16)), 1.0f);
     float2 UV = ModelPos.xy * 0.5f + 0.5f;
     UV.y = 1 - UV.y;
 
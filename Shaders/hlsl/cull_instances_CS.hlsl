@@ -0,0 +1,57 @@
+struct PushConstantData
+{
+    uint PositionBufferIndex;
+    uint InstanceBufferIndex;
+    uint VisibleInstanceBufferIndex;
+    uint DrawArgsBufferIndex;
+    uint NumInstances;
+    float ViewScale;
+    float2 ViewOffset;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
+
+[[vk::binding(0, 0)]] RWByteAddressBuffer BindlessBuffers[];
+
+// Byte offsets into the draw args, a VkDrawIndexedIndirectCommand followed by the draw count
+#define DRAW_ARGS_INSTANCE_COUNT_OFFSET 4
+#define DRAW_ARGS_DRAW_COUNT_OFFSET 20
+
+[numthreads(64, 1, 1)]
+void main(uint3 DispatchThreadID : SV_DispatchThreadID)
+{
+    const uint InstanceIndex = DispatchThreadID.x;
+
+    // Instances are float4s: center xy, radius, color seed
+    bool IsVisible = false;
+    if (InstanceIndex < PushConstants.NumInstances)
+    {
+        const float4 Instance = asfloat(BindlessBuffers[PushConstants.InstanceBufferIndex].Load4(InstanceIndex * 16));
+        const float2 ViewPos = (Instance.xy - PushConstants.ViewOffset) * PushConstants.ViewScale;
+        const float ViewRadius = Instance.z * PushConstants.ViewScale;
+
+        // The view frustum is the [-1, 1] clip space square
+        IsVisible = all(abs(ViewPos) - ViewRadius <= 1.0f);
+    }
+
+    // One atomic per wave instead of one per visible instance
+    const uint NumVisibleInWave = WaveActiveCountBits(IsVisible);
+    if (NumVisibleInWave == 0)
+        return;
+
+    uint WaveFirstSlot = 0;
+    if (WaveIsFirstLane())
+    {
+        BindlessBuffers[PushConstants.DrawArgsBufferIndex].InterlockedAdd(DRAW_ARGS_INSTANCE_COUNT_OFFSET, NumVisibleInWave, WaveFirstSlot);
+        if (WaveFirstSlot == 0)
+            BindlessBuffers[PushConstants.DrawArgsBufferIndex].Store(DRAW_ARGS_DRAW_COUNT_OFFSET, 1);
+    }
+    WaveFirstSlot = WaveReadLaneFirst(WaveFirstSlot);
+
+    if (IsVisible)
+    {
+        const uint Slot = WaveFirstSlot + WavePrefixCountBits(IsVisible);
+        BindlessBuffers[PushConstants.VisibleInstanceBufferIndex].Store(Slot * 4, InstanceIndex);
+    }
+}
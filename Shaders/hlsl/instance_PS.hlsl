@@ -0,0 +1,10 @@
+struct PSInput
+{
+    [[vk::location(0)]] float4 Position : SV_POSITION;
+    [[vk::location(1)]] float3 Color    : COLOR0;
+};
+
+float4 main(PSInput Input) : SV_Target0
+{
+    return float4(Input.Color, 1.0f);
+}
@@ -0,0 +1,37 @@
+struct PushConstantData
+{
+    uint PositionBufferIndex;
+    uint InstanceBufferIndex;
+    uint VisibleInstanceBufferIndex;
+    uint DrawArgsBufferIndex;
+    uint NumInstances;
+    float ViewScale;
+    float2 ViewOffset;
+};
+
+[[vk::push_constant]]
+PushConstantData PushConstants;
+
+[[vk::binding(0, 0)]] ByteAddressBuffer BindlessBuffers[];
+
+struct VSOutput
+{
+    [[vk::location(0)]] float4 Position : SV_POSITION;
+    [[vk::location(1)]] float3 Color    : COLOR0;
+};
+
+VSOutput main(uint VertexIndex : SV_VertexID, uint InstanceID : SV_InstanceID)
+{
+    // The culling pass compacted the visible instance indices, the draw's instance count is the number visible
+    const uint InstanceIndex = BindlessBuffers[PushConstants.VisibleInstanceBufferIndex].Load(InstanceID * 4);
+    const float4 Instance = asfloat(BindlessBuffers[PushConstants.InstanceBufferIndex].Load4(InstanceIndex * 16));
+
+    // Positions are float4s
+    const float2 QuadPos = asfloat(BindlessBuffers[PushConstants.PositionBufferIndex].Load2(VertexIndex * 16));
+    const float2 WorldPos = Instance.xy + QuadPos * Instance.z;
+
+    VSOutput Out;
+    Out.Position = float4((WorldPos - PushConstants.ViewOffset) * PushConstants.ViewScale, 0.0f, 1.0f);
+    Out.Color = saturate(abs(frac(Instance.w + float3(0.0f, 2.0f / 3.0f, 1.0f / 3.0f)) * 6.0f - 3.0f) - 1.0f);
+    return Out;
+}
@@ -31,6 +31,8 @@ typedef unsigned __int64 uint64_t;
 // NOTE(Joe) - this is the original function, modified slightly
 uint32_t MurmurHash3_x86_32(const void* key, int len, uint32_t seed);
 
+void MurmurHash3_x64_128(const void* key, int len, uint32_t seed, void* out);
+
 // NOTE(Joe) - what follows is the same murmur3 hash, but run at compile time for strings that it can be computed for (string literals)
 inline consteval uint32_t rotl32_Internal(uint32_t x, int8_t r)
 {
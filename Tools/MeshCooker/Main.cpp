@@ -0,0 +1,63 @@
+#include "CoreDefines.h"
+#include "AssetFileParsing.h"
+#include "Platform/PlatformGameAPI.h"
+
+#include <stdio.h>
+#include <cstring>
+
+namespace ErrCode
+{
+    enum : int
+    {
+        Success = 0,
+        InvalidArgs,
+        ReadFailed,
+        CookFailed,
+        WriteFailed,
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    bool bQuantize = false;
+    if (argc == 4 && strcmp(argv[3], "-q") == 0)
+    {
+        bQuantize = true;
+    }
+    else if (argc != 3)
+    {
+        printf("Invalid arguments provided. Usage: TinkerMC.exe <input.obj> <output%s> [-q]\n", COOKED_MESH_FILE_EXT);
+        printf("  -q: quantize vertex attributes\n");
+        return ErrCode::InvalidArgs;
+    }
+
+    Tk::Platform::MappedFile objFile;
+    if (!Tk::Platform::MapFileReadOnly(argv[1], Tk::Platform::FileAccessPattern::eSequential, &objFile))
+    {
+        printf("Failed to read %s.\n", argv[1]);
+        return ErrCode::ReadFailed;
+    }
+
+    Buffer cookedMesh;
+    const uint32 flags = bQuantize ? Tk::Core::Asset::CookedMeshFlags::eQuantized : Tk::Core::Asset::CookedMeshFlags::eNone;
+    const bool bCooked = Tk::Core::Asset::CookOBJ(objFile.data, objFile.sizeInBytes, flags, &cookedMesh);
+    Tk::Platform::UnmapFile(&objFile);
+    if (!bCooked)
+    {
+        printf("Failed to cook %s.\n", argv[1]);
+        return ErrCode::CookFailed;
+    }
+
+    const Tk::Core::Asset::CookedMeshHeader* header = (const Tk::Core::Asset::CookedMeshHeader*)cookedMesh.m_data;
+    printf("Cooked %u triangles, %u vertices, %u bit indices%s.\n", header->numIndices / 3, header->numVertices,
+        (header->flags & Tk::Core::Asset::CookedMeshFlags::eIndices16) ? 16 : 32, bQuantize ? ", quantized" : "");
+
+    int result = ErrCode::Success;
+    if (Tk::Platform::WriteEntireFile(argv[2], cookedMesh.m_sizeInBytes, cookedMesh.m_data))
+    {
+        printf("Failed to write %s.\n", argv[2]);
+        result = ErrCode::WriteFailed;
+    }
+    cookedMesh.Dealloc();
+    return result;
+}
@@ -2,23 +2,45 @@
 #include <inc/dxcapi.h>
 
 #include <stdio.h>
+#include <cstddef>
+#include <process.h>
+#include <atomic>
 
 #include "ShaderCompiler.h"
 #include "DataStructures/Vector.h"
 #include "Platform/PlatformGameAPI.h"
 #include "StringTypes.h"
+#include "Mem.h"
+#include "MurmurHash3.h"
 
 namespace Tk
 {
 namespace ShaderCompiler
 {
 
-static CComPtr<IDxcUtils> g_pUtils;
-static CComPtr<IDxcCompiler3> g_pCompiler;
-static CComPtr<IDxcIncludeHandler> g_pIncludeHandler;
+// DXC objects are not thread safe, so each compile thread creates its own
+typedef struct dxc_instance
+{
+    CComPtr<IDxcUtils> pUtils;
+    CComPtr<IDxcCompiler3> pCompiler;
+    CComPtr<IDxcIncludeHandler> pIncludeHandler;
+} DxcInstance;
+
+static DxcInstance g_dxc;
+static uint32 g_dxcVersion = 0;
 static uint32 isInitted = 0;
 
-Tk::Core::Vector<const wchar_t*> g_args;
+// Source hash of each shader file as of its last successful compile, used to skip unchanged shaders on hotload
+#define SHADER_SOURCE_HASH_SEED 0x54321
+#define MAX_INCLUDE_DEPTH 8
+
+typedef struct shader_source_record
+{
+    wchar_t filename[COMPILED_SHADER_FILENAME_MAX];
+    uint64 hash;
+} ShaderSourceRecord;
+static ShaderSourceRecord g_shaderSourceRecords[MAX_COMPILED_SHADERS] = {};
+static uint32 g_numShaderSourceRecords = 0;
 
 #ifdef _SHADERS_SRC_DIR
 #define SHADERS_SRC_DIR STRINGIFY(_SHADERS_SRC_DIR)
@@ -28,6 +50,21 @@ Tk::Core::Vector<const wchar_t*> g_args;
 #define SHADERS_SPV_DIR STRINGIFY(_SHADERS_SPV_DIR)
 #endif
 
+// Content addressed cache of compiled shaders, keyed on source + includes, compile flags and compiler version
+#define SHADER_CACHE_DIR SHADERS_SPV_DIR "ShaderCache\\"
+#define SHADER_CACHE_MAGIC 0x43534B54 // 'TKSC'
+
+typedef struct shader_cache_file_header
+{
+    uint32 magic;
+    uint32 spvSizeInBytes;
+    uint8 shaderHash[16];
+} ShaderCacheFileHeader;
+
+#define SHADER_FILEPATH_MAX 512
+#define MAX_COMPILE_THREADS 16u
+#define COMPILE_THREAD_STACK_SIZE 1024 * 1024 * 2
+
 namespace ShaderType
 {
 
@@ -47,7 +84,28 @@ static const char* ShaderFileSuffixRegexs[ShaderType::Max] =
     SHADERS_SRC_DIR "*_CS.hlsl",
 };
 
-// TODO: shader #defines
+// Permutation dimensions declared in a shader source, see SHADER_PERMUTATION_TOKEN
+#define MAX_SHADER_PERMUTATION_DIMS 4
+#define MAX_SHADER_PERMUTATION_VALUES 8
+#define SHADER_PERMUTATION_NAME_MAX 32
+#define SHADER_PERMUTATION_VALUE_MAX 16
+#define MAX_SHADER_VARIANTS 16 // per shader source
+#define SHADER_DEFINE_ARG_MAX (SHADER_PERMUTATION_NAME_MAX + SHADER_PERMUTATION_VALUE_MAX + 4)
+#define SHADER_VARIANT_KEY_SEED 0x7A3B91C5
+#define MAX_COMPILE_ARGS 48
+
+typedef struct shader_permutation_dim
+{
+    char name[SHADER_PERMUTATION_NAME_MAX];
+    char values[MAX_SHADER_PERMUTATION_VALUES][SHADER_PERMUTATION_VALUE_MAX];
+    uint32 numValues;
+} ShaderPermutationDim;
+
+typedef struct shader_permutations
+{
+    ShaderPermutationDim dims[MAX_SHADER_PERMUTATION_DIMS];
+    uint32 numDims;
+} ShaderPermutations;
 
 #define ENTRY_POINT_NAME_WCHAR L"main"
 
@@ -89,17 +147,517 @@ static void AppendArgs_(const wchar_t** argsToAppend, uint32 numArgsToAppend, Tk
 }
 #define AppendArgsToList(args, argsList) AppendArgs_(args, ARRAYCOUNT(args), argsList);
 
-static uint32 CompileFile(CComPtr<IDxcCompiler3> pCompiler, CComPtr<IDxcUtils> pUtils, CComPtr<IDxcIncludeHandler> pIncludeHandler, const wchar_t* args, uint32 numArgs, const wchar_t* shaderFilepath, const wchar_t* shaderFilenameWithExt)
+// Built once per shader type before any compile threads start, read only afterwards
+static Tk::Core::Vector<const wchar_t*> g_args[ShaderType::Max];
+static uint32 g_argsHash[ShaderType::Max] = {};
+
+typedef struct shader_compile_job
+{
+    wchar_t shaderFilepath[SHADER_FILEPATH_MAX];
+    const wchar_t* shaderFilenameWithExt; // points into shaderFilepath
+    char spvFilename[COMPILED_SHADER_FILENAME_MAX];
+    char baseSpvFilename[COMPILED_SHADER_FILENAME_MAX];
+    char defines[SHADER_VARIANT_DEFINES_MAX];
+    wchar_t defineArgs[MAX_SHADER_PERMUTATION_DIMS][SHADER_DEFINE_ARG_MAX]; // -DNAME=VALUE
+    uint32 numDefineArgs;
+    uint32 variantKey;
+    uint32 shaderType;
+    uint64 sourceHash;
+    uint64 cacheKey;
+    ShaderSourceRecord* record;
+    bool isDuplicate; // same cacheKey as an earlier job, run after the others so only one thread writes the cache file
+
+    // Outputs
+    uint32 errCode;
+    bool wroteSpv;
+    ShaderManifestEntry manifestEntry;
+} ShaderCompileJob;
+
+static ShaderCompileJob g_compileJobs[MAX_COMPILED_SHADERS] = {};
+static uint32 g_numCompileJobs = 0;
+static std::atomic<uint32> g_nextCompileJob = 0;
+
+static ShaderManifest g_manifest = {};
+
+static bool CreateDxcInstance(DxcInstance* outDxc)
+{
+    return !(FAILED(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&outDxc->pUtils))) ||
+             FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&outDxc->pCompiler))) ||
+             FAILED(outDxc->pUtils->CreateDefaultIncludeHandler(&outDxc->pIncludeHandler)));
+}
+
+static uint32 GetDxcVersion(CComPtr<IDxcCompiler3> pCompiler)
 {
+    uint32 major = 0, minor = 0, commitCount = 0;
+
+    CComPtr<IDxcVersionInfo> pVersionInfo = nullptr;
+    if (SUCCEEDED(pCompiler.QueryInterface(&pVersionInfo)) && pVersionInfo != nullptr)
+        pVersionInfo->GetVersion(&major, &minor);
+
+    CComPtr<IDxcVersionInfo2> pVersionInfo2 = nullptr;
+    if (SUCCEEDED(pCompiler.QueryInterface(&pVersionInfo2)) && pVersionInfo2 != nullptr)
+    {
+        char* commitHash = nullptr;
+        if (SUCCEEDED(pVersionInfo2->GetCommitInfo(&commitCount, &commitHash)) && commitHash)
+            CoTaskMemFree(commitHash);
+    }
+
+    const uint32 version[3] = { major, minor, commitCount };
+    return MurmurHash3_x86_32(version, (int)sizeof(version), SHADER_SOURCE_HASH_SEED);
+}
+
+static uint32 HashArgs(const Tk::Core::Vector<const wchar_t*>& args)
+{
+    uint32 hash = SHADER_SOURCE_HASH_SEED;
+    for (uint32 i = 0; i < args.Size(); ++i)
+    {
+        hash = MurmurHash3_x86_32(args[i], (int)(wcslen(args[i]) * sizeof(wchar_t)), hash);
+    }
+    return hash;
+}
+
+static ShaderSourceRecord* FindOrAddSourceRecord(const wchar_t* shaderFilenameWithExt)
+{
+    for (uint32 i = 0; i < g_numShaderSourceRecords; ++i)
+    {
+        if (wcscmp(g_shaderSourceRecords[i].filename, shaderFilenameWithExt) == 0)
+            return &g_shaderSourceRecords[i];
+    }
+
+    if (g_numShaderSourceRecords == MAX_COMPILED_SHADERS)
+        return nullptr;
+
+    ShaderSourceRecord* record = &g_shaderSourceRecords[g_numShaderSourceRecords++];
+    wcsncpy_s(record->filename, ARRAYCOUNT(record->filename), shaderFilenameWithExt, _TRUNCATE);
+    record->hash = 0;
+    return record;
+}
+
+// Index of the first character after the comment starting at i, or i if there is no comment there
+static uint32 SkipComment(const char* text, uint32 textLen, uint32 i)
+{
+    if (i + 1 >= textLen || text[i] != '/')
+        return i;
+
+    if (text[i + 1] == '/')
+    {
+        i += 2;
+        while (i < textLen && text[i] != '\n')
+            ++i;
+        return i;
+    }
+
+    if (text[i + 1] == '*')
+    {
+        i += 2;
+        while (i + 1 < textLen && !(text[i] == '*' && text[i + 1] == '/'))
+            ++i;
+        return Min(i + 2, textLen);
+    }
+
+    return i;
+}
+
+// Mixes the 128 bit hash of data into hash
+static uint64 CombineHash64(uint64 hash, const void* data, uint32 sizeInBytes)
+{
+    uint64 combined[3] = { hash, 0, 0 };
+    MurmurHash3_x64_128(data, (int)sizeInBytes, SHADER_SOURCE_HASH_SEED, &combined[1]);
+
+    uint64 result[2] = {};
+    MurmurHash3_x64_128(combined, (int)sizeof(combined), SHADER_SOURCE_HASH_SEED, result);
+    return result[0];
+}
+
+// Hashes the file contents plus the contents of every file it #includes with quotes, resolved against the shader source dir.
+// Each file is read and hashed once. Includes in comments are skipped. A file that can't be loaded hashes as its path mixed
+// into hash, so that it still changes the hash without discarding what was hashed before it.
+static uint64 HashShaderSource(CComPtr<IDxcUtils> pUtils, const wchar_t* shaderFilepath, uint64 hash, uint32 depth)
+{
+    if (depth > MAX_INCLUDE_DEPTH)
+        return hash;
+
     CComPtr<IDxcBlobEncoding> pSource = nullptr;
-    pUtils->LoadFile((LPCWSTR)shaderFilepath, nullptr, &pSource);
+    if (FAILED(pUtils->LoadFile((LPCWSTR)shaderFilepath, nullptr, &pSource)) || pSource == nullptr)
+        return CombineHash64(hash, shaderFilepath, (uint32)(wcslen(shaderFilepath) * sizeof(wchar_t)));
+
+    const char* sourceText = (const char*)pSource->GetBufferPointer();
+    const uint32 sourceLen = (uint32)pSource->GetBufferSize();
+    hash = CombineHash64(hash, sourceText, sourceLen);
+
+    static const char includeToken[] = "#include";
+    const uint32 includeTokenLen = ARRAYCOUNT(includeToken) - 1;
+    for (uint32 i = 0; i + includeTokenLen < sourceLen; ++i)
+    {
+        const uint32 commentEnd = SkipComment(sourceText, sourceLen, i);
+        if (commentEnd != i)
+        {
+            // The loop increment steps past the last character of the comment
+            i = commentEnd - 1;
+            continue;
+        }
+
+        if (memcmp(&sourceText[i], includeToken, includeTokenLen) != 0)
+            continue;
+
+        // Find the quoted include name on the same line
+        uint32 nameStart = i + includeTokenLen;
+        while (nameStart < sourceLen && sourceText[nameStart] == ' ')
+            ++nameStart;
+        if (nameStart >= sourceLen || sourceText[nameStart] != '"')
+            continue;
+        ++nameStart;
+
+        uint32 nameEnd = nameStart;
+        while (nameEnd < sourceLen && sourceText[nameEnd] != '"' && sourceText[nameEnd] != '\n')
+            ++nameEnd;
+        if (nameEnd >= sourceLen || sourceText[nameEnd] != '"')
+            continue;
+
+        Tk::Core::StrFixedBuffer<2048> includeFilepath;
+        includeFilepath.Clear();
+        includeFilepath.Append(SHADERS_SRC_DIR);
+        includeFilepath.Append(&sourceText[nameStart], nameEnd - nameStart);
+        includeFilepath.NullTerminate();
+
+        wchar_t includeFilepathW[2048] = {};
+        size_t numCharsWritten = 0;
+        mbstowcs_s(&numCharsWritten, includeFilepathW, ARRAYCOUNT(includeFilepathW), includeFilepath.m_data, _TRUNCATE);
+
+        // A missing include still changes the hash, and the compile will report it
+        hash = HashShaderSource(pUtils, includeFilepathW, hash, depth + 1);
+        i = nameEnd;
+    }
+
+    return hash;
+}
+
+// blit_VS.hlsl -> blit_VS.spv
+static void GetSpvFilename(const wchar_t* shaderFilenameWithExt, char* outSpvFilename, uint32 outSpvFilenameMax)
+{
+    static const uint32 hlslExtLen = 4;
+    const uint32 shaderFilenameNoExtLen = (uint32)wcslen(shaderFilenameWithExt) - hlslExtLen;
+
+    size_t numCharsWritten = 0;
+    wcstombs_s(&numCharsWritten, outSpvFilename, outSpvFilenameMax, shaderFilenameWithExt, shaderFilenameNoExtLen);
+    strcat_s(outSpvFilename, outSpvFilenameMax, "spv");
+}
+
+static bool IsPermutationSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Reads the permutation dimensions declared in a shader source. Malformed declarations are reported and ignored.
+static void ParseShaderPermutations(CComPtr<IDxcUtils> pUtils, const wchar_t* shaderFilepath, ShaderPermutations* outPermutations)
+{
+    outPermutations->numDims = 0;
+
+    CComPtr<IDxcBlobEncoding> pSource = nullptr;
+    if (FAILED(pUtils->LoadFile((LPCWSTR)shaderFilepath, nullptr, &pSource)) || pSource == nullptr)
+        return;
+
+    const char* sourceText = (const char*)pSource->GetBufferPointer();
+    const uint32 sourceLen = (uint32)pSource->GetBufferSize();
+    const uint32 tokenLen = (uint32)sizeof(SHADER_PERMUTATION_TOKEN) - 1;
+
+    uint32 lineStart = 0;
+    while (lineStart < sourceLen)
+    {
+        uint32 lineEnd = lineStart;
+        while (lineEnd < sourceLen && sourceText[lineEnd] != '\n')
+            ++lineEnd;
+
+        uint32 i = lineStart;
+        while (i < lineEnd && IsPermutationSpace(sourceText[i]))
+            ++i;
+
+        if (lineEnd - i > tokenLen && memcmp(&sourceText[i], SHADER_PERMUTATION_TOKEN, tokenLen) == 0 &&
+            IsPermutationSpace(sourceText[i + tokenLen]))
+        {
+            i += tokenLen;
+
+            // Dimension name, then its values
+            ShaderPermutationDim dim = {};
+            bool isValid = true;
+            bool hasName = false;
+            while (true)
+            {
+                while (i < lineEnd && IsPermutationSpace(sourceText[i]))
+                    ++i;
+                const uint32 wordStart = i;
+                while (i < lineEnd && !IsPermutationSpace(sourceText[i]))
+                    ++i;
+
+                const uint32 wordLen = i - wordStart;
+                if (!wordLen)
+                    break;
+
+                if (!hasName)
+                {
+                    if (wordLen >= SHADER_PERMUTATION_NAME_MAX)
+                    {
+                        isValid = false;
+                        break;
+                    }
+                    memcpy(dim.name, &sourceText[wordStart], wordLen);
+                    hasName = true;
+                }
+                else
+                {
+                    if (dim.numValues == MAX_SHADER_PERMUTATION_VALUES || wordLen >= SHADER_PERMUTATION_VALUE_MAX)
+                    {
+                        isValid = false;
+                        break;
+                    }
+                    memcpy(dim.values[dim.numValues++], &sourceText[wordStart], wordLen);
+                }
+            }
+
+            if (!isValid || !dim.numValues || outPermutations->numDims == MAX_SHADER_PERMUTATION_DIMS)
+                printf("Ignoring invalid permutation in %ls\n", shaderFilepath);
+            else
+                outPermutations->dims[outPermutations->numDims++] = dim;
+        }
+
+        lineStart = lineEnd + 1;
+    }
+}
+
+// 0 if there are more than MAX_SHADER_VARIANTS combinations
+static uint32 GetNumShaderVariants(const ShaderPermutations& permutations)
+{
+    uint32 numVariants = 1;
+    for (uint32 uiDim = 0; uiDim < permutations.numDims; ++uiDim)
+    {
+        numVariants *= permutations.dims[uiDim].numValues;
+        if (numVariants > MAX_SHADER_VARIANTS)
+            return 0;
+    }
+    return numVariants;
+}
+
+// The variant index is a mixed radix number with a digit per dimension, so variant 0 is the default variant
+static void SetShaderVariantDefines(const ShaderPermutations& permutations, uint32 variantIndex, ShaderCompileJob& job)
+{
+    job.defines[0] = '\0';
+    job.numDefineArgs = 0;
+
+    for (uint32 uiDim = 0; uiDim < permutations.numDims; ++uiDim)
+    {
+        const ShaderPermutationDim& dim = permutations.dims[uiDim];
+        const char* value = dim.values[variantIndex % dim.numValues];
+        variantIndex /= dim.numValues;
+
+        char define[SHADER_DEFINE_ARG_MAX] = {};
+        sprintf_s(define, ARRAYCOUNT(define), "%s=%s", dim.name, value);
+        if (uiDim > 0)
+            strcat_s(job.defines, ARRAYCOUNT(job.defines), " ");
+        strcat_s(job.defines, ARRAYCOUNT(job.defines), define);
+
+        swprintf_s(job.defineArgs[job.numDefineArgs++], SHADER_DEFINE_ARG_MAX, L"-D%hs", define);
+    }
+}
+
+static uint32 GetShaderVariantKey(const char* defines, uint32 variantIndex)
+{
+    if (variantIndex == 0)
+        return SHADER_VARIANT_KEY_DEFAULT;
+
+    const uint32 key = MurmurHash3_x86_32(defines, (int)strlen(defines), SHADER_VARIANT_KEY_SEED);
+    return key == SHADER_VARIANT_KEY_DEFAULT ? 1 : key;
+}
+
+// bench_reduce_CS.spv -> bench_reduce_CS_1f2e3d4c.spv, the default variant keeps the plain name
+static void GetVariantSpvFilename(const char* baseSpvFilename, uint32 variantKey, char* outSpvFilename, uint32 outSpvFilenameMax)
+{
+    if (variantKey == SHADER_VARIANT_KEY_DEFAULT)
+    {
+        strcpy_s(outSpvFilename, outSpvFilenameMax, baseSpvFilename);
+        return;
+    }
+
+    static const uint32 spvExtLen = 4; // ".spv"
+    const int baseNameLen = (int)strlen(baseSpvFilename) - (int)spvExtLen;
+    sprintf_s(outSpvFilename, outSpvFilenameMax, "%.*s_%08x.spv", baseNameLen, baseSpvFilename, variantKey);
+}
+
+static void GetSpvFilepath(const char* spvFilename, Tk::Core::StrFixedBuffer<2048>& outFilepath)
+{
+    outFilepath.Clear();
+    outFilepath.Append(SHADERS_SPV_DIR);
+    outFilepath.Append(spvFilename);
+    outFilepath.NullTerminate();
+}
+
+static void GetCacheFilepath(uint64 cacheKey, Tk::Core::StrFixedBuffer<2048>& outFilepath)
+{
+    char keyStr[32] = {};
+    sprintf_s(keyStr, ARRAYCOUNT(keyStr), "%016llx.spv", cacheKey);
+
+    outFilepath.Clear();
+    outFilepath.Append(SHADER_CACHE_DIR);
+    outFilepath.Append(keyStr);
+    outFilepath.NullTerminate();
+}
+
+static CComPtr<IDxcBlobEncoding> LoadFileIfExists(CComPtr<IDxcUtils> pUtils, const char* filepath)
+{
+    wchar_t filepathW[2048] = {};
+    size_t numCharsWritten = 0;
+    mbstowcs_s(&numCharsWritten, filepathW, ARRAYCOUNT(filepathW), filepath, _TRUNCATE);
+
+    CComPtr<IDxcBlobEncoding> pBlob = nullptr;
+    if (FAILED(pUtils->LoadFile((LPCWSTR)filepathW, nullptr, &pBlob)))
+        return nullptr;
+    return pBlob;
+}
+
+static bool ParseManifest(const uint8* data, uint32 sizeInBytes, ShaderManifest* outManifest)
+{
+    const uint32 headerSize = (uint32)offsetof(ShaderManifest, entries);
+    if (sizeInBytes < headerSize)
+        return false;
+
+    const ShaderManifest* manifest = (const ShaderManifest*)data;
+    if (manifest->magic != SHADER_MANIFEST_MAGIC || manifest->version != SHADER_MANIFEST_VERSION ||
+        manifest->numEntries > MAX_COMPILED_SHADERS ||
+        sizeInBytes != headerSize + manifest->numEntries * sizeof(ShaderManifestEntry))
+        return false;
+
+    memcpy(outManifest, data, sizeInBytes);
+    return true;
+}
+
+static const ShaderManifestEntry* FindManifestEntry(const ShaderManifest& manifest, const char* spvFilename)
+{
+    for (uint32 i = 0; i < manifest.numEntries; ++i)
+    {
+        if (strcmp(manifest.entries[i].spvFilename, spvFilename) == 0)
+            return &manifest.entries[i];
+    }
+    return nullptr;
+}
+
+static uint32 WriteManifest(const ShaderManifest& manifest)
+{
+    Tk::Core::StrFixedBuffer<2048> manifestFilepath;
+    GetSpvFilepath(SHADER_MANIFEST_FILENAME, manifestFilepath);
+
+    const uint32 sizeInBytes = (uint32)(offsetof(ShaderManifest, entries) + manifest.numEntries * sizeof(ShaderManifestEntry));
+    return Tk::Platform::WriteEntireFile(manifestFilepath.m_data, sizeInBytes, (uint8*)&manifest);
+}
+
+uint64 HashSpvContent(const void* spv, uint32 sizeInBytes)
+{
+    uint64 hash[2] = {};
+    MurmurHash3_x64_128(spv, (int)sizeInBytes, SHADER_SOURCE_HASH_SEED, hash);
+    return hash[0];
+}
+
+static uint32 AlignArchiveOffset(uint32 offset)
+{
+    return (offset + SHADER_ARCHIVE_BLOB_ALIGNMENT - 1) & ~(SHADER_ARCHIVE_BLOB_ALIGNMENT - 1);
+}
+
+// Packs the spv files of every manifest entry into the shader archive, deduplicating identical bytecode
+static uint32 WriteArchive(const ShaderManifest& manifest)
+{
+    CComPtr<IDxcBlobEncoding> spvBlobs[MAX_COMPILED_SHADERS];
+    ShaderArchiveEntry entries[MAX_COMPILED_SHADERS];
+    uint32 entryBlobs[MAX_COMPILED_SHADERS] = {}; // index of the entry that owns the blob
+    uint32 numEntries = 0;
+    uint32 numBlobs = 0;
+
+    for (uint32 uiEntry = 0; uiEntry < manifest.numEntries; ++uiEntry)
+    {
+        Tk::Core::StrFixedBuffer<2048> spvFilepath;
+        GetSpvFilepath(manifest.entries[uiEntry].spvFilename, spvFilepath);
+        CComPtr<IDxcBlobEncoding> pSpv = LoadFileIfExists(g_dxc.pUtils, spvFilepath.m_data);
+        if (pSpv == nullptr || !pSpv->GetBufferSize())
+        {
+            printf("Missing spv file, leaving it out of the shader archive: %s\n", spvFilepath.m_data);
+            continue;
+        }
+
+        ShaderArchiveEntry& entry = entries[numEntries];
+        memset(&entry, 0, sizeof(entry));
+        strcpy_s(entry.spvFilename, ARRAYCOUNT(entry.spvFilename), manifest.entries[uiEntry].spvFilename);
+        entry.blobSizeInBytes = (uint32)pSpv->GetBufferSize();
+        entry.contentHash = HashSpvContent(pSpv->GetBufferPointer(), entry.blobSizeInBytes);
+        spvBlobs[numEntries] = pSpv;
+
+        uint32 owner = numEntries;
+        for (uint32 uiPrev = 0; uiPrev < numEntries; ++uiPrev)
+        {
+            if (entries[uiPrev].contentHash == entry.contentHash && entries[uiPrev].blobSizeInBytes == entry.blobSizeInBytes &&
+                memcmp(spvBlobs[uiPrev]->GetBufferPointer(), pSpv->GetBufferPointer(), entry.blobSizeInBytes) == 0)
+            {
+                owner = entryBlobs[uiPrev];
+                break;
+            }
+        }
+        entryBlobs[numEntries] = owner;
+        if (owner == numEntries)
+            ++numBlobs;
+        ++numEntries;
+    }
+
+    // Blob offsets, shared blobs take the offset of the entry that owns them
+    uint32 sizeInBytes = AlignArchiveOffset((uint32)sizeof(ShaderArchiveHeader) + numEntries * (uint32)sizeof(ShaderArchiveEntry));
+    for (uint32 uiEntry = 0; uiEntry < numEntries; ++uiEntry)
+    {
+        if (entryBlobs[uiEntry] == uiEntry)
+        {
+            entries[uiEntry].blobOffset = sizeInBytes;
+            sizeInBytes = AlignArchiveOffset(sizeInBytes + entries[uiEntry].blobSizeInBytes);
+        }
+        else
+        {
+            entries[uiEntry].blobOffset = entries[entryBlobs[uiEntry]].blobOffset;
+        }
+    }
+
+    uint8* archive = (uint8*)Tk::Core::CoreMalloc(sizeInBytes);
+    if (!archive)
+        return 1;
+    memset(archive, 0, sizeInBytes);
+
+    ShaderArchiveHeader* header = (ShaderArchiveHeader*)archive;
+    header->magic = SHADER_ARCHIVE_MAGIC;
+    header->version = SHADER_ARCHIVE_VERSION;
+    header->numEntries = numEntries;
+    header->numBlobs = numBlobs;
+    memcpy(header + 1, entries, numEntries * sizeof(ShaderArchiveEntry));
+    for (uint32 uiEntry = 0; uiEntry < numEntries; ++uiEntry)
+    {
+        if (entryBlobs[uiEntry] == uiEntry)
+            memcpy(archive + entries[uiEntry].blobOffset, spvBlobs[uiEntry]->GetBufferPointer(), entries[uiEntry].blobSizeInBytes);
+    }
+
+    Tk::Core::StrFixedBuffer<2048> archiveFilepath;
+    GetSpvFilepath(SHADER_ARCHIVE_FILENAME, archiveFilepath);
+    const uint32 fileErr = Tk::Platform::WriteEntireFile(archiveFilepath.m_data, sizeInBytes, archive);
+    Tk::Core::CoreFree(archive);
+
+    if (!fileErr)
+        printf("Wrote shader archive: %u shaders, %u unique, %u bytes\n", numEntries, numBlobs, sizeInBytes);
+    return fileErr;
+}
+
+static uint32 CompileFile(const DxcInstance& dxc, const wchar_t* const* args, uint32 numArgs, const wchar_t* shaderFilepath, CComPtr<IDxcBlob>& outShader, uint8* outShaderHash)
+{
+    CComPtr<IDxcBlobEncoding> pSource = nullptr;
+    if (FAILED(dxc.pUtils->LoadFile((LPCWSTR)shaderFilepath, nullptr, &pSource)) || pSource == nullptr)
+        return ErrCode::NonShaderError;
+
     DxcBuffer Source;
     Source.Ptr = pSource->GetBufferPointer();
     Source.Size = pSource->GetBufferSize();
     Source.Encoding = DXC_CP_ACP;
 
     CComPtr<IDxcResult> pResults;
-    HRESULT compileStatus = pCompiler->Compile(&Source, (LPCWSTR*)args, numArgs, pIncludeHandler, IID_PPV_ARGS(&pResults));
+    HRESULT compileStatus = dxc.pCompiler->Compile(&Source, (LPCWSTR*)args, numArgs, dxc.pIncludeHandler, IID_PPV_ARGS(&pResults));
     if (FAILED(compileStatus))
     {
         // Something bad happened inside DXC
@@ -107,124 +665,284 @@ static uint32 CompileFile(CComPtr<IDxcCompiler3> pCompiler, CComPtr<IDxcUtils> p
         return ErrCode::HasErrors;
     }
 
-    uint32 errCode = ErrCode::HasErrors;
-
     CComPtr<IDxcBlobUtf8> pErrors = nullptr;
     pResults->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&pErrors), nullptr);
 
     if (pErrors != nullptr && pErrors->GetStringLength() != 0)
     {
-        printf("Warnings and Errors:\n%s\n", pErrors->GetStringPointer());
+        printf("%ls - Warnings and Errors:\n%s\n", shaderFilepath, pErrors->GetStringPointer());
         return ErrCode::HasErrors;
     }
     
     // Compilation succeeded
-    errCode = ErrCode::Success;
     // TODO: figure out how to determine if the shader has only warnings
 
-    // Get shader hash
+    // Shader hash goes in the manifest, so the runtime can tell whether two shaders are identical
+    memset(outShaderHash, 0, sizeof(DxcShaderHash::HashDigest));
     CComPtr<IDxcBlob> pHash = nullptr;
     if (SUCCEEDED(pResults->GetOutput(DXC_OUT_SHADER_HASH, IID_PPV_ARGS(&pHash), nullptr)) && pHash != nullptr)
     {
-        DxcShaderHash* pHashBuf = (DxcShaderHash*)pHash->GetBufferPointer();
-        // TODO: do something with it
+        const DxcShaderHash* pHashBuf = (const DxcShaderHash*)pHash->GetBufferPointer();
+        memcpy(outShaderHash, pHashBuf->HashDigest, sizeof(pHashBuf->HashDigest));
     }
 
-    CComPtr<IDxcBlob> pShader = nullptr;
-    if (SUCCEEDED(pResults->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pShader), nullptr)) && pShader != nullptr)
-    {
-        // For now, just write out the spv file
-        static const uint32 filepathMax = 2048;
-        Tk::Core::StrFixedBuffer<2048> shaderFilepathSpv;
-        shaderFilepathSpv.Clear();
-        shaderFilepathSpv.Append(SHADERS_SPV_DIR);
-        char* shaderFilenameSpvStart = shaderFilepathSpv.EndOfStrPtr();
-
-        // Remove .hlsl ext, replace with .spv
-        static const char* hlslExt = "hlsl";
-        const uint32 hlslExtLen = (uint32)strlen(hlslExt);
-        uint32 shaderFilenameNoExtLen = (uint32)wcslen(shaderFilenameWithExt) - hlslExtLen;
-        shaderFilepathSpv.AppendWChar(shaderFilenameWithExt, shaderFilenameNoExtLen);
-
-        // Complete string with .spv extension and null terminator
-        shaderFilepathSpv.Append("spv");
-        shaderFilepathSpv.NullTerminate();
-        uint32 fileErr = Tk::Platform::WriteEntireFile(shaderFilepathSpv.m_data, (uint32)pShader->GetBufferSize(), (uint8*)pShader->GetBufferPointer());
-        if (!fileErr)
+    if (FAILED(pResults->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&outShader), nullptr)) || outShader == nullptr)
+        return ErrCode::NonShaderError;
+
+    return ErrCode::Success;
+}
+
+// Header then bytecode, written straight from the compiler output. Runs on the compile threads, so no heap copy.
+static bool WriteCacheFile(const char* filepath, const ShaderCacheFileHeader& header, const void* spv, uint32 spvSizeInBytes)
+{
+    HANDLE fileHandle = CreateFileA(filepath, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    DWORD numHeaderBytesWritten = 0;
+    DWORD numSpvBytesWritten = 0;
+    const bool bOk = WriteFile(fileHandle, &header, (DWORD)sizeof(header), &numHeaderBytesWritten, 0) && numHeaderBytesWritten == sizeof(header) &&
+        WriteFile(fileHandle, spv, spvSizeInBytes, &numSpvBytesWritten, 0) && numSpvBytesWritten == spvSizeInBytes;
+    CloseHandle(fileHandle);
+
+    // A partial file would only fail validation later, but don't leave it around
+    if (!bOk)
+        DeleteFileA(filepath);
+    return bOk;
+}
+
+static void ProcessCompileJob(const DxcInstance& dxc, ShaderCompileJob& job)
+{
+    job.errCode = ErrCode::Success;
+    job.wroteSpv = false;
+
+    ShaderManifestEntry& entry = job.manifestEntry;
+    memset(&entry, 0, sizeof(entry));
+    strcpy_s(entry.spvFilename, ARRAYCOUNT(entry.spvFilename), job.spvFilename);
+    strcpy_s(entry.baseSpvFilename, ARRAYCOUNT(entry.baseSpvFilename), job.baseSpvFilename);
+    strcpy_s(entry.defines, ARRAYCOUNT(entry.defines), job.defines);
+    entry.cacheKey = job.cacheKey;
+    entry.variantKey = job.variantKey;
+
+    Tk::Core::StrFixedBuffer<2048> spvFilepath;
+    GetSpvFilepath(job.spvFilename, spvFilepath);
+
+    // Output is already up to date, nothing to write
+    const ShaderManifestEntry* prevEntry = FindManifestEntry(g_manifest, job.spvFilename);
+    if (prevEntry && prevEntry->cacheKey == job.cacheKey)
+    {
+        CComPtr<IDxcBlobEncoding> pExistingSpv = LoadFileIfExists(dxc.pUtils, spvFilepath.m_data);
+        if (pExistingSpv != nullptr && pExistingSpv->GetBufferSize() == prevEntry->spvSizeInBytes)
         {
-            printf("Wrote: %s\n", shaderFilepathSpv.m_data);
+            entry = *prevEntry;
+            return;
         }
-        else
+    }
+
+    Tk::Core::StrFixedBuffer<2048> cacheFilepath;
+    GetCacheFilepath(job.cacheKey, cacheFilepath);
+
+    uint32 fileErr = 0;
+
+    // Seen this exact source, flags and compiler before
+    CComPtr<IDxcBlobEncoding> pCached = LoadFileIfExists(dxc.pUtils, cacheFilepath.m_data);
+    if (pCached != nullptr && pCached->GetBufferSize() > sizeof(ShaderCacheFileHeader))
+    {
+        const ShaderCacheFileHeader* cacheHeader = (const ShaderCacheFileHeader*)pCached->GetBufferPointer();
+        if (cacheHeader->magic == SHADER_CACHE_MAGIC &&
+            cacheHeader->spvSizeInBytes == pCached->GetBufferSize() - sizeof(ShaderCacheFileHeader))
         {
-            errCode = ErrCode::NonShaderError;
-            printf("Error writing spv file: %s\n", shaderFilepathSpv.m_data);
+            printf("Cache hit: %ls %s\n", job.shaderFilenameWithExt, job.defines);
+
+            entry.spvSizeInBytes = cacheHeader->spvSizeInBytes;
+            memcpy(entry.shaderHash, cacheHeader->shaderHash, sizeof(entry.shaderHash));
+
+            fileErr = Tk::Platform::WriteEntireFile(spvFilepath.m_data, entry.spvSizeInBytes, (uint8*)(cacheHeader + 1));
+            job.errCode = fileErr ? ErrCode::NonShaderError : ErrCode::Success;
+            job.wroteSpv = !fileErr;
+            return;
         }
     }
 
-    return errCode;
+    printf("Compiling: %ls %s...\n", job.shaderFilenameWithExt, job.defines);
+
+    // Common args for the shader type, then the variant's defines
+    const Tk::Core::Vector<const wchar_t*>& typeArgs = g_args[job.shaderType];
+    const wchar_t* args[MAX_COMPILE_ARGS] = {};
+    uint32 numArgs = 0;
+    TINKER_ASSERT(typeArgs.Size() + job.numDefineArgs <= MAX_COMPILE_ARGS);
+    for (uint32 i = 0; i < typeArgs.Size(); ++i)
+        args[numArgs++] = typeArgs[i];
+    for (uint32 i = 0; i < job.numDefineArgs; ++i)
+        args[numArgs++] = job.defineArgs[i];
+
+    CComPtr<IDxcBlob> pShader = nullptr;
+    job.errCode = CompileFile(dxc, args, numArgs, job.shaderFilepath, pShader, entry.shaderHash);
+    if (job.errCode != ErrCode::Success && job.errCode != ErrCode::HasWarnings)
+        return;
+
+    entry.spvSizeInBytes = (uint32)pShader->GetBufferSize();
+
+    fileErr = Tk::Platform::WriteEntireFile(spvFilepath.m_data, entry.spvSizeInBytes, (uint8*)pShader->GetBufferPointer());
+    if (!fileErr)
+    {
+        printf("Wrote: %s\n", spvFilepath.m_data);
+        job.wroteSpv = true;
+    }
+    else
+    {
+        job.errCode = ErrCode::NonShaderError;
+        printf("Error writing spv file: %s\n", spvFilepath.m_data);
+        return;
+    }
+
+    // Populate the cache. A failure here only costs a recompile next time.
+    ShaderCacheFileHeader cacheHeader = {};
+    cacheHeader.magic = SHADER_CACHE_MAGIC;
+    cacheHeader.spvSizeInBytes = entry.spvSizeInBytes;
+    memcpy(cacheHeader.shaderHash, entry.shaderHash, sizeof(cacheHeader.shaderHash));
+    WriteCacheFile(cacheFilepath.m_data, cacheHeader, pShader->GetBufferPointer(), entry.spvSizeInBytes);
 }
 
-uint32 Init()
+static unsigned __stdcall CompileThreadFunction(void* arg)
 {
-    g_args.Reserve(32);
-    if (!(FAILED(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&g_pUtils))) ||
-          FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&g_pCompiler))) ||
-          FAILED(g_pUtils->CreateDefaultIncludeHandler(&g_pIncludeHandler))))
+    const DxcInstance* sharedDxc = (const DxcInstance*)arg;
+
+    // The calling thread reuses the global instance, every other thread gets its own
+    DxcInstance threadDxc;
+    if (!sharedDxc)
     {
-        isInitted = 1;
-        return ErrCode::Success;
+        if (!CreateDxcInstance(&threadDxc))
+            return 1;
     }
-    else
+    const DxcInstance& dxc = sharedDxc ? *sharedDxc : threadDxc;
+
+    while (true)
     {
-        isInitted = 0;
-        return ErrCode::NonShaderError;
+        const uint32 jobIndex = g_nextCompileJob.fetch_add(1);
+        if (jobIndex >= g_numCompileJobs)
+            break;
+        if (!g_compileJobs[jobIndex].isDuplicate)
+            ProcessCompileJob(dxc, g_compileJobs[jobIndex]);
     }
+    return 0;
 }
 
-uint32 CompileAllShadersDX()
+static void RunCompileJobs()
 {
-    printf("DX codepath not implemented yet :)");
-    return ErrCode::NonShaderError;
+    SYSTEM_INFO systemInfo = {};
+    GetSystemInfo(&systemInfo);
+    const uint32 numThreads = Min(Min((uint32)systemInfo.dwNumberOfProcessors, MAX_COMPILE_THREADS), g_numCompileJobs);
+
+    g_nextCompileJob = 0;
+
+    HANDLE threadHandles[MAX_COMPILE_THREADS] = {};
+    uint32 numThreadsStarted = 0;
+    for (uint32 i = 1; i < numThreads; ++i)
+    {
+        HANDLE threadHandle = (HANDLE)_beginthreadex(nullptr, COMPILE_THREAD_STACK_SIZE, CompileThreadFunction, nullptr, 0, nullptr);
+        if (threadHandle)
+            threadHandles[numThreadsStarted++] = threadHandle;
+    }
+
+    // Assist on this thread too, which also guarantees progress if no worker could start
+    CompileThreadFunction(&g_dxc);
+
+    if (numThreadsStarted)
+    {
+        WaitForMultipleObjects(numThreadsStarted, threadHandles, TRUE, INFINITE);
+        for (uint32 i = 0; i < numThreadsStarted; ++i)
+            CloseHandle(threadHandles[i]);
+    }
+
+    // Usually cache hits now that the first job with the same key is done
+    for (uint32 uiJob = 0; uiJob < g_numCompileJobs; ++uiJob)
+    {
+        if (g_compileJobs[uiJob].isDuplicate)
+            ProcessCompileJob(g_dxc, g_compileJobs[uiJob]);
+    }
 }
 
-uint32 CompileAllShadersVK()
+static uint32 CompileShadersVK(bool onlyChanged, bool hashOnly, CompiledShaderList* outCompiledShaders)
 {
     if (!isInitted)
         return ErrCode::NonShaderError;
-    
-    // Start compilation
-    uint32 errorCode = ErrCode::Success;
 
-    // NOTE: only need this due to char -> w_char games
-    wchar_t currShaderFilepath[2048] = {};
-    uint32 filenameMax = ARRAYCOUNT(currShaderFilepath);
-    size_t numCharsWritten = 0;
-    mbstowcs_s(&numCharsWritten, currShaderFilepath, ARRAYCOUNT(currShaderFilepath), SHADERS_SRC_DIR, strlen(SHADERS_SRC_DIR));
-    --numCharsWritten; // We are going to overwrite the null terminator
-    uint32 numCharsRemaining = filenameMax - (uint32)numCharsWritten;
-    wchar_t* shaderFilenameStart = &currShaderFilepath[numCharsWritten];
+    if (outCompiledShaders)
+        outCompiledShaders->numShaders = 0;
 
+    // Gather the shaders to compile
+    g_numCompileJobs = 0;
+    uint32 numSkipped = 0;
     for (uint32 uiShaderType = 0; uiShaderType < ShaderType::Max; ++uiShaderType)
     {
-        g_args.Clear();
-        AppendArgsToList(CompileFlags_Common, g_args);
-        AppendArgsToList(CompileFlags_VkSpecific, g_args);
-        AppendArgsToList(CompileFlags_ShaderSpecific[uiShaderType], g_args);
+        wchar_t currShaderFilepath[SHADER_FILEPATH_MAX] = {};
+        size_t numCharsWritten = 0;
+        mbstowcs_s(&numCharsWritten, currShaderFilepath, ARRAYCOUNT(currShaderFilepath), SHADERS_SRC_DIR, strlen(SHADERS_SRC_DIR));
+        --numCharsWritten; // We are going to overwrite the null terminator
+        const uint32 numCharsRemaining = SHADER_FILEPATH_MAX - (uint32)numCharsWritten;
+        wchar_t* shaderFilenameStart = &currShaderFilepath[numCharsWritten];
 
         Tk::Platform::FileHandle findFileHandle = Tk::Platform::FindFileOpen(ShaderFileSuffixRegexs[uiShaderType], shaderFilenameStart, numCharsRemaining);
         uint32 findFileError = findFileHandle.h == findFileHandle.eInvalidValue;
         while (!findFileError)
         {
-            printf("\nCompiling: %ls...\n", shaderFilenameStart);
+            const uint64 sourceHash = HashShaderSource(g_dxc.pUtils, currShaderFilepath, SHADER_SOURCE_HASH_SEED, 0);
+            ShaderSourceRecord* record = FindOrAddSourceRecord(shaderFilenameStart);
 
-            uint32 compileError = CompileFile(g_pCompiler, g_pUtils, g_pIncludeHandler, (const wchar_t*)g_args.Data(), g_args.Size(), currShaderFilepath, shaderFilenameStart);
-            if (compileError == ErrCode::Success || compileError == ErrCode::HasWarnings)
+            if (hashOnly)
             {
-                // TODO: add entry to hashmap for material library, get the bytecode from the compile call
+                if (record)
+                    record->hash = sourceHash;
+            }
+            else if (onlyChanged && record && record->hash == sourceHash)
+            {
+                ++numSkipped;
             }
             else
             {
-                errorCode = compileError;
+                // Every variant is its own job, so they all compile in parallel
+                ShaderPermutations permutations;
+                ParseShaderPermutations(g_dxc.pUtils, currShaderFilepath, &permutations);
+                const uint32 numVariants = GetNumShaderVariants(permutations);
+                if (!numVariants)
+                {
+                    printf("Too many variants (max %u), skipping: %ls\n", MAX_SHADER_VARIANTS, shaderFilenameStart);
+                }
+                else if (g_numCompileJobs + numVariants > MAX_COMPILED_SHADERS)
+                {
+                    printf("Too many shaders, skipping: %ls\n", shaderFilenameStart);
+                }
+                else
+                {
+                    for (uint32 uiVariant = 0; uiVariant < numVariants; ++uiVariant)
+                    {
+                        ShaderCompileJob& job = g_compileJobs[g_numCompileJobs++];
+                        memcpy(job.shaderFilepath, currShaderFilepath, sizeof(currShaderFilepath));
+                        job.shaderFilenameWithExt = &job.shaderFilepath[numCharsWritten];
+                        GetSpvFilename(job.shaderFilenameWithExt, job.baseSpvFilename, ARRAYCOUNT(job.baseSpvFilename));
+                        SetShaderVariantDefines(permutations, uiVariant, job);
+                        job.variantKey = GetShaderVariantKey(job.defines, uiVariant);
+                        GetVariantSpvFilename(job.baseSpvFilename, job.variantKey, job.spvFilename, ARRAYCOUNT(job.spvFilename));
+                        job.shaderType = uiShaderType;
+                        job.sourceHash = sourceHash;
+                        job.record = record;
+
+                        const uint32 definesHash = MurmurHash3_x86_32(job.defines, (int)strlen(job.defines), SHADER_VARIANT_KEY_SEED);
+                        const uint32 keyData[3] = { g_argsHash[uiShaderType], g_dxcVersion, definesHash };
+                        job.cacheKey = CombineHash64(sourceHash, keyData, (uint32)sizeof(keyData));
+
+                        job.isDuplicate = false;
+                        for (uint32 uiPrevJob = 0; uiPrevJob < g_numCompileJobs - 1; ++uiPrevJob)
+                        {
+                            if (g_compileJobs[uiPrevJob].cacheKey == job.cacheKey)
+                            {
+                                job.isDuplicate = true;
+                                break;
+                            }
+                        }
+                    }
+                }
             }
 
             // Reset shader name but keep base path
@@ -234,8 +952,179 @@ uint32 CompileAllShadersVK()
         Tk::Platform::FindFileClose(findFileHandle);
     }
 
+    if (hashOnly || !g_numCompileJobs)
+    {
+        if (onlyChanged)
+            printf("\nSkipped %u unchanged shaders.\n", numSkipped);
+        return ErrCode::Success;
+    }
+
+    RunCompileJobs();
+
+    // Gather results in a deterministic order and update the manifest
+    uint32 errorCode = ErrCode::Success;
+    for (uint32 uiJob = 0; uiJob < g_numCompileJobs; ++uiJob)
+    {
+        const ShaderCompileJob& job = g_compileJobs[uiJob];
+        if (job.errCode != ErrCode::Success && job.errCode != ErrCode::HasWarnings)
+        {
+            // Hash is not remembered, so that a shader with errors is retried on the next hotload
+            errorCode = job.errCode;
+            continue;
+        }
+
+        if (job.record)
+            job.record->hash = job.sourceHash;
+
+        if (job.wroteSpv && outCompiledShaders && outCompiledShaders->numShaders < MAX_COMPILED_SHADERS)
+        {
+            strcpy_s(outCompiledShaders->spvFilenames[outCompiledShaders->numShaders], COMPILED_SHADER_FILENAME_MAX, job.spvFilename);
+            ++outCompiledShaders->numShaders;
+        }
+
+        ShaderManifestEntry* manifestEntry = (ShaderManifestEntry*)FindManifestEntry(g_manifest, job.spvFilename);
+        if (!manifestEntry && g_manifest.numEntries < MAX_COMPILED_SHADERS)
+            manifestEntry = &g_manifest.entries[g_manifest.numEntries++];
+        if (manifestEntry)
+            *manifestEntry = job.manifestEntry;
+    }
+
+    // Drop the variants of recompiled shaders that their permutations no longer produce
+    for (uint32 uiEntry = 0; uiEntry < g_manifest.numEntries;)
+    {
+        bool isShaderCompiled = false;
+        bool isVariantCompiled = false;
+        for (uint32 uiJob = 0; uiJob < g_numCompileJobs; ++uiJob)
+        {
+            const ShaderCompileJob& job = g_compileJobs[uiJob];
+            if (strcmp(job.baseSpvFilename, g_manifest.entries[uiEntry].baseSpvFilename) == 0)
+            {
+                isShaderCompiled = true;
+                isVariantCompiled |= strcmp(job.spvFilename, g_manifest.entries[uiEntry].spvFilename) == 0;
+            }
+        }
+
+        if (isShaderCompiled && !isVariantCompiled)
+            g_manifest.entries[uiEntry] = g_manifest.entries[--g_manifest.numEntries];
+        else
+            ++uiEntry;
+    }
+
+    if (WriteManifest(g_manifest))
+    {
+        printf("Error writing shader manifest.\n");
+    }
+
+    if (WriteArchive(g_manifest))
+    {
+        printf("Error writing shader archive.\n");
+    }
+
+    if (onlyChanged)
+        printf("\nSkipped %u unchanged shaders.\n", numSkipped);
+
     return errorCode;
 }
 
+uint32 Init()
+{
+    if (CreateDxcInstance(&g_dxc))
+    {
+        isInitted = 1;
+        g_dxcVersion = GetDxcVersion(g_dxc.pCompiler);
+
+        for (uint32 uiShaderType = 0; uiShaderType < ShaderType::Max; ++uiShaderType)
+        {
+            g_args[uiShaderType].Reserve(32);
+            g_args[uiShaderType].Clear();
+            AppendArgsToList(CompileFlags_Common, g_args[uiShaderType]);
+            AppendArgsToList(CompileFlags_VkSpecific, g_args[uiShaderType]);
+            AppendArgsToList(CompileFlags_ShaderSpecific[uiShaderType], g_args[uiShaderType]);
+            g_argsHash[uiShaderType] = HashArgs(g_args[uiShaderType]);
+        }
+
+        CreateDirectoryA(SHADER_CACHE_DIR, nullptr);
+
+        // Start from the previous manifest, if there is a valid one
+        g_manifest = {};
+        g_manifest.magic = SHADER_MANIFEST_MAGIC;
+        g_manifest.version = SHADER_MANIFEST_VERSION;
+        Tk::Core::StrFixedBuffer<2048> manifestFilepath;
+        GetSpvFilepath(SHADER_MANIFEST_FILENAME, manifestFilepath);
+        CComPtr<IDxcBlobEncoding> pManifest = LoadFileIfExists(g_dxc.pUtils, manifestFilepath.m_data);
+        if (pManifest == nullptr || !ParseManifest((const uint8*)pManifest->GetBufferPointer(), (uint32)pManifest->GetBufferSize(), &g_manifest))
+        {
+            g_manifest.numEntries = 0;
+        }
+
+        // The spv files on disk are assumed to match the current sources, so the first hotload only compiles what gets edited after this
+        CompileShadersVK(false, true, nullptr);
+        return ErrCode::Success;
+    }
+    else
+    {
+        isInitted = 0;
+        return ErrCode::NonShaderError;
+    }
+}
+
+bool ReadShaderManifest(ShaderManifest* outManifest)
+{
+    Tk::Core::StrFixedBuffer<2048> manifestFilepath;
+    GetSpvFilepath(SHADER_MANIFEST_FILENAME, manifestFilepath);
+
+    const uint64 sizeInBytes = Tk::Platform::GetEntireFileSize(manifestFilepath.m_data);
+    if (!sizeInBytes || sizeInBytes > sizeof(ShaderManifest))
+        return false;
+
+    uint8* data = (uint8*)Tk::Core::CoreMalloc(sizeInBytes);
+    bool bOk = data && !Tk::Platform::ReadEntireFile(manifestFilepath.m_data, sizeInBytes, data) &&
+        ParseManifest(data, (uint32)sizeInBytes, outManifest);
+    Tk::Core::CoreFree(data);
+    return bOk;
+}
+
+const ShaderArchiveEntry* GetShaderArchiveEntries(const uint8* archive, uint64 archiveSizeInBytes, uint32* outNumEntries)
+{
+    *outNumEntries = 0;
+    if (!archive || archiveSizeInBytes < sizeof(ShaderArchiveHeader))
+        return nullptr;
+
+    const ShaderArchiveHeader* header = (const ShaderArchiveHeader*)archive;
+    if (header->magic != SHADER_ARCHIVE_MAGIC || header->version != SHADER_ARCHIVE_VERSION ||
+        header->numEntries > MAX_COMPILED_SHADERS ||
+        archiveSizeInBytes < sizeof(ShaderArchiveHeader) + header->numEntries * sizeof(ShaderArchiveEntry))
+        return nullptr;
+
+    const ShaderArchiveEntry* entries = (const ShaderArchiveEntry*)(header + 1);
+    for (uint32 uiEntry = 0; uiEntry < header->numEntries; ++uiEntry)
+    {
+        const ShaderArchiveEntry& entry = entries[uiEntry];
+        if (entry.spvFilename[COMPILED_SHADER_FILENAME_MAX - 1] != '\0' ||
+            !entry.blobSizeInBytes || (entry.blobSizeInBytes & 3) || (entry.blobOffset & (SHADER_ARCHIVE_BLOB_ALIGNMENT - 1)) ||
+            (uint64)entry.blobOffset + entry.blobSizeInBytes > archiveSizeInBytes)
+            return nullptr;
+    }
+
+    *outNumEntries = header->numEntries;
+    return entries;
+}
+
+uint32 CompileAllShadersDX()
+{
+    printf("DX codepath not implemented yet :)");
+    return ErrCode::NonShaderError;
+}
+
+uint32 CompileAllShadersVK()
+{
+    return CompileShadersVK(false, false, nullptr);
+}
+
+uint32 CompileChangedShadersVK(CompiledShaderList* outCompiledShaders)
+{
+    return CompileShadersVK(true, false, outCompiledShaders);
+}
+
 }
 }
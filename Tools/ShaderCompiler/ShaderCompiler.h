@@ -19,11 +19,91 @@ enum : uint32
 };
 }
 
+#define MAX_COMPILED_SHADERS 256
+#define COMPILED_SHADER_FILENAME_MAX 256
+#define SHADER_VARIANT_DEFINES_MAX 256
+
+// Names (no directory) of the spv files written by a compile call, e.g. "blit_VS.spv" or "bench_reduce_CS_1f2e3d4c.spv"
+typedef struct compiled_shader_list
+{
+    uint32 numShaders;
+    char spvFilenames[MAX_COMPILED_SHADERS][COMPILED_SHADER_FILENAME_MAX];
+} CompiledShaderList;
+
+// Written next to the spv files by every compile. Lists each compiled shader with the cache key it was built from.
+#define SHADER_MANIFEST_FILENAME "ShaderManifest.bin"
+#define SHADER_MANIFEST_MAGIC 0x4D534B54 // 'TKSM'
+#define SHADER_MANIFEST_VERSION 3
+
+// Shader sources can declare permutations, one dimension per line, e.g.
+//   // TK_PERMUTATION USE_WAVE_OPS 1 0
+// Every combination of values is compiled as a variant of the shader. The first value of each dimension makes up
+// the default variant, which keeps the plain spv filename and variant key 0. Other variants are keyed by a hash of
+// their defines and written to <name>_<key>.spv.
+#define SHADER_PERMUTATION_TOKEN "// TK_PERMUTATION"
+#define SHADER_VARIANT_KEY_DEFAULT 0
+
+typedef struct shader_manifest_entry
+{
+    char spvFilename[COMPILED_SHADER_FILENAME_MAX];
+    char baseSpvFilename[COMPILED_SHADER_FILENAME_MAX]; // spv of the default variant, same as spvFilename for it
+    char defines[SHADER_VARIANT_DEFINES_MAX]; // e.g. "USE_WAVE_OPS=1", empty if the shader has no permutations
+    uint64 cacheKey; // hash of source + includes, compile flags, defines and compiler version
+    uint8 shaderHash[16]; // DXC_OUT_SHADER_HASH, zero if the compiler didn't provide one
+    uint32 spvSizeInBytes;
+    uint32 variantKey;
+} ShaderManifestEntry;
+
+typedef struct shader_manifest
+{
+    uint32 magic;
+    uint32 version;
+    uint32 numEntries;
+    uint32 pad;
+    ShaderManifestEntry entries[MAX_COMPILED_SHADERS]; // only numEntries are stored on disk
+} ShaderManifest;
+
+// Packed bytecode of every shader in the manifest, written after each compile so the runtime can map one file instead of
+// reading each spv. Identical bytecode, e.g. a variant whose defines don't change the output, is stored once and shared by
+// its entries. Layout: header, entries, then the blobs, each starting on a SHADER_ARCHIVE_BLOB_ALIGNMENT boundary.
+#define SHADER_ARCHIVE_FILENAME "ShaderArchive.bin"
+#define SHADER_ARCHIVE_MAGIC 0x41534B54 // 'TKSA'
+#define SHADER_ARCHIVE_VERSION 2
+#define SHADER_ARCHIVE_BLOB_ALIGNMENT 64
+
+typedef struct shader_archive_entry
+{
+    char spvFilename[COMPILED_SHADER_FILENAME_MAX];
+    uint64 contentHash; // hash of the bytecode, entries with the same hash share a blob
+    uint32 blobOffset; // from the start of the archive
+    uint32 blobSizeInBytes;
+} ShaderArchiveEntry;
+
+typedef struct shader_archive_header
+{
+    uint32 magic;
+    uint32 version;
+    uint32 numEntries;
+    uint32 numBlobs;
+} ShaderArchiveHeader;
+
 // 1 means all files compiled cleanly, 0 means failure to compile
 // TODO: expose the errors buffer
 uint32 Init();
 uint32 CompileAllShadersVK();
+// Only recompiles shaders whose source, or any file they #include, changed since they were last compiled (or since Init)
+uint32 CompileChangedShadersVK(CompiledShaderList* outCompiledShaders);
 uint32 CompileAllShadersDX();
 
+// Does not require Init, so the runtime can use it. Returns false if there is no valid manifest.
+bool ReadShaderManifest(ShaderManifest* outManifest);
+
+// Validates an archive in memory, e.g. a mapped view of SHADER_ARCHIVE_FILENAME, and returns its entries. Every blob is
+// checked to be in bounds, so the runtime can use them without further checks. Returns nullptr if the archive is invalid.
+const ShaderArchiveEntry* GetShaderArchiveEntries(const uint8* archive, uint64 archiveSizeInBytes, uint32* outNumEntries);
+
+// Does not require Init. The hash stored as ShaderArchiveEntry::contentHash, for bytecode that isn't read from an archive.
+uint64 HashSpvContent(const void* spv, uint32 sizeInBytes);
+
 }
 }